@@ -0,0 +1,124 @@
+/// File: gpu_culling.hlsl.h
+// Culling kernels of hiz_build.cs and gpu_culling.cs. The CPU reference in renderer/gpu_culling.h
+// runs the same functions, it defines CullingImage before including this file.
+#ifndef GPU_CULLING_HLSL_H_INCLUDED
+#define GPU_CULLING_HLSL_H_INCLUDED
+#include "structured_buffer.hlsl.h"
+
+#if defined(__cplusplus)
+#define CULLING_FUNC      inline
+#define CULLING_IN(TYPE)  const TYPE&
+#define CULLING_IMAGE     const CullingImage&
+#define CULLING_MUL(a, b) ((a) * (b))
+#else
+#define CULLING_FUNC
+#define CULLING_IN(TYPE)  TYPE
+#define CULLING_IMAGE     Texture2D<float>
+#define CULLING_MUL(a, b) mul((a), (b))
+#endif
+
+// depth is reversed, the farthest depth of a tile is the smallest
+CULLING_FUNC float ReduceHiZTile(CULLING_IMAGE p_depth, Vector2i p_depth_size, Vector2i p_tile) {
+    int x_begin = p_tile.x * HIZ_TILE_SIZE;
+    int y_begin = p_tile.y * HIZ_TILE_SIZE;
+    int x_end = min(x_begin + HIZ_TILE_SIZE, p_depth_size.x);
+    int y_end = min(y_begin + HIZ_TILE_SIZE, p_depth_size.y);
+
+    float farthest = 1.0f;
+    for (int y = y_begin; y < y_end; ++y) {
+        for (int x = x_begin; x < x_end; ++x) {
+            farthest = min(farthest, p_depth.Load(Vector3i(x, y, 0)));
+        }
+    }
+    return farthest;
+}
+
+// false when the box is on the negative side of a plane
+CULLING_FUNC bool CullingFrustumTest(CULLING_IN(GpuCullConstants) p_constants, Vector3f p_min, Vector3f p_max) {
+    for (int i = 0; i < 6; ++i) {
+        Vector4f plane = p_constants.planes[i];
+        // the corner furthest along the normal
+        float x = plane.x > 0.0f ? p_max.x : p_min.x;
+        float y = plane.y > 0.0f ? p_max.y : p_min.y;
+        float z = plane.z > 0.0f ? p_max.z : p_min.z;
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// false when the hi-z texels the box covers are all nearer than the box, it was hidden last frame.
+// boxes that were partly out of view, or that cover too many texels, are kept
+CULLING_FUNC bool CullingOcclusionTest(CULLING_IN(GpuCullConstants) p_constants, CULLING_IMAGE p_hiz, Vector3f p_min, Vector3f p_max) {
+    float u_min = 1.0f;
+    float v_min = 1.0f;
+    float u_max = 0.0f;
+    float v_max = 0.0f;
+    float nearest = 0.0f;
+    for (int i = 0; i < 8; ++i) {
+        Vector4f corner = Vector4f((i & 1) != 0 ? p_max.x : p_min.x,
+                                   (i & 2) != 0 ? p_max.y : p_min.y,
+                                   (i & 4) != 0 ? p_max.z : p_min.z,
+                                   1.0f);
+        Vector4f clip = CULLING_MUL(p_constants.hizMatrix, corner);
+        // the box crosses the camera plane
+        if (clip.w <= 0.0f) {
+            return true;
+        }
+
+        float u = clip.x / clip.w;
+        float v = clip.y / clip.w;
+        u_min = min(u_min, u);
+        v_min = min(v_min, v);
+        u_max = max(u_max, u);
+        v_max = max(v_max, v);
+        nearest = max(nearest, clip.z / clip.w);
+    }
+
+    if (u_min < 0.0f || v_min < 0.0f || u_max > 1.0f || v_max > 1.0f) {
+        return true;
+    }
+
+    int x_begin = min(int(u_min * float(p_constants.hizSize.x)), p_constants.hizSize.x - 1);
+    int y_begin = min(int(v_min * float(p_constants.hizSize.y)), p_constants.hizSize.y - 1);
+    int x_end = min(int(u_max * float(p_constants.hizSize.x)), p_constants.hizSize.x - 1);
+    int y_end = min(int(v_max * float(p_constants.hizSize.y)), p_constants.hizSize.y - 1);
+    if (x_end - x_begin >= HIZ_MAX_FOOTPRINT || y_end - y_begin >= HIZ_MAX_FOOTPRINT) {
+        return true;
+    }
+
+    float farthest = 1.0f;
+    for (int y = y_begin; y <= y_end; ++y) {
+        for (int x = x_begin; x <= x_end; ++x) {
+            farthest = min(farthest, p_hiz.Load(Vector3i(x, y, 0)));
+        }
+    }
+    return nearest >= farthest;
+}
+
+CULLING_FUNC bool IsInstanceVisible(CULLING_IN(GpuCullConstants) p_constants, CULLING_IMAGE p_hiz, CULLING_IN(GpuCullInstance) p_instance) {
+    if (!CullingFrustumTest(p_constants, p_instance.min, p_instance.max)) {
+        return false;
+    }
+    if (p_constants.hizEnabled == 0) {
+        return true;
+    }
+    return CullingOcclusionTest(p_constants, p_hiz, p_instance.min, p_instance.max);
+}
+
+// draws the instance once, the draw id is passed on as the first instance
+CULLING_FUNC GpuDrawIndirectArgs MakeIndirectArgs(CULLING_IN(GpuCullInstance) p_instance) {
+    GpuDrawIndirectArgs args;
+    args.indexCount = p_instance.indexCount;
+    args.instanceCount = 1;
+    args.firstIndex = p_instance.firstIndex;
+    args.baseVertex = p_instance.baseVertex;
+    args.firstInstance = p_instance.drawId;
+    args._padding1 = 0;
+    args._padding2 = 0;
+    args._padding3 = 0;
+    return args;
+}
+
+#endif
@@ -0,0 +1,29 @@
+/// File: gpu_culling.cs.hlsl
+#include "shader_resource_defines.hlsl.h"
+#include "gpu_culling.hlsl.h"
+
+// hi-z of the previous frame
+Texture2D<float> t_HiZ : register(t0);
+
+[numthreads(GPU_CULLING_LOCAL_SIZE, 1, 1)] void main(uint3 dispatch_thread_id : SV_DISPATCHTHREADID) {
+    int index = int(dispatch_thread_id.x);
+    GpuCullConstants constants = GlobalCullConstants[0];
+    if (index >= constants.instanceCount) {
+        return;
+    }
+
+    // the cpu sizes the hi-z after the camera, the texture bound is sized after the frame
+    uint hiz_width, hiz_height;
+    t_HiZ.GetDimensions(hiz_width, hiz_height);
+    constants.hizSize = Vector2i(hiz_width, hiz_height);
+
+    GpuCullInstance instance = GlobalCullInstances[index];
+    if (!IsInstanceVisible(constants, t_HiZ, instance)) {
+        return;
+    }
+
+    // survivors are appended in any order
+    uint slot;
+    InterlockedAdd(GlobalIndirectCount[0], 1, slot);
+    GlobalIndirectArgs[slot] = MakeIndirectArgs(instance);
+}
@@ -0,0 +1,20 @@
+/// File: hiz_build.cs.hlsl
+#include "gpu_culling.hlsl.h"
+
+Texture2D<float> t_GbufferDepth : register(t0);
+RWTexture2D<float> u_HiZImage : register(u0);
+
+[numthreads(HIZ_LOCAL_SIZE, HIZ_LOCAL_SIZE, 1)] void main(uint3 dispatch_thread_id : SV_DISPATCHTHREADID) {
+    uint width, height;
+    u_HiZImage.GetDimensions(width, height);
+    if (dispatch_thread_id.x >= width || dispatch_thread_id.y >= height) {
+        return;
+    }
+
+    uint depth_width, depth_height;
+    t_GbufferDepth.GetDimensions(depth_width, depth_height);
+
+    Vector2i depth_size = Vector2i(depth_width, depth_height);
+    Vector2i tile = Vector2i(dispatch_thread_id.xy);
+    u_HiZImage[dispatch_thread_id.xy] = ReduceHiZTile(t_GbufferDepth, depth_size, tile);
+}
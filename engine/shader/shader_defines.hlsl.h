@@ -42,6 +42,13 @@
 
 // compute local sizes
 #define COMPUTE_LOCAL_SIZE_VOXEL 4
+#define GPU_CULLING_LOCAL_SIZE   64
+#define HIZ_LOCAL_SIZE           8
+
+// a hi-z texel holds the farthest depth of a tile of screen pixels
+#define HIZ_TILE_SIZE     16
+// boxes covering more hi-z texels than this in x or y are not tested for occlusion
+#define HIZ_MAX_FOOTPRINT 4
 
 #if defined(__cplusplus)
 #define VCT_CONST constexpr
@@ -155,8 +155,20 @@ HitResult HitScene(inout Ray p_ray) {
     res.hitTriangleId = -1;
     res.uv = Vector2f(0.0f, 0.0f);
 
-    // check if it hits all the objects
-    for (int mesh_id = 0; mesh_id < c_ptObjectCount; ++mesh_id) {
+    // the top level tree over the meshes starts at node 0, a leaf holds the mesh id in triangleIndex
+    int tlasIndex = 0;
+    while (tlasIndex >= 0) {
+        GpuPtBvh tlas = GlobalPtBvhs[tlasIndex];
+        if (!HitBvh(p_ray, tlas.min, tlas.max)) {
+            tlasIndex = tlas.missIdx;
+            continue;
+        }
+        if (tlas.triangleIndex == -1) {
+            tlasIndex = tlasIndex + 1;
+            continue;
+        }
+
+        int mesh_id = tlas.triangleIndex;
         GpuPtMesh mesh = GlobalPtMeshes[mesh_id];
         Matrix4x4f inversed = mesh.transformInv;
         Ray local_ray;
@@ -177,12 +189,16 @@ HitResult HitScene(inout Ray p_ray) {
                         res.uv = result.uv;
                         p_ray.t = local_ray.t;
                     }
+                    bvhIndex = bvh.missIdx;
+                } else {
+                    bvhIndex = bvhIndex + 1;
                 }
-                bvhIndex = bvh.hitIdx;
             } else {
                 bvhIndex = bvh.missIdx;
             }
         }
+
+        tlasIndex = tlas.missIdx;
     }
 
     return res;
@@ -21,14 +21,13 @@ struct ParticleCounter {
 };
 
 // ray tracing
+// nodes are in preorder, on a hit the next node to visit is the left child (the next node),
+// on a miss or after a leaf it's missIdx
 struct GpuPtBvh {
     Vector3f min;
     int missIdx;
     Vector3f max;
-    int hitIdx;
-
-    Vector2f _padding;
-    int leaf;
+    // -1 for inner nodes
     int triangleIndex;
 };
 
@@ -60,24 +59,68 @@ struct GpuPtMaterial {
     float metallic;
 };
 
+// gpu culling, the constants are the only element of their buffer
+struct GpuCullConstants {
+    // world space frustum planes, xyz is the normal and w the distance
+    Vector4f planes[6];
+    // view projection of the previous frame, the hi-z was built with it. maps a world position
+    // to the hi-z uv in xy and the reversed depth in z
+    Matrix4x4f hizMatrix;
+    Vector2i hizSize;
+    int instanceCount;
+    // 0 when there is no hi-z of the previous frame
+    int hizEnabled;
+};
+
+struct GpuCullInstance {
+    // world space bounds
+    Vector3f min;
+    uint indexCount;
+    Vector3f max;
+    uint firstIndex;
+    int baseVertex;
+    // passed on as the first instance of the draw
+    uint drawId;
+    Vector2i _padding;
+};
+
+// DrawIndexedInstancedIndirect and glDrawElementsIndirect arguments, padded to 32 bytes
+struct GpuDrawIndirectArgs {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint firstInstance;
+    int _padding1;
+    int _padding2;
+    int _padding3;
+};
+
 #ifdef __cplusplus
 static_assert(sizeof(GpuPtBvh) % sizeof(Vector4f) == 0);
 static_assert(sizeof(GpuPtVertex) % sizeof(Vector4f) == 0);
 static_assert(sizeof(GpuPtIndex) % sizeof(Vector4f) == 0);
 static_assert(sizeof(GpuPtMesh) % sizeof(Vector4f) == 0);
 static_assert(sizeof(GpuPtMaterial) % sizeof(Vector4f) == 0);
+static_assert(sizeof(GpuCullConstants) % sizeof(Vector4f) == 0);
+static_assert(sizeof(GpuCullInstance) % sizeof(Vector4f) == 0);
+static_assert(sizeof(GpuDrawIndirectArgs) % sizeof(Vector4f) == 0);
 #endif  // __cplusplus
 
-#define SBUFFER_LIST                                         \
-    SBUFFER(ParticleCounter, GlobalParticleCounter, 16, 511) \
-    SBUFFER(int, GlobalDeadIndices, 17, 510)                 \
-    SBUFFER(int, GlobalAliveIndicesPreSim, 18, 509)          \
-    SBUFFER(int, GlobalAliveIndicesPostSim, 19, 508)         \
-    SBUFFER(Particle, GlobalParticleData, 20, 507)           \
-    SBUFFER(GpuPtVertex, GlobalPtVertices, 21, 506)          \
-    SBUFFER(GpuPtIndex, GlobalPtIndices, 22, 505)            \
-    SBUFFER(GpuPtBvh, GlobalPtBvhs, 23, 504)                 \
-    SBUFFER(GpuPtMesh, GlobalPtMeshes, 24, 503)              \
-    SBUFFER(GpuPtMaterial, GlobalPtMaterials, 25, 502)
+#define SBUFFER_LIST                                          \
+    SBUFFER(ParticleCounter, GlobalParticleCounter, 16, 511)  \
+    SBUFFER(int, GlobalDeadIndices, 17, 510)                  \
+    SBUFFER(int, GlobalAliveIndicesPreSim, 18, 509)           \
+    SBUFFER(int, GlobalAliveIndicesPostSim, 19, 508)          \
+    SBUFFER(Particle, GlobalParticleData, 20, 507)            \
+    SBUFFER(GpuPtVertex, GlobalPtVertices, 21, 506)           \
+    SBUFFER(GpuPtIndex, GlobalPtIndices, 22, 505)             \
+    SBUFFER(GpuPtBvh, GlobalPtBvhs, 23, 504)                  \
+    SBUFFER(GpuPtMesh, GlobalPtMeshes, 24, 503)               \
+    SBUFFER(GpuPtMaterial, GlobalPtMaterials, 25, 502)        \
+    SBUFFER(GpuCullConstants, GlobalCullConstants, 26, 501)   \
+    SBUFFER(GpuCullInstance, GlobalCullInstances, 27, 500)    \
+    SBUFFER(GpuDrawIndirectArgs, GlobalIndirectArgs, 28, 499) \
+    SBUFFER(uint, GlobalIndirectCount, 29, 498)
 
 #endif
@@ -0,0 +1,53 @@
+#pragma once
+
+namespace my {
+
+// Stable LSD radix sort of p_items by the 64-bit key p_key(item), 8 bits per pass.
+// p_scratch must hold at least as many items as p_items. Bytes that are the same in
+// every key are skipped, so keys that only use a few bits sort in a few passes.
+template<typename T, typename KEY_FUNC>
+void RadixSort(std::span<T> p_items, std::span<T> p_scratch, const KEY_FUNC& p_key) {
+    DEV_ASSERT(p_scratch.size() >= p_items.size());
+    const size_t count = p_items.size();
+    if (count < 2) {
+        return;
+    }
+
+    uint64_t any_set = 0;
+    uint64_t all_set = ~0ull;
+    for (const T& item : p_items) {
+        const uint64_t key = p_key(item);
+        any_set |= key;
+        all_set &= key;
+    }
+    const uint64_t varying = any_set ^ all_set;
+
+    T* src = p_items.data();
+    T* dst = p_scratch.data();
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        if (((varying >> shift) & 0xFF) == 0) {
+            continue;
+        }
+
+        size_t offsets[256] = {};
+        for (size_t i = 0; i < count; ++i) {
+            ++offsets[(p_key(src[i]) >> shift) & 0xFF];
+        }
+        size_t sum = 0;
+        for (size_t& offset : offsets) {
+            const size_t bucket_size = offset;
+            offset = sum;
+            sum += bucket_size;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            dst[offsets[(p_key(src[i]) >> shift) & 0xFF]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != p_items.data()) {
+        std::copy(src, src + count, p_items.data());
+    }
+}
+
+}  // namespace my
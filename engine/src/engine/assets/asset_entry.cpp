@@ -6,12 +6,15 @@ auto AssetEntry::Wait() -> Result<AssetRef> {
     std::unique_lock lock(m_mutex);
 
     m_cv.wait(lock, [this]() {
-        return status == AssetStatus::Loaded || status == AssetStatus::Failed;
+        return status == AssetStatus::Loaded || status == AssetStatus::Failed || status == AssetStatus::Cancelled;
     });
 
     if (status == AssetStatus::Failed) {
         return HBN_ERROR(ErrorCode::ERR_INVALID_DATA, "failed to load {}", metadata.path);
     }
+    if (status == AssetStatus::Cancelled) {
+        return HBN_ERROR(ErrorCode::ERR_SKIP, "loading {} was cancelled", metadata.path);
+    }
 
     return asset;
 }
@@ -33,4 +36,12 @@ void AssetEntry::MarkFailed() {
     m_cv.notify_all();
 }
 
+void AssetEntry::MarkCancelled() {
+    {
+        std::lock_guard lock(m_mutex);
+        status = AssetStatus::Cancelled;
+    }
+    m_cv.notify_all();
+}
+
 }  // namespace my
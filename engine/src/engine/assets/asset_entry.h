@@ -11,6 +11,8 @@ enum class AssetStatus : uint8_t {
     Loading,
     Loaded,
     Failed,
+    // taken out of the load queue before it was loaded
+    Cancelled,
 };
 
 class AssetEntry {
@@ -35,6 +37,8 @@ public:
 
     void MarkFailed();
 
+    void MarkCancelled();
+
 private:
     std::mutex m_mutex;
     std::condition_variable m_cv;
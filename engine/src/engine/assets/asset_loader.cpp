@@ -1,7 +1,7 @@
 #include "asset_loader.h"
 
 #include "engine/assets/assets.h"
-#include "engine/core/io/file_access.h"
+#include "engine/core/io/file_access_mapped.h"
 #include "engine/core/string/string_utils.h"
 #include "engine/renderer/pixel_format.h"
 #include "engine/scene/scene.h"
@@ -41,38 +41,26 @@ std::unique_ptr<IAssetLoader> IAssetLoader::Create(const AssetMetaData& p_meta)
 }
 
 auto BufferAssetLoader::Load() -> Result<AssetRef> {
-    auto res = FileAccess::Open(m_meta.path, FileAccess::READ);
+    auto res = FileAccessMapped::Map(m_meta.path);
     if (!res) {
         return HBN_ERROR(res.error());
     }
 
-    std::shared_ptr<FileAccess> file_access = *res;
-
-    const size_t size = file_access->GetLength();
-
-    std::vector<char> buffer;
-    buffer.resize(size);
-    file_access->ReadBuffer(buffer.data(), size);
+    const auto data = (*res)->GetData();
     auto file = new BufferAsset;
-    file->buffer = std::move(buffer);
+    file->buffer.assign(data.begin(), data.end());
     return AssetRef(file);
 }
 
 auto TextAssetLoader::Load() -> Result<AssetRef> {
-    auto res = FileAccess::Open(m_meta.path, FileAccess::READ);
+    auto res = FileAccessMapped::Map(m_meta.path);
     if (!res) {
         return HBN_ERROR(res.error());
     }
 
-    std::shared_ptr<FileAccess> file_access = *res;
-
-    const size_t size = file_access->GetLength();
-    std::vector<char> buffer;
-    buffer.resize(size);
-    file_access->ReadBuffer(buffer.data(), size);
-
+    const auto data = (*res)->GetData();
     auto file = new TextAsset;
-    file->source = std::string(buffer.begin(), buffer.end());
+    file->source.assign(reinterpret_cast<const char*>(data.data()), data.size());
     return AssetRef(file);
 }
 
@@ -93,18 +81,16 @@ static PixelFormat ChannelToFormat(int p_channel, bool p_is_float) {
 }
 
 auto ImageAssetLoader::Load() -> Result<AssetRef> {
-    auto res = FileAccess::Open(m_meta.path, FileAccess::READ);
+    // stb decodes straight from the mapped file
+    auto res = FileAccessMapped::Map(m_meta.path);
     if (!res) {
         return HBN_ERROR(res.error());
     }
 
     const bool is_float = m_size == 4;
 
-    std::shared_ptr<FileAccess> file = *res;
-    const size_t size = file->GetLength();
-    std::vector<uint8_t> file_buffer;
-    file_buffer.resize(size);
-    file->ReadBuffer(file_buffer.data(), size);
+    const auto file_buffer = (*res)->GetData();
+    const size_t size = file_buffer.size();
 
     int width = 0;
     int height = 0;
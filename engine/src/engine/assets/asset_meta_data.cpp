@@ -33,7 +33,7 @@ static Result<AssetType> ParseAssetType(std::string_view p_string) {
 auto AssetMetaData::LoadMeta(std::string_view p_path) -> Result<AssetMetaData> {
     std::shared_ptr<FileAccess> file;
     {
-        auto res = FileAccess::Open(p_path, FileAccess::READ);
+        auto res = FileAccess::Open(p_path, FileAccess::READ, FileAccess::PATTERN_WHOLE_FILE);
         if (!res) {
             return HBN_ERROR(res.error());
         }
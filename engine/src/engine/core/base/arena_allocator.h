@@ -0,0 +1,43 @@
+#pragma once
+#include "linear_allocator.h"
+
+namespace my {
+
+// Standard allocator on top of a LinearAllocator, so std containers can live in an arena.
+// deallocate() does nothing, the memory comes back when the arena is reset, and containers
+// using it must be destroyed before that.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator(LinearAllocator& p_arena)
+        : m_arena(&p_arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& p_other)
+        : m_arena(p_other.GetArena()) {}
+
+    T* allocate(size_t p_count) {
+        static_assert(alignof(T) <= LinearAllocator::BLOCK_ALIGNMENT, "the arena can't align T");
+        return static_cast<T*>(m_arena->Allocate(sizeof(T) * p_count, alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {}
+
+    LinearAllocator* GetArena() const { return m_arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& p_other) const { return m_arena == p_other.GetArena(); }
+
+private:
+    LinearAllocator* m_arena;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+template<typename KEY, typename VALUE>
+using ArenaHashMap = std::unordered_map<KEY, VALUE, std::hash<KEY>, std::equal_to<KEY>, ArenaAllocator<std::pair<const KEY, VALUE>>>;
+
+}  // namespace my
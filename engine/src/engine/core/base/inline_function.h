@@ -0,0 +1,110 @@
+#pragma once
+
+namespace my {
+
+template<typename T, size_t N>
+class InlineFunction;
+
+// std::function like callable that stores the target in a fixed size buffer and never allocates,
+// targets that don't fit are rejected at compile time
+template<typename R, typename... Args, size_t N>
+class InlineFunction<R(Args...), N> {
+    enum class Op {
+        COPY,
+        MOVE,
+        DESTROY,
+    };
+
+    using InvokeFunc = R (*)(void*, Args&&...);
+    using ManageFunc = void (*)(Op, void*, void*);
+
+public:
+    InlineFunction() = default;
+
+    InlineFunction(std::nullptr_t) {}
+
+    template<typename F>
+        requires(!std::is_same_v<std::decay_t<F>, InlineFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    InlineFunction(F&& p_func) {
+        using Func = std::decay_t<F>;
+        static_assert(sizeof(Func) <= N, "callable is too large, capture less or capture by reference");
+        static_assert(alignof(Func) <= alignof(std::max_align_t));
+
+        new (m_storage) Func(std::forward<F>(p_func));
+        m_invoke = [](void* p_target, Args&&... p_args) -> R {
+            return (*static_cast<Func*>(p_target))(std::forward<Args>(p_args)...);
+        };
+        m_manage = [](Op p_op, void* p_dest, void* p_src) {
+            switch (p_op) {
+                case Op::COPY:
+                    new (p_dest) Func(*static_cast<const Func*>(p_src));
+                    break;
+                case Op::MOVE:
+                    new (p_dest) Func(std::move(*static_cast<Func*>(p_src)));
+                    break;
+                case Op::DESTROY:
+                    static_cast<Func*>(p_dest)->~Func();
+                    break;
+            }
+        };
+    }
+
+    InlineFunction(const InlineFunction& p_other) {
+        if (p_other.m_manage) {
+            p_other.m_manage(Op::COPY, m_storage, const_cast<std::byte*>(p_other.m_storage));
+            m_invoke = p_other.m_invoke;
+            m_manage = p_other.m_manage;
+        }
+    }
+
+    InlineFunction(InlineFunction&& p_other) {
+        if (p_other.m_manage) {
+            p_other.m_manage(Op::MOVE, m_storage, p_other.m_storage);
+            m_invoke = p_other.m_invoke;
+            m_manage = p_other.m_manage;
+            p_other.reset();
+        }
+    }
+
+    ~InlineFunction() { reset(); }
+
+    InlineFunction& operator=(const InlineFunction& p_other) {
+        if (this != &p_other) {
+            this->~InlineFunction();
+            new (this) InlineFunction(p_other);
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(InlineFunction&& p_other) {
+        if (this != &p_other) {
+            this->~InlineFunction();
+            new (this) InlineFunction(std::move(p_other));
+        }
+        return *this;
+    }
+
+    void reset() {
+        if (m_manage) {
+            m_manage(Op::DESTROY, m_storage, nullptr);
+            m_invoke = nullptr;
+            m_manage = nullptr;
+        }
+    }
+
+    R operator()(Args... p_args) const {
+        DEV_ASSERT(m_invoke);
+        return m_invoke(const_cast<std::byte*>(m_storage), std::forward<Args>(p_args)...);
+    }
+
+    explicit operator bool() const { return m_invoke != nullptr; }
+
+    static constexpr size_t capacity() { return N; }
+
+private:
+    alignas(std::max_align_t) std::byte m_storage[N];
+    InvokeFunc m_invoke{ nullptr };
+    ManageFunc m_manage{ nullptr };
+};
+
+}  // namespace my
@@ -0,0 +1,49 @@
+#include "linear_allocator.h"
+
+namespace my {
+
+LinearAllocator::~LinearAllocator() {
+    for (Block& block : m_blocks) {
+        ::operator delete(block.data, std::align_val_t{ BLOCK_ALIGNMENT });
+    }
+}
+
+void* LinearAllocator::Allocate(size_t p_size, size_t p_alignment) {
+    DEV_ASSERT(p_alignment && (p_alignment & (p_alignment - 1)) == 0);
+    DEV_ASSERT(p_alignment <= BLOCK_ALIGNMENT);
+
+    for (; m_current < m_blocks.size(); ++m_current, m_offset = 0) {
+        const Block& block = m_blocks[m_current];
+        const size_t offset = (m_offset + p_alignment - 1) & ~(p_alignment - 1);
+        if (offset + p_size <= block.size) {
+            m_offset = offset + p_size;
+            m_usedSize += p_size;
+            return block.data + offset;
+        }
+    }
+
+    // oversized requests get a block of their own
+    const size_t size = p_size > m_blockSize ? p_size : m_blockSize;
+    char* data = static_cast<char*>(::operator new(size, std::align_val_t{ BLOCK_ALIGNMENT }));
+    m_blocks.push_back({ data, size });
+    m_current = m_blocks.size() - 1;
+    m_offset = p_size;
+    m_usedSize += p_size;
+    return data;
+}
+
+void LinearAllocator::Reset() {
+    m_current = 0;
+    m_offset = 0;
+    m_usedSize = 0;
+}
+
+size_t LinearAllocator::GetCapacity() const {
+    size_t capacity = 0;
+    for (const Block& block : m_blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+}  // namespace my
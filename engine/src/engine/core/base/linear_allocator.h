@@ -0,0 +1,51 @@
+#pragma once
+#include "noncopyable.h"
+
+namespace my {
+
+// Bump allocator for memory that lives until Reset(), nothing is freed individually.
+// Blocks are kept on Reset(), so a warmed up allocator doesn't touch the heap.
+// Not thread safe, allocate up front and hand the memory to jobs.
+class LinearAllocator : public NonCopyable {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+    // blocks start on a cache line, so does anything allocated with up to this alignment
+    static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+    explicit LinearAllocator(size_t p_block_size = DEFAULT_BLOCK_SIZE)
+        : m_blockSize(p_block_size) {}
+
+    ~LinearAllocator();
+
+    void* Allocate(size_t p_size, size_t p_alignment = alignof(std::max_align_t));
+
+    // uninitialized storage for p_count objects, never destructed
+    template<typename T>
+    std::span<T> AllocateArray(size_t p_count) {
+        static_assert(std::is_trivially_destructible_v<T>);
+        if (p_count == 0) {
+            return {};
+        }
+        return std::span<T>(static_cast<T*>(Allocate(sizeof(T) * p_count, alignof(T))), p_count);
+    }
+
+    void Reset();
+
+    size_t GetUsedSize() const { return m_usedSize; }
+    size_t GetCapacity() const;
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    size_t m_blockSize;
+    std::vector<Block> m_blocks;
+    // block allocations are served from, blocks before it are full
+    size_t m_current{ 0 };
+    size_t m_offset{ 0 };
+    size_t m_usedSize{ 0 };
+};
+
+}  // namespace my
@@ -0,0 +1,89 @@
+#pragma once
+
+namespace my {
+
+// Fixed capacity Chase-Lev deque, based on
+// "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013)
+// The owner thread pushes and pops at the bottom, other threads steal from the top.
+// T must be trivially copyable, a thief may read a slot that is being overwritten,
+// the value is discarded when the CAS on m_top fails.
+template<typename T, size_t N>
+class WorkStealingDeque {
+    static_assert(N > 1 && (N & (N - 1)) == 0, "capacity must be power of two");
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    static constexpr int64_t MASK = static_cast<int64_t>(N - 1);
+
+public:
+    // owner only
+    bool push_back(const T& p_value) {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+        if (bottom - top >= static_cast<int64_t>(N)) {
+            return false;
+        }
+
+        m_data[bottom & MASK] = p_value;
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // owner only
+    bool pop_back(T& p_out_value) {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            // empty
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        p_out_value = m_data[bottom & MASK];
+        if (top != bottom) {
+            return true;
+        }
+
+        // last element, race against thieves
+        const bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    // any thread
+    bool steal(T& p_out_value) {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return false;
+        }
+
+        T value = m_data[top & MASK];
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+
+        p_out_value = value;
+        return true;
+    }
+
+    bool empty() const {
+        const int64_t top = m_top.load(std::memory_order_acquire);
+        const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        return top >= bottom;
+    }
+
+    constexpr size_t capacity() const { return N; }
+
+private:
+    // keep the indices on different cache lines, thieves hammer m_top
+    alignas(64) std::atomic<int64_t> m_top{ 0 };
+    alignas(64) std::atomic<int64_t> m_bottom{ 0 };
+    alignas(64) T m_data[N];
+};
+
+}  // namespace my
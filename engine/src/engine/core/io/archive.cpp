@@ -1,5 +1,6 @@
 #include "archive.h"
 
+#include "engine/core/io/file_access_mapped.h"
 #include "engine/core/io/print.h"
 
 namespace my {
@@ -11,23 +12,57 @@ auto Archive::OpenMode(const std::string& p_path, bool p_write_mode) -> Result<v
         m_path += ".tmp";
     }
 
-    auto result = FileAccess::Open(m_path, p_write_mode ? FileAccess::WRITE : FileAccess::READ);
+    // scenes read and write a lot of small fields, don't let each of them hit the file
+    auto result = FileAccess::Open(m_path, p_write_mode ? FileAccess::WRITE : FileAccess::READ, FileAccess::PATTERN_STREAM);
     if (!result) {
         return HBN_ERROR(result.error());
     }
 
     m_file = *result;
+    m_readCursor = nullptr;
+    m_readEnd = nullptr;
     return Result<void>();
 }
 
+void Archive::OpenRead(std::shared_ptr<FileAccess> p_file) {
+    DEV_ASSERT(p_file && (p_file->GetOpenMode() & FileAccess::READ));
+    m_path.clear();
+    m_isWriteMode = false;
+    m_file = std::move(p_file);
+    m_readCursor = nullptr;
+    m_readEnd = nullptr;
+}
+
+void Archive::OpenRead(std::shared_ptr<FileAccessMapped> p_file) {
+    DEV_ASSERT(p_file && p_file->IsOpen());
+    const std::span<const uint8_t> data = p_file->GetData().subspan(static_cast<size_t>(p_file->Tell()));
+    OpenRead(std::shared_ptr<FileAccess>(std::move(p_file)));
+    // an empty file has no memory to point to, reads fail through m_file
+    if (!data.empty()) {
+        m_readCursor = data.data();
+        m_readEnd = data.data() + data.size();
+    }
+}
+
+void Archive::OpenWrite(std::shared_ptr<FileAccess> p_file) {
+    DEV_ASSERT(p_file && (p_file->GetOpenMode() & FileAccess::WRITE));
+    m_path.clear();
+    m_isWriteMode = true;
+    m_file = std::move(p_file);
+    m_readCursor = nullptr;
+    m_readEnd = nullptr;
+}
+
 void Archive::Close() {
     if (!m_file) {
         return;
     }
 
     m_file.reset();
+    m_readCursor = nullptr;
+    m_readEnd = nullptr;
 
-    if (m_isWriteMode) {
+    if (m_isWriteMode && !m_path.empty()) {
         namespace fs = std::filesystem;
 
         fs::path final_path{ m_path };
@@ -54,7 +89,7 @@ bool Archive::Write(const void* p_data, size_t p_size) {
     return m_file->WriteBuffer(p_data, p_size) == p_size;
 }
 
-bool Archive::Read(void* p_data, size_t p_size) {
+bool Archive::ReadFile(void* p_data, size_t p_size) {
     DEV_ASSERT(m_file && !m_isWriteMode);
     return m_file->ReadBuffer(p_data, p_size) == p_size;
 }
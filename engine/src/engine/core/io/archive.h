@@ -3,6 +3,8 @@
 
 namespace my {
 
+class FileAccessMapped;
+
 class Archive {
 public:
     ~Archive() {
@@ -11,13 +13,31 @@ public:
 
     [[nodiscard]] auto OpenRead(const std::string& p_path) -> Result<void> { return OpenMode(p_path.c_str(), false); }
     [[nodiscard]] auto OpenWrite(const std::string& p_path) -> Result<void> { return OpenMode(p_path.c_str(), true); }
+    // reads from a file that is already open
+    void OpenRead(std::shared_ptr<FileAccess> p_file);
+    // reads straight from the memory of a mapped file from its cursor on, fields don't go through
+    // FileAccess::ReadBuffer() and the cursor of p_file doesn't move
+    void OpenRead(std::shared_ptr<FileAccessMapped> p_file);
+    // writes to a file that is already open, unlike OpenWrite(path) nothing is buffered or renamed
+    void OpenWrite(std::shared_ptr<FileAccess> p_file);
 
     void Close();
     bool IsWriteMode() const;
     bool IsReadMode() const;
 
     bool Write(const void* p_data, size_t p_size);
-    bool Read(void* p_data, size_t p_size);
+
+    bool Read(void* p_data, size_t p_size) {
+        if (m_readCursor) {
+            if (p_size > static_cast<size_t>(m_readEnd - m_readCursor)) {
+                return false;
+            }
+            memcpy(p_data, m_readCursor, p_size);
+            m_readCursor += p_size;
+            return true;
+        }
+        return ReadFile(p_data, p_size);
+    }
 
     template<typename T>
     bool Write(const T& p_value) {
@@ -27,8 +47,7 @@ public:
 
     template<typename T>
     bool Read(T& p_value) {
-        const size_t read = m_file->Read(p_value);
-        return read == sizeof(T);
+        return Read(&p_value, sizeof(T));
     }
 
     template<>
@@ -102,10 +121,14 @@ private:
     [[nodiscard]] auto OpenMode(const std::string& p_path, bool p_write_mode) -> Result<void>;
 
     bool WriteString(const char* p_data, size_t p_length);
+    bool ReadFile(void* p_data, size_t p_size);
 
     bool m_isWriteMode{ false };
     std::shared_ptr<FileAccess> m_file{};
     std::string m_path{};
+    // the unread part of a mapped file, null when reading through m_file
+    const uint8_t* m_readCursor{ nullptr };
+    const uint8_t* m_readEnd{ nullptr };
 };
 
 }  // namespace my
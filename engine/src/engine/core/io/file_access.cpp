@@ -1,5 +1,7 @@
 #include "file_access.h"
 
+#include "engine/core/io/file_access_buffered.h"
+#include "engine/core/io/file_access_mapped.h"
 #include "engine/core/string/string_utils.h"
 
 namespace my {
@@ -17,24 +19,43 @@ auto FileAccess::Create(AccessType p_access_type) -> std::shared_ptr<FileAccess>
 }
 
 auto FileAccess::CreateForPath(std::string_view p_path) -> std::shared_ptr<FileAccess> {
+    return Create(GetAccessTypeForPath(p_path));
+}
+
+FileAccess::AccessType FileAccess::GetAccessTypeForPath(std::string_view p_path) {
     if (p_path.starts_with("@res://")) {
-        return Create(ACCESS_RESOURCE);
+        return ACCESS_RESOURCE;
     }
 
     if (p_path.starts_with("@user://")) {
-        return Create(ACCESS_USERDATA);
+        return ACCESS_USERDATA;
     }
 
-    return Create(ACCESS_FILESYSTEM);
+    return ACCESS_FILESYSTEM;
 }
 
-auto FileAccess::Open(std::string_view p_path, ModeFlags p_mode_flags) -> Result<std::shared_ptr<FileAccess>> {
-    auto file_access = CreateForPath(p_path);
+auto FileAccess::Open(std::string_view p_path,
+                      ModeFlags p_mode_flags,
+                      AccessPattern p_pattern) -> Result<std::shared_ptr<FileAccess>> {
+    // only files that are read can be mapped, anything else falls back to the default backend
+    if (p_pattern == PATTERN_WHOLE_FILE && p_mode_flags == READ) {
+        auto res = FileAccessMapped::Map(p_path);
+        if (!res) {
+            return HBN_ERROR(res.error());
+        }
+        return std::shared_ptr<FileAccess>(*res);
+    }
+
+    std::shared_ptr<FileAccess> file_access = CreateForPath(p_path);
 
     if (auto res = file_access->OpenInternal(FileAccess::FixPath(file_access->m_accessType, p_path), p_mode_flags); !res) {
         return HBN_ERROR(res.error());
     }
 
+    if (p_pattern == PATTERN_STREAM && (p_mode_flags & READ_WRITE) != READ_WRITE) {
+        return std::shared_ptr<FileAccess>(std::make_shared<FileAccessBuffered>(file_access));
+    }
+
     return file_access;
 }
 
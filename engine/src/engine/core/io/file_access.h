@@ -30,6 +30,16 @@ public:
         READ_WRITE = READ | WRITE,
     };
 
+    // how a file is going to be used, Open() picks the backend for it
+    enum AccessPattern : uint8_t {
+        // the backend registered with MakeDefault()
+        PATTERN_DEFAULT,
+        // lots of small reads or writes, such as an Archive, goes through FileAccessBuffered
+        PATTERN_STREAM,
+        // read in one go or jumped around in, the file is mapped with FileAccessMapped
+        PATTERN_WHOLE_FILE,
+    };
+
     virtual ~FileAccess() = default;
 
     virtual void Close() = 0;
@@ -76,13 +86,16 @@ public:
     static auto Create(AccessType p_access_type) -> std::shared_ptr<FileAccess>;
     static auto CreateForPath(std::string_view p_path) -> std::shared_ptr<FileAccess>;
 
-    static auto Open(std::string_view p_path, ModeFlags p_mode_flags) -> Result<std::shared_ptr<FileAccess>>;
+    static auto Open(std::string_view p_path,
+                     ModeFlags p_mode_flags,
+                     AccessPattern p_pattern = PATTERN_DEFAULT) -> Result<std::shared_ptr<FileAccess>>;
 
     template<typename T>
     static void MakeDefault(AccessType p_access_type) {
         s_createFuncs[p_access_type] = CreateBuiltin<T>;
     }
 
+    static AccessType GetAccessTypeForPath(std::string_view p_path);
     static std::string FixPath(AccessType p_access_type, std::string_view p_path);
 
 protected:
@@ -0,0 +1,125 @@
+#include "file_access_buffered.h"
+
+namespace my {
+
+FileAccessBuffered::FileAccessBuffered(std::shared_ptr<FileAccess> p_file, size_t p_buffer_size)
+    : m_file(std::move(p_file)) {
+    DEV_ASSERT(m_file && p_buffer_size);
+    SetAccessType(m_file->GetAccessType());
+    m_openMode = m_file->GetOpenMode();
+    // a file is either read or written through the buffer, not both
+    DEV_ASSERT((m_openMode & READ_WRITE) != READ_WRITE);
+    m_buffer.resize(p_buffer_size);
+}
+
+FileAccessBuffered::~FileAccessBuffered() {
+    Close();
+}
+
+auto FileAccessBuffered::OpenInternal(std::string_view p_path, ModeFlags) -> Result<void> {
+    return HBN_ERROR(ErrorCode::ERR_INVALID_PARAMETER, "buffered file '{}' wraps a file that is already open", p_path);
+}
+
+bool FileAccessBuffered::Flush() {
+    if (!(m_openMode & WRITE) || m_bufferSize == 0) {
+        return true;
+    }
+
+    const size_t size = m_bufferSize;
+    m_bufferSize = 0;
+    return m_file->WriteBuffer(m_buffer.data(), size) == size;
+}
+
+void FileAccessBuffered::Close() {
+    if (!m_file) {
+        return;
+    }
+
+    if (!Flush()) {
+        LOG_ERROR("failed to flush buffered file");
+    }
+    m_file->Close();
+    m_file.reset();
+}
+
+bool FileAccessBuffered::IsOpen() const {
+    return m_file && m_file->IsOpen();
+}
+
+size_t FileAccessBuffered::GetLength() const {
+    ERR_FAIL_COND_V(!IsOpen(), 0);
+    if (m_openMode & WRITE) {
+        return m_file->GetLength() + m_bufferSize;
+    }
+    return m_file->GetLength();
+}
+
+size_t FileAccessBuffered::ReadBuffer(void* p_data, size_t p_size) const {
+    DEV_ASSERT(m_openMode & READ);
+    ERR_FAIL_COND_V(!IsOpen(), 0);
+
+    uint8_t* dest = static_cast<uint8_t*>(p_data);
+    size_t read = 0;
+    while (read < p_size) {
+        if (m_readOffset == m_bufferSize) {
+            // too big to be worth copying, read it through
+            if (p_size - read >= m_buffer.size()) {
+                return read + m_file->ReadBuffer(dest + read, p_size - read);
+            }
+
+            m_bufferSize = m_file->ReadBuffer(m_buffer.data(), m_buffer.size());
+            m_readOffset = 0;
+            if (m_bufferSize == 0) {
+                break;
+            }
+        }
+
+        const size_t size = std::min(p_size - read, m_bufferSize - m_readOffset);
+        memcpy(dest + read, m_buffer.data() + m_readOffset, size);
+        m_readOffset += size;
+        read += size;
+    }
+    return read;
+}
+
+size_t FileAccessBuffered::WriteBuffer(const void* p_data, size_t p_size) {
+    DEV_ASSERT(m_openMode & WRITE);
+    ERR_FAIL_COND_V(!IsOpen(), 0);
+
+    if (m_bufferSize + p_size > m_buffer.size()) {
+        if (!Flush()) {
+            return 0;
+        }
+        // too big to be worth copying, write it through
+        if (p_size >= m_buffer.size()) {
+            return m_file->WriteBuffer(p_data, p_size);
+        }
+    }
+
+    memcpy(m_buffer.data() + m_bufferSize, p_data, p_size);
+    m_bufferSize += p_size;
+    return p_size;
+}
+
+long FileAccessBuffered::Tell() {
+    ERR_FAIL_COND_V(!IsOpen(), -1);
+    if (m_openMode & WRITE) {
+        return m_file->Tell() + static_cast<long>(m_bufferSize);
+    }
+    return m_file->Tell() - static_cast<long>(m_bufferSize - m_readOffset);
+}
+
+int FileAccessBuffered::Seek(long p_offset) {
+    ERR_FAIL_COND_V(!IsOpen(), -1);
+    if (m_openMode & WRITE) {
+        if (!Flush()) {
+            return -1;
+        }
+    } else {
+        m_bufferSize = 0;
+        m_readOffset = 0;
+    }
+    return m_file->Seek(p_offset);
+}
+
+}  // namespace my
@@ -0,0 +1,38 @@
+#pragma once
+#include "file_access.h"
+
+namespace my {
+
+// Wraps an open file with a user space buffer, so small reads and writes such as the fields of a
+// component don't each go through the file. Reads fill the buffer a block at a time, writes are
+// collected and flushed when the buffer is full, before a seek and when the file is closed.
+class FileAccessBuffered : public FileAccess {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+
+    explicit FileAccessBuffered(std::shared_ptr<FileAccess> p_file, size_t p_buffer_size = DEFAULT_BUFFER_SIZE);
+    ~FileAccessBuffered();
+
+    // writes out what is buffered, nothing to do for a file that is read
+    bool Flush();
+
+    void Close() override;
+    bool IsOpen() const override;
+    size_t GetLength() const override;
+    size_t ReadBuffer(void* p_data, size_t p_size) const override;
+    size_t WriteBuffer(const void* p_data, size_t p_size) override;
+    long Tell() override;
+    int Seek(long p_offset) override;
+
+protected:
+    auto OpenInternal(std::string_view p_path, ModeFlags p_mode_flags) -> Result<void> override;
+
+    std::shared_ptr<FileAccess> m_file;
+    mutable std::vector<uint8_t> m_buffer;
+    // bytes waiting to be written, or bytes read ahead
+    mutable size_t m_bufferSize{ 0 };
+    // next byte to read from the buffer
+    mutable size_t m_readOffset{ 0 };
+};
+
+}  // namespace my
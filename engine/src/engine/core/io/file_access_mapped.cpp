@@ -0,0 +1,203 @@
+#include "file_access_mapped.h"
+
+#if USING(PLATFORM_WINDOWS)
+#include "engine/drivers/windows/win32_prerequisites.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace my {
+
+struct FileAccessMapped::Mapping {
+    const uint8_t* data{ nullptr };
+    size_t size{ 0 };
+#if USING(PLATFORM_WINDOWS)
+    HANDLE file{ INVALID_HANDLE_VALUE };
+    HANDLE mapping{ nullptr };
+#endif
+
+    ~Mapping() {
+#if USING(PLATFORM_WINDOWS)
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+#else
+        if (data) {
+            munmap(const_cast<uint8_t*>(data), size);
+        }
+#endif
+    }
+};
+
+FileAccessMapped::~FileAccessMapped() {
+    Close();
+}
+
+auto FileAccessMapped::Map(std::string_view p_path) -> Result<std::shared_ptr<FileAccessMapped>> {
+    auto file = std::make_shared<FileAccessMapped>();
+    file->SetAccessType(GetAccessTypeForPath(p_path));
+    if (auto res = file->OpenInternal(FixPath(file->GetAccessType(), p_path), READ); !res) {
+        return HBN_ERROR(res.error());
+    }
+
+    return file;
+}
+
+auto FileAccessMapped::OpenInternal(std::string_view p_path, ModeFlags p_mode_flags) -> Result<void> {
+    DEV_ASSERT(!m_mapping);
+
+    if (p_mode_flags != READ) {
+        return HBN_ERROR(ErrorCode::ERR_INVALID_PARAMETER, "mapped file '{}' can only be read", p_path);
+    }
+
+    const std::string path{ p_path };
+    auto mapping = std::make_shared<Mapping>();
+
+#if USING(PLATFORM_WINDOWS)
+    mapping->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (mapping->file == INVALID_HANDLE_VALUE) {
+        if (GetLastError() == ERROR_FILE_NOT_FOUND || GetLastError() == ERROR_PATH_NOT_FOUND) {
+            return HBN_ERROR(ErrorCode::ERR_FILE_NOT_FOUND, "file '{}' not found", p_path);
+        }
+        return HBN_ERROR(ErrorCode::ERR_FILE_CANT_OPEN, "failed to open '{}'", p_path);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mapping->file, &size)) {
+        return HBN_ERROR(ErrorCode::ERR_FILE_CANT_READ, "failed to get the size of '{}'", p_path);
+    }
+    mapping->size = static_cast<size_t>(size.QuadPart);
+
+    // an empty file can't be mapped, it is just an empty view
+    if (mapping->size) {
+        mapping->mapping = CreateFileMappingA(mapping->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping->mapping) {
+            return HBN_ERROR(ErrorCode::ERR_FILE_CANT_OPEN, "failed to map '{}'", p_path);
+        }
+        mapping->data = static_cast<const uint8_t*>(MapViewOfFile(mapping->mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!mapping->data) {
+            return HBN_ERROR(ErrorCode::ERR_FILE_CANT_OPEN, "failed to map '{}'", p_path);
+        }
+    }
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return HBN_ERROR(ErrorCode::ERR_FILE_NOT_FOUND, "file '{}' not found", p_path);
+        }
+        return HBN_ERROR(ErrorCode::ERR_FILE_CANT_OPEN, "failed to open '{}'", p_path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return HBN_ERROR(ErrorCode::ERR_FILE_CANT_READ, "failed to get the size of '{}'", p_path);
+    }
+    mapping->size = static_cast<size_t>(info.st_size);
+
+    // an empty file can't be mapped, it is just an empty view
+    if (mapping->size) {
+        void* data = mmap(nullptr, mapping->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return HBN_ERROR(ErrorCode::ERR_FILE_CANT_OPEN, "failed to map '{}'", p_path);
+        }
+        mapping->data = static_cast<const uint8_t*>(data);
+    }
+    // the mapping keeps the file alive
+    close(fd);
+#endif
+
+    m_mapping = std::move(mapping);
+    m_begin = m_mapping->data;
+    m_size = m_mapping->size;
+    m_cursor = 0;
+    m_openMode = p_mode_flags;
+    return Result<void>();
+}
+
+auto FileAccessMapped::CreateView(size_t p_offset, size_t p_size) const -> std::shared_ptr<FileAccessMapped> {
+    DEV_ASSERT(m_mapping);
+    DEV_ASSERT(p_offset <= m_size && p_size <= m_size - p_offset);
+
+    auto view = std::make_shared<FileAccessMapped>();
+    view->SetAccessType(m_accessType);
+    view->m_openMode = m_openMode;
+    view->m_mapping = m_mapping;
+    view->m_begin = m_begin + p_offset;
+    view->m_size = p_size;
+    return view;
+}
+
+void FileAccessMapped::Prefetch() const {
+    if (!m_size) {
+        return;
+    }
+
+#if USING(PLATFORM_WINDOWS)
+    WIN32_MEMORY_RANGE_ENTRY range{ const_cast<uint8_t*>(m_begin), m_size };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // madvise() wants a page aligned address
+    const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(m_begin) & ~(page_size - 1);
+    const uintptr_t end = reinterpret_cast<uintptr_t>(m_begin) + m_size;
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+#endif
+}
+
+void FileAccessMapped::Close() {
+    m_mapping.reset();
+    m_begin = nullptr;
+    m_size = 0;
+    m_cursor = 0;
+}
+
+bool FileAccessMapped::IsOpen() const {
+    return m_mapping != nullptr;
+}
+
+size_t FileAccessMapped::ReadBuffer(void* p_data, size_t p_size) const {
+    ERR_FAIL_COND_V(!IsOpen(), 0);
+
+    const size_t size = std::min(p_size, m_size - m_cursor);
+    if (size) {
+        memcpy(p_data, m_begin + m_cursor, size);
+        m_cursor += size;
+    }
+    return size;
+}
+
+size_t FileAccessMapped::WriteBuffer(const void* p_data, size_t p_size) {
+    unused(p_data);
+    unused(p_size);
+    DEV_ASSERT(0 && "mapped files are read only");
+    return 0;
+}
+
+long FileAccessMapped::Tell() {
+    ERR_FAIL_COND_V(!IsOpen(), -1);
+    return static_cast<long>(m_cursor);
+}
+
+int FileAccessMapped::Seek(long p_offset) {
+    ERR_FAIL_COND_V(!IsOpen(), -1);
+    if (p_offset < 0 || static_cast<size_t>(p_offset) > m_size) {
+        LOG_ERROR("seek failed");
+        return -1;
+    }
+
+    m_cursor = static_cast<size_t>(p_offset);
+    return 0;
+}
+
+}  // namespace my
@@ -0,0 +1,44 @@
+#pragma once
+#include "file_access.h"
+
+namespace my {
+
+// Read only view of a memory mapped file. Reads are copies out of the mapping, the pages are
+// brought in by the OS the first time they are touched, so nothing is read up front.
+// Views share the mapping, each view has its own cursor and can be read from its own thread.
+class FileAccessMapped : public FileAccess {
+public:
+    ~FileAccessMapped();
+
+    // maps the whole file, p_path is resolved like FileAccess::Open()
+    static auto Map(std::string_view p_path) -> Result<std::shared_ptr<FileAccessMapped>>;
+
+    // view of [p_offset, p_offset + p_size) of this view
+    auto CreateView(size_t p_offset, size_t p_size) const -> std::shared_ptr<FileAccessMapped>;
+
+    std::span<const uint8_t> GetData() const { return { m_begin, m_size }; }
+
+    // asks the OS to start reading the pages of this view in, so a view that is about to be read
+    // doesn't fault them in one at a time
+    void Prefetch() const;
+
+    void Close() override;
+    bool IsOpen() const override;
+    size_t GetLength() const override { return m_size; }
+    size_t ReadBuffer(void* p_data, size_t p_size) const override;
+    size_t WriteBuffer(const void* p_data, size_t p_size) override;
+    long Tell() override;
+    int Seek(long p_offset) override;
+
+protected:
+    auto OpenInternal(std::string_view p_path, ModeFlags p_mode_flags) -> Result<void> override;
+
+    struct Mapping;
+
+    std::shared_ptr<Mapping> m_mapping;
+    const uint8_t* m_begin{ nullptr };
+    size_t m_size{ 0 };
+    mutable size_t m_cursor{ 0 };
+};
+
+}  // namespace my
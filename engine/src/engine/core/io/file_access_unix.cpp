@@ -62,6 +62,7 @@ void FileAccessUnix::Close() {
         fclose(m_fileHandle);
         m_fileHandle = nullptr;
     }
+    m_length.reset();
 }
 
 bool FileAccessUnix::IsOpen() const {
@@ -69,9 +70,20 @@ bool FileAccessUnix::IsOpen() const {
 }
 
 size_t FileAccessUnix::GetLength() const {
+    ERR_FAIL_COND_V(!IsOpen(), 0);
+
+    if (m_length) {
+        return *m_length;
+    }
+
+    const long offset = ftell(m_fileHandle);
     fseek(m_fileHandle, 0, SEEK_END);
     const size_t length = ftell(m_fileHandle);
-    fseek(m_fileHandle, 0, SEEK_SET);
+    fseek(m_fileHandle, offset, SEEK_SET);
+
+    if (!(m_openMode & WRITE)) {
+        m_length = length;
+    }
     return length;
 }
 
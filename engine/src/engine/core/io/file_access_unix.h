@@ -19,6 +19,8 @@ protected:
     auto OpenInternal(std::string_view p_path, ModeFlags p_mode_flags) -> Result<void> override;
 
     FILE* m_fileHandle{ nullptr };
+    // a file that is only read can't change size, the length is looked up once
+    mutable std::optional<size_t> m_length;
 };
 
 }  // namespace my
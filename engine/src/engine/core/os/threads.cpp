@@ -19,13 +19,17 @@ struct ThreadObject {
     std::thread threadObject{};
 };
 
-static thread_local uint32_t g_threadId;
+// static initialization runs on the main thread, threads not started by Initialize() get THREAD_MAX
+static const std::thread::id s_mainThreadId = std::this_thread::get_id();
+static thread_local uint32_t g_threadId = std::this_thread::get_id() == s_mainThreadId ? THREAD_MAIN : THREAD_MAX;
 static struct {
     std::atomic_bool shutdownRequested;
     std::array<ThreadObject, THREAD_MAX> threads = {
         ThreadObject{ "THREAD_MAIN", []() {} },
         ThreadObject{ "THREAD_ASSET_LOADER_1", AssetManager::WorkerMain },
-    // ThreadObject{ "THREAD_ASSET_LOADER_2", AssetManager::WorkerMain },
+        ThreadObject{ "THREAD_ASSET_LOADER_2", AssetManager::WorkerMain },
+        ThreadObject{ "THREAD_ASSET_LOADER_3", AssetManager::WorkerMain },
+        ThreadObject{ "THREAD_ASSET_LOADER_4", AssetManager::WorkerMain },
 #if USING(ENABLE_JOB_SYSTEM)
         ThreadObject{ "THREAD_JOBSYSTEM_WORKER_1", jobsystem::WorkerMain },
         ThreadObject{ "THREAD_JOBSYSTEM_WORKER_2", jobsystem::WorkerMain },
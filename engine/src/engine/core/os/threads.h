@@ -6,7 +6,9 @@ namespace my::thread {
 enum ThreadID : uint32_t {
     THREAD_MAIN,
     THREAD_ASSET_LOADER_1,
-// THREAD_ASSET_LOADER_2,
+    THREAD_ASSET_LOADER_2,
+    THREAD_ASSET_LOADER_3,
+    THREAD_ASSET_LOADER_4,
 #if USING(ENABLE_JOB_SYSTEM)
     THREAD_JOBSYSTEM_WORKER_1,
     THREAD_JOBSYSTEM_WORKER_2,
@@ -39,6 +39,7 @@ public:
     void UnbindStructuredBufferSRV(int p_slot) override {}
 
     void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) override {}
+    void UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, uint32_t p_size, uint32_t p_offset) override {}
     void BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) override {}
 
     void BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) override {}
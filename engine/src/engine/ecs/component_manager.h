@@ -1,5 +1,5 @@
 #pragma once
-#include "entity.h"
+#include "entity_index.h"
 
 namespace YAML {
 class Node;
@@ -17,11 +17,16 @@ concept Serializable = requires(T& t, Archive& p_archive, uint32_t p_version) {
     { T::RegisterClass() } -> std::same_as<void>;
 };
 
+// Opt in for components whose Serialize() writes every member in declaration order with no padding, the
+// component array is then written and read as one block and the bytes are the same as going through Serialize()
+template<typename T>
+concept BulkSerializable = Serializable<T> && std::is_trivially_copyable_v<T> && T::BULK_SERIALIZABLE;
+
 }  // namespace my
 
 namespace my::ecs {
 
-template<Serializable T>
+template<Serializable... Ts>
 class View;
 
 // @TODO: remove this iterator, use view iterator instead
@@ -158,13 +163,24 @@ public:
 
     bool Serialize(Archive& p_archive, uint32_t p_version) override;
 
+    // returns EntityIndex::INVALID_INDEX if the entity doesn't have the component
+    uint32_t FindIndex(const Entity& p_entity) const;
+
+    // changes whenever a component is added or removed, or indices are shuffled
+    uint32_t GetVersion() const { return m_version; }
+
 private:
+    void RebuildIndex();
+
+    // dense arrays, removal swaps the last element in
     std::vector<T> m_componentArray;
     std::vector<Entity> m_entityArray;
-    std::unordered_map<Entity, size_t> m_lookup;
+    EntityIndex m_lookup;
+    uint32_t m_version{ 0 };
 
     friend class ::my::Scene;
-    friend class View<T>;
+    template<Serializable... Ts>
+    friend class View;
 };
 
 class ComponentLibrary {
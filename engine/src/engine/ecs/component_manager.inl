@@ -10,7 +10,6 @@ void ComponentManager<T>::Reserve(size_t p_capacity) {
     if (p_capacity) {
         m_componentArray.reserve(p_capacity);
         m_entityArray.reserve(p_capacity);
-        m_lookup.reserve(p_capacity);
     }
 }
 
@@ -18,7 +17,8 @@ template<Serializable T>
 void ComponentManager<T>::Clear() {
     m_componentArray.clear();
     m_entityArray.clear();
-    m_lookup.clear();
+    m_lookup.Clear();
+    ++m_version;
 }
 
 template<Serializable T>
@@ -26,7 +26,7 @@ void ComponentManager<T>::Copy(const ComponentManager<T>& p_other) {
     Clear();
     m_componentArray = p_other.m_componentArray;
     m_entityArray = p_other.m_entityArray;
-    m_lookup = p_other.m_lookup;
+    RebuildIndex();
 }
 
 template<Serializable T>
@@ -39,16 +39,16 @@ void ComponentManager<T>::Merge(ComponentManager<T>& p_other) {
     const size_t reserved = GetCount() + p_other.GetCount();
     m_componentArray.reserve(reserved);
     m_entityArray.reserve(reserved);
-    m_lookup.reserve(reserved);
 
     for (size_t i = 0; i < p_other.GetCount(); ++i) {
         Entity entity = p_other.m_entityArray[i];
         DEV_ASSERT(!Contains(entity));
         m_entityArray.push_back(entity);
-        m_lookup[entity] = m_componentArray.size();
+        m_lookup.Set(entity, static_cast<uint32_t>(m_componentArray.size()));
         m_componentArray.push_back(std::move(p_other.m_componentArray[i]));
     }
 
+    ++m_version;
     p_other.Clear();
 }
 
@@ -57,32 +57,47 @@ void ComponentManager<T>::Merge(IComponentManager& p_other) {
     Merge((ComponentManager<T>&)p_other);
 }
 
+template<Serializable T>
+uint32_t ComponentManager<T>::FindIndex(const Entity& p_entity) const {
+    const uint32_t index = m_lookup.Find(p_entity);
+    if (index < m_entityArray.size() && m_entityArray[index] == p_entity) {
+        return index;
+    }
+    return EntityIndex::INVALID_INDEX;
+}
+
+template<Serializable T>
+void ComponentManager<T>::RebuildIndex() {
+    m_lookup.Clear();
+    for (size_t i = 0; i < m_entityArray.size(); ++i) {
+        m_lookup.Set(m_entityArray[i], static_cast<uint32_t>(i));
+    }
+}
+
 template<Serializable T>
 void ComponentManager<T>::Remove(const Entity& p_entity) {
-    auto it = m_lookup.find(p_entity);
-    if (it == m_lookup.end()) {
+    const uint32_t index = FindIndex(p_entity);
+    if (index == EntityIndex::INVALID_INDEX) {
         return;
     }
 
-    size_t index = it->second;
-    DEV_ASSERT_INDEX(index, m_entityArray.size());
-    m_lookup.erase(it);
-    m_entityArray.erase(m_entityArray.begin() + index);
-    m_componentArray.erase(m_componentArray.begin() + index);
-    for (auto& iter : m_lookup) {
-        DEV_ASSERT(iter.second != index);
-        if (iter.second > index) {
-            --iter.second;
-        }
+    // swap and pop, the order of components is not preserved
+    const size_t last = m_entityArray.size() - 1;
+    if (index != last) {
+        m_componentArray[index] = std::move(m_componentArray[last]);
+        m_entityArray[index] = m_entityArray[last];
+        m_lookup.Set(m_entityArray[index], index);
     }
+
+    m_componentArray.pop_back();
+    m_entityArray.pop_back();
+    m_lookup.Erase(p_entity);
+    ++m_version;
 }
 
 template<Serializable T>
 bool ComponentManager<T>::Contains(const Entity& p_entity) const {
-    if (m_lookup.empty()) {
-        return false;
-    }
-    return m_lookup.find(p_entity) != m_lookup.end();
+    return FindIndex(p_entity) != EntityIndex::INVALID_INDEX;
 }
 
 template<Serializable T>
@@ -99,17 +114,12 @@ const T& ComponentManager<T>::GetComponentByIndex(size_t p_index) const {
 
 template<Serializable T>
 T* ComponentManager<T>::GetComponent(const Entity& p_entity) {
-    if (!p_entity.IsValid() || m_lookup.empty()) {
+    const uint32_t index = FindIndex(p_entity);
+    if (index == EntityIndex::INVALID_INDEX) {
         return nullptr;
     }
 
-    auto it = m_lookup.find(p_entity);
-
-    if (it == m_lookup.end()) {
-        return nullptr;
-    }
-
-    return &m_componentArray[it->second];
+    return &m_componentArray[index];
 }
 
 template<Serializable T>
@@ -123,18 +133,21 @@ T& ComponentManager<T>::Create(const Entity& p_entity) {
     DEV_ASSERT(p_entity.IsValid());
 
     const size_t componentCount = m_componentArray.size();
-    DEV_ASSERT(m_lookup.find(p_entity) == m_lookup.end());
+    DEV_ASSERT(!Contains(p_entity));
     DEV_ASSERT(m_entityArray.size() == componentCount);
-    DEV_ASSERT(m_lookup.size() == componentCount);
 
-    m_lookup[p_entity] = componentCount;
+    m_lookup.Set(p_entity, static_cast<uint32_t>(componentCount));
     m_componentArray.emplace_back();
     m_entityArray.push_back(p_entity);
+    ++m_version;
     return m_componentArray.back();
 }
 
 template<Serializable T>
 bool ComponentManager<T>::Serialize(Archive& p_archive, uint32_t p_version) {
+    // entities are written as one block, same bytes as one at a time
+    static_assert(std::is_trivially_copyable_v<Entity> && sizeof(Entity) == sizeof(uint32_t));
+
     constexpr uint64_t magic = 7165065861825654388llu;
     size_t count;
     if (p_archive.IsWriteMode()) {
@@ -144,12 +157,14 @@ bool ComponentManager<T>::Serialize(Archive& p_archive, uint32_t p_version) {
         }
         p_archive << magic;
         p_archive << count;
-        for (auto& component : m_componentArray) {
-            component.Serialize(p_archive, p_version);
-        }
-        for (auto& entity : m_entityArray) {
-            p_archive << entity;
+        if constexpr (BulkSerializable<T>) {
+            p_archive.Write(m_componentArray.data(), sizeof(T) * count);
+        } else {
+            for (auto& component : m_componentArray) {
+                component.Serialize(p_archive, p_version);
+            }
         }
+        p_archive.Write(m_entityArray.data(), sizeof(Entity) * count);
     } else {
         uint64_t read_magic;
         p_archive >> read_magic;
@@ -161,14 +176,23 @@ bool ComponentManager<T>::Serialize(Archive& p_archive, uint32_t p_version) {
         p_archive >> count;
         m_componentArray.resize(count);
         m_entityArray.resize(count);
-        for (size_t i = 0; i < count; ++i) {
-            m_componentArray[i].Serialize(p_archive, p_version);
-            m_componentArray[i].OnDeserialized();
+        if constexpr (BulkSerializable<T>) {
+            if (!p_archive.Read(m_componentArray.data(), sizeof(T) * count)) {
+                return false;
+            }
+            for (auto& component : m_componentArray) {
+                component.OnDeserialized();
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                m_componentArray[i].Serialize(p_archive, p_version);
+                m_componentArray[i].OnDeserialized();
+            }
         }
-        for (size_t i = 0; i < count; ++i) {
-            p_archive >> m_entityArray[i];
-            m_lookup[m_entityArray[i]] = i;
+        if (!p_archive.Read(m_entityArray.data(), sizeof(Entity) * count)) {
+            return false;
         }
+        RebuildIndex();
     }
 
     return true;
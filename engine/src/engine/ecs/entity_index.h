@@ -0,0 +1,53 @@
+#pragma once
+#include "entity.h"
+
+namespace my::ecs {
+
+// Sparse side of a sparse set, maps an entity id to a dense index with a direct array access.
+// Pages are allocated on demand, so a few large ids don't allocate the whole range.
+// A slot may be stale, the owner validates it against its dense entity array,
+// entity ids are never reused, so the id itself acts as the generation.
+class EntityIndex {
+public:
+    static constexpr uint32_t PAGE_BITS = 10;
+    static constexpr uint32_t PAGE_SIZE = 1 << PAGE_BITS;
+    static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+    static constexpr uint32_t INVALID_INDEX = ~0u;
+
+    uint32_t Find(const Entity& p_entity) const {
+        const uint32_t id = p_entity.GetId();
+        const uint32_t page = id >> PAGE_BITS;
+        if (page >= m_pages.size() || !m_pages[page]) {
+            return INVALID_INDEX;
+        }
+        return m_pages[page][id & PAGE_MASK];
+    }
+
+    void Set(const Entity& p_entity, uint32_t p_index) {
+        const uint32_t id = p_entity.GetId();
+        const uint32_t page = id >> PAGE_BITS;
+        if (page >= m_pages.size()) {
+            m_pages.resize(page + 1);
+        }
+        if (!m_pages[page]) {
+            m_pages[page] = std::make_unique<uint32_t[]>(PAGE_SIZE);
+            std::fill_n(m_pages[page].get(), PAGE_SIZE, INVALID_INDEX);
+        }
+        m_pages[page][id & PAGE_MASK] = p_index;
+    }
+
+    void Erase(const Entity& p_entity) {
+        const uint32_t id = p_entity.GetId();
+        const uint32_t page = id >> PAGE_BITS;
+        if (page < m_pages.size() && m_pages[page]) {
+            m_pages[page][id & PAGE_MASK] = INVALID_INDEX;
+        }
+    }
+
+    void Clear() { m_pages.clear(); }
+
+private:
+    std::vector<std::unique_ptr<uint32_t[]>> m_pages;
+};
+
+}  // namespace my::ecs
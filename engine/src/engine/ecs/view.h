@@ -1,105 +1,169 @@
 #pragma once
 #include "component_manager.h"
+#include "engine/systems/job_system/job_system.h"
 
 namespace my::ecs {
 
-// @TODO: combine View with reserved allocator and recycling
-// so when removing a component, we don't need to remove it from the array,
-// but we can invalidate it, and when creating View, View can skip it
-
-template<Serializable T>
+// View over the entities that have all the components Ts...
+// It doesn't copy anything, iteration walks the entity array of the smallest pool
+// and probes the other pools through their entity index.
+// Components must not be created or removed while a view is being iterated.
+template<Serializable... Ts>
 class View {
-    using ViewContainer = std::vector<std::pair<Entity, int>>;
+    static_assert(sizeof...(Ts) > 0);
+
+    using Managers = std::tuple<const ComponentManager<Ts>*...>;
+
+    static constexpr bool SINGLE = sizeof...(Ts) == 1;
 
 public:
-    template<typename U>
-        requires std::is_same_v<T, std::remove_const_t<U>>
+    template<bool IS_CONST>
     class Iterator;
 
-    using iter = Iterator<T>;
-    using const_iter = Iterator<const T>;
+    using iter = Iterator<false>;
+    using const_iter = Iterator<true>;
 
 #pragma region ITERATOR
-    template<typename U>
-        requires std::is_same_v<T, std::remove_const_t<U>>
+    template<bool IS_CONST>
     class Iterator {
-        using Self = Iterator<U>;
+        using Self = Iterator<IS_CONST>;
+
+        template<typename T>
+        using Ref = std::conditional_t<IS_CONST, const T&, T&>;
 
     public:
-        Iterator(const ViewContainer& p_container,
-                 const ComponentManager<T>& p_manager,
-                 uint32_t p_index)
-            : m_container(p_container), m_manager(p_manager), m_index(p_index) {}
+        using value_type = std::tuple<Entity, Ref<Ts>...>;
 
-        Self operator++(int) {
-            Self tmp = *this;
-            ++m_index;
-            return tmp;
+        Iterator(const Managers& p_managers,
+                 const std::vector<Entity>& p_entities,
+                 size_t p_index)
+            : m_managers(p_managers), m_entities(&p_entities), m_index(p_index) {
+            SkipMissing();
         }
 
-        Self operator--(int) {
+        Self operator++(int) {
             Self tmp = *this;
-            --m_index;
+            ++(*this);
             return tmp;
         }
 
         Self& operator++() {
             ++m_index;
-            return *this;
-        }
-
-        Self& operator--() {
-            --m_index;
+            SkipMissing();
             return *this;
         }
 
         bool operator==(const Self& p_rhs) const { return m_index == p_rhs.m_index; }
         bool operator!=(const Self& p_rhs) const { return m_index != p_rhs.m_index; }
 
-        auto operator*() -> std::pair<Entity, U&> {
-            Entity entity = m_container[m_index].first;
-            int index = m_container[m_index].second;
-            U& component = ((ComponentManager<T>&)m_manager).GetComponentByIndex(index);
-            return std::pair<Entity, U&>(entity, component);
-        }
-
-        auto operator*() const -> std::pair<Entity, U&> {
-            Entity entity = m_container[m_index].first;
-            int index = m_container[m_index].second;
-            U& component = m_manager.GetComponentByIndex(index);
-            return std::pair<Entity, U&>(entity, component);
+        value_type operator*() const {
+            const Entity entity = (*m_entities)[m_index];
+            return value_type(entity, View::Get<IS_CONST, Ts>(m_managers, entity, m_index)...);
         }
 
     private:
-        const ViewContainer& m_container;
-        const ComponentManager<T>& m_manager;
+        void SkipMissing() {
+            if constexpr (!SINGLE) {
+                const size_t size = m_entities->size();
+                while (m_index < size && !View::HasAll(m_managers, (*m_entities)[m_index])) {
+                    ++m_index;
+                }
+            }
+        }
 
-        uint32_t m_index{ 0 };
+        Managers m_managers;
+        const std::vector<Entity>* m_entities;
+        size_t m_index{ 0 };
     };
 #pragma endregion ITERATOR
 
-    View(const ComponentManager<T>& p_manager)
-        : m_manager(p_manager), m_size(static_cast<uint32_t>(p_manager.GetCount())) {
-        const int size = (int)p_manager.GetCount();
-        for (int i = 0; i < size; ++i) {
-            m_container.emplace_back(std::make_pair(m_manager.m_entityArray[i], i));
+    View(const ComponentManager<Ts>&... p_managers)
+        : m_managers(&p_managers...) {
+        // drive the iteration with the smallest pool
+        const std::vector<Entity>* entity_arrays[] = { &p_managers.m_entityArray... };
+        m_entities = entity_arrays[0];
+        for (const auto* entities : entity_arrays) {
+            if (entities->size() < m_entities->size()) {
+                m_entities = entities;
+            }
         }
     }
 
-    View(const View<T>&) = default;
+    View(const View&) = default;
 
-    iter begin() { return iter(m_container, m_manager, 0); }
-    iter end() { return iter(m_container, m_manager, m_size); }
+    iter begin() { return iter(m_managers, *m_entities, 0); }
+    iter end() { return iter(m_managers, *m_entities, m_entities->size()); }
 
-    const_iter begin() const { return const_iter(m_container, m_manager, 0); }
-    const_iter end() const { return const_iter(m_container, m_manager, m_size); }
+    const_iter begin() const { return const_iter(m_managers, *m_entities, 0); }
+    const_iter end() const { return const_iter(m_managers, *m_entities, m_entities->size()); }
 
-    uint32_t GetSize() const { return m_size; }
+    // exact for a single component view, an upper bound otherwise
+    uint32_t GetSize() const { return static_cast<uint32_t>(m_entities->size()); }
+
+    // calls p_func(entity, components...) for the matches in [p_begin, p_end) of the driving pool
+    template<typename Func>
+    void ForEach(uint32_t p_begin, uint32_t p_end, const Func& p_func) { ForEachImpl<false>(p_begin, p_end, p_func); }
+
+    template<typename Func>
+    void ForEach(uint32_t p_begin, uint32_t p_end, const Func& p_func) const { ForEachImpl<true>(p_begin, p_end, p_func); }
+
+    // splits the driving pool into chunks of p_chunk_size and runs them as jobs,
+    // p_func is copied into the job, the view must stay alive until p_context.Wait() returns
+    template<typename Func>
+    void ParallelForEach(jobsystem::Context& p_context, uint32_t p_chunk_size, const Func& p_func) { ParallelForEachImpl<false>(p_context, p_chunk_size, p_func); }
+
+    template<typename Func>
+    void ParallelForEach(jobsystem::Context& p_context, uint32_t p_chunk_size, const Func& p_func) const { ParallelForEachImpl<true>(p_context, p_chunk_size, p_func); }
 
 private:
-    ViewContainer m_container;
-    const ComponentManager<T>& m_manager;
-    uint32_t m_size;
+    static bool HasAll(const Managers& p_managers, const Entity& p_entity) {
+        return ((std::get<const ComponentManager<Ts>*>(p_managers)->FindIndex(p_entity) != EntityIndex::INVALID_INDEX) && ...);
+    }
+
+    // p_index is the index of p_entity in the driving pool
+    template<bool IS_CONST, typename T>
+    static auto Get(const Managers& p_managers, const Entity& p_entity, size_t p_index) -> std::conditional_t<IS_CONST, const T&, T&> {
+        auto manager = const_cast<ComponentManager<T>*>(std::get<const ComponentManager<T>*>(p_managers));
+        if constexpr (SINGLE) {
+            unused(p_entity);
+            return manager->m_componentArray[p_index];
+        } else {
+            return manager->m_componentArray[manager->FindIndex(p_entity)];
+        }
+    }
+
+    template<bool IS_CONST, typename Func>
+    void ForEachImpl(uint32_t p_begin, uint32_t p_end, const Func& p_func) const {
+        DEV_ASSERT(p_end <= GetSize());
+        for (uint32_t i = p_begin; i < p_end; ++i) {
+            const Entity entity = (*m_entities)[i];
+            if constexpr (!SINGLE) {
+                if (!HasAll(m_managers, entity)) {
+                    continue;
+                }
+            }
+            p_func(entity, Get<IS_CONST, Ts>(m_managers, entity, i)...);
+        }
+    }
+
+    template<bool IS_CONST, typename Func>
+    void ParallelForEachImpl(jobsystem::Context& p_context, uint32_t p_chunk_size, const Func& p_func) const {
+        DEV_ASSERT(p_chunk_size > 0);
+        const uint32_t size = GetSize();
+#if USING(ENABLE_JOB_SYSTEM)
+        const uint32_t chunk_count = (size + p_chunk_size - 1) / p_chunk_size;
+        p_context.Dispatch(chunk_count, 1, [this, p_func, p_chunk_size, size](jobsystem::JobArgs p_args) {
+            const uint32_t begin = p_args.jobIndex * p_chunk_size;
+            ForEachImpl<IS_CONST>(begin, std::min(begin + p_chunk_size, size), p_func);
+        });
+#else
+        unused(p_context);
+        ForEachImpl<IS_CONST>(0, size, p_func);
+#endif
+    }
+
+    Managers m_managers;
+    const std::vector<Entity>* m_entities;
 };
 
 }  // namespace my::ecs
@@ -0,0 +1,81 @@
+#pragma once
+#include <xmmintrin.h>
+
+#include "common.h"
+
+namespace my {
+
+// Ray kernels for 4 rays at once, one lane per ray, p_origin/p_direction hold x, y and z of the 4 rays.
+// They follow HitBvh() and HitTriangle() in shared_path_tracer.h, so the cpu and the gpu path tracer agree.
+
+// returns the mask of the lanes whose ray enters the box before its current t
+static inline int ray4_aabb_sse(const __m128* p_origin,
+                                const __m128* p_inv_direction,
+                                __m128 p_t,
+                                const float* p_min,
+                                const float* p_max) {
+    __m128 t_min = _mm_setzero_ps();
+    __m128 t_max = p_t;
+    for (int axis = 0; axis < 3; ++axis) {
+        const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(p_min[axis]), p_origin[axis]), p_inv_direction[axis]);
+        const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(p_max[axis]), p_origin[axis]), p_inv_direction[axis]);
+        t_min = _mm_max_ps(t_min, _mm_min_ps(t0, t1));
+        t_max = _mm_min_ps(t_max, _mm_max_ps(t0, t1));
+    }
+    return _mm_movemask_ps(_mm_cmple_ps(t_min, t_max));
+}
+
+// Moller-Trumbore with back face culling, lanes that hit get t, u and v replaced, returns the mask of those lanes
+static inline int ray4_triangle_sse(const __m128* p_origin,
+                                    const __m128* p_direction,
+                                    __m128& p_t,
+                                    __m128& p_u,
+                                    __m128& p_v,
+                                    const float* p_a,
+                                    const float* p_b,
+                                    const float* p_c,
+                                    float p_epsilon) {
+    const float ab[3] = { p_b[0] - p_a[0], p_b[1] - p_a[1], p_b[2] - p_a[2] };
+    const float ac[3] = { p_c[0] - p_a[0], p_c[1] - p_a[1], p_c[2] - p_a[2] };
+    const __m128 ab_x = _mm_set1_ps(ab[0]), ab_y = _mm_set1_ps(ab[1]), ab_z = _mm_set1_ps(ab[2]);
+    const __m128 ac_x = _mm_set1_ps(ac[0]), ac_y = _mm_set1_ps(ac[1]), ac_z = _mm_set1_ps(ac[2]);
+
+    // P = cross(direction, AC)
+    const __m128 p_x = _mm_sub_ps(_mm_mul_ps(p_direction[1], ac_z), _mm_mul_ps(p_direction[2], ac_y));
+    const __m128 p_y = _mm_sub_ps(_mm_mul_ps(p_direction[2], ac_x), _mm_mul_ps(p_direction[0], ac_z));
+    const __m128 p_z = _mm_sub_ps(_mm_mul_ps(p_direction[0], ac_y), _mm_mul_ps(p_direction[1], ac_x));
+    const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ab_x, p_x), _mm_mul_ps(ab_y, p_y)), _mm_mul_ps(ab_z, p_z));
+    const __m128 epsilon = _mm_set1_ps(p_epsilon);
+    __m128 valid = _mm_cmpge_ps(det, epsilon);
+    if (_mm_movemask_ps(valid) == 0) {
+        return 0;
+    }
+
+    const __m128 inv_det = _mm_div_ps(_mm_set1_ps(1.0f), det);
+    const __m128 ao_x = _mm_sub_ps(p_origin[0], _mm_set1_ps(p_a[0]));
+    const __m128 ao_y = _mm_sub_ps(p_origin[1], _mm_set1_ps(p_a[1]));
+    const __m128 ao_z = _mm_sub_ps(p_origin[2], _mm_set1_ps(p_a[2]));
+
+    // Q = cross(AO, AB)
+    const __m128 q_x = _mm_sub_ps(_mm_mul_ps(ao_y, ab_z), _mm_mul_ps(ao_z, ab_y));
+    const __m128 q_y = _mm_sub_ps(_mm_mul_ps(ao_z, ab_x), _mm_mul_ps(ao_x, ab_z));
+    const __m128 q_z = _mm_sub_ps(_mm_mul_ps(ao_x, ab_y), _mm_mul_ps(ao_y, ab_x));
+
+    const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ao_x, p_x), _mm_mul_ps(ao_y, p_y)), _mm_mul_ps(ao_z, p_z)), inv_det);
+    const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(p_direction[0], q_x), _mm_mul_ps(p_direction[1], q_y)), _mm_mul_ps(p_direction[2], q_z)), inv_det);
+    const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ac_x, q_x), _mm_mul_ps(ac_y, q_y)), _mm_mul_ps(ac_z, q_z)), inv_det);
+
+    const __m128 zero = _mm_setzero_ps();
+    valid = _mm_and_ps(valid, _mm_cmpge_ps(u, zero));
+    valid = _mm_and_ps(valid, _mm_cmpge_ps(v, zero));
+    valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+    valid = _mm_and_ps(valid, _mm_cmplt_ps(t, p_t));
+    valid = _mm_and_ps(valid, _mm_cmpge_ps(t, epsilon));
+
+    p_t = _mm_or_ps(_mm_and_ps(valid, t), _mm_andnot_ps(valid, p_t));
+    p_u = _mm_or_ps(_mm_and_ps(valid, u), _mm_andnot_ps(valid, p_u));
+    p_v = _mm_or_ps(_mm_and_ps(valid, v), _mm_andnot_ps(valid, p_v));
+    return _mm_movemask_ps(valid);
+}
+
+}  // namespace my
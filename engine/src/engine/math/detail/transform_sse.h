@@ -0,0 +1,102 @@
+#pragma once
+#include <xmmintrin.h>
+
+#include "common.h"
+
+namespace my {
+
+// builds 4 column major T * R * S matrices (16 floats each) from 4 lanes of translation, rotation and scale,
+// matches glm::translate * glm::toMat4 * glm::scale
+static inline void compose_transform4_sse(__m128 p_tx, __m128 p_ty, __m128 p_tz,
+                                          __m128 p_rx, __m128 p_ry, __m128 p_rz, __m128 p_rw,
+                                          __m128 p_sx, __m128 p_sy, __m128 p_sz,
+                                          float* p_out0, float* p_out1, float* p_out2, float* p_out3) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    const __m128 x2 = _mm_mul_ps(p_rx, two);
+    const __m128 y2 = _mm_mul_ps(p_ry, two);
+    const __m128 z2 = _mm_mul_ps(p_rz, two);
+
+    const __m128 xx = _mm_mul_ps(p_rx, x2);
+    const __m128 yy = _mm_mul_ps(p_ry, y2);
+    const __m128 zz = _mm_mul_ps(p_rz, z2);
+    const __m128 xy = _mm_mul_ps(p_rx, y2);
+    const __m128 xz = _mm_mul_ps(p_rx, z2);
+    const __m128 yz = _mm_mul_ps(p_ry, z2);
+    const __m128 wx = _mm_mul_ps(p_rw, x2);
+    const __m128 wy = _mm_mul_ps(p_rw, y2);
+    const __m128 wz = _mm_mul_ps(p_rw, z2);
+
+    // one register per matrix element, one lane per transform
+    __m128 c00 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), p_sx);
+    __m128 c01 = _mm_mul_ps(_mm_add_ps(xy, wz), p_sx);
+    __m128 c02 = _mm_mul_ps(_mm_sub_ps(xz, wy), p_sx);
+    __m128 c03 = zero;
+
+    __m128 c10 = _mm_mul_ps(_mm_sub_ps(xy, wz), p_sy);
+    __m128 c11 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), p_sy);
+    __m128 c12 = _mm_mul_ps(_mm_add_ps(yz, wx), p_sy);
+    __m128 c13 = zero;
+
+    __m128 c20 = _mm_mul_ps(_mm_add_ps(xz, wy), p_sz);
+    __m128 c21 = _mm_mul_ps(_mm_sub_ps(yz, wx), p_sz);
+    __m128 c22 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), p_sz);
+    __m128 c23 = zero;
+
+    __m128 c30 = p_tx;
+    __m128 c31 = p_ty;
+    __m128 c32 = p_tz;
+    __m128 c33 = one;
+
+    // after the transpose, register i holds column c of transform i
+    _MM_TRANSPOSE4_PS(c00, c01, c02, c03);
+    _MM_TRANSPOSE4_PS(c10, c11, c12, c13);
+    _MM_TRANSPOSE4_PS(c20, c21, c22, c23);
+    _MM_TRANSPOSE4_PS(c30, c31, c32, c33);
+
+    _mm_storeu_ps(p_out0 + 0, c00);
+    _mm_storeu_ps(p_out0 + 4, c10);
+    _mm_storeu_ps(p_out0 + 8, c20);
+    _mm_storeu_ps(p_out0 + 12, c30);
+
+    _mm_storeu_ps(p_out1 + 0, c01);
+    _mm_storeu_ps(p_out1 + 4, c11);
+    _mm_storeu_ps(p_out1 + 8, c21);
+    _mm_storeu_ps(p_out1 + 12, c31);
+
+    _mm_storeu_ps(p_out2 + 0, c02);
+    _mm_storeu_ps(p_out2 + 4, c12);
+    _mm_storeu_ps(p_out2 + 8, c22);
+    _mm_storeu_ps(p_out2 + 12, c32);
+
+    _mm_storeu_ps(p_out3 + 0, c03);
+    _mm_storeu_ps(p_out3 + 4, c13);
+    _mm_storeu_ps(p_out3 + 8, c23);
+    _mm_storeu_ps(p_out3 + 12, c33);
+}
+
+// p_out = p_lhs * p_rhs for column major 4x4 matrices, p_out may alias either input
+static inline void multiply_matrix_sse(const float* p_lhs, const float* p_rhs, float* p_out) {
+    const __m128 l0 = _mm_loadu_ps(p_lhs + 0);
+    const __m128 l1 = _mm_loadu_ps(p_lhs + 4);
+    const __m128 l2 = _mm_loadu_ps(p_lhs + 8);
+    const __m128 l3 = _mm_loadu_ps(p_lhs + 12);
+
+    __m128 columns[4];
+    for (int i = 0; i < 4; ++i) {
+        const float* r = p_rhs + 4 * i;
+        __m128 column = _mm_mul_ps(l0, _mm_set1_ps(r[0]));
+        column = _mm_add_ps(column, _mm_mul_ps(l1, _mm_set1_ps(r[1])));
+        column = _mm_add_ps(column, _mm_mul_ps(l2, _mm_set1_ps(r[2])));
+        column = _mm_add_ps(column, _mm_mul_ps(l3, _mm_set1_ps(r[3])));
+        columns[i] = column;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        _mm_storeu_ps(p_out + 4 * i, columns[i]);
+    }
+}
+
+}  // namespace my
@@ -0,0 +1,292 @@
+#include "dynamic_aabb_tree.h"
+
+namespace my {
+
+// surface area without the validity check of Box::SurfaceArea(), flat boxes still have an area
+static float Area(const AABB& p_aabb) {
+    const Vector3f size = p_aabb.Size();
+    return 2.0f * (size.x * size.y + size.x * size.z + size.y * size.z);
+}
+
+static AABB Union(const AABB& p_a, const AABB& p_b) {
+    AABB result = p_a;
+    result.UnionBox(p_b);
+    return result;
+}
+
+static bool Contains(const AABB& p_outer, const AABB& p_inner) {
+    const Vector3f& outer_min = p_outer.GetMin();
+    const Vector3f& outer_max = p_outer.GetMax();
+    const Vector3f& inner_min = p_inner.GetMin();
+    const Vector3f& inner_max = p_inner.GetMax();
+    return outer_min.x <= inner_min.x && outer_min.y <= inner_min.y && outer_min.z <= inner_min.z &&
+           inner_max.x <= outer_max.x && inner_max.y <= outer_max.y && inner_max.z <= outer_max.z;
+}
+
+int DynamicAABBTree::AllocateNode() {
+    if (m_freeList == NULL_NODE) {
+        const int node = static_cast<int>(m_nodes.size());
+        m_nodes.push_back({});
+        m_nodes[node].height = -1;
+        m_nodes[node].parent = NULL_NODE;
+        m_freeList = node;
+    }
+
+    const int node = m_freeList;
+    Node& n = m_nodes[node];
+    m_freeList = n.parent;
+    n.parent = NULL_NODE;
+    n.left = NULL_NODE;
+    n.right = NULL_NODE;
+    n.height = 0;
+    n.userData = 0;
+    return node;
+}
+
+void DynamicAABBTree::FreeNode(int p_node) {
+    DEV_ASSERT_INDEX(p_node, m_nodes.size());
+    m_nodes[p_node].parent = m_freeList;
+    m_nodes[p_node].height = -1;
+    m_freeList = p_node;
+}
+
+int DynamicAABBTree::Insert(const AABB& p_aabb, uint32_t p_user_data) {
+    const int leaf = AllocateNode();
+    const Vector3f margin(m_margin);
+    m_nodes[leaf].aabb = AABB(p_aabb.GetMin() - margin, p_aabb.GetMax() + margin);
+    m_nodes[leaf].userData = p_user_data;
+    InsertLeaf(leaf);
+    ++m_leafCount;
+    return leaf;
+}
+
+void DynamicAABBTree::Remove(int p_proxy) {
+    DEV_ASSERT(m_nodes[p_proxy].IsLeaf());
+    RemoveLeaf(p_proxy);
+    FreeNode(p_proxy);
+    --m_leafCount;
+}
+
+bool DynamicAABBTree::Move(int p_proxy, const AABB& p_aabb) {
+    DEV_ASSERT(m_nodes[p_proxy].IsLeaf());
+    if (Contains(m_nodes[p_proxy].aabb, p_aabb)) {
+        return false;
+    }
+
+    RemoveLeaf(p_proxy);
+    const Vector3f margin(m_margin);
+    m_nodes[p_proxy].aabb = AABB(p_aabb.GetMin() - margin, p_aabb.GetMax() + margin);
+    InsertLeaf(p_proxy);
+    return true;
+}
+
+void DynamicAABBTree::SetLeafBound(int p_proxy, const AABB& p_aabb) {
+    DEV_ASSERT(m_nodes[p_proxy].IsLeaf());
+    const Vector3f margin(m_margin);
+    m_nodes[p_proxy].aabb = AABB(p_aabb.GetMin() - margin, p_aabb.GetMax() + margin);
+}
+
+void DynamicAABBTree::Refit() {
+    if (m_root == NULL_NODE) {
+        return;
+    }
+
+    // post order, an internal node is pushed again as ~index and refitted after both children
+    Stack stack;
+    stack.push_back(m_root);
+    while (!stack.empty()) {
+        const int entry = stack.back();
+        stack.pop_back();
+
+        if (entry < 0) {
+            Node& node = m_nodes[~entry];
+            node.aabb = Union(m_nodes[node.left].aabb, m_nodes[node.right].aabb);
+            node.height = 1 + glm::max(m_nodes[node.left].height, m_nodes[node.right].height);
+            continue;
+        }
+
+        const Node& node = m_nodes[entry];
+        if (!node.IsLeaf()) {
+            stack.push_back(~entry);
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void DynamicAABBTree::Clear() {
+    m_nodes.clear();
+    m_root = NULL_NODE;
+    m_freeList = NULL_NODE;
+    m_leafCount = 0;
+}
+
+void DynamicAABBTree::InsertLeaf(int p_leaf) {
+    if (m_root == NULL_NODE) {
+        m_root = p_leaf;
+        m_nodes[p_leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // walk down to the sibling that adds the least surface area
+    const AABB leaf_aabb = m_nodes[p_leaf].aabb;
+    int index = m_root;
+    while (!m_nodes[index].IsLeaf()) {
+        const Node& node = m_nodes[index];
+        const float area = Area(node.aabb);
+        const float combined_area = Area(Union(node.aabb, leaf_aabb));
+
+        // cost of making a new parent for this node and the leaf
+        const float cost = 2.0f * combined_area;
+        // minimum cost of pushing the leaf further down the tree
+        const float inheritance_cost = 2.0f * (combined_area - area);
+
+        auto child_cost = [&](int p_child) {
+            const Node& child = m_nodes[p_child];
+            const float new_area = Area(Union(child.aabb, leaf_aabb));
+            return child.IsLeaf() ? new_area + inheritance_cost : new_area - Area(child.aabb) + inheritance_cost;
+        };
+
+        const float cost_left = child_cost(node.left);
+        const float cost_right = child_cost(node.right);
+        if (cost < cost_left && cost < cost_right) {
+            break;
+        }
+        index = cost_left < cost_right ? node.left : node.right;
+    }
+
+    const int sibling = index;
+    const int old_parent = m_nodes[sibling].parent;
+    const int new_parent = AllocateNode();
+    m_nodes[new_parent].parent = old_parent;
+    m_nodes[new_parent].aabb = Union(leaf_aabb, m_nodes[sibling].aabb);
+    m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+    m_nodes[new_parent].left = sibling;
+    m_nodes[new_parent].right = p_leaf;
+    m_nodes[sibling].parent = new_parent;
+    m_nodes[p_leaf].parent = new_parent;
+
+    if (old_parent == NULL_NODE) {
+        m_root = new_parent;
+    } else if (m_nodes[old_parent].left == sibling) {
+        m_nodes[old_parent].left = new_parent;
+    } else {
+        m_nodes[old_parent].right = new_parent;
+    }
+
+    FixUpwards(m_nodes[p_leaf].parent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int p_leaf) {
+    if (p_leaf == m_root) {
+        m_root = NULL_NODE;
+        return;
+    }
+
+    const int parent = m_nodes[p_leaf].parent;
+    const int grand_parent = m_nodes[parent].parent;
+    const int sibling = m_nodes[parent].left == p_leaf ? m_nodes[parent].right : m_nodes[parent].left;
+
+    // the sibling takes the place of the parent
+    if (grand_parent == NULL_NODE) {
+        m_root = sibling;
+        m_nodes[sibling].parent = NULL_NODE;
+    } else {
+        if (m_nodes[grand_parent].left == parent) {
+            m_nodes[grand_parent].left = sibling;
+        } else {
+            m_nodes[grand_parent].right = sibling;
+        }
+        m_nodes[sibling].parent = grand_parent;
+        FixUpwards(grand_parent);
+    }
+    FreeNode(parent);
+    m_nodes[p_leaf].parent = NULL_NODE;
+}
+
+void DynamicAABBTree::FixUpwards(int p_node) {
+    for (int index = p_node; index != NULL_NODE;) {
+        index = Balance(index);
+
+        Node& node = m_nodes[index];
+        node.height = 1 + glm::max(m_nodes[node.left].height, m_nodes[node.right].height);
+        node.aabb = Union(m_nodes[node.left].aabb, m_nodes[node.right].aabb);
+        index = node.parent;
+    }
+}
+
+// rotates the taller child up when the children heights differ by more than one, returns the node now at p_node's place
+int DynamicAABBTree::Balance(int p_node) {
+    Node& a = m_nodes[p_node];
+    if (a.IsLeaf()) {
+        return p_node;
+    }
+
+    const int ib = a.left;
+    const int ic = a.right;
+    const int balance = m_nodes[ic].height - m_nodes[ib].height;
+    if (balance >= -1 && balance <= 1) {
+        return p_node;
+    }
+
+    // the taller child becomes the parent of p_node
+    const int up = balance > 1 ? ic : ib;
+    const int other = balance > 1 ? ib : ic;
+    Node& u = m_nodes[up];
+    const int f = u.left;
+    const int g = u.right;
+
+    u.left = p_node;
+    u.parent = a.parent;
+    a.parent = up;
+    if (u.parent == NULL_NODE) {
+        m_root = up;
+    } else if (m_nodes[u.parent].left == p_node) {
+        m_nodes[u.parent].left = up;
+    } else {
+        m_nodes[u.parent].right = up;
+    }
+
+    // the taller grandchild stays under up, the other one moves under p_node
+    const bool keep_f = m_nodes[f].height > m_nodes[g].height;
+    const int keep = keep_f ? f : g;
+    const int move = keep_f ? g : f;
+    u.right = keep;
+    if (balance > 1) {
+        a.right = move;
+    } else {
+        a.left = move;
+    }
+    m_nodes[move].parent = p_node;
+
+    a.aabb = Union(m_nodes[other].aabb, m_nodes[move].aabb);
+    a.height = 1 + glm::max(m_nodes[other].height, m_nodes[move].height);
+    u.aabb = Union(a.aabb, m_nodes[keep].aabb);
+    u.height = 1 + glm::max(a.height, m_nodes[keep].height);
+    return up;
+}
+
+DynamicAABBTree::Containment DynamicAABBTree::Classify(const Frustum& p_frustum, const AABB& p_aabb) {
+    const Vector3f& box_min = p_aabb.GetMin();
+    const Vector3f& box_max = p_aabb.GetMax();
+    Containment result = Containment::INSIDE;
+    for (int i = 0; i < 6; ++i) {
+        const Plane& plane = p_frustum[i];
+        // corners furthest along and against the normal
+        const Vector3f p(plane.normal.x > 0.0f ? box_max.x : box_min.x,
+                         plane.normal.y > 0.0f ? box_max.y : box_min.y,
+                         plane.normal.z > 0.0f ? box_max.z : box_min.z);
+        if (plane.Distance(p) < 0.0f) {
+            return Containment::OUTSIDE;
+        }
+        const Vector3f n(plane.normal.x > 0.0f ? box_min.x : box_max.x,
+                         plane.normal.y > 0.0f ? box_min.y : box_max.y,
+                         plane.normal.z > 0.0f ? box_min.z : box_max.z);
+        if (plane.Distance(n) < 0.0f) {
+            result = Containment::INTERSECTS;
+        }
+    }
+    return result;
+}
+
+}  // namespace my
@@ -0,0 +1,254 @@
+#pragma once
+#include <bit>
+
+#include "engine/core/base/fixed_stack.h"
+#include "engine/math/aabb.h"
+#include "engine/math/frustum.h"
+#include "engine/math/ray.h"
+
+namespace my {
+
+// Bounding volume hierarchy that supports inserting, removing and moving boxes one at a time.
+// Leaves store a box enlarged by a margin, so objects that move a little don't change the tree.
+// Inserting picks the sibling that grows the tree surface area the least, and the tree is kept
+// balanced with rotations. Nodes live in a pool, a proxy is the index of its leaf and stays valid until removed.
+// Queries don't modify the tree, so they can run on several threads at once.
+class DynamicAABBTree {
+public:
+    static constexpr int NULL_NODE = -1;
+
+    struct Node {
+        AABB aabb;
+        // next free node when the node is not in use
+        int parent;
+        int left;
+        int right;
+        // 0 for leaves, -1 for free nodes
+        int height;
+        uint32_t userData;
+
+        bool IsLeaf() const { return left == NULL_NODE; }
+    };
+
+    explicit DynamicAABBTree(float p_margin = 0.1f)
+        : m_margin(p_margin) {}
+
+    int Insert(const AABB& p_aabb, uint32_t p_user_data);
+    void Remove(int p_proxy);
+    // reinserts the proxy when p_aabb is no longer inside its enlarged box, returns true if it did
+    bool Move(int p_proxy, const AABB& p_aabb);
+    // replaces the box of the leaf without changing the tree, call Refit() once all leaves are updated
+    void SetLeafBound(int p_proxy, const AABB& p_aabb);
+    // recomputes the boxes of the internal nodes bottom up
+    void Refit();
+    void Clear();
+
+    uint32_t GetUserData(int p_proxy) const { return m_nodes[p_proxy].userData; }
+    const AABB& GetFatBound(int p_proxy) const { return m_nodes[p_proxy].aabb; }
+    int GetHeight() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+    uint32_t GetLeafCount() const { return m_leafCount; }
+    int GetRoot() const { return m_root; }
+    const Node& GetNode(int p_index) const { return m_nodes[p_index]; }
+
+    // p_callback(user_data) for every leaf whose box overlaps p_aabb
+    template<typename FUNC>
+    void Query(const AABB& p_aabb, FUNC&& p_callback) const;
+
+    // p_callback(user_data) for every leaf whose box intersects the frustum,
+    // subtrees fully inside the frustum are reported without testing their leaves
+    template<typename FUNC>
+    void Query(const Frustum& p_frustum, FUNC&& p_callback) const;
+
+    // p_callback(user_data) -> bool for every leaf whose box the ray segment hits, nearest first is not guaranteed.
+    // the ray is read before every test, so a callback that shortens it prunes the rest of the traversal,
+    // returning false stops the traversal
+    template<typename FUNC>
+    void RayCast(const Ray& p_ray, FUNC&& p_callback) const;
+
+    // p_callback(user_data, mask) -> mask for every leaf the segment of at least one ray in p_mask hits,
+    // mask has the rays that hit the leaf, the callback returns those of them that keep tracing
+    template<typename FUNC>
+    void RayCast(const RayPacket& p_packet, uint32_t p_mask, FUNC&& p_callback) const;
+
+private:
+    // deep enough for any tree the balancing produces
+    static constexpr size_t STACK_SIZE = 256;
+    using Stack = FixedStack<int, STACK_SIZE>;
+
+    struct PacketEntry {
+        int node;
+        // rays that hit the parent
+        uint32_t mask;
+    };
+
+    enum class Containment {
+        OUTSIDE,
+        INTERSECTS,
+        INSIDE,
+    };
+
+    int AllocateNode();
+    void FreeNode(int p_node);
+    void InsertLeaf(int p_leaf);
+    void RemoveLeaf(int p_leaf);
+    int Balance(int p_node);
+    void FixUpwards(int p_node);
+
+    static Containment Classify(const Frustum& p_frustum, const AABB& p_aabb);
+
+    template<typename FUNC>
+    void ReportSubtree(int p_node, Stack& p_stack, FUNC& p_callback) const;
+
+    std::vector<Node> m_nodes;
+    int m_root{ NULL_NODE };
+    int m_freeList{ NULL_NODE };
+    uint32_t m_leafCount{ 0 };
+    float m_margin;
+};
+
+template<typename FUNC>
+void DynamicAABBTree::Query(const AABB& p_aabb, FUNC&& p_callback) const {
+    if (m_root == NULL_NODE) {
+        return;
+    }
+
+    Stack stack;
+    stack.push_back(m_root);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+
+        const AABB& box = node.aabb;
+        if (box.GetMin().x > p_aabb.GetMax().x || box.GetMax().x < p_aabb.GetMin().x ||
+            box.GetMin().y > p_aabb.GetMax().y || box.GetMax().y < p_aabb.GetMin().y ||
+            box.GetMin().z > p_aabb.GetMax().z || box.GetMax().z < p_aabb.GetMin().z) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            p_callback(node.userData);
+        } else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+template<typename FUNC>
+void DynamicAABBTree::ReportSubtree(int p_node, Stack& p_stack, FUNC& p_callback) const {
+    // uses the end of the stack, the caller's entries below are left untouched
+    const size_t base = p_stack.size();
+    p_stack.push_back(p_node);
+    while (p_stack.size() > base) {
+        const Node& node = m_nodes[p_stack.back()];
+        p_stack.pop_back();
+        if (node.IsLeaf()) {
+            p_callback(node.userData);
+        } else {
+            p_stack.push_back(node.left);
+            p_stack.push_back(node.right);
+        }
+    }
+}
+
+template<typename FUNC>
+void DynamicAABBTree::Query(const Frustum& p_frustum, FUNC&& p_callback) const {
+    if (m_root == NULL_NODE) {
+        return;
+    }
+
+    Stack stack;
+    stack.push_back(m_root);
+    while (!stack.empty()) {
+        const int index = stack.back();
+        stack.pop_back();
+        const Node& node = m_nodes[index];
+
+        switch (Classify(p_frustum, node.aabb)) {
+            case Containment::OUTSIDE:
+                break;
+            case Containment::INSIDE:
+                ReportSubtree(index, stack, p_callback);
+                break;
+            case Containment::INTERSECTS:
+                if (node.IsLeaf()) {
+                    p_callback(node.userData);
+                } else {
+                    stack.push_back(node.left);
+                    stack.push_back(node.right);
+                }
+                break;
+        }
+    }
+}
+
+template<typename FUNC>
+void DynamicAABBTree::RayCast(const Ray& p_ray, FUNC&& p_callback) const {
+    if (m_root == NULL_NODE) {
+        return;
+    }
+
+    const Vector3f start = p_ray.GetStart();
+    const Vector3f inv_direction = 1.0f / (p_ray.GetEnd() - start);
+
+    Stack stack;
+    stack.push_back(m_root);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+
+        if (!TestIntersection::RaySegmentAabb(start, inv_direction, p_ray.GetDist(), node.aabb)) {
+            continue;
+        }
+
+        if (!node.IsLeaf()) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        } else if (!p_callback(node.userData)) {
+            return;
+        }
+    }
+}
+
+template<typename FUNC>
+void DynamicAABBTree::RayCast(const RayPacket& p_packet, uint32_t p_mask, FUNC&& p_callback) const {
+    if (m_root == NULL_NODE || p_mask == 0) {
+        return;
+    }
+
+    Vector3f inv_directions[RayPacket::MAX_SIZE];
+    for (uint32_t i = 0; i < p_packet.count; ++i) {
+        inv_directions[i] = 1.0f / p_packet.directions[i];
+    }
+
+    // a ray that misses a node skips the whole subtree
+    FixedStack<PacketEntry, STACK_SIZE> stack;
+    stack.push_back({ m_root, p_mask });
+    uint32_t active = p_mask;
+    while (!stack.empty() && active) {
+        const PacketEntry entry = stack.back();
+        stack.pop_back();
+        const Node& node = m_nodes[entry.node];
+
+        uint32_t mask = 0;
+        for (uint32_t rays = entry.mask & active; rays; rays &= rays - 1) {
+            const uint32_t i = std::countr_zero(rays);
+            if (TestIntersection::RaySegmentAabb(p_packet.starts[i], inv_directions[i], p_packet.dists[i], node.aabb)) {
+                mask |= 1u << i;
+            }
+        }
+        if (mask == 0) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            const uint32_t keep = p_callback(node.userData, mask);
+            active &= ~mask | keep;
+        } else {
+            stack.push_back({ node.left, mask });
+            stack.push_back({ node.right, mask });
+        }
+    }
+}
+
+}  // namespace my
@@ -56,4 +56,22 @@ bool Frustum::Intersects(const AABB& p_box) const {
     return true;
 }
 
+void Frustum::Intersects(const AABBBatch& p_boxes, uint8_t* p_out_visible, size_t p_count) const {
+    for (size_t i = 0; i < p_count; ++i) {
+        p_out_visible[i] = 1;
+    }
+
+    for (int plane_index = 0; plane_index < 6; ++plane_index) {
+        const Plane& plane = this->operator[](plane_index);
+        // the corner furthest along the normal
+        const float* x = plane.normal.x > 0.0f ? p_boxes.maxX : p_boxes.minX;
+        const float* y = plane.normal.y > 0.0f ? p_boxes.maxY : p_boxes.minY;
+        const float* z = plane.normal.z > 0.0f ? p_boxes.maxZ : p_boxes.minZ;
+        for (size_t i = 0; i < p_count; ++i) {
+            const float distance = plane.normal.x * x[i] + plane.normal.y * y[i] + plane.normal.z * z[i] + plane.dist;
+            p_out_visible[i] &= static_cast<uint8_t>(distance >= 0.0f);
+        }
+    }
+}
+
 }  // namespace my
@@ -6,6 +6,16 @@ namespace my {
 
 class AABB;
 
+// structure of arrays view of boxes
+struct AABBBatch {
+    const float* minX;
+    const float* minY;
+    const float* minZ;
+    const float* maxX;
+    const float* maxY;
+    const float* maxZ;
+};
+
 class Frustum {
 public:
     Frustum() = default;
@@ -17,6 +27,10 @@ public:
 
     bool Intersects(const AABB& p_box) const;
 
+    // p_out_visible[i] is 1 when box i intersects, 0 otherwise.
+    // planes are tested one at a time over all boxes, so the inner loop is branch free
+    void Intersects(const AABBBatch& p_boxes, uint8_t* p_out_visible, size_t p_count) const;
+
 private:
     Plane m_left;
     Plane m_right;
@@ -657,6 +657,17 @@ void BoxWireFrameHelper(const Vector3f& p_min,
                         const Vector3f& p_max,
                         std::vector<Vector3f>& p_out_positions,
                         std::vector<uint32_t>& p_out_indices) {
+    std::array<Vector3f, 8> positions;
+    std::array<uint32_t, 36> indices;
+    BoxWireFrameHelper(p_min, p_max, positions, indices);
+    p_out_positions.assign(positions.begin(), positions.end());
+    p_out_indices.assign(indices.begin(), indices.end());
+}
+
+void BoxWireFrameHelper(const Vector3f& p_min,
+                        const Vector3f& p_max,
+                        std::array<Vector3f, 8>& p_out_positions,
+                        std::array<uint32_t, 36>& p_out_indices) {
     p_out_positions = {
         Vector3f(p_min.x, p_max.y, p_max.z),  // A
         Vector3f(p_min.x, p_min.y, p_max.z),  // B
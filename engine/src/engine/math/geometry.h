@@ -8,6 +8,12 @@ void BoxWireFrameHelper(const Vector3f& p_min,
                         std::vector<Vector3f>& p_out_positions,
                         std::vector<uint32_t>& p_out_indices);
 
+// same as above without allocating, for code running every frame
+void BoxWireFrameHelper(const Vector3f& p_min,
+                        const Vector3f& p_max,
+                        std::array<Vector3f, 8>& p_out_positions,
+                        std::array<uint32_t, 36>& p_out_indices);
+
 MeshComponent MakePlaneMesh(const Vector3f& p_scale = Vector3f(0.5f));
 
 MeshComponent MakePlaneMesh(const Vector3f& p_point_0,
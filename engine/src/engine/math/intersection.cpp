@@ -38,35 +38,53 @@ bool TestIntersection::RayAabb(const AABB& p_aabb, Ray& p_ray) {
 }
 
 bool TestIntersection::RayTriangle(const Vector3f& p_a, const Vector3f& p_b, const Vector3f& p_c, Ray& p_ray) {
+    return RayTriangle(p_a, p_b, p_c, p_ray.m_start, p_ray.m_end - p_ray.m_start, p_ray.m_dist);
+}
+
+bool TestIntersection::RayTriangle(const Vector3f& p_a,
+                                   const Vector3f& p_b,
+                                   const Vector3f& p_c,
+                                   const Vector3f& p_start,
+                                   const Vector3f& p_direction,
+                                   float& p_dist) {
     // P = A + u(B - A) + v(C - A) => O - A = -tD + u(B - A) + v(C - A)
     // -tD + uAB + vAC = AO
-    const Vector3f direction = p_ray.m_end - p_ray.m_start;
     const Vector3f ab = p_b - p_a;
     const Vector3f ac = p_c - p_a;
-    Vector3f P = cross(direction, ac);
+    Vector3f P = cross(p_direction, ac);
     const float det = dot(ab, P);
     if (det < Epsilon()) {
         return false;
     }
 
     const float inv_det = 1.0f / det;
-    const Vector3f AO = p_ray.m_start - p_a;
+    const Vector3f AO = p_start - p_a;
 
     const Vector3f q = cross(AO, ab);
     const float u = dot(AO, P) * inv_det;
-    const float v = dot(direction, q) * inv_det;
+    const float v = dot(p_direction, q) * inv_det;
 
     if (u < 0.0 || v < 0.0 || u + v > 1.0) {
         return false;
     }
 
     const float t = dot(ac, q) * inv_det;
-    if (t < Epsilon() || t >= p_ray.m_dist) {
+    if (t < Epsilon() || t >= p_dist) {
         return false;
     }
 
-    p_ray.m_dist = t;
+    p_dist = t;
     return true;
 }
 
+bool TestIntersection::RaySegmentAabb(const Vector3f& p_start, const Vector3f& p_inv_direction, float p_dist, const AABB& p_aabb) {
+    const Vector3f t0 = (p_aabb.m_min - p_start) * p_inv_direction;
+    const Vector3f t1 = (p_aabb.m_max - p_start) * p_inv_direction;
+    const Vector3f t_near = min(t0, t1);
+    const Vector3f t_far = max(t0, t1);
+    const float t_min = max(0.0f, max(t_near.x, max(t_near.y, t_near.z)));
+    const float t_max = min(p_dist, min(t_far.x, min(t_far.y, t_far.z)));
+    return t_min <= t_max;
+}
+
 }  // namespace my
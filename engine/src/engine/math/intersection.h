@@ -11,6 +11,15 @@ public:
     static bool AabbAabb(const AABB& p_aabb1, const AABB& p_aabb2);
     static bool RayAabb(const AABB& p_aabb, Ray& p_ray);
     static bool RayTriangle(const Vector3f& p_a, const Vector3f& p_b, const Vector3f& p_c, Ray& p_ray);
+    // p_direction is end - start, p_dist is shortened on hit, back faces are culled like the Ray version
+    static bool RayTriangle(const Vector3f& p_a,
+                            const Vector3f& p_b,
+                            const Vector3f& p_c,
+                            const Vector3f& p_start,
+                            const Vector3f& p_direction,
+                            float& p_dist);
+    // segment [0, p_dist] against the box without modifying anything, the segment may start inside the box
+    static bool RaySegmentAabb(const Vector3f& p_start, const Vector3f& p_inv_direction, float p_dist, const AABB& p_aabb);
 };
 
 }  // namespace my
\ No newline at end of file
@@ -13,6 +13,11 @@ public:
 
     Vector3f Direction() const;
 
+    const Vector3f& GetStart() const { return m_start; }
+    const Vector3f& GetEnd() const { return m_end; }
+    float GetDist() const { return m_dist; }
+    void SetDist(float p_dist) { m_dist = p_dist; }
+
     bool Intersects(const AABB& p_aabb) { return TestIntersection::RayAabb(p_aabb, *this); }
 
     bool Intersects(const Vector3f& p_a,
@@ -32,4 +37,27 @@ private:
     friend class TestIntersection;
 };
 
+// Rays traced together through the same nodes, they should start close to each other and point the same way.
+// Bit i of a mask selects ray i, dists work like the dist of a Ray and are shortened by hits.
+struct RayPacket {
+    static constexpr uint32_t MAX_SIZE = 16;
+    static_assert(MAX_SIZE < 32, "masks are 32 bits");
+
+    uint32_t count{ 0 };
+    Vector3f starts[MAX_SIZE];
+    // end - start
+    Vector3f directions[MAX_SIZE];
+    float dists[MAX_SIZE];
+
+    void Add(const Ray& p_ray) {
+        DEV_ASSERT(count < MAX_SIZE);
+        starts[count] = p_ray.GetStart();
+        directions[count] = p_ray.GetEnd() - p_ray.GetStart();
+        dists[count] = p_ray.GetDist();
+        ++count;
+    }
+
+    uint32_t GetMask() const { return (1u << count) - 1; }
+};
+
 }  // namespace my
@@ -0,0 +1,87 @@
+#include "transform_batch.h"
+
+#if USING(MATH_ENABLE_SIMD_SSE)
+#include "detail/transform_sse.h"
+#endif
+
+namespace my {
+
+static_assert(sizeof(Matrix4x4f) == sizeof(float) * 16);
+
+void ComposeTransformsScalar(const TransformBatch& p_batch, Matrix4x4f* p_out, size_t p_count) {
+    for (size_t i = 0; i < p_count; ++i) {
+        const float x = p_batch.rx[i];
+        const float y = p_batch.ry[i];
+        const float z = p_batch.rz[i];
+        const float w = p_batch.rw[i];
+
+        const float xx = 2.0f * x * x, yy = 2.0f * y * y, zz = 2.0f * z * z;
+        const float xy = 2.0f * x * y, xz = 2.0f * x * z, yz = 2.0f * y * z;
+        const float wx = 2.0f * w * x, wy = 2.0f * w * y, wz = 2.0f * w * z;
+
+        const float sx = p_batch.sx[i];
+        const float sy = p_batch.sy[i];
+        const float sz = p_batch.sz[i];
+
+        Matrix4x4f& m = p_out[i];
+        m[0] = glm::vec4((1.0f - (yy + zz)) * sx, (xy + wz) * sx, (xz - wy) * sx, 0.0f);
+        m[1] = glm::vec4((xy - wz) * sy, (1.0f - (xx + zz)) * sy, (yz + wx) * sy, 0.0f);
+        m[2] = glm::vec4((xz + wy) * sz, (yz - wx) * sz, (1.0f - (xx + yy)) * sz, 0.0f);
+        m[3] = glm::vec4(p_batch.tx[i], p_batch.ty[i], p_batch.tz[i], 1.0f);
+    }
+}
+
+void ComposeTransforms(const TransformBatch& p_batch, Matrix4x4f* p_out, size_t p_count) {
+    size_t i = 0;
+#if USING(MATH_ENABLE_SIMD_SSE)
+    for (; i + 4 <= p_count; i += 4) {
+        compose_transform4_sse(_mm_loadu_ps(p_batch.tx + i),
+                               _mm_loadu_ps(p_batch.ty + i),
+                               _mm_loadu_ps(p_batch.tz + i),
+                               _mm_loadu_ps(p_batch.rx + i),
+                               _mm_loadu_ps(p_batch.ry + i),
+                               _mm_loadu_ps(p_batch.rz + i),
+                               _mm_loadu_ps(p_batch.rw + i),
+                               _mm_loadu_ps(p_batch.sx + i),
+                               _mm_loadu_ps(p_batch.sy + i),
+                               _mm_loadu_ps(p_batch.sz + i),
+                               &p_out[i + 0][0][0],
+                               &p_out[i + 1][0][0],
+                               &p_out[i + 2][0][0],
+                               &p_out[i + 3][0][0]);
+    }
+#endif
+
+    if (i < p_count) {
+        const TransformBatch tail = {
+            p_batch.tx + i,
+            p_batch.ty + i,
+            p_batch.tz + i,
+            p_batch.rx + i,
+            p_batch.ry + i,
+            p_batch.rz + i,
+            p_batch.rw + i,
+            p_batch.sx + i,
+            p_batch.sy + i,
+            p_batch.sz + i,
+        };
+        ComposeTransformsScalar(tail, p_out + i, p_count - i);
+    }
+}
+
+void ComputeSkinningMatrices(const Matrix4x4f& p_root_inverse,
+                             const Matrix4x4f* p_inverse_binds,
+                             Matrix4x4f* p_palette,
+                             size_t p_count) {
+    for (size_t i = 0; i < p_count; ++i) {
+#if USING(MATH_ENABLE_SIMD_SSE)
+        float* palette = &p_palette[i][0][0];
+        multiply_matrix_sse(&p_root_inverse[0][0], palette, palette);
+        multiply_matrix_sse(palette, &p_inverse_binds[i][0][0], palette);
+#else
+        p_palette[i] = p_root_inverse * p_palette[i] * p_inverse_binds[i];
+#endif
+    }
+}
+
+}  // namespace my
@@ -0,0 +1,33 @@
+#pragma once
+#include "engine/math/matrix.h"
+
+namespace my {
+
+// structure of arrays view of p_count translation, rotation (quaternion xyzw) and scale values
+struct TransformBatch {
+    const float* tx;
+    const float* ty;
+    const float* tz;
+    const float* rx;
+    const float* ry;
+    const float* rz;
+    const float* rw;
+    const float* sx;
+    const float* sy;
+    const float* sz;
+};
+
+// p_out[i] = translate(t[i]) * rotate(r[i]) * scale(s[i]), 4 matrices per iteration when SSE is available
+void ComposeTransforms(const TransformBatch& p_batch, Matrix4x4f* p_out, size_t p_count);
+
+// one matrix at a time, used for the tail and as the reference for the SIMD path
+void ComposeTransformsScalar(const TransformBatch& p_batch, Matrix4x4f* p_out, size_t p_count);
+
+// skinning matrices, p_palette[i] = p_root_inverse * p_palette[i] * p_inverse_binds[i],
+// p_palette holds the world matrices of the bones on input
+void ComputeSkinningMatrices(const Matrix4x4f& p_root_inverse,
+                             const Matrix4x4f* p_inverse_binds,
+                             Matrix4x4f* p_palette,
+                             size_t p_count);
+
+}  // namespace my
@@ -57,24 +57,61 @@ static void DrawInstacedGeometry(const RenderSystem& p_data, const std::vector<I
 }
 #endif
 
-static void ExecuteDrawCommands(const FrameData& p_data, const std::vector<RenderCommand>& p_commands, bool p_is_prepass = false) {
+static void ExecuteDrawCommands(const FrameData& p_data, std::span<const RenderCommand> p_commands, bool p_is_prepass = false) {
 
     HBN_PROFILE_EVENT();
 
     auto& gm = IGraphicsManager::GetSingleton();
     auto& frame = gm.GetCurrentFrame();
+    DrawStats& stats = frame.drawStats;
+
+    // commands are sorted by state, binds the previous command already made are skipped
+    const GpuMesh* bound_mesh = nullptr;
+    // bones and instances share the BoneConstantBuffer slot
+    int bound_bone_idx = -1;
+    int bound_instance_idx = -1;
+    int bound_mat_idx = -1;
+    uint32_t bound_pipeline = 0;
     for (const RenderCommand& cmd : p_commands) {
         if (cmd.type != RenderCommandType::Draw) continue;
         const DrawCommand& draw = cmd.draw;
 
+        // commands that carry a pipeline are sorted by it, a pipeline is bound once per run
+        if (const uint32_t pipeline = GetSortKeyPipeline(draw.sortKey); pipeline && pipeline != bound_pipeline) {
+            gm.SetPipelineState(static_cast<PipelineStateName>(pipeline - 1));
+            bound_pipeline = pipeline;
+        }
+
+        const bool is_instanced = draw.instance_idx >= 0;
+        if (is_instanced) {
+            if (draw.instance_idx != bound_instance_idx) {
+                gm.BindConstantBufferSlot<BoneConstantBuffer>(frame.instanceCb.get(), draw.instance_idx);
+                bound_instance_idx = draw.instance_idx;
+                bound_bone_idx = -1;
+            } else {
+                ++stats.boneBindsSkipped;
+            }
+        }
+
         const bool has_bone = draw.bone_idx >= 0;
         if (has_bone) {
-            gm.BindConstantBufferSlot<BoneConstantBuffer>(frame.boneCb.get(), draw.bone_idx);
+            if (draw.bone_idx != bound_bone_idx) {
+                gm.BindConstantBufferSlot<BoneConstantBuffer>(frame.boneCb.get(), draw.bone_idx);
+                bound_bone_idx = draw.bone_idx;
+                bound_instance_idx = -1;
+            } else {
+                ++stats.boneBindsSkipped;
+            }
         }
 
         gm.BindConstantBufferSlot<PerBatchConstantBuffer>(frame.batchCb.get(), draw.batch_idx);
 
-        gm.SetMesh(draw.mesh_data);
+        if (draw.mesh_data != bound_mesh) {
+            gm.SetMesh(draw.mesh_data);
+            bound_mesh = draw.mesh_data;
+        } else {
+            ++stats.meshBindsSkipped;
+        }
 
         // @TODO: instead of dowing this,
         // set flag directly from draw.flags
@@ -82,15 +119,24 @@ static void ExecuteDrawCommands(const FrameData& p_data, const std::vector<Rende
             gm.SetStencilRef(draw.flags);
         }
 
-        if (draw.mat_idx != -1) {
+        if (draw.mat_idx != -1 && draw.mat_idx == bound_mat_idx) {
+            ++stats.materialBindsSkipped;
+        } else if (draw.mat_idx != -1) {
             const MaterialConstantBuffer& material = p_data.materialCache.buffer[draw.mat_idx];
             gm.BindTexture(Dimension::TEXTURE_2D, material.c_baseColorMapHandle, GetBaseColorMapSlot());
             gm.BindTexture(Dimension::TEXTURE_2D, material.c_normalMapHandle, GetNormalMapSlot());
             gm.BindTexture(Dimension::TEXTURE_2D, material.c_materialMapHandle, GetMaterialMapSlot());
 
             gm.BindConstantBufferSlot<MaterialConstantBuffer>(frame.materialCb.get(), draw.mat_idx);
+            bound_mat_idx = draw.mat_idx;
         }
-        gm.DrawElements(draw.indexCount, draw.indexOffset);
+        if (is_instanced) {
+            gm.DrawElementsInstanced(draw.instanceCount, draw.indexCount, draw.indexOffset);
+        } else {
+            gm.DrawElements(draw.indexCount, draw.indexOffset);
+        }
+        ++stats.drawCount;
+        stats.instanceCount += draw.instanceCount;
 
         if (p_is_prepass && draw.flags) {
             gm.SetStencilRef(0);
@@ -98,6 +144,15 @@ static void ExecuteDrawCommands(const FrameData& p_data, const std::vector<Rende
     }
 }
 
+static void ExecuteComputeCommands(std::span<const RenderCommand> p_commands) {
+    auto& gm = IGraphicsManager::GetSingleton();
+    for (const RenderCommand& cmd : p_commands) {
+        if (cmd.type != RenderCommandType::Compute) continue;
+        const ComputeCommand& compute = cmd.compute;
+        gm.Dispatch(compute.dispatchSize[0], compute.dispatchSize[1], compute.dispatchSize[2]);
+    }
+}
+
 struct ScopedEvent {
     IRenderCmdContext& m_ctx;
 
@@ -115,6 +170,75 @@ struct ScopedEvent {
     ScopedEvent _scoped(p_ctx.cmd, p_ctx.pass.GetName()); \
     HBN_PROFILE_EVENT();
 
+/// GPU culling
+// tests the opaque subsets against the hi-z the previous frame built, the hi-z of this frame is built after the gbuffer
+// debug only, the draw arguments and the count are written for inspection, the opaque passes still draw from the CPU lists
+static void GpuCullingPassFunc(RenderPassExcutionContext& p_ctx) {
+    const FrameData& data = p_ctx.frameData;
+    if (!data.options.debugGpuCulling || data.culling_commands.empty()) {
+        return;
+    }
+
+    RENDER_PASS_FUNC();
+
+    auto& cmd = p_ctx.cmd;
+    auto& frame = cmd.GetCurrentFrame();
+
+    cmd.BindStructuredBuffer(GetGlobalCullConstantsSlot(), frame.cullConstantBuffer.get());
+    cmd.BindStructuredBuffer(GetGlobalCullInstancesSlot(), frame.cullInstanceBuffer.get());
+    cmd.BindStructuredBuffer(GetGlobalIndirectArgsSlot(), frame.indirectArgsBuffer.get());
+    cmd.BindStructuredBuffer(GetGlobalIndirectCountSlot(), frame.indirectCountBuffer.get());
+
+    cmd.SetPipelineState(PSO_GPU_CULLING);
+    ExecuteComputeCommands(data.culling_commands);
+
+    cmd.UnbindStructuredBuffer(GetGlobalCullConstantsSlot());
+    cmd.UnbindStructuredBuffer(GetGlobalCullInstancesSlot());
+    cmd.UnbindStructuredBuffer(GetGlobalIndirectArgsSlot());
+    cmd.UnbindStructuredBuffer(GetGlobalIndirectCountSlot());
+}
+
+static void HiZPassFunc(RenderPassExcutionContext& p_ctx) {
+    if (!p_ctx.frameData.options.debugGpuCulling) {
+        return;
+    }
+
+    RENDER_PASS_FUNC();
+
+    auto& cmd = p_ctx.cmd;
+
+    auto uav = p_ctx.pass.GetUavs()[0];
+
+    cmd.SetPipelineState(PSO_HIZ_BUILD);
+
+    const uint32_t work_group_x = CeilingDivision(uav->desc.width, HIZ_LOCAL_SIZE);
+    const uint32_t work_group_y = CeilingDivision(uav->desc.height, HIZ_LOCAL_SIZE);
+
+    cmd.Dispatch(work_group_x, work_group_y, 1);
+}
+
+void RenderGraphBuilderExt::AddGpuCullingPass() {
+    // one texel per HIZ_TILE_SIZE x HIZ_TILE_SIZE pixels, it keeps the farthest depth of the tile
+    const int width = CeilingDivision(m_config.frameWidth, HIZ_TILE_SIZE);
+    const int height = CeilingDivision(m_config.frameHeight, HIZ_TILE_SIZE);
+    auto hiz_desc = BuildDefaultTextureDesc(PixelFormat::R32_FLOAT,
+                                            AttachmentType::COLOR_2D,
+                                            width, height);
+
+    // the culling pass creates the hi-z, so it reads it before the hi-z pass overwrites it
+    auto& culling_pass = AddPass(RG_PASS_GPU_CULLING);
+    culling_pass.Create(RG_RES_HIZ, { hiz_desc, PointClampSampler() })
+        .Read(ResourceAccess::SRV, RG_RES_HIZ)
+        .SetExecuteFunc(GpuCullingPassFunc);
+    AddDependency(RG_PASS_GPU_CULLING, RG_PASS_EARLY_Z);
+
+    auto& hiz_pass = AddPass(RG_PASS_HIZ);
+    hiz_pass.Read(ResourceAccess::SRV, RG_RES_DEPTH_STENCIL)
+        .Read(ResourceAccess::UAV, RG_RES_HIZ)
+        .SetExecuteFunc(HiZPassFunc);
+    AddDependency(RG_PASS_GBUFFER, RG_PASS_HIZ);
+}
+
 static void EarlyZPassFunc(RenderPassExcutionContext& p_ctx) {
     RENDER_PASS_FUNC();
 
@@ -1055,6 +1179,7 @@ auto RenderGraphBuilderExt::Create3D(RenderGraphBuilderConfig& p_config) -> Resu
 
     RenderGraphBuilderExt builder(p_config);
 
+    builder.AddGpuCullingPass();
     builder.AddEarlyZPass();
     builder.AddGbufferPass();
     builder.AddGenerateSkylightPass();
@@ -12,6 +12,7 @@ public:
 private:
     void AddSprite();
 
+    void AddGpuCullingPass();
     void AddEarlyZPass();
     void AddGbufferPass();
     void AddHighlightPass();
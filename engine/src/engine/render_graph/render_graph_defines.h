@@ -7,6 +7,8 @@ constexpr const char RG_PASS_2D[] = "p:2d";
 constexpr const char RG_PASS_EARLY_Z[] = "p:early_z";
 constexpr const char RG_PASS_SHADOW[] = "p:shadow";
 constexpr const char RG_PASS_GBUFFER[] = "p:gbuffer";
+constexpr const char RG_PASS_GPU_CULLING[] = "p:gpu_culling";
+constexpr const char RG_PASS_HIZ[] = "p:hiz";
 constexpr const char RG_PASS_VOXELIZATION[] = "p:voxelization";
 constexpr const char RG_PASS_LIGHTING[] = "p:lighting";
 constexpr const char RG_PASS_FORWARD[] = "p:forward";
@@ -25,6 +27,7 @@ constexpr const char RG_RES_SHADOW_MAP[] = "r:shadow";
 constexpr const char RG_RES_GBUFFER_COLOR0[] = "r:gbuffer0";
 constexpr const char RG_RES_GBUFFER_COLOR1[] = "r:gbuffer1";
 constexpr const char RG_RES_GBUFFER_COLOR2[] = "r:gbuffer2";
+constexpr const char RG_RES_HIZ[] = "r:hiz";
 constexpr const char RG_RES_SSAO[] = "r:ssao";
 constexpr const char RG_RES_LIGHTING[] = "r:lighting";
 constexpr const char RG_RES_POST_PROCESS[] = "r:post_process";
@@ -35,6 +35,10 @@ void RenderPass::Execute(const FrameData& p_data, IRenderCmdContext& p_cmd) {
 
     p_cmd.BeginDrawPass(framebuffer);
 
+    // whatever ran between passes (backend helpers, imgui, compute work) may have bound a program
+    // behind the cache, every pass starts from an unknown pipeline
+    p_cmd.InvalidatePipelineState();
+
     m_executor(ctx);
 
     p_cmd.EndDrawPass(framebuffer);
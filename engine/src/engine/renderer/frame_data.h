@@ -1,4 +1,5 @@
 #pragma once
+#include "engine/core/base/arena_allocator.h"
 #include "engine/ecs/entity.h"
 #include "engine/math/aabb.h"
 #include "engine/math/angle.h"
@@ -10,10 +11,12 @@
 
 namespace my {
 #include "cbuffer.hlsl.h"
+#include "structured_buffer.hlsl.h"
 }  // namespace my
 
 namespace my {
 
+class RenderSlotTable;
 class Scene;
 // @TODO: get rid of this
 class TileMapComponent;
@@ -24,6 +27,8 @@ struct RenderOptions {
     bool vxgiEnabled{ false };
     bool bloomEnabled{ false };
     bool iblEnabled{ false };
+    bool instancingEnabled{ false };
+    bool debugGpuCulling{ false };
     int debugVoxelId{ 0 };
     int debugBvhDepth{ -1 };
     int voxelTextureSize{ 0 };
@@ -34,20 +39,30 @@ struct PassContext {
     int pass_idx{ 0 };
 };
 
-// @TODO: refactor this
+// Constant buffers deduplicated by content, objects with identical buffers share a slot.
+// Buffers are compared byte by byte, zero them so the padding compares equal.
 template<typename BUFFER>
 struct BufferCache {
-    std::vector<BUFFER> buffer;
-    std::unordered_map<ecs::Entity, uint32_t> lookup;
+    static_assert(std::is_trivially_copyable_v<BUFFER>);
 
-    uint32_t FindOrAdd(ecs::Entity p_entity, const BUFFER& p_buffer) {
-        auto it = lookup.find(p_entity);
-        if (it != lookup.end()) {
+    ArenaVector<BUFFER> buffer;
+    ArenaHashMap<size_t, uint32_t> lookup;
+
+    BufferCache(LinearAllocator& p_arena)
+        : buffer(p_arena)
+        , lookup(p_arena) {}
+
+    uint32_t FindOrAdd(const BUFFER& p_buffer) {
+        const std::string_view bytes(reinterpret_cast<const char*>(&p_buffer), sizeof(BUFFER));
+        const size_t hash = std::hash<std::string_view>{}(bytes);
+        auto it = lookup.find(hash);
+        if (it != lookup.end() && memcmp(&buffer[it->second], &p_buffer, sizeof(BUFFER)) == 0) {
             return it->second;
         }
 
-        uint32_t index = static_cast<uint32_t>(buffer.size());
-        lookup[p_entity] = index;
+        const uint32_t index = static_cast<uint32_t>(buffer.size());
+        // on a hash collision the first buffer keeps the entry
+        lookup.emplace(hash, index);
         buffer.emplace_back(p_buffer);
         return index;
     }
@@ -59,6 +74,9 @@ struct BufferCache {
 };
 
 struct FrameData {
+    // instance buffers a frame can fill, objects past that are drawn one by one
+    static constexpr uint32_t MAX_INSTANCE_BUFFER_COUNT = 64;
+
     struct Camera {
         Matrix4x4f viewMatrix;
         Matrix4x4f projectionMatrixRendering;
@@ -75,22 +93,43 @@ struct FrameData {
         Degree fovy;
     };
 
-    FrameData(const RenderOptions& p_options)
-        : options(p_options) {
+    // the containers allocate from p_arena, which must not be reset before the frame data is destroyed
+    FrameData(const RenderOptions& p_options, LinearAllocator& p_arena)
+        : options(p_options)
+        , arena(p_arena)
+        , materialCache(p_arena)
+        , passCache(p_arena)
+        , instanceCache(p_arena)
+        , shadow_pass_commands(p_arena)
+        , prepass_commands(p_arena)
+        , gbuffer_commands(p_arena)
+        , transparent_commands(p_arena)
+        , voxelization_commands(p_arena)
+        , tile_maps(p_arena)
+        , cullInstances(p_arena)
+        , culling_commands(p_arena)
+        , drawDebugContext{ .positions = ArenaVector<Vector3f>(p_arena), .colors = ArenaVector<Color>(p_arena), .drawCount = 0 } {
     }
 
     const RenderOptions options;
 
+    // scratch memory that lives as long as the frame data
+    LinearAllocator& arena;
+
     Camera mainCamera;
+    // main camera of the previous frame if that frame built a hi-z, the culling tests against it
+    const Camera* hizCamera{ nullptr };
 
     // @TODO: multi camera & viewport
 
     PerFrameConstantBuffer perFrameCache;
-    BufferCache<PerBatchConstantBuffer> batchCache;
+    // batch and bone slots, they live across frames and only the changed ranges are uploaded
+    const RenderSlotTable* slots{ nullptr };
     BufferCache<MaterialConstantBuffer> materialCache;
-    std::vector<PerPassConstantBuffer> passCache;
+    ArenaVector<PerPassConstantBuffer> passCache;
+    // world matrices of instanced draws, laid out like the bones so the shaders read them from c_bones
+    ArenaVector<BoneConstantBuffer> instanceCache;
     std::array<PointShadowConstantBuffer, MAX_POINT_LIGHT_SHADOW_COUNT * 6> pointShadowCache;
-    BufferCache<BoneConstantBuffer> boneCache;
     // std::vector<EmitterConstantBuffer> emitterCache;
 
     // @TODO: rename
@@ -100,12 +139,17 @@ struct FrameData {
     PassContext voxelPass;
     PassContext mainPass;
 
-    std::vector<RenderCommand> shadow_pass_commands;
-    std::vector<RenderCommand> prepass_commands;
-    std::vector<RenderCommand> gbuffer_commands;
-    std::vector<RenderCommand> transparent_commands;
-    std::vector<RenderCommand> voxelization_commands;
-    std::vector<RenderCommand> tile_maps;
+    ArenaVector<RenderCommand> shadow_pass_commands;
+    ArenaVector<RenderCommand> prepass_commands;
+    ArenaVector<RenderCommand> gbuffer_commands;
+    ArenaVector<RenderCommand> transparent_commands;
+    ArenaVector<RenderCommand> voxelization_commands;
+    ArenaVector<RenderCommand> tile_maps;
+
+    // opaque subsets tested by gpu_culling.cs, one thread per instance. debug only, nothing draws from its output
+    GpuCullConstants cullConstants;
+    ArenaVector<GpuCullInstance> cullInstances;
+    ArenaVector<RenderCommand> culling_commands;
 
     // std::vector<InstanceContext> instances;
 
@@ -121,8 +165,8 @@ struct FrameData {
     };
 
     struct DrawDebugContext {
-        std::vector<Vector3f> positions;
-        std::vector<Color> colors;
+        ArenaVector<Vector3f> positions;
+        ArenaVector<Color> colors;
         uint32_t drawCount;
     } drawDebugContext;
 
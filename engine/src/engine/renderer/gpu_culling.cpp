@@ -0,0 +1,69 @@
+#include "gpu_culling.h"
+
+#include "engine/math/frustum.h"
+
+namespace my {
+
+Vector2i GetHiZSize(int p_width, int p_height) {
+    return Vector2i(CeilingDivision(p_width, HIZ_TILE_SIZE), CeilingDivision(p_height, HIZ_TILE_SIZE));
+}
+
+CullingImage BuildHiZ(const CullingImage& p_depth) {
+    const Vector2i size = GetHiZSize(p_depth.width, p_depth.height);
+    const Vector2i depth_size(p_depth.width, p_depth.height);
+
+    CullingImage hiz;
+    hiz.width = size.x;
+    hiz.height = size.y;
+    hiz.texels.resize(size.x * size.y);
+    for (int y = 0; y < size.y; ++y) {
+        for (int x = 0; x < size.x; ++x) {
+            hiz.texels[y * size.x + x] = ReduceHiZTile(p_depth, depth_size, Vector2i(x, y));
+        }
+    }
+    return hiz;
+}
+
+Matrix4x4f BuildHiZMatrix(const Matrix4x4f& p_projection_view, bool p_is_opengl) {
+    // x and y from [-1, 1] to [0, 1], v goes down the rows of a D3D texture
+    const float v_scale = p_is_opengl ? 0.5f : -0.5f;
+    const Matrix4x4f uv_matrix{ 0.5f, 0.0f, 0.0f, 0.0f,
+                                0.0f, v_scale, 0.0f, 0.0f,
+                                0.0f, 0.0f, 1.0f, 0.0f,
+                                0.5f, 0.5f, 0.0f, 1.0f };
+    return uv_matrix * p_projection_view;
+}
+
+GpuCullConstants MakeCullConstants(const Frustum& p_frustum,
+                                   const Matrix4x4f* p_hiz_matrix,
+                                   const Vector2i& p_hiz_size,
+                                   uint32_t p_instance_count) {
+    GpuCullConstants constants;
+    for (int i = 0; i < 6; ++i) {
+        const Plane& plane = p_frustum[i];
+        constants.planes[i] = Vector4f(plane.normal, plane.dist);
+    }
+    constants.hizMatrix = p_hiz_matrix ? *p_hiz_matrix : Matrix4x4f(1.0f);
+    constants.hizSize = p_hiz_size;
+    constants.instanceCount = static_cast<int>(p_instance_count);
+    constants.hizEnabled = p_hiz_matrix != nullptr;
+    return constants;
+}
+
+uint32_t CullInstances(const GpuCullConstants& p_constants,
+                       const CullingImage& p_hiz,
+                       std::span<const GpuCullInstance> p_instances,
+                       std::span<GpuDrawIndirectArgs> p_out_args) {
+    DEV_ASSERT(p_instances.size() == static_cast<size_t>(p_constants.instanceCount));
+    DEV_ASSERT(p_out_args.size() >= p_instances.size());
+
+    uint32_t count = 0;
+    for (const GpuCullInstance& instance : p_instances) {
+        if (IsInstanceVisible(p_constants, p_hiz, instance)) {
+            p_out_args[count++] = MakeIndirectArgs(instance);
+        }
+    }
+    return count;
+}
+
+}  // namespace my
@@ -0,0 +1,56 @@
+#pragma once
+#include "engine/math/matrix.h"
+#include "engine/math/vector.h"
+
+namespace my {
+#include "structured_buffer.hlsl.h"
+}  // namespace my
+
+namespace my {
+
+class Frustum;
+
+// Single channel image read by the culling kernels, stands in for a Texture2D<float>.
+// Row 0 is the first row of the texture.
+struct CullingImage {
+    int width{ 0 };
+    int height{ 0 };
+    std::vector<float> texels;
+
+    float Load(const Vector3i& p_coord) const { return texels[p_coord.y * width + p_coord.x]; }
+};
+
+}  // namespace my
+
+namespace my {
+#include "gpu_culling.hlsl.h"
+}  // namespace my
+
+namespace my {
+
+// CPU reference of hiz_build.cs and gpu_culling.cs, runs the kernels of gpu_culling.hlsl.h one thread at a time.
+// The compute shader appends the visible instances in any order, CullInstances() keeps the instance order.
+
+// one hi-z texel per HIZ_TILE_SIZE x HIZ_TILE_SIZE pixels
+Vector2i GetHiZSize(int p_width, int p_height);
+
+// p_depth holds reversed depth, the hi-z keeps the farthest depth of every tile
+CullingImage BuildHiZ(const CullingImage& p_depth);
+
+// p_projection_view is the rendering matrix, its depth is already in [0, 1].
+// The matrix maps a world position to the hi-z uv in xy and the depth in z, rows of OpenGL textures go bottom up
+Matrix4x4f BuildHiZMatrix(const Matrix4x4f& p_projection_view, bool p_is_opengl);
+
+// p_hiz_matrix is null when there's no hi-z of the previous frame to test against
+GpuCullConstants MakeCullConstants(const Frustum& p_frustum,
+                                   const Matrix4x4f* p_hiz_matrix,
+                                   const Vector2i& p_hiz_size,
+                                   uint32_t p_instance_count);
+
+// writes the draw arguments of the visible instances to p_out_args, returns how many
+uint32_t CullInstances(const GpuCullConstants& p_constants,
+                       const CullingImage& p_hiz,
+                       std::span<const GpuCullInstance> p_instances,
+                       std::span<GpuDrawIndirectArgs> p_out_args);
+
+}  // namespace my
@@ -109,6 +109,7 @@ struct GpuBufferDesc {
     uint32_t slot{ 0 };  // remove this if possible
     uint32_t elementSize{ 0 };
     uint32_t elementCount{ 0 };
+    // first element written by UpdateBufferData()
     uint32_t offset{ 0 };
     const void* initialData{ nullptr };
 };
@@ -17,6 +17,8 @@ DVAR_BOOL(gfx_gpu_validation, DVAR_FLAG_NONE, "Enable GPU validation", true);
 DVAR_BOOL(gfx_debug_shadow, DVAR_FLAG_CACHE, "Debug shadow", false);
 DVAR_BOOL(gfx_enable_bloom, DVAR_FLAG_CACHE, "Enable Bloom", true);
 DVAR_BOOL(gfx_enable_ibl, DVAR_FLAG_CACHE, "Enable IBL", false);
+DVAR_BOOL(gfx_enable_instancing, DVAR_FLAG_CACHE, "Draw objects sharing a mesh with instanced draws", true);
+DVAR_BOOL(gfx_debug_gpu_culling, DVAR_FLAG_NONE, "Debug GPU culling, runs the culling kernels without drawing from their output", false);
 
 // SSAO
 DVAR_BOOL(gfx_ssao_enabled, DVAR_FLAG_CACHE, "Enable SSAO", true);
@@ -30,6 +32,8 @@ DVAR_INT(gfx_voxel_size, DVAR_FLAG_NONE, "Voxel size", 64);
 // path tracer
 DVAR_BOOL(gfx_bvh_generate, DVAR_FLAG_NONE, "Generate BVH", false);
 DVAR_INT(gfx_bvh_debug, DVAR_FLAG_NONE, "Debug BVH level", -1);
+DVAR_INT(gfx_pt_samples, DVAR_FLAG_NONE, "Samples per pixel of the tiled path tracer", 256);
+DVAR_STRING(gfx_pt_output, DVAR_FLAG_NONE, "Radiance .hdr file written once the tiled path tracer has all its samples", "");
 
 // shadow
 DVAR_INT(gfx_point_shadow_res, DVAR_FLAG_NONE, "Point shadow resolution", 1024);
@@ -11,6 +11,7 @@
 #include "engine/render_graph/render_graph_predefined.h"
 #include "engine/renderer/frame_data.h"
 #include "engine/renderer/graphics_dvars.h"
+#include "engine/renderer/render_slot_table.h"
 #include "engine/renderer/renderer_misc.h"
 #include "engine/renderer/sampler.h"
 #include "engine/runtime/application.h"
@@ -59,6 +60,70 @@ static auto CreateUniformCheckSize(GraphicsManager& p_graphics_manager, uint32_t
 }
 
 // @TODO: refactor this
+// uploads the slots written after p_version
+template<typename T>
+static void UpdateChangedSlots(GraphicsManager& p_graphics_manager,
+                               const GpuConstantBuffer* p_buffer,
+                               const std::vector<T>& p_slots,
+                               const std::vector<uint32_t>& p_versions,
+                               uint32_t p_version) {
+    bool updated = false;
+    RenderSlotTable::ForEachChangedRange(p_versions, p_version, [&](uint32_t p_begin, uint32_t p_end) {
+        p_graphics_manager.UpdateConstantBufferRange(p_buffer, p_slots.data(), sizeof(T) * (p_end - p_begin), sizeof(T) * p_begin);
+        updated = true;
+    });
+    // backends copying on bind keep a pointer to the slots, it has to be refreshed every frame
+    if (!updated) {
+        p_graphics_manager.UpdateConstantBufferRange(p_buffer, p_slots.data(), 0, 0);
+    }
+}
+
+// uploads the constants and instances of gpu_culling.cs and clears the count it appends to
+static void UpdateCullingBuffers(GraphicsManager& p_graphics_manager, FrameContext& p_frame, const FrameData& p_data) {
+    const uint32_t instance_count = static_cast<uint32_t>(p_data.cullInstances.size());
+    if (!p_frame.cullConstantBuffer) {
+        p_frame.cullConstantBuffer = *p_graphics_manager.CreateStructuredBuffer({
+            .elementSize = sizeof(GpuCullConstants),
+            .elementCount = 1,
+        });
+        p_frame.indirectCountBuffer = *p_graphics_manager.CreateStructuredBuffer({
+            .elementSize = sizeof(uint32_t),
+            .elementCount = 1,
+        });
+    }
+    if (instance_count > p_frame.cullCapacity) {
+        p_frame.cullCapacity = NextPowerOfTwo(instance_count);
+        p_frame.cullInstanceBuffer = *p_graphics_manager.CreateStructuredBuffer({
+            .elementSize = sizeof(GpuCullInstance),
+            .elementCount = p_frame.cullCapacity,
+        });
+        p_frame.indirectArgsBuffer = *p_graphics_manager.CreateStructuredBuffer({
+            .elementSize = sizeof(GpuDrawIndirectArgs),
+            .elementCount = p_frame.cullCapacity,
+        });
+    }
+
+    const uint32_t zero = 0;
+    p_graphics_manager.UpdateBufferData({
+                                            .elementSize = sizeof(GpuCullConstants),
+                                            .elementCount = 1,
+                                            .initialData = &p_data.cullConstants,
+                                        },
+                                        p_frame.cullConstantBuffer.get());
+    p_graphics_manager.UpdateBufferData({
+                                            .elementSize = sizeof(GpuCullInstance),
+                                            .elementCount = instance_count,
+                                            .initialData = p_data.cullInstances.data(),
+                                        },
+                                        p_frame.cullInstanceBuffer.get());
+    p_graphics_manager.UpdateBufferData({
+                                            .elementSize = sizeof(uint32_t),
+                                            .elementCount = 1,
+                                            .initialData = &zero,
+                                        },
+                                        p_frame.indirectCountBuffer.get());
+}
+
 template<typename T>
 static void CreateUniformBuffer(ConstantBuffer<T>& p_buffer) {
     GpuBufferDesc buffer_desc{};
@@ -94,6 +159,7 @@ auto GraphicsManager::InitializeImpl() -> Result<void> {
         frame_context.passCb = *::my::CreateUniformCheckSize<PerPassConstantBuffer>(*this, 32);
         frame_context.materialCb = *::my::CreateUniformCheckSize<MaterialConstantBuffer>(*this, 2048 * 16);
         frame_context.boneCb = *::my::CreateUniformCheckSize<BoneConstantBuffer>(*this, 16);
+        frame_context.instanceCb = *::my::CreateUniformCheckSize<BoneConstantBuffer>(*this, FrameData::MAX_INSTANCE_BUFFER_COUNT);
         frame_context.emitterCb = *::my::CreateUniformCheckSize<EmitterConstantBuffer>(*this, 32);
         frame_context.pointShadowCb = *::my::CreateUniformCheckSize<PointShadowConstantBuffer>(*this, 6 * MAX_POINT_LIGHT_SHADOW_COUNT);
         frame_context.perFrameCb = *::my::CreateUniformCheckSize<PerFrameConstantBuffer>(*this, 1);
@@ -104,6 +170,8 @@ auto GraphicsManager::InitializeImpl() -> Result<void> {
     if (auto res = m_pipelineStateManager->Initialize(); !res) {
         return HBN_ERROR(res.error());
     }
+    // creating a pipeline can bind programs, the OpenGL backend does to set uniforms
+    InvalidatePipelineState();
 
     // create meshes
     // @TODO: refactor
@@ -142,6 +210,11 @@ void GraphicsManager::EventReceived(std::shared_ptr<IEvent> p_event) {
 }
 
 void GraphicsManager::SetPipelineState(PipelineStateName p_name) {
+    if (p_name == m_pipelineState) {
+        ++GetCurrentFrame().drawStats.pipelineBindsSkipped;
+        return;
+    }
+    m_pipelineState = p_name;
     SetPipelineStateImpl(p_name);
 }
 
@@ -291,6 +364,9 @@ void GraphicsManager::Update(Scene& p_scene) {
     {
         HBN_PROFILE_EVENT("Render");
         BeginFrame();
+        // command lists are reset when a frame begins
+        InvalidatePipelineState();
+        GetCurrentFrame().drawStats = DrawStats();
 
         auto data = m_app->GetRenderSystem()->GetFrameData();
 
@@ -299,10 +375,16 @@ void GraphicsManager::Update(Scene& p_scene) {
 
         if (data) {
             auto& frame = GetCurrentFrame();
-            UpdateConstantBuffer(frame.batchCb.get(), data->batchCache.buffer);
+            if (const RenderSlotTable* slots = data->slots; slots) {
+                // every frame context has its own buffers, they catch up on what changed since they were last used
+                UpdateChangedSlots(*this, frame.batchCb.get(), slots->GetBatches(), slots->GetBatchVersions(), frame.batchVersion);
+                UpdateChangedSlots(*this, frame.boneCb.get(), slots->GetBones(), slots->GetBoneVersions(), frame.boneVersion);
+                frame.batchVersion = slots->GetVersion();
+                frame.boneVersion = slots->GetVersion();
+            }
             UpdateConstantBuffer(frame.materialCb.get(), data->materialCache.buffer);
-            UpdateConstantBuffer(frame.boneCb.get(), data->boneCache.buffer);
             UpdateConstantBuffer(frame.passCb.get(), data->passCache);
+            UpdateConstantBuffer(frame.instanceCb.get(), data->instanceCache);
             // UpdateConstantBuffer(frame.emitterCb.get(), data->emitterCache);
 
             UpdateConstantBuffer<PointShadowConstantBuffer, 6 * MAX_POINT_LIGHT_SHADOW_COUNT>(
@@ -314,6 +396,10 @@ void GraphicsManager::Update(Scene& p_scene) {
 
             BindConstantBufferSlot<PerFrameConstantBuffer>(frame.perFrameCb.get(), 0);
 
+            if (!data->cullInstances.empty()) {
+                UpdateCullingBuffers(*this, frame, *data);
+            }
+
             // @HACK
             switch (m_backend) {
                 case Backend::VULKAN:
@@ -31,14 +31,40 @@ struct GpuConstantBuffer;
 
 const char* ToString(RenderGraphName p_name);
 
+// Draw submission counters of a frame, the skipped binds were already set by the previous draw or pass
+struct DrawStats {
+    uint32_t drawCount{ 0 };
+    // objects drawn, an instanced draw counts all its instances
+    uint32_t instanceCount{ 0 };
+    uint32_t pipelineBindsSkipped{ 0 };
+    uint32_t meshBindsSkipped{ 0 };
+    uint32_t materialBindsSkipped{ 0 };
+    uint32_t boneBindsSkipped{ 0 };
+};
+
 struct FrameContext {
+    // counters of the last frame recorded with this context
+    DrawStats drawStats;
+
+    // RenderSlotTable version batchCb and boneCb were last uploaded at, 0 means never
+    uint32_t batchVersion{ 0 };
+    uint32_t boneVersion{ 0 };
+
     std::shared_ptr<GpuConstantBuffer> batchCb;
     std::shared_ptr<GpuConstantBuffer> materialCb;
     std::shared_ptr<GpuConstantBuffer> boneCb;
+    std::shared_ptr<GpuConstantBuffer> instanceCb;
     std::shared_ptr<GpuConstantBuffer> passCb;
     std::shared_ptr<GpuConstantBuffer> emitterCb;
     std::shared_ptr<GpuConstantBuffer> pointShadowCb;
     std::shared_ptr<GpuConstantBuffer> perFrameCb;
+
+    // gpu culling buffers, grown to fit the instances of a frame
+    uint32_t cullCapacity{ 0 };
+    std::shared_ptr<GpuStructuredBuffer> cullConstantBuffer;
+    std::shared_ptr<GpuStructuredBuffer> cullInstanceBuffer;
+    std::shared_ptr<GpuStructuredBuffer> indirectArgsBuffer;
+    std::shared_ptr<GpuStructuredBuffer> indirectCountBuffer;
 };
 
 class GraphicsManager : public IGraphicsManager {
@@ -62,6 +88,7 @@ public:
     auto CreateMesh(const MeshComponent& p_mesh) -> Result<std::shared_ptr<GpuMesh>> override;
 
     void SetPipelineState(PipelineStateName p_name) override;
+    void InvalidatePipelineState() override { m_pipelineState = PSO_NAME_MAX; }
 
     std::shared_ptr<GpuTexture> CreateTexture(const GpuTextureDesc& p_texture_desc, const SamplerDesc& p_sampler_desc) override;
     std::shared_ptr<GpuTexture> CreateTexture(ImageAsset* p_image) override;
@@ -109,6 +136,8 @@ protected:
     ConcurrentQueue<ImageAsset*> m_loadedImages;
 
     std::shared_ptr<PipelineStateManager> m_pipelineStateManager;
+    // bound pipeline, PSO_NAME_MAX when unknown
+    PipelineStateName m_pipelineState{ PSO_NAME_MAX };
     std::vector<std::shared_ptr<FrameContext>> m_frameContexts;
     int m_frameIndex{ 0 };
     const int m_frameCount;
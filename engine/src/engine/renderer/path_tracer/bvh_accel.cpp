@@ -1,76 +1,67 @@
 #include "bvh_accel.h"
 
 #include <algorithm>
+#include <bit>
+
+#include "engine/core/base/fixed_stack.h"
+#include "engine/systems/job_system/job_system.h"
 
 namespace my {
 
 using VertexList = std::vector<Vector3f>;
-using TriangleList = std::vector<Vector3i>;
-
-class BvhSorter;
 
+// Builds the flat node array in place. A node's children and its miss link only depend on
+// how many triangles go to each side, so every subtree knows where its nodes go before it's built
+// and subtrees can be built by different jobs without any synchronization.
 class BvhBuilder {
 public:
-    BvhBuilder(const VertexList& p_vertices,
-               const TriangleList& p_triangles);
-
-    BvhAccel::Ref ConstructHelper(const BvhAccel* p_parent, const std::vector<uint32_t>& p_indices) const;
+    BvhBuilder(const std::vector<uint32_t>& p_indices,
+               const VertexList& p_vertices,
+               std::vector<BvhAccel::Node>& p_nodes);
 
-    uint32_t GetBVHCount() const {
-        return m_bvhCounter;
-    }
+    void Build();
 
 private:
     BvhBuilder(const BvhBuilder&) = delete;
 
-    void SplitByAxis(BvhAccel* p_parent, const std::vector<uint32_t>& p_indices) const;
-    AABB AABBFromTriangles(const std::vector<uint32_t>& p_indices) const;
+    void BuildNode(int p_node, uint32_t p_begin, uint32_t p_end, int p_depth);
+    // partitions m_triangles[p_begin, p_end) and returns where the right child starts
+    uint32_t Split(uint32_t p_begin, uint32_t p_end, const AABB& p_centroid_bound, int p_depth);
+
+    // bins per axis for the SAH split
+    static constexpr int BIN_COUNT = 16;
+    // past this depth nodes are split at the median, so the depth is bounded even if SAH keeps
+    // cutting single triangles off
+    static constexpr int MAX_SAH_DEPTH = 48;
+    // each node above this depth builds its left child in a job, 31 jobs at most
+    static constexpr int PARALLEL_DEPTH = 5;
+    static constexpr uint32_t PARALLEL_MIN_TRIANGLES = 4096;
 
-    mutable uint32_t m_bvhCounter = 0;
+    const std::vector<uint32_t>& m_indices;
     const VertexList& m_vertices;
-    const TriangleList& m_triangles;
+    BvhAccel::Node* m_nodes;
+    int m_nodeCount;
+
+    // triangle ids, partitioned in place while building
+    std::vector<uint32_t> m_triangles;
     std::vector<AABB> m_aabbs;
     std::vector<Vector3f> m_centroids;
 
-    friend class BvhSorter;
-};
-
-class BvhSorter {
-public:
-    BvhSorter(int p_axis,
-              const BvhBuilder& p_builder)
-        : m_axis(p_axis), m_builder(p_builder) {}
-
-    bool operator()(uint32_t p_lhs, uint32_t p_rhs) const {
-        auto aabb_1 = m_builder.m_aabbs.at(p_lhs);
-        auto aabb_2 = m_builder.m_aabbs.at(p_rhs);
-        Vector3f center_1 = aabb_1.Center();
-        Vector3f center_2 = aabb_2.Center();
-        return center_1[m_axis] < center_2[m_axis];
-    }
-
-private:
-    const int m_axis;
-    const BvhBuilder& m_builder;
+    jobsystem::Context m_ctx;
 };
 
-BvhBuilder::BvhBuilder(const VertexList& p_vertices,
-                       const TriangleList& p_triangles)
-    : m_vertices(p_vertices), m_triangles(p_triangles) {
-    m_aabbs.resize(m_triangles.size());
-    m_centroids.resize(m_triangles.size());
-    for (size_t i = 0; i < m_triangles.size(); ++i) {
-        const auto& triangle = m_triangles[i];
-        const Vector3f& a = m_vertices.at(triangle.x);
-        const Vector3f& b = m_vertices.at(triangle.y);
-        const Vector3f& c = m_vertices.at(triangle.z);
-        m_centroids[i] = (1.0f / 3.0f) * (a + b + c);
-        m_aabbs[i].MakeInvalid();
-        m_aabbs[i].ExpandPoint(a);
-        m_aabbs[i].ExpandPoint(b);
-        m_aabbs[i].ExpandPoint(c);
-        m_aabbs[i].MakeValid();
-    }
+BvhBuilder::BvhBuilder(const std::vector<uint32_t>& p_indices,
+                       const VertexList& p_vertices,
+                       std::vector<BvhAccel::Node>& p_nodes)
+    : m_indices(p_indices), m_vertices(p_vertices) {
+    const uint32_t triangle_count = static_cast<uint32_t>(p_indices.size() / 3);
+    p_nodes.resize(2 * static_cast<size_t>(triangle_count) - 1);
+    m_nodes = p_nodes.data();
+    m_nodeCount = static_cast<int>(p_nodes.size());
+
+    m_triangles.resize(triangle_count);
+    m_aabbs.resize(triangle_count);
+    m_centroids.resize(triangle_count);
 }
 
 static int DominantAxis(const AABB& p_aabb) {
@@ -86,205 +77,273 @@ static int DominantAxis(const AABB& p_aabb) {
     return axis;
 }
 
-AABB BvhBuilder::AABBFromTriangles(const std::vector<uint32_t>& p_indices) const {
-    AABB aabb;
-    for (uint32_t index : p_indices) {
-        const auto& points = m_triangles[index];
-        aabb.ExpandPoint(m_vertices[points.x]);
-        aabb.ExpandPoint(m_vertices[points.y]);
-        aabb.ExpandPoint(m_vertices[points.z]);
-    }
-    aabb.MakeValid();
-    return aabb;
+// surface area without the validity check of Box::SurfaceArea(), boxes of triangles are always valid
+static float Area(const AABB& p_aabb) {
+    const Vector3f size = p_aabb.Size();
+    return 2.0f * (size.x * size.y + size.x * size.z + size.y * size.z);
 }
 
-void BvhBuilder::SplitByAxis(BvhAccel* p_parent,
-                             const std::vector<uint32_t>& p_indices) const {
-    auto indices = p_indices;
-    const int axis = DominantAxis(p_parent->aabb);
-    BvhSorter sorter(axis, *this);
-    std::sort(indices.begin(), indices.end(), sorter);
-    const size_t mid = indices.size() / 2;
-    std::vector<uint32_t> left(indices.begin(), indices.begin() + mid);
-    std::vector<uint32_t> right(indices.begin() + mid, indices.end());
-
-    p_parent->left = ConstructHelper(p_parent, left);
-    p_parent->right = ConstructHelper(p_parent, right);
+static int BinIndex(float p_value, float p_min, float p_scale, int p_bin_count) {
+    const int bin = static_cast<int>((p_value - p_min) * p_scale);
+    return glm::clamp(bin, 0, p_bin_count - 1);
 }
 
-BvhAccel::Ref BvhBuilder::ConstructHelper(const BvhAccel* p_parent, const std::vector<uint32_t>& p_indices) const {
-    const int depth = p_parent ? p_parent->depth + 1 : 0;
-    if (depth > 64) {
-        CRASH_NOW_MSG("TOO MANY LEVELS OF BVH");
-        return nullptr;
-    }
-
-    const int triangle_count = (int)p_indices.size();
-    const AABB parent_aabb = AABBFromTriangles(p_indices);
-    auto bvh = std::make_shared<BvhAccel>(m_bvhCounter++, p_parent);
-    bvh->aabb = parent_aabb;
-    bvh->depth = depth;
+void BvhBuilder::Build() {
+    auto prepare = [&](uint32_t p_index) {
+        const Vector3f& a = m_vertices[m_indices[3 * p_index + 0]];
+        const Vector3f& b = m_vertices[m_indices[3 * p_index + 1]];
+        const Vector3f& c = m_vertices[m_indices[3 * p_index + 2]];
+        m_triangles[p_index] = p_index;
+        m_centroids[p_index] = (1.0f / 3.0f) * (a + b + c);
+        AABB& aabb = m_aabbs[p_index];
+        aabb.MakeInvalid();
+        aabb.ExpandPoint(a);
+        aabb.ExpandPoint(b);
+        aabb.ExpandPoint(c);
+        aabb.MakeValid();
+    };
 
-    if (triangle_count == 1) {
-        bvh->isLeaf = true;
-        bvh->triangleIndex = p_indices[0];
-        return bvh;
+    const uint32_t triangle_count = static_cast<uint32_t>(m_triangles.size());
+#if USING(ENABLE_JOB_SYSTEM)
+    m_ctx.Dispatch(triangle_count, 4096, [&prepare](jobsystem::JobArgs p_args) { prepare(p_args.jobIndex); });
+    m_ctx.Wait();
+#else
+    for (uint32_t i = 0; i < triangle_count; ++i) {
+        prepare(i);
     }
+#endif
 
-    // @TODO: refactor
-    const float parent_surface = parent_aabb.SurfaceArea();
+    BuildNode(0, 0, triangle_count, 0);
+    m_ctx.Wait();
+}
 
-    // @TODO rework
-    if (triangle_count <= 4 || parent_surface == 0.0f) {
-        DEV_ASSERT(parent_surface > 0.0f);
-        SplitByAxis(bvh.get(), p_indices);
-        return bvh;
+void BvhBuilder::BuildNode(int p_node, uint32_t p_begin, uint32_t p_end, int p_depth) {
+    BvhAccel::Node& node = m_nodes[p_node];
+    const uint32_t count = p_end - p_begin;
+    const int subtree_end = p_node + 2 * static_cast<int>(count) - 1;
+    node.missIndex = subtree_end < m_nodeCount ? subtree_end : -1;
+
+    if (count == 1) {
+        const uint32_t triangle = m_triangles[p_begin];
+        node.min = m_aabbs[triangle].GetMin();
+        node.max = m_aabbs[triangle].GetMax();
+        node.triangleIndex = static_cast<int>(triangle);
+        return;
     }
 
-    constexpr int BUCKED_MAX = 12;
-    struct BucketInfo {
-        int count = 0;
-        AABB box;
-    };
-    std::array<BucketInfo, BUCKED_MAX> buckets;
-
-    AABB centroidBox;
-    for (const auto index : p_indices) {
-        const Vector3f& point = m_centroids.at(index);
-        centroidBox.ExpandPoint(point);
+    AABB bound;
+    AABB centroid_bound;
+    for (uint32_t i = p_begin; i < p_end; ++i) {
+        const uint32_t triangle = m_triangles[i];
+        bound.UnionBox(m_aabbs[triangle]);
+        centroid_bound.ExpandPoint(m_centroids[triangle]);
     }
-    centroidBox.MakeValid();
-
-    const int axis = DominantAxis(centroidBox);
-    const float tmin = centroidBox.GetMin()[axis];
-    const float tmax = centroidBox.GetMax()[axis];
-
-    for (int index : p_indices) {
-        float tmp = ((m_centroids.at(index)[axis] - tmin) * BUCKED_MAX) / (tmax - tmin);
-        int slot = static_cast<int>(tmp);
-        slot = clamp(slot, 0, BUCKED_MAX - 1);
-        BucketInfo& bucket = buckets[slot];
-        ++bucket.count;
-        bucket.box.UnionBox(m_aabbs.at(index));
+    node.min = bound.GetMin();
+    node.max = bound.GetMax();
+    node.triangleIndex = -1;
+
+    const uint32_t mid = Split(p_begin, p_end, centroid_bound, p_depth);
+    DEV_ASSERT(mid > p_begin && mid < p_end);
+    const int left = p_node + 1;
+    const int right = p_node + 2 * static_cast<int>(mid - p_begin);
+
+#if USING(ENABLE_JOB_SYSTEM)
+    if (p_depth < PARALLEL_DEPTH && count >= PARALLEL_MIN_TRIANGLES) {
+        m_ctx.Dispatch(1, 1, [this, left, p_begin, mid, p_depth](jobsystem::JobArgs) {
+            BuildNode(left, p_begin, mid, p_depth + 1);
+        });
+    } else {
+        BuildNode(left, p_begin, mid, p_depth + 1);
     }
+#else
+    BuildNode(left, p_begin, mid, p_depth + 1);
+#endif
+    BuildNode(right, mid, p_end, p_depth + 1);
+}
 
-    float costs[BUCKED_MAX - 1];
-    for (int i = 0; i < BUCKED_MAX - 1; ++i) {
-        AABB b0, b1;
-        int count0 = 0, count1 = 0;
-        for (int j = 0; j <= i; ++j) {
-            b0.UnionBox(buckets[j].box);
-            count0 += buckets[j].count;
-        }
-        for (int j = i + 1; j < BUCKED_MAX; ++j) {
-            b1.UnionBox(buckets[j].box);
-            count1 += buckets[j].count;
-        }
-
-        constexpr float travCost = 0.125f;
-        costs[i] = travCost + (count0 * b0.SurfaceArea() + count1 * b1.SurfaceArea()) / parent_surface;
+uint32_t BvhBuilder::Split(uint32_t p_begin, uint32_t p_end, const AABB& p_centroid_bound, int p_depth) {
+    const uint32_t count = p_end - p_begin;
+    if (count == 2) {
+        return p_begin + 1;
     }
 
-    int splitIndex = 0;
-    float minCost = costs[splitIndex];
-    for (int i = 0; i < BUCKED_MAX - 1; ++i) {
-        // printf("cost of split after bucket %d is %f\n", i, costs[i]);
-        if (costs[i] < minCost) {
-            splitIndex = i;
-            minCost = costs[splitIndex];
+    const Vector3f extent = p_centroid_bound.Size();
+    const Vector3f& centroid_min = p_centroid_bound.GetMin();
+
+    if (p_depth < MAX_SAH_DEPTH) {
+        // most nodes are small, no point having more bins than triangles
+        const int bin_count = glm::min(BIN_COUNT, static_cast<int>(count));
+        struct Bin {
+            AABB box;
+            uint32_t count = 0;
+        };
+        Bin bins[3][BIN_COUNT];
+        Vector3f scale;
+        for (int axis = 0; axis < 3; ++axis) {
+            scale[axis] = extent[axis] > 0.0f ? bin_count / extent[axis] : 0.0f;
         }
-    }
 
-    // printf("split index is %d\n", splitIndex);
-
-    std::vector<uint32_t> leftPartition;
-    std::vector<uint32_t> rightPartition;
-
-    for (auto index : p_indices) {
-        const auto& t = m_centroids.at(index);
-        float tmp = (t[axis] - tmin) / (tmax - tmin);
-        tmp *= BUCKED_MAX;
-        int slot = static_cast<int>(tmp);
-        slot = glm::clamp(slot, 0, BUCKED_MAX - 1);
-        if (slot <= splitIndex) {
-            leftPartition.push_back(index);
-        } else {
-            rightPartition.push_back(index);
+        for (uint32_t i = p_begin; i < p_end; ++i) {
+            const uint32_t triangle = m_triangles[i];
+            const Vector3f& centroid = m_centroids[triangle];
+            for (int axis = 0; axis < 3; ++axis) {
+                Bin& bin = bins[axis][BinIndex(centroid[axis], centroid_min[axis], scale[axis], bin_count)];
+                bin.box.UnionBox(m_aabbs[triangle]);
+                ++bin.count;
+            }
         }
-    }
-
-    bvh->left = ConstructHelper(bvh.get(), leftPartition);
-    bvh->right = ConstructHelper(bvh.get(), rightPartition);
-    return bvh;
-}
 
-void BvhAccel::DiscoverIdx() {
-    missIndex = -1;
+        // cost of splitting after bin i is count_left * area_left + count_right * area_right,
+        // the traversal cost and the parent area are the same for every candidate
+        float best_cost = std::numeric_limits<float>::infinity();
+        int best_axis = -1;
+        int best_bin = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (extent[axis] <= 0.0f) {
+                continue;
+            }
+
+            float right_costs[BIN_COUNT];
+            uint32_t right_counts[BIN_COUNT];
+            AABB right_box;
+            uint32_t right_count = 0;
+            for (int i = bin_count - 1; i > 0; --i) {
+                right_box.UnionBox(bins[axis][i].box);
+                right_count += bins[axis][i].count;
+                right_counts[i] = right_count;
+                right_costs[i] = right_count * Area(right_box);
+            }
+
+            AABB left_box;
+            uint32_t left_count = 0;
+            for (int i = 0; i < bin_count - 1; ++i) {
+                left_box.UnionBox(bins[axis][i].box);
+                left_count += bins[axis][i].count;
+                if (left_count == 0 || right_counts[i + 1] == 0) {
+                    continue;
+                }
+
+                const float cost = left_count * Area(left_box) + right_costs[i + 1];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_bin = i;
+                }
+            }
+        }
 
-    // hit link (find right link)
-    for (const BvhAccel* cursor = parent; cursor; cursor = cursor->parent) {
-        if (cursor->right && cursor->right->index > index) {
-            missIndex = cursor->right->index;
-            break;
+        if (best_axis != -1) {
+            const float axis_min = centroid_min[best_axis];
+            const float axis_scale = scale[best_axis];
+            auto it = std::partition(m_triangles.begin() + p_begin, m_triangles.begin() + p_end, [&](uint32_t p_triangle) {
+                return BinIndex(m_centroids[p_triangle][best_axis], axis_min, axis_scale, bin_count) <= best_bin;
+            });
+            return static_cast<uint32_t>(it - m_triangles.begin());
         }
     }
 
-    // if it's a hit, then check the left child node
-    // if there's not left child, treat it as a miss, so next bounding box to check is the miss node
-    hitIndex = left ? left->index : missIndex;
+    // too deep, or every centroid is at the same point
+    const int axis = DominantAxis(p_centroid_bound);
+    const uint32_t mid = p_begin + count / 2;
+    std::nth_element(m_triangles.begin() + p_begin, m_triangles.begin() + mid, m_triangles.begin() + p_end, [&](uint32_t p_lhs, uint32_t p_rhs) {
+        return m_centroids[p_lhs][axis] < m_centroids[p_rhs][axis];
+    });
+    return mid;
 }
 
-void BvhAccel::FillGpuBvhAccel(std::vector<GpuPtBvh>& p_out) {
-    DiscoverIdx();
-    DEV_ASSERT(aabb.IsValid());
-
-    GpuPtBvh gpu_bvh;
-    gpu_bvh.min = aabb.GetMin();
-    gpu_bvh.max = aabb.GetMax();
-    gpu_bvh.hitIdx = hitIndex;
-    gpu_bvh.missIdx = missIndex;
-    gpu_bvh.leaf = !!isLeaf;
-    gpu_bvh.triangleIndex = -1;
-    if (isLeaf) {
-        DEV_ASSERT(triangleIndex != -1);
-        gpu_bvh.triangleIndex = triangleIndex;
-    }
+void BvhAccel::FillGpuBvhAccel(std::vector<GpuPtBvh>& p_out) const {
+    const size_t offset = p_out.size();
+    p_out.resize(offset + nodes.size());
+    memcpy(p_out.data() + offset, nodes.data(), sizeof(Node) * nodes.size());
+}
 
-    p_out.push_back(gpu_bvh);
-    if (!isLeaf) {
-        DEV_ASSERT(left && right);
+uint32_t BvhAccel::Intersects(RayPacket& p_packet,
+                              uint32_t p_mask,
+                              const std::vector<uint32_t>& p_indices,
+                              const std::vector<Vector3f>& p_vertices,
+                              bool p_any_hit,
+                              int* p_out_triangles) const {
+    if (nodes.empty()) {
+        return 0;
     }
-    if (left) {
-        left->FillGpuBvhAccel(p_out);
+
+    Vector3f inv_directions[RayPacket::MAX_SIZE];
+    for (uint32_t i = 0; i < p_packet.count; ++i) {
+        inv_directions[i] = 1.0f / p_packet.directions[i];
     }
-    if (right) {
-        right->FillGpuBvhAccel(p_out);
+
+    struct StackEntry {
+        int node;
+        // rays that hit the parent
+        uint32_t mask;
+    };
+    // the builder switches to median splits after 48 levels, so the depth stays well below 128
+    FixedStack<StackEntry, 128> stack;
+    stack.push_back({ 0, p_mask });
+
+    uint32_t active = p_mask;
+    uint32_t hit = 0;
+    while (!stack.empty() && active) {
+        const StackEntry entry = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[entry.node];
+        const AABB aabb(node.min, node.max);
+
+        uint32_t mask = 0;
+        for (uint32_t rays = entry.mask & active; rays; rays &= rays - 1) {
+            const uint32_t i = std::countr_zero(rays);
+            if (TestIntersection::RaySegmentAabb(p_packet.starts[i], inv_directions[i], p_packet.dists[i], aabb)) {
+                mask |= 1u << i;
+            }
+        }
+        if (mask == 0) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            const size_t base = 3 * static_cast<size_t>(node.triangleIndex);
+            const Vector3f& a = p_vertices[p_indices[base + 0]];
+            const Vector3f& b = p_vertices[p_indices[base + 1]];
+            const Vector3f& c = p_vertices[p_indices[base + 2]];
+            for (uint32_t rays = mask; rays; rays &= rays - 1) {
+                const uint32_t i = std::countr_zero(rays);
+                if (TestIntersection::RayTriangle(a, b, c, p_packet.starts[i], p_packet.directions[i], p_packet.dists[i])) {
+                    hit |= 1u << i;
+                    p_out_triangles[i] = node.triangleIndex;
+                }
+            }
+            if (p_any_hit) {
+                active &= ~hit;
+            }
+            continue;
+        }
+
+        // the child closer to the first ray is visited first, so its hits prune the other one
+        const int left = GetLeftChild(entry.node);
+        const int right = GetRightChild(entry.node);
+        const Node& left_node = nodes[left];
+        const Node& right_node = nodes[right];
+        const Vector3f& direction = p_packet.directions[std::countr_zero(mask)];
+        const bool left_first = dot((left_node.min + left_node.max) - (right_node.min + right_node.max), direction) < 0.0f;
+        stack.push_back({ left_first ? right : left, mask });
+        stack.push_back({ left_first ? left : right, mask });
     }
+
+    return hit;
 }
 
 BvhAccel::Ref BvhAccel::Construct(const std::vector<uint32_t>& p_indices,
                                   const VertexList& p_vertices) {
+    DEV_ASSERT(p_indices.size() % 3 == 0);
 
-    const int index_count = (int)p_indices.size();
-    DEV_ASSERT(index_count % 3 == 0);
-    const int triangle_count = index_count / 3;
-
-    TriangleList triangles(triangle_count);
-    std::vector<uint32_t> triangle_indices(triangle_count);
-
-    // @TODO: centroid?
-    for (int i = 0; i < index_count; i += 3) {
-        const int index = i / 3;
-
-        const int a = p_indices[i];
-        const int b = p_indices[i + 1];
-        const int c = p_indices[i + 2];
-        triangles[index] = Vector3i(a, b, c);
-        triangle_indices[index] = index;
+    auto bvh = std::make_shared<BvhAccel>();
+    if (p_indices.empty()) {
+        return bvh;
     }
 
-    BvhBuilder builder(p_vertices, triangles);
-    return builder.ConstructHelper(nullptr, triangle_indices);
+    BvhBuilder builder(p_indices, p_vertices, bvh->nodes);
+    builder.Build();
+    return bvh;
 }
 
 }  // namespace my
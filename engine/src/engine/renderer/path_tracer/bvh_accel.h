@@ -1,5 +1,6 @@
 #pragma once
 #include "engine/math/aabb.h"
+#include "engine/math/ray.h"
 #include "engine/math/vector.h"
 
 namespace my {
@@ -8,32 +9,50 @@ namespace my {
 
 namespace my {
 
+// Bounding volume hierarchy over the triangles of a mesh, one triangle per leaf.
+// Nodes are stored in preorder in a flat array: the left child of an inner node is the next node,
+// the right child is where the left subtree ends. A subtree of n triangles takes exactly 2n - 1 nodes.
 struct BvhAccel {
     using Ref = std::shared_ptr<BvhAccel>;
 
-    BvhAccel(int p_index,
-             const BvhAccel* p_parent)
-        : index(p_index), parent(p_parent) {}
+    // same layout as GpuPtBvh, so the whole array can be copied to the gpu as is
+    struct alignas(32) Node {
+        Vector3f min;
+        // first node after the subtree, -1 if the subtree ends the tree
+        int missIndex;
+        Vector3f max;
+        // -1 for inner nodes
+        int triangleIndex;
 
-    void DiscoverIdx();
+        bool IsLeaf() const { return triangleIndex != -1; }
+    };
 
-    AABB aabb;
+    std::vector<Node> nodes;
 
-    const int index;
-    const BvhAccel* parent;
-
-    int triangleIndex{ -1 };
-    int hitIndex{ -1 };
-    int missIndex{ -1 };
-    int depth{ 0 };
-    Ref left{ nullptr };
-    Ref right{ nullptr };
-    bool isLeaf{ false };
+    int GetLeftChild(int p_node) const { return p_node + 1; }
+    int GetRightChild(int p_node) const { return nodes[p_node + 1].missIndex; }
 
+    // binned SAH build, the top levels are built in parallel
     static Ref Construct(const std::vector<uint32_t>& p_indices,
                          const std::vector<Vector3f>& p_vertices);
 
-    void FillGpuBvhAccel(std::vector<GpuPtBvh>& p_out);
+    // appends the nodes, indices are relative to the first appended node
+    void FillGpuBvhAccel(std::vector<GpuPtBvh>& p_out) const;
+
+    // Traces the rays in p_mask against the triangles the tree was built from, the rays are in the space of p_vertices.
+    // Rays that hit get their dist shortened and p_out_triangles[i] set, the mask of those rays is returned.
+    // With p_any_hit a ray stops at the first triangle it hits instead of the nearest one.
+    uint32_t Intersects(RayPacket& p_packet,
+                        uint32_t p_mask,
+                        const std::vector<uint32_t>& p_indices,
+                        const std::vector<Vector3f>& p_vertices,
+                        bool p_any_hit,
+                        int* p_out_triangles) const;
 };
 
+static_assert(sizeof(BvhAccel::Node) == sizeof(GpuPtBvh));
+static_assert(offsetof(BvhAccel::Node, missIndex) == offsetof(GpuPtBvh, missIdx));
+static_assert(offsetof(BvhAccel::Node, max) == offsetof(GpuPtBvh, max));
+static_assert(offsetof(BvhAccel::Node, triangleIndex) == offsetof(GpuPtBvh, triangleIndex));
+
 }  // namespace my
@@ -0,0 +1,469 @@
+#include "cpu_path_tracer.h"
+
+#include <bit>
+
+#include "engine/core/debugger/profiler.h"
+#include "engine/core/io/file_access.h"
+#include "engine/scene/scene.h"
+#include "engine/systems/job_system/job_system.h"
+
+#if USING(MATH_ENABLE_SIMD_SSE)
+#include "engine/math/detail/ray_sse.h"
+#endif
+
+namespace my {
+#include "shader_defines.hlsl.h"
+}  // namespace my
+
+namespace my {
+
+// same as the defines in shared_path_tracer.h
+static constexpr float PT_EPSILON = 1.1920929e-7f;
+static constexpr int PT_MAX_BOUNCE = 5;
+static constexpr float PT_RAY_T_MAX = 999999999.0f;
+static const Vector3f PT_SKY_COLOR(0.3f, 0.3f, 0.3f);
+
+static constexpr int LANE_COUNT = 4;
+static constexpr int ALL_LANES = (1 << LANE_COUNT) - 1;
+
+// WangHash(), Random() and RandomUnitVector() of shared_path_tracer.h
+static uint32_t WangHash(uint32_t& p_seed) {
+    p_seed = (p_seed ^ 61u) ^ (p_seed >> 16u);
+    p_seed *= 9u;
+    p_seed = p_seed ^ (p_seed >> 4);
+    p_seed *= 0x27d4eb2du;
+    p_seed = p_seed ^ (p_seed >> 15);
+    return p_seed;
+}
+
+static float Random(uint32_t& p_state) {
+    return static_cast<float>(WangHash(p_state)) / 4294967296.0f;
+}
+
+static Vector3f RandomUnitVector(uint32_t& p_state) {
+    const float z = Random(p_state) * 2.0f - 1.0f;
+    const float a = Random(p_state) * MY_TWO_PI;
+    const float r = glm::sqrt(1.0f - z * z);
+    return Vector3f(r * glm::cos(a), r * glm::sin(a), z);
+}
+
+// 4 rays in the space of one mesh, one lane per ray
+struct RayQuad {
+    alignas(16) float origin[3][LANE_COUNT];
+    alignas(16) float direction[3][LANE_COUNT];
+    alignas(16) float invDirection[3][LANE_COUNT];
+    alignas(16) float t[LANE_COUNT];
+    alignas(16) float u[LANE_COUNT];
+    alignas(16) float v[LANE_COUNT];
+
+    void Set(int p_lane, const Vector3f& p_origin, const Vector3f& p_direction, float p_t) {
+        for (int axis = 0; axis < 3; ++axis) {
+            origin[axis][p_lane] = p_origin[axis];
+            direction[axis][p_lane] = p_direction[axis];
+            invDirection[axis][p_lane] = 1.0f / p_direction[axis];
+        }
+        t[p_lane] = p_t;
+    }
+};
+
+struct LaneHit {
+    int meshId{ -1 };
+    int triangleId{ -1 };
+    float u{ 0.0f };
+    float v{ 0.0f };
+};
+
+// state of the path of one pixel
+struct PathLane {
+    Vector3f origin;
+    Vector3f direction;
+    float t;
+    Vector3f radiance;
+    Vector3f throughput;
+    uint32_t seed;
+};
+
+// returns the lanes whose ray enters the box
+static int IntersectBox(const RayQuad& p_quad, const GpuPtBvh& p_bvh) {
+#if USING(MATH_ENABLE_SIMD_SSE)
+    const __m128 origin[3] = { _mm_load_ps(p_quad.origin[0]), _mm_load_ps(p_quad.origin[1]), _mm_load_ps(p_quad.origin[2]) };
+    const __m128 inv_direction[3] = { _mm_load_ps(p_quad.invDirection[0]), _mm_load_ps(p_quad.invDirection[1]), _mm_load_ps(p_quad.invDirection[2]) };
+    return ray4_aabb_sse(origin, inv_direction, _mm_load_ps(p_quad.t), &p_bvh.min.x, &p_bvh.max.x);
+#else
+    int mask = 0;
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        float t_min = 0.0f;
+        float t_max = p_quad.t[lane];
+        for (int axis = 0; axis < 3; ++axis) {
+            const float t0 = (p_bvh.min[axis] - p_quad.origin[axis][lane]) * p_quad.invDirection[axis][lane];
+            const float t1 = (p_bvh.max[axis] - p_quad.origin[axis][lane]) * p_quad.invDirection[axis][lane];
+            t_min = glm::max(t_min, glm::min(t0, t1));
+            t_max = glm::min(t_max, glm::max(t0, t1));
+        }
+        mask |= (t_min <= t_max) << lane;
+    }
+    return mask;
+#endif
+}
+
+// returns the lanes that hit the triangle, their t, u and v are updated
+static int IntersectTriangle(RayQuad& p_quad, const Vector3f& p_a, const Vector3f& p_b, const Vector3f& p_c) {
+#if USING(MATH_ENABLE_SIMD_SSE)
+    const __m128 origin[3] = { _mm_load_ps(p_quad.origin[0]), _mm_load_ps(p_quad.origin[1]), _mm_load_ps(p_quad.origin[2]) };
+    const __m128 direction[3] = { _mm_load_ps(p_quad.direction[0]), _mm_load_ps(p_quad.direction[1]), _mm_load_ps(p_quad.direction[2]) };
+    __m128 t = _mm_load_ps(p_quad.t);
+    __m128 u = _mm_load_ps(p_quad.u);
+    __m128 v = _mm_load_ps(p_quad.v);
+    const int mask = ray4_triangle_sse(origin, direction, t, u, v, &p_a.x, &p_b.x, &p_c.x, PT_EPSILON);
+    if (mask) {
+        _mm_store_ps(p_quad.t, t);
+        _mm_store_ps(p_quad.u, u);
+        _mm_store_ps(p_quad.v, v);
+    }
+    return mask;
+#else
+    const Vector3f ab = p_b - p_a;
+    const Vector3f ac = p_c - p_a;
+    int mask = 0;
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        const Vector3f origin(p_quad.origin[0][lane], p_quad.origin[1][lane], p_quad.origin[2][lane]);
+        const Vector3f direction(p_quad.direction[0][lane], p_quad.direction[1][lane], p_quad.direction[2][lane]);
+        const Vector3f p = cross(direction, ac);
+        const float det = dot(ab, p);
+        if (det < PT_EPSILON) {
+            continue;
+        }
+
+        const float inv_det = 1.0f / det;
+        const Vector3f ao = origin - p_a;
+        const Vector3f q = cross(ao, ab);
+        const float u = dot(ao, p) * inv_det;
+        const float v = dot(direction, q) * inv_det;
+        if (u < 0.0f || v < 0.0f || u + v > 1.0f) {
+            continue;
+        }
+
+        const float t = dot(ac, q) * inv_det;
+        if (t >= p_quad.t[lane] || t < PT_EPSILON) {
+            continue;
+        }
+
+        p_quad.t[lane] = t;
+        p_quad.u[lane] = u;
+        p_quad.v[lane] = v;
+        mask |= 1 << lane;
+    }
+    return mask;
+#endif
+}
+
+// traces the rays of p_world_quad against the triangles of one mesh, t of the lanes that hit is shortened
+static void HitMesh(const GpuScene& p_scene, int p_mesh_id, RayQuad& p_world_quad, LaneHit* p_out_hits) {
+    const GpuPtMesh& mesh = p_scene.meshes[p_mesh_id];
+
+    RayQuad quad;
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        const Vector4f origin(p_world_quad.origin[0][lane], p_world_quad.origin[1][lane], p_world_quad.origin[2][lane], 1.0f);
+        const Vector4f direction(p_world_quad.direction[0][lane], p_world_quad.direction[1][lane], p_world_quad.direction[2][lane], 0.0f);
+        quad.Set(lane, (mesh.transformInv * origin).xyz, (mesh.transformInv * direction).xyz, p_world_quad.t[lane]);
+        quad.u[lane] = 0.0f;
+        quad.v[lane] = 0.0f;
+    }
+
+    int bvh_index = mesh.rootBvhId;
+    while (bvh_index >= 0) {
+        const GpuPtBvh& bvh = p_scene.bvhs[bvh_index];
+        if (!IntersectBox(quad, bvh)) {
+            bvh_index = bvh.missIdx;
+            continue;
+        }
+        if (bvh.triangleIndex == -1) {
+            ++bvh_index;
+            continue;
+        }
+
+        const Vector3i& indices = p_scene.indices[bvh.triangleIndex].tri;
+        const int hit = IntersectTriangle(quad,
+                                          p_scene.vertices[indices.x].position,
+                                          p_scene.vertices[indices.y].position,
+                                          p_scene.vertices[indices.z].position);
+        for (int lanes = hit; lanes; lanes &= lanes - 1) {
+            const int lane = std::countr_zero(static_cast<uint32_t>(lanes));
+            p_out_hits[lane] = { p_mesh_id, bvh.triangleIndex, quad.u[lane], quad.v[lane] };
+        }
+        bvh_index = bvh.missIdx;
+    }
+
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        p_world_quad.t[lane] = quad.t[lane];
+    }
+}
+
+// HitScene() of shared_path_tracer.h for the lanes in p_mask
+static void HitScene(const GpuScene& p_scene, PathLane* p_lanes, int p_mask, LaneHit* p_out_hits) {
+    RayQuad quad;
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        if (p_mask & (1 << lane)) {
+            const PathLane& path = p_lanes[lane];
+            quad.Set(lane, path.origin, path.direction, path.t);
+        } else {
+            // a negative t never hits anything
+            quad.Set(lane, Vector3f(0.0f), Vector3f(1.0f), -1.0f);
+        }
+    }
+
+    // the top level tree over the meshes starts at node 0, a leaf holds the mesh id in triangleIndex
+    int tlas_index = p_scene.meshes.empty() ? -1 : 0;
+    while (tlas_index >= 0) {
+        const GpuPtBvh& tlas = p_scene.bvhs[tlas_index];
+        if (!IntersectBox(quad, tlas)) {
+            tlas_index = tlas.missIdx;
+            continue;
+        }
+        if (tlas.triangleIndex == -1) {
+            ++tlas_index;
+            continue;
+        }
+
+        HitMesh(p_scene, tlas.triangleIndex, quad, p_out_hits);
+        tlas_index = tlas.missIdx;
+    }
+
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        if (p_mask & (1 << lane)) {
+            p_lanes[lane].t = quad.t[lane];
+        }
+    }
+}
+
+// RayColor() of shared_path_tracer.h, all lanes bounce together until their paths end
+static void RayColor(const GpuScene& p_scene, PathLane* p_lanes, int p_mask) {
+    for (int bounce = 0; bounce < PT_MAX_BOUNCE && p_mask; ++bounce) {
+        LaneHit hits[LANE_COUNT];
+        HitScene(p_scene, p_lanes, p_mask, hits);
+
+        for (int lanes = p_mask; lanes; lanes &= lanes - 1) {
+            const int lane = std::countr_zero(static_cast<uint32_t>(lanes));
+            PathLane& path = p_lanes[lane];
+            const LaneHit& hit = hits[lane];
+            if (hit.meshId < 0) {
+                path.radiance += PT_SKY_COLOR * path.throughput;
+                p_mask &= ~(1 << lane);
+                continue;
+            }
+
+            path.origin = path.origin + path.t * path.direction;
+            path.t = PT_RAY_T_MAX;
+
+            const GpuPtMesh& mesh = p_scene.meshes[hit.meshId];
+            const Vector3i& indices = p_scene.indices[hit.triangleId].tri;
+            const Vector3f& n1 = p_scene.vertices[indices.x].normal;
+            const Vector3f& n2 = p_scene.vertices[indices.y].normal;
+            const Vector3f& n3 = p_scene.vertices[indices.z].normal;
+            Vector3f n = n1 + hit.u * (n2 - n1) + hit.v * (n3 - n1);
+            n = normalize(Vector3f((mesh.transform * Vector4f(n, 0.0f)).xyz));
+
+            const GpuPtMaterial& material = p_scene.materials[mesh.materialId];
+            const float reflect_chance = Random(path.seed) > material.metallic ? 0.0f : 1.0f;
+
+            const Vector3f diffuse_dir = normalize(n + RandomUnitVector(path.seed));
+            Vector3f reflect_dir = path.direction - 2.0f * dot(path.direction, n) * n;
+            reflect_dir = normalize(lerp(reflect_dir, diffuse_dir, material.roughness * material.roughness));
+
+            path.direction = normalize(lerp(diffuse_dir, reflect_dir, reflect_chance));
+
+            path.radiance += material.emissive * path.throughput;
+            path.throughput *= material.baseColor;
+        }
+    }
+}
+
+void CpuPathTracer::SetScene(const Scene& p_scene) {
+    BuildGpuScene(p_scene, m_scene);
+    ResetAccumulation();
+}
+
+void CpuPathTracer::UpdateScene(const Scene& p_scene) {
+    GpuSceneDelta delta;
+    if (!RefitGpuScene(p_scene, m_scene, delta)) {
+        SetScene(p_scene);
+        return;
+    }
+
+    if (delta.meshBegin < delta.meshEnd) {
+        ResetAccumulation();
+    }
+}
+
+void CpuPathTracer::SetCamera(const CameraComponent& p_camera) {
+    Camera camera;
+    camera.position = p_camera.GetPosition();
+    camera.forward = p_camera.GetFront();
+    camera.right = p_camera.GetRight();
+    camera.up = cross(camera.forward, camera.right);
+    camera.fovDegree = p_camera.GetFovy().GetDegree();
+
+    const int width = p_camera.GetWidth();
+    const int height = p_camera.GetHeight();
+    if (camera == m_camera && width == m_width && height == m_height) {
+        return;
+    }
+
+    m_camera = camera;
+    m_width = width;
+    m_height = height;
+    m_image.resize(static_cast<size_t>(m_width) * m_height);
+    ResetAccumulation();
+}
+
+void CpuPathTracer::ResetAccumulation() {
+    m_sampleCount = 0;
+}
+
+void CpuPathTracer::RenderSample() {
+    HBN_PROFILE_EVENT();
+
+    if (m_width <= 0 || m_height <= 0) {
+        return;
+    }
+
+    const int tile_x_count = (m_width + TILE_SIZE - 1) / TILE_SIZE;
+    const int tile_y_count = (m_height + TILE_SIZE - 1) / TILE_SIZE;
+    const uint32_t tile_count = static_cast<uint32_t>(tile_x_count * tile_y_count);
+    auto render_tile = [&](uint32_t p_index) {
+        RenderTile(p_index % tile_x_count, p_index / tile_x_count);
+    };
+
+#if USING(ENABLE_JOB_SYSTEM)
+    jobsystem::Context ctx;
+    ctx.Dispatch(tile_count, 1, [&render_tile](jobsystem::JobArgs p_args) { render_tile(p_args.jobIndex); });
+    ctx.Wait();
+#else
+    for (uint32_t i = 0; i < tile_count; ++i) {
+        render_tile(i);
+    }
+#endif
+
+    ++m_sampleCount;
+}
+
+void CpuPathTracer::RenderTile(int p_tile_x, int p_tile_y) {
+    const Vector2f resolution(static_cast<float>(m_width), static_cast<float>(m_height));
+    const float aspect_ratio = resolution.x / resolution.y;
+    const float cam_distance = glm::tan(m_camera.fovDegree * MY_PI / 180.0f);
+
+    const int x_begin = p_tile_x * TILE_SIZE;
+    const int y_begin = p_tile_y * TILE_SIZE;
+    const int x_end = glm::min(x_begin + TILE_SIZE, m_width);
+    const int y_end = glm::min(y_begin + TILE_SIZE, m_height);
+
+    // 2x2 pixels per quad, neighbouring primary rays stay close in the trees
+    for (int y = y_begin; y < y_end; y += 2) {
+        for (int x = x_begin; x < x_end; x += 2) {
+            PathLane lanes[LANE_COUNT];
+            int mask = 0;
+            for (int lane = 0; lane < LANE_COUNT; ++lane) {
+                const int pixel_x = x + (lane & 1);
+                const int pixel_y = y + (lane >> 1);
+                if (pixel_x >= x_end || pixel_y >= y_end) {
+                    continue;
+                }
+                mask |= 1 << lane;
+
+                // camera ray of path_tracer.cs, the sample count takes the place of the frame index
+                PathLane& path = lanes[lane];
+                path.seed = (static_cast<uint32_t>(pixel_x) * 1973u + static_cast<uint32_t>(pixel_y) * 9277u + m_sampleCount * 26699u) | 1u;
+                const float jitter_x = Random(path.seed) - 0.5f;
+                const float jitter_y = Random(path.seed) - 0.5f;
+                const Vector2f uv_jitter = (Vector2f(static_cast<float>(pixel_x), static_cast<float>(pixel_y)) + Vector2f(jitter_x, jitter_y)) / resolution;
+                Vector2f screen = 2.0f * uv_jitter - 1.0f;
+                screen.y /= aspect_ratio;
+
+                path.origin = m_camera.position;
+                path.direction = normalize(screen.x * m_camera.right + screen.y * m_camera.up + cam_distance * m_camera.forward);
+                path.t = PT_RAY_T_MAX;
+                path.radiance = Vector3f(0.0f);
+                path.throughput = Vector3f(1.0f);
+            }
+
+            RayColor(m_scene, lanes, mask);
+
+            for (int lanes_left = mask; lanes_left; lanes_left &= lanes_left - 1) {
+                const int lane = std::countr_zero(static_cast<uint32_t>(lanes_left));
+                Vector4f& accumulated = m_image[(y + (lane >> 1)) * m_width + x + (lane & 1)];
+                const Vector3f& radiance = lanes[lane].radiance;
+                if (m_sampleCount == 0) {
+                    accumulated = Vector4f(radiance, 1.0f);
+                    continue;
+                }
+
+                const float weight = accumulated.w;
+                const Vector3f new_color = (radiance + weight * Vector3f(accumulated.xyz)) / (weight + 1.0f);
+                accumulated = Vector4f(new_color, weight + 1.0f);
+            }
+        }
+    }
+}
+
+// shared exponent encoding of Radiance .hdr files
+static void FloatToRgbe(const Vector3f& p_color, uint8_t* p_out) {
+    const float max_component = glm::max(p_color.r, glm::max(p_color.g, p_color.b));
+    if (max_component < 1e-32f) {
+        p_out[0] = p_out[1] = p_out[2] = p_out[3] = 0;
+        return;
+    }
+
+    int exponent;
+    const float scale = std::frexp(max_component, &exponent) * 256.0f / max_component;
+    p_out[0] = static_cast<uint8_t>(p_color.r * scale);
+    p_out[1] = static_cast<uint8_t>(p_color.g * scale);
+    p_out[2] = static_cast<uint8_t>(p_color.b * scale);
+    p_out[3] = static_cast<uint8_t>(exponent + 128);
+}
+
+auto CpuPathTracer::WriteHdr(std::string_view p_path) const -> Result<void> {
+    auto res = FileAccess::Open(p_path, FileAccess::WRITE);
+    if (!res) {
+        return HBN_ERROR(res.error());
+    }
+
+    auto file = *res;
+    const std::string header = std::format("#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y {} +X {}\n", m_height, m_width);
+    file->WriteBuffer(header.data(), header.size());
+
+    std::vector<uint8_t> rgbe(4 * static_cast<size_t>(m_width));
+    // scanlines are written run length encoded with literal runs only, flat scanlines can be mistaken
+    // for encoded ones by readers when the first pixel starts with 2, 2. readers only expect encoded
+    // scanlines for widths in [8, 32767], other widths are written flat
+    const bool run_length_encoded = m_width >= 8 && m_width <= 0x7FFF;
+    std::vector<uint8_t> scanline;
+    scanline.reserve(rgbe.size() + 4 + 4 * (m_width / 128 + 1));
+    // -Y, the first scanline is the top of the image
+    for (int y = m_height - 1; y >= 0; --y) {
+        for (int x = 0; x < m_width; ++x) {
+            FloatToRgbe(m_image[y * m_width + x].xyz, &rgbe[4 * x]);
+        }
+
+        if (!run_length_encoded) {
+            file->WriteBuffer(rgbe.data(), rgbe.size());
+            continue;
+        }
+
+        scanline.clear();
+        scanline.insert(scanline.end(), { 2, 2, static_cast<uint8_t>(m_width >> 8), static_cast<uint8_t>(m_width & 0xFF) });
+        for (int channel = 0; channel < 4; ++channel) {
+            for (int x = 0; x < m_width; x += 128) {
+                const int count = glm::min(128, m_width - x);
+                scanline.push_back(static_cast<uint8_t>(count));
+                for (int i = x; i < x + count; ++i) {
+                    scanline.push_back(rgbe[4 * i + channel]);
+                }
+            }
+        }
+        file->WriteBuffer(scanline.data(), scanline.size());
+    }
+
+    return Result<void>();
+}
+
+}  // namespace my
@@ -0,0 +1,61 @@
+#pragma once
+#include "engine/renderer/path_tracer/path_tracer.h"
+
+namespace my {
+
+class CameraComponent;
+
+// Path tracer running on the job system, for machines without a gpu and for offline renders.
+// It traces the same GpuScene as path_tracer.cs and follows RayColor() in shared_path_tracer.h,
+// the image holds the running average in rgb and the sample count in alpha, like the compute shader's output.
+// The image is split in TILE_SIZE x TILE_SIZE tiles, one job per tile, rays are traced 2x2 pixels at a time.
+class CpuPathTracer {
+public:
+    static constexpr int TILE_SIZE = 16;
+
+    // copies the meshes, instances and materials of p_scene, starts accumulating over
+    void SetScene(const Scene& p_scene);
+    // picks up moved instances, starts accumulating over if any moved
+    void UpdateScene(const Scene& p_scene);
+    // takes the position, orientation, field of view and resolution of p_camera,
+    // starts accumulating over if any of them changed
+    void SetCamera(const CameraComponent& p_camera);
+
+    void ResetAccumulation();
+
+    // adds one sample to every pixel
+    void RenderSample();
+
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    uint32_t GetSampleCount() const { return m_sampleCount; }
+    // row 0 is the bottom of the image
+    const std::vector<Vector4f>& GetImage() const { return m_image; }
+
+    // Radiance .hdr
+    auto WriteHdr(std::string_view p_path) const -> Result<void>;
+
+private:
+    struct Camera {
+        Vector3f position{ 0 };
+        Vector3f forward{ 0 };
+        Vector3f right{ 0 };
+        Vector3f up{ 0 };
+        float fovDegree{ 0 };
+
+        bool operator==(const Camera&) const = default;
+    };
+
+    void RenderTile(int p_tile_x, int p_tile_y);
+
+    GpuScene m_scene;
+
+    Camera m_camera;
+    int m_width{ 0 };
+    int m_height{ 0 };
+
+    std::vector<Vector4f> m_image;
+    uint32_t m_sampleCount{ 0 };
+};
+
+}  // namespace my
@@ -3,8 +3,11 @@
 #include <algorithm>
 
 #include "engine/core/os/timer.h"
+#include "engine/renderer/graphics_dvars.h"
 #include "engine/renderer/graphics_manager.h"
 #include "engine/renderer/path_tracer/bvh_accel.h"
+#include "engine/renderer/path_tracer/cpu_path_tracer.h"
+#include "engine/renderer/path_tracer/top_level_bvh.h"
 #include "engine/runtime/asset_registry.h"
 #include "engine/scene/scene.h"
 
@@ -29,35 +32,13 @@ static auto CreateBuffer(IGraphicsManager* p_gm, uint32_t p_slot, const std::vec
     return p_gm->CreateStructuredBuffer(desc);
 }
 
-static void ConstructMesh(const MeshComponent& p_mesh, GpuScene& p_gpu_scene) {
-    if (!p_mesh.bvh) {
-        p_mesh.bvh = BvhAccel::Construct(p_mesh.indices, p_mesh.positions);
-    }
-
-    p_mesh.bvh->FillGpuBvhAccel(p_gpu_scene.bvhs);
-    for (size_t i = 0; i < p_mesh.positions.size(); ++i) {
-        GpuPtVertex vertex;
-        vertex.position = p_mesh.positions[i];
-        vertex.normal = p_mesh.normals[i];
-        p_gpu_scene.vertices.emplace_back(vertex);
-    }
-
-    for (size_t i = 0; i < p_mesh.indices.size(); i += 3) {
-        GpuPtIndex index;
-        index.tri = Vector3i(p_mesh.indices[i],
-                             p_mesh.indices[i + 1],
-                             p_mesh.indices[i + 2]);
-        p_gpu_scene.indices.emplace_back(index);
-    }
-}
-
-void PathTracer::Update(const Scene& p_scene) {
+void PathTracer::Update(const CameraComponent& p_camera, const Scene& p_scene) {
     switch (m_mode) {
         case PathTracerMode::NONE:
             return;
         case PathTracerMode::TILED:
-            LOG_ERROR("Not implmeneted");
-            [[fallthrough]];
+            UpdateTiled(p_camera, p_scene);
+            return;
         case PathTracerMode::INTERACTIVE:
             break;
         default:
@@ -65,13 +46,48 @@ void PathTracer::Update(const Scene& p_scene) {
             return;
     }
 
-    if (!m_ptIndexBuffer) {
+    if (!m_ptBvhBuffer) {
         CreateAccelStructure(p_scene);
+        return;
+    }
+
+    if (p_scene.GetDirtyFlags() & SCENE_DIRTY_WORLD) {
+        UpdateAccelStructure(p_scene);
+    }
+}
+
+void PathTracer::UpdateTiled(const CameraComponent& p_camera, const Scene& p_scene) {
+    if (!m_cpuPathTracer) {
+        m_cpuPathTracer = std::make_shared<CpuPathTracer>();
+        m_cpuPathTracer->SetScene(p_scene);
+    } else if (p_scene.GetDirtyFlags() & SCENE_DIRTY_WORLD) {
+        m_cpuPathTracer->UpdateScene(p_scene);
+    }
+
+    auto& tracer = *m_cpuPathTracer;
+    tracer.SetCamera(p_camera);
+
+    const uint32_t sample_count = static_cast<uint32_t>(DVAR_GET_INT(gfx_pt_samples));
+    if (tracer.GetSampleCount() >= sample_count) {
+        return;
+    }
+
+    tracer.RenderSample();
+    if (tracer.GetSampleCount() < sample_count) {
+        return;
     }
 
-    std::vector<GpuPtMesh> meshes;
-    UpdateAccelStructure(p_scene);
-    // @TODO: update mesh buffers
+    const std::string& output = DVAR_GET_STRING(gfx_pt_output);
+    if (output.empty()) {
+        return;
+    }
+
+    if (auto res = tracer.WriteHdr(output); !res) {
+        LOG_ERROR("failed to write '{}'", output);
+        return;
+    }
+
+    LOG("path tracer: {} samples written to '{}'", sample_count, output);
 }
 
 static void AppendVertices(const std::vector<GpuPtVertex>& p_source, std::vector<GpuPtVertex>& p_dest) {
@@ -114,7 +130,6 @@ static void AppendBvhs(const std::vector<GpuPtBvh>& p_source, std::vector<GpuPtB
         auto& dest = p_dest[i + offset];
         dest = source;
 
-        adjust_index(dest.hitIdx);
         adjust_index(dest.missIdx);
         if (dest.triangleIndex >= 0) {
             dest.triangleIndex += p_index_offset;
@@ -122,136 +137,206 @@ static void AppendBvhs(const std::vector<GpuPtBvh>& p_source, std::vector<GpuPtB
     }
 }
 
-void PathTracer::UpdateAccelStructure(const Scene& p_scene) {
-    const auto dirty_flag = p_scene.GetDirtyFlags();
-    auto gm = GraphicsManager::GetSingletonPtr();
-
-    std::map<ecs::Entity, int> materials_lookup;
-    {
-        std::vector<GpuPtMaterial> materials;
-        for (auto mesh_it : m_meshs) {
-            auto material_id = mesh_it.second.materialId;
-            auto mat_it = materials_lookup.find(material_id);
-            if (mat_it != materials_lookup.end()) {
-                continue;
-            }
+static void ConstructMesh(const MeshComponent& p_mesh, GpuScene& p_gpu_scene) {
+    if (!p_mesh.bvh) {
+        p_mesh.bvh = BvhAccel::Construct(p_mesh.indices, p_mesh.positions);
+    }
 
-            const auto material = p_scene.GetComponent<MaterialComponent>(material_id);
-            DEV_ASSERT(material);
+    p_mesh.bvh->FillGpuBvhAccel(p_gpu_scene.bvhs);
+    for (size_t i = 0; i < p_mesh.positions.size(); ++i) {
+        GpuPtVertex vertex;
+        vertex.position = p_mesh.positions[i];
+        vertex.normal = p_mesh.normals[i];
+        p_gpu_scene.vertices.emplace_back(vertex);
+    }
 
-            materials_lookup[material_id] = (int)materials.size();
+    for (size_t i = 0; i < p_mesh.indices.size(); i += 3) {
+        GpuPtIndex index;
+        index.tri = Vector3i(p_mesh.indices[i],
+                             p_mesh.indices[i + 1],
+                             p_mesh.indices[i + 2]);
+        p_gpu_scene.indices.emplace_back(index);
+    }
+}
 
-            GpuPtMaterial gpu_mat;
-            gpu_mat.baseColor = material->baseColor.xyz;
-            gpu_mat.emissive = gpu_mat.baseColor * material->emissive;
-            gpu_mat.roughness = material->roughness;
-            gpu_mat.metallic = material->metallic;
-            materials.emplace_back(gpu_mat);
-        }
+int AppendGpuPtMesh(const MeshComponent& p_mesh, GpuScene& p_gpu_scene) {
+    const int bvh_count = (int)p_gpu_scene.bvhs.size();
+    const int index_count = (int)p_gpu_scene.indices.size();
+    const int vertex_count = (int)p_gpu_scene.vertices.size();
 
-        GpuBufferDesc desc{
-            .slot = GetGlobalPtMeshesSlot(),
-            .elementSize = sizeof(materials[0]),
-            .elementCount = static_cast<uint32_t>(materials.size()),
-            .initialData = materials.data(),
-        };
+    GpuScene tmp_scene;
+    ConstructMesh(p_mesh, tmp_scene);
+
+    AppendVertices(tmp_scene.vertices, p_gpu_scene.vertices);
+    AppendIndices(tmp_scene.indices, p_gpu_scene.indices, vertex_count);
+    AppendBvhs(tmp_scene.bvhs, p_gpu_scene.bvhs, index_count);
+    return bvh_count;
+}
 
-        // @TODO: only change when material is dirty
-        if ((dirty_flag != SCENE_DIRTY_NONE) || m_ptMaterialBuffer == nullptr) {
-            m_ptMaterialBuffer = *gm->CreateStructuredBuffer(desc);
+GpuPtMaterial MakeGpuPtMaterial(const MaterialComponent& p_material) {
+    GpuPtMaterial gpu_mat;
+    gpu_mat.baseColor = p_material.baseColor.xyz;
+    gpu_mat.emissive = gpu_mat.baseColor * p_material.emissive;
+    gpu_mat.roughness = p_material.roughness;
+    gpu_mat.metallic = p_material.metallic;
+    return gpu_mat;
+}
+
+template<typename FUNC>
+static void ForEachInstance(const Scene& p_scene, FUNC&& p_func) {
+    for (auto [id, object] : p_scene.View<MeshRendererComponent>()) {
+        const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(id);
+        const MeshComponent* mesh = p_scene.GetComponent<MeshComponent>(object.meshId);
+        if (!transform || !mesh || mesh->indices.empty() || mesh->subsets.empty()) {
+            continue;
         }
+
+        p_func(id, *transform, object.meshId, *mesh);
     }
+}
 
-    {
-        const auto view = p_scene.View<MeshRendererComponent>();
-
-        std::vector<GpuPtMesh> meshes;
-        meshes.reserve(view.GetSize());
-        for (auto [id, object] : view) {
-            auto transform = p_scene.GetComponent<TransformComponent>(id);
-            auto mesh = p_scene.GetComponent<MeshComponent>(object.meshId);
-            if (DEV_VERIFY(transform && mesh)) {
-                auto mesh_it = m_meshs.find(object.meshId);
-                if (mesh_it == m_meshs.end()) {
-                    CRASH_NOW_MSG("mesh not found");
-                    continue;
-                }
+static AABB GetInstanceBounds(const GpuScene& p_gpu_scene, const GpuPtMesh& p_mesh) {
+    const GpuPtBvh& root = p_gpu_scene.bvhs[p_mesh.rootBvhId];
+    AABB box(root.min, root.max);
+    box.ApplyMatrix(p_mesh.transform);
+    return box;
+}
 
-                GpuPtMesh gpu_pt_mesh;
-                gpu_pt_mesh.transform = transform->GetWorldMatrix();
-                gpu_pt_mesh.transformInv = glm::inverse(gpu_pt_mesh.transform);
-                const auto& cache = mesh_it->second;
-                gpu_pt_mesh.rootBvhId = cache.rootBvhId;
-                auto mat_it = materials_lookup.find(cache.materialId);
-                DEV_ASSERT(mat_it != materials_lookup.end());
-                gpu_pt_mesh.materialId = mat_it->second;
-
-                // @TODO: fill offsets
-                meshes.push_back(gpu_pt_mesh);
-            }
+void BuildGpuScene(const Scene& p_scene, GpuScene& p_out_gpu_scene) {
+    p_out_gpu_scene = GpuScene();
+
+    int instance_count = 0;
+    ForEachInstance(p_scene, [&](ecs::Entity, const TransformComponent&, ecs::Entity, const MeshComponent&) {
+        ++instance_count;
+    });
+
+    // the top level tree goes first, so its root is always node 0
+    p_out_gpu_scene.bvhs.resize(TopLevelBvh::GetNodeCount(instance_count));
+
+    std::map<ecs::Entity, int> mesh_lookup;
+    std::map<ecs::Entity, int> material_lookup;
+    std::vector<AABB> instance_bounds;
+    instance_bounds.reserve(instance_count);
+    ForEachInstance(p_scene, [&](ecs::Entity p_id, const TransformComponent& p_transform, ecs::Entity p_mesh_id, const MeshComponent& p_mesh) {
+        auto [mesh_it, new_mesh] = mesh_lookup.try_emplace(p_mesh_id, 0);
+        if (new_mesh) {
+            mesh_it->second = AppendGpuPtMesh(p_mesh, p_out_gpu_scene);
         }
 
-        GpuBufferDesc desc{
-            .slot = GetGlobalPtMeshesSlot(),
-            .elementSize = sizeof(meshes[0]),
-            .elementCount = static_cast<uint32_t>(meshes.size()),
-            .initialData = meshes.data(),
-        };
-
-        if ((dirty_flag & SCENE_DIRTY_WORLD) || m_ptMeshBuffer == nullptr) {
-            m_ptMeshBuffer = *gm->CreateStructuredBuffer(desc);
+        auto& materials = p_out_gpu_scene.materials;
+        const ecs::Entity material_id = p_mesh.subsets[0].material_id;
+        auto [material_it, new_material] = material_lookup.try_emplace(material_id, static_cast<int>(materials.size()));
+        if (new_material) {
+            const MaterialComponent* material = p_scene.GetComponent<MaterialComponent>(material_id);
+            materials.push_back(material ? MakeGpuPtMaterial(*material) : MakeGpuPtMaterial(MaterialComponent()));
         }
-    }
+
+        GpuPtMesh gpu_mesh;
+        gpu_mesh.transform = p_transform.GetWorldMatrix();
+        gpu_mesh.transformInv = glm::inverse(gpu_mesh.transform);
+        gpu_mesh.rootBvhId = mesh_it->second;
+        gpu_mesh.materialId = material_it->second;
+        p_out_gpu_scene.meshes.push_back(gpu_mesh);
+        p_out_gpu_scene.instances.push_back(p_id);
+        instance_bounds.push_back(GetInstanceBounds(p_out_gpu_scene, gpu_mesh));
+    });
+
+    TopLevelBvh::Build(instance_bounds, p_out_gpu_scene.bvhs.data());
 }
 
-bool PathTracer::CreateAccelStructure(const Scene& p_scene) {
-    DEV_ASSERT(m_ptVertexBuffer == nullptr);
+bool RefitGpuScene(const Scene& p_scene, GpuScene& p_gpu_scene, GpuSceneDelta& p_out_delta) {
+    const int instance_count = static_cast<int>(p_gpu_scene.instances.size());
+    p_out_delta = GpuSceneDelta{ .meshBegin = instance_count };
+
+    std::vector<AABB> instance_bounds;
+    instance_bounds.reserve(instance_count);
+    bool same_instances = true;
+    ForEachInstance(p_scene, [&](ecs::Entity p_id, const TransformComponent& p_transform, ecs::Entity, const MeshComponent&) {
+        const int index = static_cast<int>(instance_bounds.size());
+        if (!same_instances || index >= instance_count || p_gpu_scene.instances[index] != p_id) {
+            same_instances = false;
+            return;
+        }
 
-    auto gm = IGraphicsManager::GetSingletonPtr();
+        GpuPtMesh& gpu_mesh = p_gpu_scene.meshes[index];
+        const Matrix4x4f& world = p_transform.GetWorldMatrix();
+        if (world != gpu_mesh.transform) {
+            gpu_mesh.transform = world;
+            gpu_mesh.transformInv = glm::inverse(world);
+            p_out_delta.meshBegin = glm::min(p_out_delta.meshBegin, index);
+            p_out_delta.meshEnd = index + 1;
+        }
+        instance_bounds.push_back(GetInstanceBounds(p_gpu_scene, gpu_mesh));
+    });
 
-    Timer timer;
-    GpuScene gpu_scene;
-
-    // meshes
-    for (auto [id, object] : p_scene.m_MeshRendererComponents) {
-        auto transform = p_scene.GetComponent<TransformComponent>(id);
-        auto mesh = p_scene.GetComponent<MeshComponent>(object.meshId);
-        if (DEV_VERIFY(transform && mesh)) {
-            auto it = m_meshs.find(object.meshId);
-            if (it != m_meshs.end()) {
-                continue;
-            }
+    if (!same_instances || static_cast<int>(instance_bounds.size()) != instance_count) {
+        p_out_delta = GpuSceneDelta();
+        return false;
+    }
 
-            const int bvh_count = (int)gpu_scene.bvhs.size();
-            const int index_count = (int)gpu_scene.indices.size();
-            const int vertex_count = (int)gpu_scene.vertices.size();
+    if (p_out_delta.meshEnd == 0) {
+        p_out_delta.meshBegin = 0;
+        return true;
+    }
 
-            MeshData meta{
-                .rootBvhId = bvh_count,
-                .materialId = mesh->subsets[0].material_id
-            };
-            m_meshs[object.meshId] = meta;
+    p_out_delta.bvhEnd = TopLevelBvh::Refit(instance_bounds, p_gpu_scene.bvhs.data());
+    return true;
+}
 
-            GpuScene tmp_scene;
-            ConstructMesh(*mesh, tmp_scene);
+template<typename T>
+static void UploadRange(IGraphicsManager* p_gm,
+                        const GpuStructuredBuffer* p_buffer,
+                        const std::vector<T>& p_data,
+                        int p_begin,
+                        int p_end) {
+    if (p_begin >= p_end) {
+        return;
+    }
 
-            AppendVertices(tmp_scene.vertices, gpu_scene.vertices);
-            AppendIndices(tmp_scene.indices, gpu_scene.indices, vertex_count);
-            AppendBvhs(tmp_scene.bvhs, gpu_scene.bvhs, index_count);
-        }
+    GpuBufferDesc desc{
+        .elementSize = sizeof(T),
+        .elementCount = static_cast<uint32_t>(p_end - p_begin),
+        .offset = static_cast<uint32_t>(p_begin),
+        .initialData = p_data.data() + p_begin,
+    };
+    p_gm->UpdateBufferData(desc, p_buffer);
+}
+
+void PathTracer::UpdateAccelStructure(const Scene& p_scene) {
+    GpuSceneDelta delta;
+    if (!RefitGpuScene(p_scene, m_gpuScene, delta)) {
+        // instances were added or removed, the meshes keep their bvh, only the buffers are built again
+        CreateAccelStructure(p_scene);
+        return;
     }
 
-    const uint32_t triangle_count = (uint32_t)gpu_scene.indices.size();
-    const uint32_t bvh_count = (uint32_t)gpu_scene.bvhs.size();
+    auto gm = IGraphicsManager::GetSingletonPtr();
+    UploadRange(gm, m_ptMeshBuffer.get(), m_gpuScene.meshes, delta.meshBegin, delta.meshEnd);
+    UploadRange(gm, m_ptBvhBuffer.get(), m_gpuScene.bvhs, 0, delta.bvhEnd);
+}
+
+void PathTracer::CreateAccelStructure(const Scene& p_scene) {
+    auto gm = IGraphicsManager::GetSingletonPtr();
+
+    Timer timer;
+    BuildGpuScene(p_scene, m_gpuScene);
+    if (m_gpuScene.instances.empty()) {
+        m_ptBvhBuffer.reset();
+        return;
+    }
 
-    m_ptBvhBuffer = *CreateBuffer(gm, GetGlobalPtBvhsSlot(), gpu_scene.bvhs);
-    m_ptVertexBuffer = *CreateBuffer(gm, GetGlobalPtVerticesSlot(), gpu_scene.vertices);
-    m_ptIndexBuffer = *CreateBuffer(gm, GetGlobalPtIndicesSlot(), gpu_scene.indices);
+    m_ptBvhBuffer = *CreateBuffer(gm, GetGlobalPtBvhsSlot(), m_gpuScene.bvhs);
+    m_ptVertexBuffer = *CreateBuffer(gm, GetGlobalPtVerticesSlot(), m_gpuScene.vertices);
+    m_ptIndexBuffer = *CreateBuffer(gm, GetGlobalPtIndicesSlot(), m_gpuScene.indices);
+    m_ptMeshBuffer = *CreateBuffer(gm, GetGlobalPtMeshesSlot(), m_gpuScene.meshes);
+    // @TODO: upload again when materials change
+    m_ptMaterialBuffer = *CreateBuffer(gm, GetGlobalPtMaterialsSlot(), m_gpuScene.materials);
 
-    LOG("Path tracer scene loaded in {}, contains {} triangles, {} BVH",
+    LOG("Path tracer scene loaded in {}, contains {} triangles, {} BVH, {} instances",
         timer.GetDurationString(),
-        triangle_count,
-        bvh_count);
+        m_gpuScene.indices.size(),
+        m_gpuScene.bvhs.size(),
+        m_gpuScene.instances.size());
 
     /// materials
 #if 0
@@ -308,8 +393,6 @@ bool PathTracer::CreateAccelStructure(const Scene& p_scene) {
         }
     }
 #endif
-
-    return true;
 }
 
 bool PathTracer::IsActive() const {
@@ -317,7 +400,7 @@ bool PathTracer::IsActive() const {
         return false;
     }
 
-    if (m_ptBvhBuffer == nullptr) {
+    if (m_ptBvhBuffer == nullptr || m_gpuScene.instances.empty()) {
         return false;
     }
 
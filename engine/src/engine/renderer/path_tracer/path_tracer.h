@@ -8,21 +8,53 @@
 
 namespace my {
 
+class CameraComponent;
+class CpuPathTracer;
 class Scene;
+struct MaterialComponent;
+struct MeshComponent;
 
 struct GpuScene {
-    // @TODO: material
+    // the top level tree over the instances comes first, followed by the bottom level tree of every mesh
     std::vector<GpuPtBvh> bvhs;
     std::vector<GpuPtVertex> vertices;
     std::vector<GpuPtIndex> indices;
+    // one per instance
+    std::vector<GpuPtMesh> meshes;
+    std::vector<GpuPtMaterial> materials;
+    // entity of every instance
+    std::vector<ecs::Entity> instances;
 };
 
+// elements of a GpuScene changed by RefitGpuScene()
+struct GpuSceneDelta {
+    // [meshBegin, meshEnd) of GpuScene::meshes
+    int meshBegin{ 0 };
+    int meshEnd{ 0 };
+    // [0, bvhEnd) of GpuScene::bvhs
+    int bvhEnd{ 0 };
+};
+
+// builds the bvh of p_mesh if it has none, appends its vertices, indices and nodes to p_gpu_scene,
+// returns the index of its root node
+int AppendGpuPtMesh(const MeshComponent& p_mesh, GpuScene& p_gpu_scene);
+
+GpuPtMaterial MakeGpuPtMaterial(const MaterialComponent& p_material);
+
+// Fills p_out_gpu_scene with the mesh renderers of p_scene. Every mesh is added once however many instances
+// it has, its bottom level tree is built once and cached on the MeshComponent.
+void BuildGpuScene(const Scene& p_scene, GpuScene& p_out_gpu_scene);
+
+// Picks up the world matrices of the instances and refits the top level tree, p_out_delta tells what changed.
+// Returns false if the instances of p_scene are not the ones p_gpu_scene was built with.
+bool RefitGpuScene(const Scene& p_scene, GpuScene& p_gpu_scene, GpuSceneDelta& p_out_delta);
+
 // @TODO: make it a layer?
 class PathTracer {
 public:
     void SetMode(PathTracerMode p_mode) { m_mode = p_mode; }
 
-    void Update(const Scene& p_scene);
+    void Update(const CameraComponent& p_camera, const Scene& p_scene);
 
     bool IsActive() const;
 
@@ -31,8 +63,9 @@ public:
     void UnbindData(IGraphicsManager& p_gm);
 
 private:
-    bool CreateAccelStructure(const Scene& p_scene);
+    void CreateAccelStructure(const Scene& p_scene);
     void UpdateAccelStructure(const Scene& p_scene);
+    void UpdateTiled(const CameraComponent& p_camera, const Scene& p_scene);
 
     std::shared_ptr<GpuStructuredBuffer> m_ptBvhBuffer;
     std::shared_ptr<GpuStructuredBuffer> m_ptVertexBuffer;
@@ -40,13 +73,10 @@ private:
     std::shared_ptr<GpuStructuredBuffer> m_ptMeshBuffer;
     std::shared_ptr<GpuStructuredBuffer> m_ptMaterialBuffer;
 
-    struct MeshData {
-        int rootBvhId;
-        ecs::Entity materialId;
-    };
+    // cpu copy of the buffers, the instances are refit in place and only the changes are uploaded
+    GpuScene m_gpuScene;
 
-    // @TODO: rename
-    std::map<ecs::Entity, MeshData> m_meshs;
+    std::shared_ptr<CpuPathTracer> m_cpuPathTracer;
 
     PathTracerMode m_mode{ PathTracerMode::NONE };
 };
@@ -0,0 +1,100 @@
+#include "top_level_bvh.h"
+
+#include <algorithm>
+
+namespace my {
+
+static void BuildNode(const std::vector<AABB>& p_instance_bounds,
+                      int* p_begin,
+                      int* p_end,
+                      int p_node,
+                      int p_tree_end,
+                      GpuPtBvh* p_out_nodes) {
+    const int count = static_cast<int>(p_end - p_begin);
+    const int subtree_end = p_node + 2 * count - 1;
+
+    GpuPtBvh& node = p_out_nodes[p_node];
+    node.missIdx = subtree_end == p_tree_end ? -1 : subtree_end;
+
+    AABB box;
+    for (const int* it = p_begin; it != p_end; ++it) {
+        box.UnionBox(p_instance_bounds[*it]);
+    }
+    node.min = box.GetMin();
+    node.max = box.GetMax();
+
+    if (count == 1) {
+        node.triangleIndex = *p_begin;
+        return;
+    }
+
+    node.triangleIndex = -1;
+
+    AABB centers;
+    for (const int* it = p_begin; it != p_end; ++it) {
+        centers.ExpandPoint(p_instance_bounds[*it].Center());
+    }
+    const Vector3f size = centers.Size();
+    const int axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+
+    // a handful of instances, the median split keeps the tree balanced and the build trivial
+    int* mid = p_begin + count / 2;
+    std::nth_element(p_begin, mid, p_end, [&](int p_lhs, int p_rhs) {
+        return p_instance_bounds[p_lhs].Center()[axis] < p_instance_bounds[p_rhs].Center()[axis];
+    });
+
+    BuildNode(p_instance_bounds, p_begin, mid, p_node + 1, p_tree_end, p_out_nodes);
+    BuildNode(p_instance_bounds, mid, p_end, p_node + 2 * (count / 2), p_tree_end, p_out_nodes);
+}
+
+void TopLevelBvh::Build(const std::vector<AABB>& p_instance_bounds, GpuPtBvh* p_out_nodes) {
+    const int instance_count = static_cast<int>(p_instance_bounds.size());
+    if (instance_count == 0) {
+        return;
+    }
+
+    std::vector<int> instances(instance_count);
+    for (int i = 0; i < instance_count; ++i) {
+        instances[i] = i;
+    }
+
+    BuildNode(p_instance_bounds,
+              instances.data(),
+              instances.data() + instance_count,
+              0,
+              GetNodeCount(instance_count),
+              p_out_nodes);
+}
+
+int TopLevelBvh::Refit(const std::vector<AABB>& p_instance_bounds, GpuPtBvh* p_nodes) {
+    const int node_count = GetNodeCount(static_cast<int>(p_instance_bounds.size()));
+
+    // children always come after their parent, so walking backwards visits them first
+    int dirty_end = 0;
+    for (int i = node_count - 1; i >= 0; --i) {
+        GpuPtBvh& node = p_nodes[i];
+        Vector3f box_min, box_max;
+        if (node.triangleIndex != -1) {
+            const AABB& box = p_instance_bounds[node.triangleIndex];
+            box_min = box.GetMin();
+            box_max = box.GetMax();
+        } else {
+            const GpuPtBvh& left = p_nodes[i + 1];
+            const GpuPtBvh& right = p_nodes[left.missIdx];
+            box_min = min(left.min, right.min);
+            box_max = max(left.max, right.max);
+        }
+
+        if (box_min == node.min && box_max == node.max) {
+            continue;
+        }
+
+        node.min = box_min;
+        node.max = box_max;
+        dirty_end = glm::max(dirty_end, i + 1);
+    }
+
+    return dirty_end;
+}
+
+}  // namespace my
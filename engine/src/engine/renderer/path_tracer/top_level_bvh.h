@@ -0,0 +1,24 @@
+#pragma once
+#include "engine/math/aabb.h"
+
+namespace my {
+#include "structured_buffer.hlsl.h"
+}  // namespace my
+
+namespace my {
+
+// Bounding volume hierarchy over the mesh instances of the path tracer, one instance per leaf.
+// It uses the preorder layout of BvhAccel, a leaf stores the index of its instance in triangleIndex.
+// The tree is built once for a set of instances, when they move only the boxes are refit.
+struct TopLevelBvh {
+    static int GetNodeCount(int p_instance_count) { return p_instance_count ? 2 * p_instance_count - 1 : 0; }
+
+    // median split over the instance centers, p_out_nodes holds GetNodeCount() nodes
+    static void Build(const std::vector<AABB>& p_instance_bounds, GpuPtBvh* p_out_nodes);
+
+    // recomputes the boxes from the new instance bounds, returns the index after the last node that changed,
+    // so uploading [0, returned index) is enough, 0 if nothing changed
+    static int Refit(const std::vector<AABB>& p_instance_bounds, GpuPtBvh* p_nodes);
+};
+
+}  // namespace my
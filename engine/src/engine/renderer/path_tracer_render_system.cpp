@@ -9,9 +9,9 @@ static struct {
     PathTracer pt;
 } s_glob;
 
-void RequestPathTracerUpdate(const CameraComponent&, Scene& p_scene) {
+void RequestPathTracerUpdate(const CameraComponent& p_camera, Scene& p_scene) {
     // @TODO: refactor
-    s_glob.pt.Update(p_scene);
+    s_glob.pt.Update(p_camera, p_scene);
 }
 
 // path tracer
@@ -105,6 +105,8 @@ struct PipelineState {
     PSO_NAME(PSO_BLOOM_SETUP)            \
     PSO_NAME(PSO_BLOOM_DOWNSAMPLE)       \
     PSO_NAME(PSO_BLOOM_UPSAMPLE)         \
+    PSO_NAME(PSO_HIZ_BUILD)              \
+    PSO_NAME(PSO_GPU_CULLING)            \
     PSO_NAME(PSO_SSAO)                   \
     PSO_NAME(PSO_POST_PROCESS)           \
     PSO_NAME(PSO_DEBUG_VOXEL)            \
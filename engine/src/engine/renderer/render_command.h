@@ -28,11 +28,43 @@ struct DrawCommand {
 
     int bone_idx = -1;
     int mat_idx = -1;
+    // slot of the instance world matrices, instanced draws have no bones
+    int instance_idx = -1;
 
-    uint8_t sortKey = 0;
+    uint64_t sortKey = 0;
     StencilFlags flags{ 0 };
 };
 
+// Commands of a pass are drawn in ascending sort key order, bits from high to low:
+//   opaque:      pass 4 | pipeline 8 | material 16 | mesh 16 | depth 20
+//   transparent: pass 4 | pipeline 8 | inverted depth 20 | material 16 | mesh 16
+// Opaque draws are grouped by state, then front to back. Transparent draws go back to front.
+// The pipeline is PipelineStateName + 1, 0 keeps the pipeline the pass bound.
+inline uint32_t QuantizeSortDepth(float p_depth) {
+    // the bits of a non negative float sort like the float, keep the top 20
+    return std::bit_cast<uint32_t>(p_depth > 0.0f ? p_depth : 0.0f) >> 11;
+}
+
+inline uint64_t MakeOpaqueSortKey(uint32_t p_pass, uint32_t p_pipeline, uint32_t p_material, uint32_t p_mesh, float p_depth) {
+    return (uint64_t(p_pass & 0xF) << 60) |
+           (uint64_t(p_pipeline & 0xFF) << 52) |
+           (uint64_t(p_material & 0xFFFF) << 36) |
+           (uint64_t(p_mesh & 0xFFFF) << 20) |
+           uint64_t(QuantizeSortDepth(p_depth));
+}
+
+inline uint64_t MakeTransparentSortKey(uint32_t p_pass, uint32_t p_pipeline, uint32_t p_material, uint32_t p_mesh, float p_depth) {
+    return (uint64_t(p_pass & 0xF) << 60) |
+           (uint64_t(p_pipeline & 0xFF) << 52) |
+           (uint64_t(~QuantizeSortDepth(p_depth) & 0xFFFFF) << 32) |
+           (uint64_t(p_material & 0xFFFF) << 16) |
+           uint64_t(p_mesh & 0xFFFF);
+}
+
+inline uint32_t GetSortKeyPipeline(uint64_t p_key) {
+    return static_cast<uint32_t>(p_key >> 52) & 0xFF;
+}
+
 struct ComputeCommand {
     int dispatchSize[3];
 };
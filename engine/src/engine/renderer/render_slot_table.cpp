@@ -0,0 +1,150 @@
+#include "render_slot_table.h"
+
+#include "engine/core/debugger/profiler.h"
+#include "engine/math/matrix_transform.h"
+#include "engine/scene/scene.h"
+
+namespace my {
+
+bool RenderSlotTable::NeedsRebuild(const Scene& p_scene, bool p_is_opengl) const {
+    return m_scene != &p_scene ||
+           m_isOpengl != p_is_opengl ||
+           m_meshRendererVersion != p_scene.m_MeshRendererComponents.GetVersion() ||
+           m_meshVersion != p_scene.m_MeshComponents.GetVersion() ||
+           m_tileMapVersion != p_scene.m_TileMapComponents.GetVersion() ||
+           m_armatureVersion != p_scene.m_ArmatureComponents.GetVersion() ||
+           m_transformVersion != p_scene.m_TransformComponents.GetVersion();
+}
+
+void RenderSlotTable::WriteMeshBatch(Scene& p_scene, uint32_t p_index) {
+    const ecs::Entity entity = p_scene.GetEntityByIndex<MeshRendererComponent>(p_index);
+    const MeshRendererComponent& obj = p_scene.GetComponentByIndex<MeshRendererComponent>(p_index);
+    const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(entity);
+    const MeshComponent* mesh = p_scene.GetComponent<MeshComponent>(obj.meshId);
+    DEV_ASSERT(transform && mesh);
+
+    PerBatchConstantBuffer& batch = m_batches[GetMeshBatchSlot(p_index)];
+    batch.c_worldMatrix = transform->GetWorldMatrix();
+    batch.c_meshFlag = mesh->armatureId.IsValid();
+    m_batchVersions[GetMeshBatchSlot(p_index)] = m_version;
+}
+
+void RenderSlotTable::WriteTileMapBatch(Scene& p_scene, uint32_t p_index) {
+    const ecs::Entity entity = p_scene.GetEntityByIndex<TileMapComponent>(p_index);
+    const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(entity);
+    DEV_ASSERT(transform);
+
+    PerBatchConstantBuffer& batch = m_batches[GetTileMapBatchSlot(p_index)];
+    batch.c_worldMatrix = transform->GetWorldMatrix();
+    m_batchVersions[GetTileMapBatchSlot(p_index)] = m_version;
+}
+
+void RenderSlotTable::WriteBones(Scene& p_scene, uint32_t p_index) {
+    const ArmatureComponent& armature = p_scene.GetComponentByIndex<ArmatureComponent>(p_index);
+    const size_t bone_count = armature.boneIndices.size();
+    DEV_ASSERT(bone_count <= MAX_BONE_COUNT);
+    DEV_ASSERT(armature.paletteOffset + bone_count <= p_scene.m_bonePalette.size());
+
+    BoneConstantBuffer& bones = m_bones[GetBoneSlot(p_index)];
+    memcpy(bones.c_bones, p_scene.m_bonePalette.data() + armature.paletteOffset, sizeof(Matrix4x4f) * bone_count);
+    m_boneVersions[GetBoneSlot(p_index)] = m_version;
+}
+
+void RenderSlotTable::Build(Scene& p_scene, bool p_is_opengl) {
+    HBN_PROFILE_EVENT();
+
+    const uint32_t mesh_renderer_count = static_cast<uint32_t>(p_scene.GetCount<MeshRendererComponent>());
+    const uint32_t tile_map_count = static_cast<uint32_t>(p_scene.GetCount<TileMapComponent>());
+    const uint32_t armature_count = static_cast<uint32_t>(p_scene.GetCount<ArmatureComponent>());
+    const uint32_t batch_count = glm::max(mesh_renderer_count + tile_map_count + 1, ENV_SLOT_COUNT);
+
+    m_tileMapOffset = mesh_renderer_count;
+    m_instanceSlot = mesh_renderer_count + tile_map_count;
+    m_batches.assign(batch_count, PerBatchConstantBuffer());
+    m_batchVersions.assign(batch_count, m_version);
+    m_bones.resize(armature_count);
+    m_boneVersions.assign(armature_count, m_version);
+
+    const auto matrices = p_is_opengl ? BuildOpenGlCubeMapViewProjectionMatrix(Vector3f(0)) : BuildCubeMapViewProjectionMatrix(Vector3f(0));
+    for (int mip_idx = 0; mip_idx < IBL_MIP_CHAIN_MAX; ++mip_idx) {
+        for (int face_id = 0; face_id < 6; ++face_id) {
+            PerBatchConstantBuffer& batch = m_batches[mip_idx * 6 + face_id];
+            batch.c_cubeProjectionViewMatrix = matrices[face_id];
+            batch.c_envPassRoughness = (float)mip_idx / (float)(IBL_MIP_CHAIN_MAX - 1);
+        }
+    }
+
+    for (uint32_t i = 0; i < mesh_renderer_count; ++i) {
+        WriteMeshBatch(p_scene, i);
+    }
+    for (uint32_t i = 0; i < tile_map_count; ++i) {
+        WriteTileMapBatch(p_scene, i);
+    }
+    for (uint32_t i = 0; i < armature_count; ++i) {
+        WriteBones(p_scene, i);
+    }
+
+    PerBatchConstantBuffer& instance_batch = m_batches[m_instanceSlot];
+    instance_batch.c_worldMatrix = Matrix4x4f(1);
+    instance_batch.c_meshFlag = MESH_HAS_INSTANCE;
+
+    m_scene = &p_scene;
+    m_isOpengl = p_is_opengl;
+    m_meshRendererVersion = p_scene.m_MeshRendererComponents.GetVersion();
+    m_meshVersion = p_scene.m_MeshComponents.GetVersion();
+    m_tileMapVersion = p_scene.m_TileMapComponents.GetVersion();
+    m_armatureVersion = p_scene.m_ArmatureComponents.GetVersion();
+    m_transformVersion = p_scene.m_TransformComponents.GetVersion();
+    m_updatedBatchCount = batch_count;
+    m_updatedBoneCount = armature_count;
+}
+
+void RenderSlotTable::Update(Scene& p_scene, bool p_is_opengl) {
+    HBN_PROFILE_EVENT();
+
+    ++m_version;
+    if (NeedsRebuild(p_scene, p_is_opengl)) {
+        Build(p_scene, p_is_opengl);
+        return;
+    }
+
+    const auto& transforms = p_scene.GetManager<TransformComponent>();
+    const TransformHierarchy& hierarchy = p_scene.m_transformHierarchy;
+    auto is_moved = [&](ecs::Entity p_entity) {
+        const uint32_t transform_index = transforms.FindIndex(p_entity);
+        return transform_index != ecs::EntityIndex::INVALID_INDEX && hierarchy.IsWorldChanged(transform_index);
+    };
+
+    m_updatedBatchCount = 0;
+    const uint32_t mesh_renderer_count = static_cast<uint32_t>(p_scene.GetCount<MeshRendererComponent>());
+    for (uint32_t i = 0; i < mesh_renderer_count; ++i) {
+        if (is_moved(p_scene.GetEntityByIndex<MeshRendererComponent>(i))) {
+            WriteMeshBatch(p_scene, i);
+            ++m_updatedBatchCount;
+        }
+    }
+    const uint32_t tile_map_count = static_cast<uint32_t>(p_scene.GetCount<TileMapComponent>());
+    for (uint32_t i = 0; i < tile_map_count; ++i) {
+        if (is_moved(p_scene.GetEntityByIndex<TileMapComponent>(i))) {
+            WriteTileMapBatch(p_scene, i);
+            ++m_updatedBatchCount;
+        }
+    }
+
+    // the palette is relative to the armature, it changes when a bone or the armature moves
+    m_updatedBoneCount = 0;
+    const uint32_t armature_count = static_cast<uint32_t>(p_scene.GetCount<ArmatureComponent>());
+    for (uint32_t i = 0; i < armature_count; ++i) {
+        const ArmatureComponent& armature = p_scene.GetComponentByIndex<ArmatureComponent>(i);
+        bool moved = is_moved(p_scene.GetEntityByIndex<ArmatureComponent>(i));
+        for (size_t bone = 0; bone < armature.boneIndices.size() && !moved; ++bone) {
+            moved = hierarchy.IsWorldChanged(armature.boneIndices[bone]);
+        }
+        if (moved) {
+            WriteBones(p_scene, i);
+            ++m_updatedBoneCount;
+        }
+    }
+}
+
+}  // namespace my
@@ -0,0 +1,100 @@
+#pragma once
+#include "engine/render_graph/render_graph_defines.h"
+#include "engine/renderer/frame_data.h"
+
+// clang-format off
+namespace my { class Scene; }
+// clang-format on
+
+namespace my {
+
+// Batch and bone constant buffer slots that live across frames. A MeshRendererComponent owns the
+// batch slot at its dense index, tile maps come after the mesh renderers, and an ArmatureComponent
+// owns the bone slot at its dense index, so the passes index the slots without a lookup.
+// The slot after the tile maps is shared by the instanced draws.
+// Only the slots whose world matrix or skeleton changed are rewritten. Every slot remembers the
+// version of the Update() that last wrote it, so a GPU buffer uploads only the ranges written
+// since it was last updated. The table is rebuilt when renderers, meshes, tile maps, armatures
+// or transforms are added or removed.
+class RenderSlotTable {
+public:
+    // the IBL bake passes draw with the first slots, their fields don't overlap the object fields
+    static constexpr uint32_t ENV_SLOT_COUNT = IBL_MIP_CHAIN_MAX * 6;
+    // changed ranges closer than this are uploaded as one
+    static constexpr uint32_t MERGE_GAP = 8;
+
+    void Update(Scene& p_scene, bool p_is_opengl);
+    bool NeedsRebuild(const Scene& p_scene, bool p_is_opengl) const;
+
+    uint32_t GetMeshBatchSlot(uint32_t p_mesh_renderer_index) const { return p_mesh_renderer_index; }
+    uint32_t GetTileMapBatchSlot(uint32_t p_tile_map_index) const { return m_tileMapOffset + p_tile_map_index; }
+    uint32_t GetBoneSlot(uint32_t p_armature_index) const { return p_armature_index; }
+    // instanced draws share this slot, it only flags the mesh as instanced
+    uint32_t GetInstanceBatchSlot() const { return m_instanceSlot; }
+
+    const std::vector<PerBatchConstantBuffer>& GetBatches() const { return m_batches; }
+    const std::vector<BoneConstantBuffer>& GetBones() const { return m_bones; }
+
+    // version of the Update() that last wrote each slot
+    const std::vector<uint32_t>& GetBatchVersions() const { return m_batchVersions; }
+    const std::vector<uint32_t>& GetBoneVersions() const { return m_boneVersions; }
+
+    // version of the last Update(), starts at 1, 0 is older than every slot
+    uint32_t GetVersion() const { return m_version; }
+
+    // number of slots written by the last Update()
+    uint32_t GetUpdatedBatchCount() const { return m_updatedBatchCount; }
+    uint32_t GetUpdatedBoneCount() const { return m_updatedBoneCount; }
+
+    // p_func(begin, end) for the ranges of slots written after p_version, in order
+    template<typename FUNC>
+    static void ForEachChangedRange(const std::vector<uint32_t>& p_versions, uint32_t p_version, const FUNC& p_func) {
+        const uint32_t count = static_cast<uint32_t>(p_versions.size());
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (p_versions[i] <= p_version) {
+                continue;
+            }
+            if (end != 0 && i - end < MERGE_GAP) {
+                end = i + 1;
+                continue;
+            }
+            if (end != 0) {
+                p_func(begin, end);
+            }
+            begin = i;
+            end = i + 1;
+        }
+        if (end != 0) {
+            p_func(begin, end);
+        }
+    }
+
+private:
+    void Build(Scene& p_scene, bool p_is_opengl);
+    void WriteMeshBatch(Scene& p_scene, uint32_t p_index);
+    void WriteTileMapBatch(Scene& p_scene, uint32_t p_index);
+    void WriteBones(Scene& p_scene, uint32_t p_index);
+
+    std::vector<PerBatchConstantBuffer> m_batches;
+    std::vector<uint32_t> m_batchVersions;
+    std::vector<BoneConstantBuffer> m_bones;
+    std::vector<uint32_t> m_boneVersions;
+    uint32_t m_tileMapOffset{ 0 };
+    uint32_t m_instanceSlot{ 0 };
+
+    uint32_t m_version{ 0 };
+    uint32_t m_updatedBatchCount{ 0 };
+    uint32_t m_updatedBoneCount{ 0 };
+
+    const Scene* m_scene{ nullptr };
+    bool m_isOpengl{ false };
+    uint32_t m_meshRendererVersion{ ~0u };
+    uint32_t m_meshVersion{ ~0u };
+    uint32_t m_tileMapVersion{ ~0u };
+    uint32_t m_armatureVersion{ ~0u };
+    uint32_t m_transformVersion{ ~0u };
+};
+
+}  // namespace my
@@ -1,15 +1,18 @@
+#include "engine/algorithm/radix_sort.h"
+#include "engine/core/debugger/profiler.h"
 #include "engine/math/frustum.h"
 #include "engine/math/geometry.h"
 #include "engine/math/matrix_transform.h"
 #include "engine/renderer/frame_data.h"
+#include "engine/renderer/gpu_culling.h"
+#include "engine/renderer/pipeline_state.h"
+#include "engine/renderer/render_slot_table.h"
 #include "engine/runtime/asset_registry.h"
 #include "engine/scene/scene.h"
+#include "engine/systems/job_system/job_system.h"
 
 namespace my {
 
-using FilterObjectFunc1 = std::function<bool(const MeshRendererComponent& p_object)>;
-using FilterObjectFunc2 = std::function<bool(const AABB& p_object_aabb)>;
-
 // @TODO: fix this function OMG
 static void FillMaterialConstantBuffer(bool p_is_opengl, const MaterialComponent* p_material, MaterialConstantBuffer& cb) {
     unused(p_is_opengl);
@@ -59,67 +62,525 @@ static void FillMaterialConstantBuffer(bool p_is_opengl, const MaterialComponent
     cb.c_hasMaterialMap = set_texture(MaterialComponent::TEXTURE_METALLIC_ROUGHNESS, cb.c_materialMapHandle, cb.c_MaterialMapResidentHandle);
 };
 
-// @TODO: refactor this
-static void FillPass(const Scene& p_scene,
-                     FilterObjectFunc1 p_filter1,
-                     FilterObjectFunc2 p_filter2,
-                     std::vector<RenderCommand>& p_commands,
-                     FrameData& p_framedata) {
+static constexpr uint32_t CULLING_GROUP_SIZE = 64;
+
+// Every mesh renderer, gathered once per frame and shared by all the passes.
+// Arrays are indexed by dense MeshRendererComponent index and live in the frame arena.
+struct MeshObjects {
+    uint32_t count;
+    ecs::Entity* entities;
+    uint32_t* flags;
+    const MeshComponent** meshes;
+    // dense MeshComponent index, objects sharing a mesh sort next to each other
+    uint32_t* meshIndices;
+    const Matrix4x4f** worldMatrices;
+    int* batchIndices;
+    int* boneIndices;
+    // the most commands an object can add to a single pass
+    uint32_t* commandCounts;
+    // world space bounds, owned by the scene's object tree
+    const AABB* bounds;
+    // material constant buffer slot, indexed by dense MaterialComponent index
+    int* materialIndices;
+};
 
-    for (auto [entity, obj] : p_scene.m_MeshRendererComponents) {
-        if (!p_scene.Contains<TransformComponent>(entity)) {
-            continue;
+struct MeshPass {
+    ArenaVector<RenderCommand>* commands;
+    // objects are drawn when (flags & flagMask) == flagValue
+    uint32_t flagMask;
+    uint32_t flagValue;
+    // draw the whole mesh once instead of one command per subset
+    bool modelOnly;
+    // culled against frustum, or against region when frustum is null
+    const Frustum* frustum;
+    const AABB* region;
+    // depth of the sort keys is measured along view, all zero when null
+    const Matrix4x4f* view;
+    bool backToFront;
+    // objects without bones sharing a mesh are drawn instanced, the vertex shaders of the pass
+    // must read the world matrices from c_bones when the mesh is flagged MESH_HAS_INSTANCE
+    bool instancing;
+    // pipeline of the draws and of the draws of double sided meshes, it goes in the sort keys.
+    // PSO_NAME_MAX leaves it to the pass, for command lists drawn with more than one pipeline
+    PipelineStateName pipeline;
+    PipelineStateName doubleSidedPipeline;
+};
+
+// p_func(chunk) for every chunk, chunks run in parallel and this returns when they are all done
+template<typename FUNC>
+static void ForEachChunk(uint32_t p_chunk_count, const FUNC& p_func) {
+#if USING(ENABLE_JOB_SYSTEM)
+    jobsystem::Context ctx;
+    ctx.Dispatch(p_chunk_count, 1, [&p_func](jobsystem::JobArgs p_args) { p_func(p_args.jobIndex); });
+    ctx.Wait();
+#else
+    for (uint32_t chunk = 0; chunk < p_chunk_count; ++chunk) {
+        p_func(chunk);
+    }
+#endif
+}
+
+static MeshObjects GatherMeshObjects(Scene& p_scene, FrameData& p_framedata) {
+    HBN_PROFILE_EVENT();
+
+    LinearAllocator& arena = p_framedata.arena;
+
+    // scripts and physics run after the scene update and may have added objects
+    if (p_scene.m_objectTree.NeedsRebuild(p_scene)) {
+        p_scene.m_objectTree.Update(p_scene);
+    }
+    const ObjectTree& object_tree = p_scene.m_objectTree;
+    DEV_ASSERT(object_tree.GetBounds().size() == p_scene.GetCount<MeshRendererComponent>());
+
+    MeshObjects objects;
+    objects.count = static_cast<uint32_t>(p_scene.GetCount<MeshRendererComponent>());
+    objects.entities = arena.AllocateArray<ecs::Entity>(objects.count).data();
+    objects.flags = arena.AllocateArray<uint32_t>(objects.count).data();
+    objects.meshes = arena.AllocateArray<const MeshComponent*>(objects.count).data();
+    objects.meshIndices = arena.AllocateArray<uint32_t>(objects.count).data();
+    objects.worldMatrices = arena.AllocateArray<const Matrix4x4f*>(objects.count).data();
+    objects.batchIndices = arena.AllocateArray<int>(objects.count).data();
+    objects.boneIndices = arena.AllocateArray<int>(objects.count).data();
+    objects.commandCounts = arena.AllocateArray<uint32_t>(objects.count).data();
+    objects.bounds = object_tree.GetBounds().data();
+
+    // materials are filled up front, the jobs only read the slots
+    const bool is_opengl = p_framedata.options.isOpengl;
+    const uint32_t material_count = static_cast<uint32_t>(p_scene.GetCount<MaterialComponent>());
+    objects.materialIndices = arena.AllocateArray<int>(material_count).data();
+    for (uint32_t i = 0; i < material_count; ++i) {
+        // zeroed so unused fields don't break the content hash
+        MaterialConstantBuffer material_buffer;
+        memset(&material_buffer, 0, sizeof(material_buffer));
+        FillMaterialConstantBuffer(is_opengl, &p_scene.GetComponentByIndex<MaterialComponent>(i), material_buffer);
+        objects.materialIndices[i] = p_framedata.materialCache.FindOrAdd(material_buffer);
+    }
+
+    // batch and bone buffers were written by the slot table, objects only pick their slots
+    DEV_ASSERT(p_framedata.slots);
+    const RenderSlotTable& slots = *p_framedata.slots;
+    const uint32_t armature_count = static_cast<uint32_t>(p_scene.GetCount<ArmatureComponent>());
+
+    const uint32_t chunk_count = (objects.count + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE;
+    ForEachChunk(chunk_count, [&](uint32_t p_chunk) {
+        const auto& armatures = p_scene.GetManager<ArmatureComponent>();
+        const auto& meshes = p_scene.GetManager<MeshComponent>();
+        const uint32_t begin = p_chunk * CULLING_GROUP_SIZE;
+        const uint32_t end = glm::min(begin + CULLING_GROUP_SIZE, objects.count);
+
+        for (uint32_t i = begin; i < end; ++i) {
+            const ecs::Entity entity = p_scene.GetEntityByIndex<MeshRendererComponent>(i);
+            const MeshRendererComponent& obj = p_scene.GetComponentByIndex<MeshRendererComponent>(i);
+            const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(entity);
+            const MeshComponent* mesh = p_scene.GetComponent<MeshComponent>(obj.meshId);
+            DEV_ASSERT(transform && mesh);
+
+            objects.entities[i] = entity;
+            objects.flags[i] = obj.flags;
+            objects.meshes[i] = mesh;
+            objects.meshIndices[i] = meshes.FindIndex(obj.meshId);
+            objects.worldMatrices[i] = &transform->GetWorldMatrix();
+            objects.commandCounts[i] = glm::max(1u, static_cast<uint32_t>(mesh->subsets.size()));
+            objects.batchIndices[i] = static_cast<int>(slots.GetMeshBatchSlot(i));
+
+            objects.boneIndices[i] = -1;
+            if (mesh->armatureId.IsValid()) {
+                const uint32_t armature_index = armatures.FindIndex(mesh->armatureId);
+                DEV_ASSERT_INDEX(armature_index, armature_count);
+                objects.boneIndices[i] = static_cast<int>(slots.GetBoneSlot(armature_index));
+            }
         }
+    });
 
-        if (!p_filter1(obj)) {
-            continue;
+    return objects;
+}
+
+// objects sharing a mesh are drawn with one instanced draw when at least this many are visible
+static constexpr uint32_t INSTANCING_MIN_COUNT = 2;
+
+// Candidates of a pass, the objects whose enlarged box in the object tree passed the pass test.
+// Candidates are split in chunks, each chunk tests the tight bounds and writes its own command bucket.
+// Visible objects that can be instanced go to the instance bucket of the chunk instead.
+struct PassCandidates {
+    uint32_t* indices;
+    uint32_t count;
+    uint32_t chunkOffset;
+    RenderCommand** buckets;
+    uint32_t* bucketSizes;
+    // null when the pass doesn't instance
+    uint32_t** instanceBuckets;
+    uint32_t* instanceBucketSizes;
+};
+
+// queries the object tree for every pass, then culls the candidates of all the passes in parallel.
+// the buckets are appended to the pass in chunk order so the result doesn't depend on scheduling
+static void FillPasses(Scene& p_scene, const MeshObjects& p_objects, std::span<const MeshPass> p_passes, FrameData& p_framedata) {
+    HBN_PROFILE_EVENT();
+
+    LinearAllocator& arena = p_framedata.arena;
+    const DynamicAABBTree& tree = p_scene.m_objectTree.GetTree();
+
+    std::span<PassCandidates> candidates = arena.AllocateArray<PassCandidates>(p_passes.size());
+    uint32_t chunk_count = 0;
+    for (size_t pass_index = 0; pass_index < p_passes.size(); ++pass_index) {
+        const MeshPass& pass = p_passes[pass_index];
+        PassCandidates& result = candidates[pass_index];
+        result.indices = arena.AllocateArray<uint32_t>(p_objects.count).data();
+        result.count = 0;
+
+        auto add_candidate = [&](uint32_t p_index) {
+            if ((p_objects.flags[p_index] & pass.flagMask) == pass.flagValue) {
+                result.indices[result.count++] = p_index;
+            }
+        };
+        if (pass.frustum) {
+            tree.Query(*pass.frustum, add_candidate);
+        } else {
+            tree.Query(*pass.region, add_candidate);
         }
+        // tree order changes as objects move, sorting keeps the command order stable
+        std::sort(result.indices, result.indices + result.count);
+
+        const bool instancing = pass.instancing && p_framedata.options.instancingEnabled;
+        const uint32_t pass_chunk_count = (result.count + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE;
+        result.chunkOffset = chunk_count;
+        result.buckets = arena.AllocateArray<RenderCommand*>(pass_chunk_count).data();
+        result.bucketSizes = arena.AllocateArray<uint32_t>(pass_chunk_count).data();
+        result.instanceBuckets = instancing ? arena.AllocateArray<uint32_t*>(pass_chunk_count).data() : nullptr;
+        result.instanceBucketSizes = arena.AllocateArray<uint32_t>(pass_chunk_count).data();
+        for (uint32_t chunk = 0; chunk < pass_chunk_count; ++chunk) {
+            const uint32_t begin = chunk * CULLING_GROUP_SIZE;
+            const uint32_t end = glm::min(begin + CULLING_GROUP_SIZE, result.count);
+            uint32_t capacity = 0;
+            for (uint32_t i = begin; i < end; ++i) {
+                capacity += p_objects.commandCounts[result.indices[i]];
+            }
+            result.buckets[chunk] = arena.AllocateArray<RenderCommand>(capacity).data();
+            if (instancing) {
+                result.instanceBuckets[chunk] = arena.AllocateArray<uint32_t>(end - begin).data();
+            }
+        }
+        chunk_count += pass_chunk_count;
+    }
+
+    // maps a chunk to its pass, so all the passes share one dispatch
+    uint32_t* chunk_passes = arena.AllocateArray<uint32_t>(chunk_count).data();
+    for (uint32_t pass_index = 0; pass_index < p_passes.size(); ++pass_index) {
+        const uint32_t end = pass_index + 1 < p_passes.size() ? candidates[pass_index + 1].chunkOffset : chunk_count;
+        for (uint32_t chunk = candidates[pass_index].chunkOffset; chunk < end; ++chunk) {
+            chunk_passes[chunk] = pass_index;
+        }
+    }
 
-        const TransformComponent& transform = *p_scene.GetComponent<TransformComponent>(entity);
-        DEV_ASSERT(p_scene.Contains<MeshComponent>(obj.meshId));
+    const auto& materials = p_scene.GetManager<MaterialComponent>();
+    const ecs::Entity selected = p_scene.m_selected;
 
-        const MeshComponent& mesh = *p_scene.GetComponent<MeshComponent>(obj.meshId);
+    auto material_slot = [&](ecs::Entity p_material_id) {
+        const uint32_t material_index = materials.FindIndex(p_material_id);
+        DEV_ASSERT(material_index != ecs::EntityIndex::INVALID_INDEX);
+        return p_objects.materialIndices[material_index];
+    };
 
-        const Matrix4x4f& world_matrix = transform.GetWorldMatrix();
-        AABB aabb = mesh.localBound;
-        aabb.ApplyMatrix(world_matrix);
-        if (!p_filter2(aabb)) {
-            continue;
+    auto object_depth = [&p_objects](const MeshPass& p_pass, uint32_t p_index) {
+        if (!p_pass.view) {
+            return 0.0f;
+        }
+        const Vector3f center = p_objects.bounds[p_index].Center();
+        return -(*p_pass.view * Vector4f(center, 1.0f)).z;
+    };
+
+    auto sort_key = [&p_objects](const MeshPass& p_pass, uint32_t p_pass_index, uint32_t p_index, int p_material_slot, float p_depth) {
+        uint32_t pipeline = 0;
+        if (p_pass.pipeline != PSO_NAME_MAX) {
+            const bool double_sided = p_objects.meshes[p_index]->flags & MeshComponent::DOUBLE_SIDED;
+            pipeline = (double_sided ? p_pass.doubleSidedPipeline : p_pass.pipeline) + 1;
         }
+        const uint32_t material = static_cast<uint32_t>(p_material_slot + 1);
+        const uint32_t mesh_index = p_objects.meshIndices[p_index] + 1;
+        return p_pass.backToFront ? MakeTransparentSortKey(p_pass_index, pipeline, material, mesh_index, p_depth)
+                                  : MakeOpaqueSortKey(p_pass_index, pipeline, material, mesh_index, p_depth);
+    };
+
+    auto subset_visible = [&](const MeshPass& p_pass, uint32_t p_index, const MeshComponent::MeshSubset& p_subset) {
+        AABB aabb = p_subset.local_bound;
+        aabb.ApplyMatrix(*p_objects.worldMatrices[p_index]);
+        return p_pass.frustum ? p_pass.frustum->Intersects(aabb) : p_pass.region->Intersects(aabb);
+    };
 
-        PerBatchConstantBuffer batch_buffer;
-        batch_buffer.c_worldMatrix = world_matrix;
-        batch_buffer.c_meshFlag = mesh.armatureId.IsValid();
+    // the draw of the whole mesh of object p_index, without a sort key
+    auto object_draw = [&](uint32_t p_index) {
+        const MeshComponent& mesh = *p_objects.meshes[p_index];
 
         DrawCommand draw;
-        if (entity == p_scene.m_selected) {
+        if (p_objects.entities[p_index] == selected) {
             draw.flags = STENCIL_FLAG_SELECTED;
         }
+        draw.batch_idx = p_objects.batchIndices[p_index];
+        draw.bone_idx = p_objects.boneIndices[p_index];
+        draw.mat_idx = -1;
+        draw.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        draw.mesh_data = mesh.gpuResource.get();
+        DEV_ASSERT(draw.mesh_data);
+        return draw;
+    };
+
+    // writes the commands of object p_index, one per visible subset, returns how many
+    auto emit_object = [&](const MeshPass& p_pass, uint32_t p_pass_index, uint32_t p_index, RenderCommand* p_out) {
+        const MeshComponent& mesh = *p_objects.meshes[p_index];
+        const float depth = object_depth(p_pass, p_index);
+
+        DrawCommand draw = object_draw(p_index);
+        if (p_pass.modelOnly) {
+            draw.sortKey = sort_key(p_pass, p_pass_index, p_index, -1, depth);
+            p_out[0] = RenderCommand::From(draw);
+            return 1u;
+        }
 
-        draw.batch_idx = p_framedata.batchCache.FindOrAdd(entity, batch_buffer);
-        if (mesh.armatureId.IsValid()) {
-            auto& armature = *p_scene.GetComponent<ArmatureComponent>(mesh.armatureId);
-            DEV_ASSERT(armature.boneTransforms.size() <= MAX_BONE_COUNT);
+        uint32_t size = 0;
+        for (const auto& subset : mesh.subsets) {
+            if (!subset_visible(p_pass, p_index, subset)) {
+                continue;
+            }
+
+            draw.indexCount = subset.index_count;
+            draw.indexOffset = subset.index_offset;
+            draw.mat_idx = material_slot(subset.material_id);
+            draw.sortKey = sort_key(p_pass, p_pass_index, p_index, draw.mat_idx, depth);
+            p_out[size++] = RenderCommand::From(draw);
+        }
+        return size;
+    };
 
-            BoneConstantBuffer bone;
-            memcpy(bone.c_bones, armature.boneTransforms.data(), sizeof(Matrix4x4f) * armature.boneTransforms.size());
+    ForEachChunk(chunk_count, [&](uint32_t p_chunk) {
+        const uint32_t pass_index = chunk_passes[p_chunk];
+        const MeshPass& pass = p_passes[pass_index];
+        const PassCandidates& pass_candidates = candidates[pass_index];
+        const uint32_t local_chunk = p_chunk - pass_candidates.chunkOffset;
+        const uint32_t begin = local_chunk * CULLING_GROUP_SIZE;
+        const uint32_t count = glm::min(CULLING_GROUP_SIZE, pass_candidates.count - begin);
+        const uint32_t* indices = pass_candidates.indices + begin;
+
+        // the tree tested the enlarged boxes, the tight bounds are tested in batch
+        float soa[6][CULLING_GROUP_SIZE];
+        for (uint32_t local = 0; local < count; ++local) {
+            const AABB& aabb = p_objects.bounds[indices[local]];
+            for (int axis = 0; axis < 3; ++axis) {
+                soa[axis][local] = aabb.GetMin()[axis];
+                soa[axis + 3][local] = aabb.GetMax()[axis];
+            }
+        }
+        const AABBBatch bounds = { soa[0], soa[1], soa[2], soa[3], soa[4], soa[5] };
 
-            // @TODO: better memory usage
-            draw.bone_idx = p_framedata.boneCache.FindOrAdd(mesh.armatureId, bone);
+        uint8_t visible[CULLING_GROUP_SIZE];
+        if (pass.frustum) {
+            pass.frustum->Intersects(bounds, visible, count);
         } else {
-            draw.bone_idx = -1;
+            const Vector3f& region_min = pass.region->GetMin();
+            const Vector3f& region_max = pass.region->GetMax();
+            for (uint32_t i = 0; i < count; ++i) {
+                visible[i] = bounds.minX[i] <= region_max.x && bounds.maxX[i] >= region_min.x &&
+                             bounds.minY[i] <= region_max.y && bounds.maxY[i] >= region_min.y &&
+                             bounds.minZ[i] <= region_max.z && bounds.maxZ[i] >= region_min.z;
+            }
         }
 
-        draw.mesh_data = mesh.gpuResource.get();
-        draw.mat_idx = -1;
-        DEV_ASSERT(draw.mesh_data);
+        RenderCommand* bucket = pass_candidates.buckets[local_chunk];
+        uint32_t* instance_bucket = pass_candidates.instanceBuckets ? pass_candidates.instanceBuckets[local_chunk] : nullptr;
+        uint32_t size = 0;
+        uint32_t instance_size = 0;
+        for (uint32_t local = 0; local < count; ++local) {
+            if (!visible[local]) {
+                continue;
+            }
 
-        draw.indexCount = static_cast<uint32_t>(mesh.indices.size());
-        p_commands.emplace_back(RenderCommand::From(draw));
+            const uint32_t i = indices[local];
+            // skinned objects need their own bones, the selected one its own stencil
+            if (instance_bucket && p_objects.boneIndices[i] < 0 && p_objects.entities[i] != selected) {
+                instance_bucket[instance_size++] = i;
+                continue;
+            }
+            size += emit_object(pass, pass_index, i, bucket + size);
+        }
+        pass_candidates.bucketSizes[local_chunk] = size;
+        pass_candidates.instanceBucketSizes[local_chunk] = instance_size;
+    });
+
+    // the instanced objects of a pass are grouped by mesh, a group draws every subset of the mesh with
+    // the world matrices in an instance buffer. groups too small to pay off, and groups past the last
+    // instance buffer, are drawn object by object
+    const RenderSlotTable& slots = *p_framedata.slots;
+
+    // passes culling with the same volume, like the prepass and the gbuffer pass, get the same groups,
+    // a group keeps the instance buffer an earlier pass filled. keyed by the first object of the group
+    struct InstanceGroup {
+        const uint32_t* objects;
+        uint32_t count;
+        int instanceIdx;
+    };
+    ArenaHashMap<uint32_t, InstanceGroup> filled_groups(arena);
+    std::span<std::span<RenderCommand>> instanced = arena.AllocateArray<std::span<RenderCommand>>(p_passes.size());
+    for (uint32_t pass_index = 0; pass_index < p_passes.size(); ++pass_index) {
+        const MeshPass& pass = p_passes[pass_index];
+        const PassCandidates& pass_candidates = candidates[pass_index];
+        const uint32_t pass_chunk_count = (pass_candidates.count + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE;
+        instanced[pass_index] = std::span<RenderCommand>();
+        if (!pass_candidates.instanceBuckets) {
+            continue;
+        }
+
+        uint32_t object_count = 0;
+        for (uint32_t chunk = 0; chunk < pass_chunk_count; ++chunk) {
+            object_count += pass_candidates.instanceBucketSizes[chunk];
+        }
+        if (object_count == 0) {
+            continue;
+        }
+
+        std::span<uint32_t> objects = arena.AllocateArray<uint32_t>(object_count);
+        uint32_t command_capacity = 0;
+        uint32_t offset = 0;
+        for (uint32_t chunk = 0; chunk < pass_chunk_count; ++chunk) {
+            const uint32_t* instance_bucket = pass_candidates.instanceBuckets[chunk];
+            for (uint32_t i = 0; i < pass_candidates.instanceBucketSizes[chunk]; ++i) {
+                objects[offset++] = instance_bucket[i];
+                command_capacity += p_objects.commandCounts[instance_bucket[i]];
+            }
+        }
+        RadixSort(objects, arena.AllocateArray<uint32_t>(object_count), [&p_objects](uint32_t p_index) {
+            return static_cast<uint64_t>(p_objects.meshIndices[p_index]);
+        });
+
+        RenderCommand* commands = arena.AllocateArray<RenderCommand>(command_capacity).data();
+        uint32_t size = 0;
+        for (uint32_t begin = 0; begin < object_count;) {
+            const uint32_t mesh_index = p_objects.meshIndices[objects[begin]];
+            uint32_t end = begin + 1;
+            while (end < object_count && p_objects.meshIndices[objects[end]] == mesh_index) {
+                ++end;
+            }
+
+            for (uint32_t group = begin; group < end; group += MAX_BONE_COUNT) {
+                const uint32_t group_end = glm::min<uint32_t>(group + MAX_BONE_COUNT, end);
+                const uint32_t instance_count = group_end - group;
+                const uint32_t* group_objects = objects.data() + group;
+                int filled_idx = -1;
+                if (auto it = filled_groups.find(group_objects[0]); it != filled_groups.end()) {
+                    const InstanceGroup& filled = it->second;
+                    if (filled.count == instance_count && std::equal(group_objects, group_objects + instance_count, filled.objects)) {
+                        filled_idx = filled.instanceIdx;
+                    }
+                }
+                if (instance_count < INSTANCING_MIN_COUNT || (filled_idx < 0 && p_framedata.instanceCache.size() >= FrameData::MAX_INSTANCE_BUFFER_COUNT)) {
+                    for (uint32_t i = group; i < group_end; ++i) {
+                        size += emit_object(pass, pass_index, objects[i], commands + size);
+                    }
+                    continue;
+                }
+
+                // the group sorts by its nearest instance
+                float depth = std::numeric_limits<float>::max();
+                for (uint32_t i = group; i < group_end; ++i) {
+                    depth = glm::min(depth, object_depth(pass, objects[i]));
+                }
+
+                const uint32_t first = objects[group];
+                const MeshComponent& mesh = *p_objects.meshes[first];
+                DrawCommand draw;
+                draw.batch_idx = static_cast<int>(slots.GetInstanceBatchSlot());
+                draw.instance_idx = filled_idx;
+                draw.instanceCount = instance_count;
+                draw.mat_idx = -1;
+                draw.indexCount = static_cast<uint32_t>(mesh.indices.size());
+                draw.mesh_data = mesh.gpuResource.get();
+                DEV_ASSERT(draw.mesh_data);
+
+                // the instance buffer is filled by the first instanced draw of the group, unless a pass did already
+                auto emit_instanced = [&](int p_mat_idx) {
+                    if (draw.instance_idx < 0) {
+                        draw.instance_idx = static_cast<int>(p_framedata.instanceCache.size());
+                        BoneConstantBuffer& instances = p_framedata.instanceCache.emplace_back();
+                        for (uint32_t i = group; i < group_end; ++i) {
+                            instances.c_bones[i - group] = *p_objects.worldMatrices[objects[i]];
+                        }
+                        filled_groups[group_objects[0]] = { group_objects, instance_count, draw.instance_idx };
+                    }
+                    draw.mat_idx = p_mat_idx;
+                    draw.sortKey = sort_key(pass, pass_index, first, p_mat_idx, depth);
+                    commands[size++] = RenderCommand::From(draw);
+                };
+
+                if (pass.modelOnly) {
+                    emit_instanced(-1);
+                    continue;
+                }
+
+                // a subset every instance sees is drawn instanced, a subset only some instances see is
+                // drawn object by object, like emit_object() does
+                for (const auto& subset : mesh.subsets) {
+                    uint8_t visible[MAX_BONE_COUNT];
+                    uint32_t visible_count = 0;
+                    for (uint32_t i = group; i < group_end; ++i) {
+                        visible[i - group] = subset_visible(pass, objects[i], subset);
+                        visible_count += visible[i - group];
+                    }
+
+                    const int mat_idx = material_slot(subset.material_id);
+                    if (visible_count == instance_count) {
+                        draw.indexCount = subset.index_count;
+                        draw.indexOffset = subset.index_offset;
+                        emit_instanced(mat_idx);
+                        continue;
+                    }
+
+                    for (uint32_t i = group; i < group_end; ++i) {
+                        if (!visible[i - group]) {
+                            continue;
+                        }
+                        DrawCommand object = object_draw(objects[i]);
+                        object.indexCount = subset.index_count;
+                        object.indexOffset = subset.index_offset;
+                        object.mat_idx = mat_idx;
+                        object.sortKey = sort_key(pass, pass_index, objects[i], mat_idx, object_depth(pass, objects[i]));
+                        commands[size++] = RenderCommand::From(object);
+                    }
+                }
+            }
+            begin = end;
+        }
+        DEV_ASSERT(size <= command_capacity);
+        instanced[pass_index] = std::span<RenderCommand>(commands, size);
     }
+
+    // the commands added by this call are sorted, a pass filled more than once keeps its earlier commands first
+    std::span<std::span<RenderCommand>> added = arena.AllocateArray<std::span<RenderCommand>>(p_passes.size());
+    std::span<std::span<RenderCommand>> scratch = arena.AllocateArray<std::span<RenderCommand>>(p_passes.size());
+    for (size_t pass_index = 0; pass_index < p_passes.size(); ++pass_index) {
+        const PassCandidates& pass_candidates = candidates[pass_index];
+        const uint32_t pass_chunk_count = (pass_candidates.count + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE;
+        ArenaVector<RenderCommand>& commands = *p_passes[pass_index].commands;
+        const size_t offset = commands.size();
+        size_t total = offset + instanced[pass_index].size();
+        for (uint32_t chunk = 0; chunk < pass_chunk_count; ++chunk) {
+            total += pass_candidates.bucketSizes[chunk];
+        }
+        commands.reserve(total);
+        for (uint32_t chunk = 0; chunk < pass_chunk_count; ++chunk) {
+            const RenderCommand* bucket = pass_candidates.buckets[chunk];
+            commands.insert(commands.end(), bucket, bucket + pass_candidates.bucketSizes[chunk]);
+        }
+        commands.insert(commands.end(), instanced[pass_index].begin(), instanced[pass_index].end());
+        added[pass_index] = std::span<RenderCommand>(commands.data() + offset, total - offset);
+        scratch[pass_index] = arena.AllocateArray<RenderCommand>(total - offset);
+    }
+
+    ForEachChunk(static_cast<uint32_t>(p_passes.size()), [&](uint32_t p_pass_index) {
+        RadixSort(added[p_pass_index], scratch[p_pass_index], [](const RenderCommand& p_command) {
+            return p_command.draw.sortKey;
+        });
+    });
 }
 
-static void FillLightBuffer(const Scene& p_scene, FrameData& p_framedata) {
+static void FillLightBuffer(Scene& p_scene, const MeshObjects& p_objects, FrameData& p_framedata) {
     const uint32_t light_count = glm::min<uint32_t>((uint32_t)p_scene.GetCount<LightComponent>(), MAX_LIGHT_COUNT);
 
     auto& cache = p_framedata.perFrameCache;
@@ -176,16 +637,9 @@ static void FillLightBuffer(const Scene& p_scene, FrameData& p_framedata) {
 
                 // @TODO: fix
                 Frustum light_frustum(light.projection_matrix * light.view_matrix);
-                FillPass(
-                    p_scene,
-                    [](const MeshRendererComponent& p_object) {
-                        return p_object.flags & MeshRendererComponent::FLAG_CAST_SHADOW;
-                    },
-                    [&](const AABB& p_aabb) {
-                        return light_frustum.Intersects(p_aabb);
-                    },
-                    p_framedata.shadow_pass_commands,
-                    p_framedata);
+                constexpr uint32_t cast_shadow_flag = MeshRendererComponent::FLAG_CAST_SHADOW;
+                const MeshPass shadow_pass = { &p_framedata.shadow_pass_commands, cast_shadow_flag, cast_shadow_flag, true, &light_frustum, nullptr, &light.view_matrix, false, true, PSO_NAME_MAX, PSO_NAME_MAX };
+                FillPasses(p_scene, p_objects, { &shadow_pass, 1 }, p_framedata);
             } break;
             case LIGHT_TYPE_POINT: {
                 [[maybe_unused]] const int shadow_map_index = light_component.GetShadowMapIndex();
@@ -254,8 +708,8 @@ static void AddDebugCube(FrameData& p_framedata,
     const auto& min = p_aabb.GetMin();
     const auto& max = p_aabb.GetMax();
 
-    std::vector<Vector3f> positions;
-    std::vector<uint32_t> indices;
+    std::array<Vector3f, 8> positions;
+    std::array<uint32_t, 36> indices;
     BoxWireFrameHelper(min, max, positions, indices);
 
     auto& context = p_framedata.drawDebugContext;
@@ -318,7 +772,7 @@ static void FillVoxelPass(const Scene& p_scene, FrameData& p_framedata) {
     cache.c_voxelSize = voxel_size;
 }
 
-static void FillMainPass(const Scene& p_scene, FrameData& p_framedata) {
+static void FillMainPass(Scene& p_scene, const MeshObjects& p_objects, FrameData& p_framedata) {
     const auto& camera = p_framedata.mainCamera;
     Frustum camera_frustum(camera.projectionMatrixFrustum * camera.viewMatrix);
 
@@ -330,108 +784,75 @@ static void FillMainPass(const Scene& p_scene, FrameData& p_framedata) {
     p_framedata.mainPass.pass_idx = static_cast<int>(p_framedata.passCache.size());
     p_framedata.passCache.emplace_back(pass_constant);
 
-    using FilterFunc = std::function<bool(const AABB&)>;
-    FilterFunc filter_main = [&](const AABB& p_aabb) -> bool { return camera_frustum.Intersects(p_aabb); };
-
-    const bool is_opengl = p_framedata.options.isOpengl;
-    for (auto [entity, obj] : p_scene.m_MeshRendererComponents) {
-        const bool is_renderable = obj.flags & MeshRendererComponent::FLAG_RENDERABLE;
-        const bool is_transparent = obj.flags & MeshRendererComponent::FLAG_TRANSPARENT;
-        const bool is_opaque = is_renderable && !is_transparent;
-
-        // @TODO: cast shadow
-
-        const TransformComponent& transform = *p_scene.GetComponent<TransformComponent>(entity);
-        DEV_ASSERT(p_scene.Contains<TransformComponent>(entity));
-        const MeshComponent& mesh = *p_scene.GetComponent<MeshComponent>(obj.meshId);
-        DEV_ASSERT(p_scene.Contains<MeshComponent>(obj.meshId));
-
-        const Matrix4x4f& world_matrix = transform.GetWorldMatrix();
-        AABB aabb = mesh.localBound;
-        aabb.ApplyMatrix(world_matrix);
-
-        PerBatchConstantBuffer batch_buffer;
-        batch_buffer.c_worldMatrix = world_matrix;
-        batch_buffer.c_meshFlag = mesh.armatureId.IsValid();
-
-        DrawCommand draw;
-        // @TODO: refactor the stencil part
-        if (entity == p_scene.m_selected) {
-            draw.flags = STENCIL_FLAG_SELECTED;
-        }
-
-        if (mesh.armatureId.IsValid()) {
-            auto& armature = *p_scene.GetComponent<ArmatureComponent>(mesh.armatureId);
-            DEV_ASSERT(armature.boneTransforms.size() <= MAX_BONE_COUNT);
-
-            BoneConstantBuffer bone;
-            memcpy(bone.c_bones, armature.boneTransforms.data(), sizeof(Matrix4x4f) * armature.boneTransforms.size());
-
-            // @TODO: better memory usage
-            draw.bone_idx = p_framedata.boneCache.FindOrAdd(mesh.armatureId, bone);
-        } else {
-            draw.bone_idx = -1;
-        }
-
-        draw.mat_idx = -1;
-        draw.batch_idx = p_framedata.batchCache.FindOrAdd(entity, batch_buffer);
-        draw.indexCount = static_cast<uint32_t>(mesh.indices.size());
-        draw.mesh_data = (GpuMesh*)mesh.gpuResource.get();
-        DEV_ASSERT(draw.mesh_data);
-
-        auto add_to_pass = [&](std::vector<RenderCommand>& p_commands, FilterFunc& p_filter, bool p_model_only) {
-            if (!p_filter(aabb)) {
-                return;
-            }
-
-            DrawCommand drawCmd = draw;
-            if (p_model_only) {
-                p_commands.emplace_back(RenderCommand::From(drawCmd));
-                return;
-            }
+    // @TODO: cast shadow
+    constexpr uint32_t opaque_mask = MeshRendererComponent::FLAG_RENDERABLE | MeshRendererComponent::FLAG_TRANSPARENT;
+    constexpr uint32_t opaque_value = MeshRendererComponent::FLAG_RENDERABLE;
+    constexpr uint32_t transparent_mask = MeshRendererComponent::FLAG_TRANSPARENT;
+
+    MeshPass passes[4] = {
+        { &p_framedata.prepass_commands, opaque_mask, opaque_value, true, &camera_frustum, nullptr, &camera.viewMatrix, false, true, PSO_PREPASS, PSO_PREPASS },
+        { &p_framedata.gbuffer_commands, opaque_mask, opaque_value, false, &camera_frustum, nullptr, &camera.viewMatrix, false, true, PSO_GBUFFER, PSO_GBUFFER_DOUBLE_SIDED },
+        // back to front order is per object
+        { &p_framedata.transparent_commands, transparent_mask, transparent_mask, false, &camera_frustum, nullptr, &camera.viewMatrix, true, false, PSO_FORWARD_TRANSPARENT, PSO_FORWARD_TRANSPARENT },
+        { &p_framedata.voxelization_commands, 0, 0, false, nullptr, &p_framedata.voxel_gi_bound, nullptr, false, true, PSO_VOXELIZATION, PSO_VOXELIZATION },
+    };
 
-            for (const auto& subset : mesh.subsets) {
-                AABB aabb2 = subset.local_bound;
-                aabb2.ApplyMatrix(world_matrix);
-                if (!p_filter(aabb2)) {
-                    continue;
-                }
+    const size_t pass_count = p_framedata.voxel_gi_bound.IsValid() ? 4 : 3;
+    FillPasses(p_scene, p_objects, { passes, pass_count }, p_framedata);
+}
 
-                const MaterialComponent* material = p_scene.GetComponent<MaterialComponent>(subset.material_id);
-                MaterialConstantBuffer material_buffer;
-                FillMaterialConstantBuffer(is_opengl, material, material_buffer);
+// one instance per subset of the opaque objects, gpu_culling.cs writes the draw arguments of the visible ones
+static void FillCullingPass(const MeshObjects& p_objects, FrameData& p_framedata) {
+    HBN_PROFILE_EVENT();
 
-                drawCmd.indexCount = subset.index_count;
-                drawCmd.indexOffset = subset.index_offset;
-                drawCmd.mat_idx = p_framedata.materialCache.FindOrAdd(subset.material_id, material_buffer);
+    constexpr uint32_t opaque_mask = MeshRendererComponent::FLAG_RENDERABLE | MeshRendererComponent::FLAG_TRANSPARENT;
+    constexpr uint32_t opaque_value = MeshRendererComponent::FLAG_RENDERABLE;
 
-                p_commands.emplace_back(RenderCommand::From(drawCmd));
-            }
-        };
-
-        if (is_opaque) {
-            add_to_pass(p_framedata.prepass_commands, filter_main, true);
+    auto& instances = p_framedata.cullInstances;
+    for (uint32_t i = 0; i < p_objects.count; ++i) {
+        if ((p_objects.flags[i] & opaque_mask) != opaque_value) {
+            continue;
         }
 
-        if (is_opaque) {
-            add_to_pass(p_framedata.gbuffer_commands, filter_main, false);
+        const AABB& bounds = p_objects.bounds[i];
+        for (const auto& subset : p_objects.meshes[i]->subsets) {
+            GpuCullInstance& instance = instances.emplace_back();
+            instance.min = bounds.GetMin();
+            instance.max = bounds.GetMax();
+            instance.indexCount = subset.index_count;
+            instance.firstIndex = subset.index_offset;
+            instance.baseVertex = 0;
+            // the batch slot, so the draw can find the world matrix
+            instance.drawId = static_cast<uint32_t>(p_objects.batchIndices[i]);
+            instance._padding = Vector2i(0);
         }
+    }
 
-        if (is_transparent) {
-            add_to_pass(p_framedata.transparent_commands, filter_main, false);
-        }
+    const auto& camera = p_framedata.mainCamera;
+    const Frustum camera_frustum(camera.projectionMatrixFrustum * camera.viewMatrix);
+    const Vector2i hiz_size = GetHiZSize(static_cast<int>(camera.sceenWidth), static_cast<int>(camera.sceenHeight));
+    const uint32_t instance_count = static_cast<uint32_t>(instances.size());
+    if (const auto* hiz_camera = p_framedata.hizCamera; hiz_camera) {
+        const Matrix4x4f hiz_matrix = BuildHiZMatrix(hiz_camera->projectionMatrixRendering * hiz_camera->viewMatrix, p_framedata.options.isOpengl);
+        p_framedata.cullConstants = MakeCullConstants(camera_frustum, &hiz_matrix, hiz_size, instance_count);
+    } else {
+        p_framedata.cullConstants = MakeCullConstants(camera_frustum, nullptr, hiz_size, instance_count);
+    }
 
-        if (p_framedata.voxel_gi_bound.IsValid()) {
-            FilterFunc gi_filter = [&](const AABB& p_aabb) -> bool { return p_framedata.voxel_gi_bound.Intersects(p_aabb); };
-            add_to_pass(p_framedata.voxelization_commands, gi_filter, false);
-        }
+    if (instance_count) {
+        const int group_count = CeilingDivision(static_cast<int>(instance_count), GPU_CULLING_LOCAL_SIZE);
+        p_framedata.culling_commands.emplace_back(RenderCommand::From(ComputeCommand{ { group_count, 1, 1 } }));
     }
 }
 
 void RunMeshRenderSystem(Scene& p_scene, FrameData& p_framedata) {
-    FillLightBuffer(p_scene, p_framedata);
+    const MeshObjects objects = GatherMeshObjects(p_scene, p_framedata);
+    FillLightBuffer(p_scene, objects, p_framedata);
     FillVoxelPass(p_scene, p_framedata);
-    FillMainPass(p_scene, p_framedata);
+    FillMainPass(p_scene, objects, p_framedata);
+    if (p_framedata.options.debugGpuCulling) {
+        FillCullingPass(objects, p_framedata);
+    }
 }
 
 // @TODO: fix emitter
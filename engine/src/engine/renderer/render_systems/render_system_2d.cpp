@@ -1,12 +1,17 @@
 #include "engine/renderer/frame_data.h"
 #include "engine/assets/assets.h"
+#include "engine/renderer/render_slot_table.h"
 #include "engine/scene/scene.h"
 
 namespace my {
 
 void RunTileMapRenderSystem(Scene& p_scene, FrameData& p_framedata) {
-    auto view = p_scene.View<TileMapComponent>();
-    for (const auto [id, tileMap] : view) {
+    DEV_ASSERT(p_framedata.slots);
+    const RenderSlotTable& slots = *p_framedata.slots;
+
+    const uint32_t tile_map_count = static_cast<uint32_t>(p_scene.GetCount<TileMapComponent>());
+    for (uint32_t i = 0; i < tile_map_count; ++i) {
+        TileMapComponent& tileMap = p_scene.GetComponentByIndex<TileMapComponent>(i);
 
         // Should move tile map logic to somewhere else
         // But this is a editor only logic, we are not going to update it in actual game
@@ -16,16 +21,10 @@ void RunTileMapRenderSystem(Scene& p_scene, FrameData& p_framedata) {
         }
 
         if (tileMap.m_sprite.texture->gpu_texture) {
-            const TransformComponent& transform = *p_scene.GetComponent<TransformComponent>(id);
-
-            const Matrix4x4f& world_matrix = transform.GetWorldMatrix();
-            PerBatchConstantBuffer batch_buffer;
-            batch_buffer.c_worldMatrix = world_matrix;
-
             DrawCommand draw;
             draw.indexCount = tileMap.m_mesh->desc.drawCount;
             draw.mesh_data = tileMap.m_mesh.get();
-            draw.batch_idx = p_framedata.batchCache.FindOrAdd(id, batch_buffer);
+            draw.batch_idx = static_cast<int>(slots.GetTileMapBatchSlot(i));
 
             // @TODO: ?
             draw.texture = tileMap.m_sprite.texture->gpu_texture.get();
@@ -0,0 +1,193 @@
+#include "asset_load_queue.h"
+
+#include "engine/assets/asset_entry.h"
+
+namespace my {
+
+void AssetLoadQueue::SetWorkerCount(uint32_t p_count) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_workerCount = p_count;
+    }
+    m_wakeCondition.notify_all();
+}
+
+void AssetLoadQueue::SetTypeLimit(AssetType p_type, uint32_t p_limit) {
+    DEV_ASSERT_INDEX(p_type.GetData(), AssetType::Count);
+    {
+        std::lock_guard lock(m_mutex);
+        m_typeLimits[p_type.GetData()] = p_limit;
+    }
+    m_wakeCondition.notify_all();
+}
+
+void AssetLoadQueue::Push(const AssetLoadRequest& p_request) {
+    DEV_ASSERT(p_request.entry);
+    DEV_ASSERT_INDEX(std::to_underlying(p_request.priority), std::to_underlying(AssetLoadPriority::Count));
+    {
+        std::lock_guard lock(m_mutex);
+        m_queues[std::to_underlying(p_request.priority)].push_back(p_request);
+    }
+    // not every worker can take every request, wake them all
+    m_wakeCondition.notify_all();
+}
+
+bool AssetLoadQueue::FindNext(uint32_t p_worker_index, RequestQueue*& p_out_queue, RequestQueue::iterator& p_out_it) {
+    if (p_worker_index >= m_workerCount) {
+        return false;
+    }
+
+    for (RequestQueue& queue : m_queues) {
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            const uint8_t type = it->entry->metadata.type.GetData();
+            if (m_typeLimits[type] == 0 || m_typeInFlight[type] < m_typeLimits[type]) {
+                p_out_queue = &queue;
+                p_out_it = it;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool AssetLoadQueue::PopLocked(uint32_t p_worker_index, AssetLoadRequest& p_out_request) {
+    RequestQueue* queue = nullptr;
+    RequestQueue::iterator it;
+    if (!FindNext(p_worker_index, queue, it)) {
+        return false;
+    }
+
+    p_out_request = *it;
+    queue->erase(it);
+
+    const uint8_t type = p_out_request.entry->metadata.type.GetData();
+    ++m_typeInFlight[type];
+    ++m_inFlight;
+    m_totalWaitTime += p_out_request.timer.GetDuration().ToMillisecond();
+    p_out_request.timer.Start();
+    return true;
+}
+
+bool AssetLoadQueue::Pop(uint32_t p_worker_index, AssetLoadRequest& p_out_request) {
+    std::unique_lock lock(m_mutex);
+    for (;;) {
+        if (m_shutdown) {
+            return false;
+        }
+        if (PopLocked(p_worker_index, p_out_request)) {
+            return true;
+        }
+        m_wakeCondition.wait(lock);
+    }
+}
+
+bool AssetLoadQueue::TryPop(uint32_t p_worker_index, AssetLoadRequest& p_out_request) {
+    std::lock_guard lock(m_mutex);
+    return !m_shutdown && PopLocked(p_worker_index, p_out_request);
+}
+
+void AssetLoadQueue::Finish(const AssetLoadRequest& p_request) {
+    const double load_time = p_request.timer.GetDuration().ToMillisecond();
+    const uint8_t type = p_request.entry->metadata.type.GetData();
+    bool limited = false;
+    {
+        std::lock_guard lock(m_mutex);
+        DEV_ASSERT(m_typeInFlight[type] > 0 && m_inFlight > 0);
+        --m_typeInFlight[type];
+        --m_inFlight;
+        ++m_loadCount;
+        m_totalLoadTime += load_time;
+        m_maxLoadTime = std::max(m_maxLoadTime, load_time);
+        limited = m_typeLimits[type] != 0;
+    }
+    // a request held back by the type limit can go now
+    if (limited) {
+        m_wakeCondition.notify_all();
+    }
+}
+
+bool AssetLoadQueue::FindQueued(const AssetEntry* p_entry, RequestQueue*& p_out_queue, RequestQueue::iterator& p_out_it) {
+    for (RequestQueue& queue : m_queues) {
+        auto it = std::find_if(queue.begin(), queue.end(), [p_entry](const AssetLoadRequest& p_request) {
+            return p_request.entry == p_entry;
+        });
+        if (it != queue.end()) {
+            p_out_queue = &queue;
+            p_out_it = it;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AssetLoadQueue::Promote(const AssetEntry* p_entry, AssetLoadPriority p_priority) {
+    {
+        std::lock_guard lock(m_mutex);
+        RequestQueue* queue = nullptr;
+        RequestQueue::iterator it;
+        if (!FindQueued(p_entry, queue, it)) {
+            return false;
+        }
+        if (p_priority >= it->priority) {
+            return true;
+        }
+
+        AssetLoadRequest request = *it;
+        queue->erase(it);
+        request.priority = p_priority;
+        m_queues[std::to_underlying(p_priority)].push_back(request);
+    }
+    m_wakeCondition.notify_all();
+    return true;
+}
+
+bool AssetLoadQueue::Cancel(const AssetEntry* p_entry) {
+    std::lock_guard lock(m_mutex);
+    RequestQueue* queue = nullptr;
+    RequestQueue::iterator it;
+    if (!FindQueued(p_entry, queue, it)) {
+        return false;
+    }
+
+    queue->erase(it);
+    ++m_cancelCount;
+    return true;
+}
+
+std::vector<AssetLoadRequest> AssetLoadQueue::Cancel(AssetLoadPriority p_priority) {
+    std::lock_guard lock(m_mutex);
+    RequestQueue& queue = m_queues[std::to_underlying(p_priority)];
+    std::vector<AssetLoadRequest> cancelled(queue.begin(), queue.end());
+    queue.clear();
+    m_cancelCount += cancelled.size();
+    return cancelled;
+}
+
+void AssetLoadQueue::Shutdown() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wakeCondition.notify_all();
+}
+
+AssetLoadQueue::Metrics AssetLoadQueue::GetMetrics() const {
+    std::lock_guard lock(m_mutex);
+    Metrics metrics;
+    for (int i = 0; i < std::to_underlying(AssetLoadPriority::Count); ++i) {
+        metrics.queueDepth[i] = static_cast<uint32_t>(m_queues[i].size());
+    }
+    metrics.inFlight = m_inFlight;
+    metrics.loadCount = m_loadCount;
+    metrics.cancelCount = m_cancelCount;
+    if (const uint64_t started = m_loadCount + m_inFlight; started) {
+        metrics.averageWaitTime = m_totalWaitTime / started;
+    }
+    if (m_loadCount) {
+        metrics.averageLoadTime = m_totalLoadTime / m_loadCount;
+    }
+    metrics.maxLoadTime = m_maxLoadTime;
+    return metrics;
+}
+
+}  // namespace my
@@ -0,0 +1,92 @@
+#pragma once
+#include "engine/assets/asset_interface.h"
+#include "engine/core/os/timer.h"
+
+namespace my {
+
+class AssetEntry;
+
+enum class AssetLoadPriority : uint8_t {
+    // needed to draw the current frame
+    Visible,
+    // likely to be needed soon
+    Prefetch,
+    // everything else, such as the assets loaded at start up
+    Background,
+    Count,
+};
+
+struct AssetLoadRequest {
+    AssetEntry* entry{ nullptr };
+    OnAssetLoadSuccessFunc onSuccess{ nullptr };
+    void* userdata{ nullptr };
+    AssetLoadPriority priority{ AssetLoadPriority::Background };
+    // time spent in the queue, then time spent loading once a worker takes it
+    Timer timer;
+};
+
+// Requests of the asset loader threads, one FIFO per priority. A worker takes the oldest request of
+// the highest priority whose asset type is under its concurrency limit, so a large scene doesn't hold
+// back the small textures behind it. Requests can be promoted or cancelled until a worker takes them.
+class AssetLoadQueue {
+public:
+    struct Metrics {
+        uint32_t queueDepth[std::to_underlying(AssetLoadPriority::Count)]{};
+        uint32_t inFlight{ 0 };
+        uint64_t loadCount{ 0 };
+        uint64_t cancelCount{ 0 };
+        // in milliseconds
+        double averageWaitTime{ 0.0 };
+        double averageLoadTime{ 0.0 };
+        double maxLoadTime{ 0.0 };
+    };
+
+    // only workers with an index below p_count take requests, the others wait
+    void SetWorkerCount(uint32_t p_count);
+    // at most p_limit assets of p_type are loaded at the same time, 0 means no limit
+    void SetTypeLimit(AssetType p_type, uint32_t p_limit);
+
+    void Push(const AssetLoadRequest& p_request);
+
+    // waits for a request worker p_worker_index can take, returns false once Shutdown() is called
+    bool Pop(uint32_t p_worker_index, AssetLoadRequest& p_out_request);
+    bool TryPop(uint32_t p_worker_index, AssetLoadRequest& p_out_request);
+    // a request returned by Pop() is loaded, frees its type slot
+    void Finish(const AssetLoadRequest& p_request);
+
+    // moves a queued request to a higher priority, returns false if it isn't queued
+    bool Promote(const AssetEntry* p_entry, AssetLoadPriority p_priority);
+    // removes a queued request, returns false if it isn't queued, a request being loaded can't be cancelled
+    bool Cancel(const AssetEntry* p_entry);
+    // removes every queued request of p_priority, such as stale prefetches
+    std::vector<AssetLoadRequest> Cancel(AssetLoadPriority p_priority);
+
+    void Shutdown();
+
+    Metrics GetMetrics() const;
+
+private:
+    using RequestQueue = std::deque<AssetLoadRequest>;
+
+    bool FindNext(uint32_t p_worker_index, RequestQueue*& p_out_queue, RequestQueue::iterator& p_out_it);
+    bool PopLocked(uint32_t p_worker_index, AssetLoadRequest& p_out_request);
+    bool FindQueued(const AssetEntry* p_entry, RequestQueue*& p_out_queue, RequestQueue::iterator& p_out_it);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+
+    RequestQueue m_queues[std::to_underlying(AssetLoadPriority::Count)];
+    uint32_t m_typeLimits[AssetType::Count]{};
+    uint32_t m_typeInFlight[AssetType::Count]{};
+    uint32_t m_workerCount{ 1 };
+    bool m_shutdown{ false };
+
+    uint32_t m_inFlight{ 0 };
+    uint64_t m_loadCount{ 0 };
+    uint64_t m_cancelCount{ 0 };
+    double m_totalWaitTime{ 0.0 };
+    double m_totalLoadTime{ 0.0 };
+    double m_maxLoadTime{ 0.0 };
+};
+
+}  // namespace my
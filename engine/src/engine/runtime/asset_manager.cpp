@@ -12,6 +12,7 @@
 #include "engine/renderer/graphics_manager.h"
 #include "engine/runtime/application.h"
 #include "engine/runtime/asset_registry.h"
+#include "engine/runtime/common_dvars.h"
 #include "engine/scene/scene.h"
 
 #if USING(PLATFORM_WINDOWS)
@@ -39,20 +40,11 @@ namespace my {
 namespace fs = std::filesystem;
 using AssetCreateFunc = AssetRef (*)(void);
 
-struct AssetManager::LoadTask {
-    AssetEntry* handle;
-    OnAssetLoadSuccessFunc on_success;
-    void* userdata;
-};
+static constexpr uint32_t LOADER_THREAD_COUNT = thread::THREAD_ASSET_LOADER_4 - thread::THREAD_ASSET_LOADER_1 + 1;
 
 // @TODO: get rid of this?
 static struct {
-    // @TODO: better wake up
-    std::condition_variable wakeCondition;
-    std::mutex wakeMutex;
-    // @TODO: better thread safe queue
-    ConcurrentQueue<AssetManager::LoadTask> jobQueue;
-    std::atomic_int runningWorkers;
+    AssetLoadQueue loadQueue;
 
     AssetCreateFunc createFuncs[AssetType::Count];
 } s_assetManagerGlob;
@@ -60,6 +52,11 @@ static struct {
 auto AssetManager::InitializeImpl() -> Result<void> {
     m_assets_root = fs::path{ m_app->GetResourceFolder() };
 
+    const int loader_threads = DVAR_GET_INT(asset_loader_threads);
+    s_assetManagerGlob.loadQueue.SetWorkerCount(std::clamp(loader_threads, 1, static_cast<int>(LOADER_THREAD_COUNT)));
+    // a scene pulls in lots of data, loading one at a time leaves the other threads to everything else
+    s_assetManagerGlob.loadQueue.SetTypeLimit(AssetType::Scene, 1);
+
     IAssetLoader::RegisterLoader(".scene", SceneLoader::CreateLoader);
     IAssetLoader::RegisterLoader(".yaml", TextSceneLoader::CreateLoader);
 
@@ -139,7 +136,7 @@ void AssetManager::CreateAsset(const AssetType& p_type,
     }
 
     // 2. Update AssetRegistry when done
-    m_app->GetAssetRegistry()->StartAsyncLoad(std::move(meta), nullptr, nullptr);
+    m_app->GetAssetRegistry()->StartAsyncLoad(std::move(meta), AssetLoadPriority::Visible, nullptr, nullptr);
 }
 
 std::string AssetManager::ResolvePath(const fs::path& p_path) {
@@ -173,63 +170,85 @@ auto AssetManager::LoadAssetSync(const AssetEntry* p_entry) -> Result<AssetRef>
     return asset;
 }
 
-void AssetManager::LoadAssetAsync(AssetEntry* p_handle, OnAssetLoadSuccessFunc p_on_success, void* p_userdata) {
-    LoadTask task;
-    task.handle = p_handle;
-    task.on_success = p_on_success;
-    task.userdata = p_userdata;
-    EnqueueLoadTask(task);
+void AssetManager::LoadAssetAsync(AssetEntry* p_entry,
+                                  AssetLoadPriority p_priority,
+                                  OnAssetLoadSuccessFunc p_on_success,
+                                  void* p_userdata) {
+    p_entry->status = AssetStatus::Loading;
+
+    AssetLoadRequest request;
+    request.entry = p_entry;
+    request.onSuccess = p_on_success;
+    request.userdata = p_userdata;
+    request.priority = p_priority;
+    s_assetManagerGlob.loadQueue.Push(request);
 }
 
-void AssetManager::FinalizeImpl() {
-    RequestShutdown();
+bool AssetManager::PromoteLoad(const AssetEntry* p_entry, AssetLoadPriority p_priority) {
+    return s_assetManagerGlob.loadQueue.Promote(p_entry, p_priority);
 }
 
-void AssetManager::EnqueueLoadTask(LoadTask& p_task) {
-    s_assetManagerGlob.jobQueue.push(std::move(p_task));
-    s_assetManagerGlob.wakeCondition.notify_one();
+bool AssetManager::CancelLoad(AssetEntry* p_entry) {
+    if (!s_assetManagerGlob.loadQueue.Cancel(p_entry)) {
+        return false;
+    }
+
+    p_entry->MarkCancelled();
+    return true;
 }
 
-void AssetManager::WorkerMain() {
-    for (;;) {
-        if (thread::ShutdownRequested()) {
-            break;
-        }
+void AssetManager::CancelLoads(AssetLoadPriority p_priority) {
+    for (AssetLoadRequest& request : s_assetManagerGlob.loadQueue.Cancel(p_priority)) {
+        request.entry->MarkCancelled();
+    }
+}
 
-        LoadTask task;
-        if (!s_assetManagerGlob.jobQueue.pop(task)) {
-            std::unique_lock<std::mutex> lock(s_assetManagerGlob.wakeMutex);
-            s_assetManagerGlob.wakeCondition.wait(lock);
-            continue;
-        }
+AssetLoadQueue::Metrics AssetManager::GetLoadMetrics() const {
+    return s_assetManagerGlob.loadQueue.GetMetrics();
+}
+
+void AssetManager::FinalizeImpl() {
+    RequestShutdown();
+
+    const AssetLoadQueue::Metrics metrics = GetLoadMetrics();
+    LOG_VERBOSE("[AssetManager] {} assets loaded, {} cancelled, wait {:.2f} ms on average, load {:.2f} ms on average, {:.2f} ms at most",
+                metrics.loadCount,
+                metrics.cancelCount,
+                metrics.averageWaitTime,
+                metrics.averageLoadTime,
+                metrics.maxLoadTime);
+}
 
-        s_assetManagerGlob.runningWorkers.fetch_add(1);
+void AssetManager::WorkerMain() {
+    const uint32_t worker_index = thread::GetThreadId() - thread::THREAD_ASSET_LOADER_1;
+    DEV_ASSERT(worker_index < LOADER_THREAD_COUNT);
 
-        Timer timer;
-        auto res = AssetManager::GetSingleton().LoadAssetSync(task.handle);
+    AssetLoadRequest request;
+    while (s_assetManagerGlob.loadQueue.Pop(worker_index, request)) {
+        auto res = AssetManager::GetSingleton().LoadAssetSync(request.entry);
 
         if (res) {
             AssetRef asset = *res;
-            if (task.on_success) {
-                task.on_success(asset, task.userdata);
+            if (request.onSuccess) {
+                request.onSuccess(asset, request.userdata);
             }
-            LOG_VERBOSE("[AssetManager] asset '{}' loaded in {}", task.handle->metadata.path, timer.GetDurationString());
+            LOG_VERBOSE("[AssetManager] asset '{}' loaded in {}", request.entry->metadata.path, request.timer.GetDurationString());
 
-            task.handle->MarkLoaded(asset);
+            request.entry->MarkLoaded(asset);
         } else {
             StringStreamBuilder builder;
             builder << res.error();
             LOG_ERROR("{}", builder.ToString());
 
-            task.handle->MarkFailed();
+            request.entry->MarkFailed();
         }
 
-        s_assetManagerGlob.runningWorkers.fetch_sub(1);
+        s_assetManagerGlob.loadQueue.Finish(request);
     }
 }
 
 void AssetManager::RequestShutdown() {
-    s_assetManagerGlob.wakeCondition.notify_all();
+    s_assetManagerGlob.loadQueue.Shutdown();
 }
 
 }  // namespace my
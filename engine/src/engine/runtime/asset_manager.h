@@ -1,7 +1,7 @@
 #pragma once
 #include "engine/assets/asset_interface.h"
-#include "engine/core/base/concurrent_queue.h"
 #include "engine/core/base/singleton.h"
+#include "engine/runtime/asset_load_queue.h"
 #include "engine/runtime/module.h"
 
 namespace my {
@@ -12,8 +12,6 @@ class Scene;
 
 class AssetManager : public Singleton<AssetManager>, public Module {
 public:
-    struct LoadTask;
-
     AssetManager()
         : Module("AssetManager") {}
 
@@ -24,17 +22,25 @@ public:
 
     std::string ResolvePath(const std::filesystem::path& p_path);
 
+    // moves an asset that is still queued up, such as a prefetch that became visible
+    bool PromoteLoad(const AssetEntry* p_entry, AssetLoadPriority p_priority);
+    // takes an asset that is still queued out of the queue, waiting on it fails with ERR_SKIP
+    bool CancelLoad(AssetEntry* p_entry);
+    // cancels every queued asset of p_priority, such as the prefetches of a scene that was closed
+    void CancelLoads(AssetLoadPriority p_priority);
+
+    AssetLoadQueue::Metrics GetLoadMetrics() const;
+
     static void WorkerMain();
     static void RequestShutdown();
 
 private:
     [[nodiscard]] auto LoadAssetSync(const AssetEntry* p_entry) -> Result<AssetRef>;
     void LoadAssetAsync(AssetEntry* p_entry,
+                        AssetLoadPriority p_priority,
                         OnAssetLoadSuccessFunc p_on_success,
                         void* p_userdata);
 
-    void EnqueueLoadTask(LoadTask& p_task);
-
     uint32_t m_counter{ 0 };
     std::mutex m_assetLock;
     std::filesystem::path m_assets_root;
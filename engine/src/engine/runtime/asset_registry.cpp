@@ -79,7 +79,7 @@ auto AssetRegistry::InitializeImpl() -> Result<void> {
 
     std::latch latch(assets.size());
     for (auto& meta : assets) {
-        StartAsyncLoad(std::move(meta), [](AssetRef p_asset, void* p_userdata) {
+        StartAsyncLoad(std::move(meta), AssetLoadPriority::Background, [](AssetRef p_asset, void* p_userdata) {
             unused(p_asset);
             DEV_ASSERT(p_userdata);
             std::latch& latch = *reinterpret_cast<std::latch*>(p_userdata);
@@ -95,6 +95,7 @@ void AssetRegistry::FinalizeImpl() {
 }
 
 bool AssetRegistry::StartAsyncLoad(AssetMetaData&& p_meta,
+                                   AssetLoadPriority p_priority,
                                    OnAssetLoadSuccessFunc p_on_success,
                                    void* p_userdata) {
 
@@ -106,7 +107,7 @@ bool AssetRegistry::StartAsyncLoad(AssetMetaData&& p_meta,
         ok = ok && m_path_map.try_emplace(entry->metadata.path, entry->metadata.guid).second;
     }
     if (ok) {
-        m_app->GetAssetManager()->LoadAssetAsync(entry.get(), p_on_success, p_userdata);
+        m_app->GetAssetManager()->LoadAssetAsync(entry.get(), p_priority, p_on_success, p_userdata);
     }
     return ok;
 }
@@ -3,6 +3,7 @@
 #include "engine/assets/asset_interface.h"
 #include "engine/assets/asset_handle.h"
 #include "engine/core/base/singleton.h"
+#include "engine/runtime/asset_load_queue.h"
 #include "engine/runtime/module.h"
 
 namespace my {
@@ -24,6 +25,7 @@ protected:
     void FinalizeImpl() override;
 
     bool StartAsyncLoad(AssetMetaData&& p_meta,
+                        AssetLoadPriority p_priority,
                         OnAssetLoadSuccessFunc p_on_success,
                         void* p_userdata);
 
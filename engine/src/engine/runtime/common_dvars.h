@@ -9,6 +9,7 @@ DVAR_STRING(scene, DVAR_FLAG_NONE, "Open scene at start", "");
 
 // IO
 DVAR_BOOL(verbose, DVAR_FLAG_NONE, "Print verbose log", true);
+DVAR_INT(asset_loader_threads, DVAR_FLAG_CACHE, "Number of threads loading assets, 1 to 4", 2);
 
 // gui
 DVAR_BOOL(show_editor, DVAR_FLAG_CACHE, "Show editor", true);
@@ -94,6 +94,8 @@ public:
     virtual void UnbindUnorderedAccessView(uint32_t p_slot) = 0;
 
     virtual void SetPipelineState(PipelineStateName p_name) = 0;
+    // forgets the bound pipeline, for when something bound one without SetPipelineState()
+    virtual void InvalidatePipelineState() = 0;
 
     virtual void SetStencilRef(uint32_t p_ref) = 0;
     virtual void SetBlendState(const BlendDesc& p_desc, const float* p_factor, uint32_t p_mask) = 0;
@@ -104,8 +106,10 @@ public:
     virtual void UnbindStructuredBufferSRV(int p_slot) = 0;
 
     virtual void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) = 0;
-    template<typename T>
-    void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const std::vector<T>& p_vector) {
+    // p_data is the whole CPU copy of the buffer, only [p_offset, p_offset + p_size) of it changed
+    virtual void UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, uint32_t p_size, uint32_t p_offset) = 0;
+    template<typename T, typename ALLOCATOR>
+    void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const std::vector<T, ALLOCATOR>& p_vector) {
         UpdateConstantBuffer(p_buffer, p_vector.data(), sizeof(T) * (uint32_t)p_vector.size());
     }
     template<typename T, int N>
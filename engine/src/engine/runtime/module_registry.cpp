@@ -100,6 +100,7 @@ public:
     void UnbindUnorderedAccessView(uint32_t p_slot) override {}
 
     void SetPipelineState(PipelineStateName p_name) override {}
+    void InvalidatePipelineState() override {}
 
     void SetStencilRef(uint32_t p_ref) override {}
     void SetBlendState(const BlendDesc& p_desc, const float* p_factor, uint32_t p_mask) override {}
@@ -110,6 +111,7 @@ public:
     void UnbindStructuredBufferSRV(int p_slot) override {}
 
     void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) override {}
+    void UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, uint32_t p_size, uint32_t p_offset) override {}
 
     void BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) override {}
 
@@ -255,6 +255,11 @@ auto PipelineStateManager::Initialize() -> Result<void> {
     CREATE_PSO(PSO_BLOOM_UPSAMPLE, { .type = PipelineStateType::COMPUTE, .cs = "bloom_upsample.cs" });
 #pragma endregion PSO_BLOOM
 
+#pragma region PSO_GPU_CULLING
+    CREATE_PSO(PSO_HIZ_BUILD, { .type = PipelineStateType::COMPUTE, .cs = "hiz_build.cs" });
+    CREATE_PSO(PSO_GPU_CULLING, { .type = PipelineStateType::COMPUTE, .cs = "gpu_culling.cs" });
+#pragma endregion PSO_GPU_CULLING
+
     CREATE_PSO(PSO_ENV_SKYBOX, {
                                    .vs = "skybox.vs",
                                    .ps = "skybox.ps",
@@ -21,22 +21,35 @@ auto RenderSystem::InitializeImpl() -> Result<void> {
 }
 
 void RenderSystem::FinalizeImpl() {
+    for (int i = 0; i < FRAME_DATA_COUNT; ++i) {
+        DestroyFrameData(i);
+    }
+    m_frameData = nullptr;
 }
 
-#if 0
-static void DebugDrawBVH(int p_level, BvhAccel* p_bvh, const Matrix4x4f* p_matrix) {
-    if (!p_bvh || p_bvh->depth > p_level) {
-        return;
+void RenderSystem::DestroyFrameData(int p_index) {
+    // the frame data lives in its own arena, destruct it before the arena is reused
+    if (FrameData*& frame_data = m_frames[p_index]; frame_data) {
+        frame_data->~FrameData();
+        frame_data = nullptr;
     }
+    m_frameArenas[p_index].Reset();
+}
 
-    if (p_bvh->depth == p_level) {
-        renderer::AddDebugCube(p_bvh->aabb,
+#if 0
+static void DebugDrawBVH(int p_level, const BvhAccel& p_bvh, int p_node, int p_depth, const Matrix4x4f* p_matrix) {
+    const BvhAccel::Node& node = p_bvh.nodes[p_node];
+    if (p_depth == p_level) {
+        renderer::AddDebugCube(AABB(node.min, node.max),
                                Color::HexRgba(0xFFFF0037),
                                p_matrix);
+        return;
     }
 
-    DebugDrawBVH(p_level, p_bvh->left.get(), p_matrix);
-    DebugDrawBVH(p_level, p_bvh->right.get(), p_matrix);
+    if (!node.IsLeaf()) {
+        DebugDrawBVH(p_level, p_bvh, p_bvh.GetLeftChild(p_node), p_depth + 1, p_matrix);
+        DebugDrawBVH(p_level, p_bvh, p_bvh.GetRightChild(p_node), p_depth + 1, p_matrix);
+    }
 };
 #endif
 
@@ -147,9 +160,9 @@ static void FillConstantBuffer(const Scene& p_scene, FrameData& p_out_data) {
             const MeshComponent* mesh = p_scene.GetComponent<MeshComponent>(obj.meshId);
             const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(id);
             if (mesh && transform) {
-                if (const auto& bvh = mesh->bvh; bvh) {
+                if (const auto& bvh = mesh->bvh; bvh && !bvh->nodes.empty()) {
                     const auto& matrix = transform->GetWorldMatrix();
-                    DebugDrawBVH(level, bvh.get(), &matrix);
+                    DebugDrawBVH(level, *bvh, 0, 0, &matrix);
                 }
             }
         }
@@ -157,30 +170,11 @@ static void FillConstantBuffer(const Scene& p_scene, FrameData& p_out_data) {
 #endif
 }
 
-static void FillEnvConstants(const Scene&,
-                             FrameData& p_out_data) {
-    // @TODO: return if necessary
-
-    constexpr int count = IBL_MIP_CHAIN_MAX * 6;
-    if (p_out_data.batchCache.buffer.size() < count) {
-        p_out_data.batchCache.buffer.resize(count);
-    }
-
-    auto matrices = p_out_data.options.isOpengl ? BuildOpenGlCubeMapViewProjectionMatrix(Vector3f(0)) : BuildCubeMapViewProjectionMatrix(Vector3f(0));
-    for (int mip_idx = 0; mip_idx < IBL_MIP_CHAIN_MAX; ++mip_idx) {
-        for (int face_id = 0; face_id < 6; ++face_id) {
-            auto& batch = p_out_data.batchCache.buffer[mip_idx * 6 + face_id];
-            batch.c_cubeProjectionViewMatrix = matrices[face_id];
-            batch.c_envPassRoughness = (float)mip_idx / (float)(IBL_MIP_CHAIN_MAX - 1);
-        }
-    }
-}
-
 void RenderSystem::BeginFrame() {
-    if (m_frameData) {
-        delete m_frameData;
-        m_frameData = nullptr;
-    }
+    static_assert(FRAME_DATA_COUNT >= IGraphicsManager::NUM_FRAMES_IN_FLIGHT);
+
+    m_frameIndex = (m_frameIndex + 1) % FRAME_DATA_COUNT;
+    DestroyFrameData(m_frameIndex);
 
     RenderOptions options = {
         .isOpengl = m_app->GetGraphicsManager()->GetBackend() == Backend::OPENGL,
@@ -188,14 +182,25 @@ void RenderSystem::BeginFrame() {
         .vxgiEnabled = false,
         .bloomEnabled = DVAR_GET_BOOL(gfx_enable_bloom),
         .iblEnabled = DVAR_GET_BOOL(gfx_enable_ibl),
+        .instancingEnabled = DVAR_GET_BOOL(gfx_enable_instancing),
+        .debugGpuCulling = DVAR_GET_BOOL(gfx_debug_gpu_culling),
         .debugVoxelId = DVAR_GET_INT(gfx_debug_vxgi_voxel),
         .debugBvhDepth = DVAR_GET_INT(gfx_bvh_debug),
         .voxelTextureSize = DVAR_GET_INT(gfx_voxel_size),
         .ssaoKernelRadius = DVAR_GET_FLOAT(gfx_ssao_radius),
     };
 
+    LinearAllocator& arena = m_frameArenas[m_frameIndex];
+    m_frameData = new (arena.Allocate(sizeof(FrameData), alignof(FrameData))) FrameData(options, arena);
+    m_frames[m_frameIndex] = m_frameData;
+
+    // the previous frame data is still alive, its camera built the hi-z this frame culls against
+    const FrameData* prev_frame = m_frames[(m_frameIndex + FRAME_DATA_COUNT - 1) % FRAME_DATA_COUNT];
+    if (options.debugGpuCulling && prev_frame && prev_frame->options.debugGpuCulling) {
+        m_frameData->hizCamera = &prev_frame->mainCamera;
+    }
+
     // @HACK
-    m_frameData = new FrameData(options);
     static bool s_firstFrame = true;
     m_frameData->bakeIbl = s_firstFrame;
     s_firstFrame = false;
@@ -222,6 +227,10 @@ void RenderSystem::RenderFrame(Scene& p_scene) {
     FillCameraData(camera, framedata);
     FillConstantBuffer(p_scene, framedata);
 
+    // slots are shared by every pass, only the objects that moved are rewritten
+    m_slotTable.Update(p_scene, framedata.options.isOpengl);
+    framedata.slots = &m_slotTable;
+
     RunMeshRenderSystem(p_scene, framedata);
 
     RunTileMapRenderSystem(p_scene, framedata);
@@ -233,8 +242,6 @@ void RenderSystem::RenderFrame(Scene& p_scene) {
     FillParticleEmitterBuffer(p_scene, p_out_data);
 #endif
 
-    FillEnvConstants(p_scene, framedata);
-
     RequestPathTracerUpdate(camera, p_scene);
 
     auto& context = m_frameData->drawDebugContext;
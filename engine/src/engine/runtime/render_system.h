@@ -1,14 +1,19 @@
 #pragma once
+#include "engine/core/base/linear_allocator.h"
+#include "engine/renderer/render_slot_table.h"
 #include "engine/runtime/module.h"
 
 namespace my {
 
 class CameraComponent;
-struct FrameData;
 class Scene;
 
 class RenderSystem : public Module {
 public:
+    // frame data is built in a ring of arenas, the data of the previous frames stays valid
+    // while the next one is built, and a warmed up arena doesn't touch the heap
+    static constexpr int FRAME_DATA_COUNT = 2;
+
     RenderSystem()
         : Module("RenderSystem") {}
 
@@ -24,7 +29,14 @@ protected:
 
     void FillCameraData(const CameraComponent& p_camera, FrameData& p_framedata);
 
+    void DestroyFrameData(int p_index);
+
+    std::array<LinearAllocator, FRAME_DATA_COUNT> m_frameArenas;
+    std::array<FrameData*, FRAME_DATA_COUNT> m_frames{};
+    int m_frameIndex{ 0 };
     FrameData* m_frameData{ nullptr };
+
+    RenderSlotTable m_slotTable;
 };
 
 }  // namespace my
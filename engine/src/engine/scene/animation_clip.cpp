@@ -0,0 +1,390 @@
+#include "animation_clip.h"
+
+#include "engine/core/debugger/profiler.h"
+#include "engine/math/geomath.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my {
+
+using Path = AnimationComponent::Channel::Path;
+
+static constexpr float QUANTIZE_16 = 65535.0f;
+static constexpr float QUANTIZE_15 = 32767.0f;
+// the three smallest components of a unit quaternion are in [-1/sqrt(2), 1/sqrt(2)]
+static constexpr float SMALLEST_THREE_RANGE = 0.70710678f;
+
+static uint16_t Quantize(float p_value, float p_scale) {
+    return static_cast<uint16_t>(glm::round(Saturate(p_value) * p_scale));
+}
+
+static Vector4f Nlerp(const Vector4f& p_a, const Vector4f& p_b, float p_t) {
+    const Vector4f b = dot(p_a, p_b) < 0.0f ? p_b * -1.0f : p_b;
+    return normalize(lerp(p_a, b, p_t));
+}
+
+static Quaternion ToQuaternion(const Vector4f& p_v) {
+    return Quaternion(p_v.w, p_v.x, p_v.y, p_v.z);
+}
+
+static Vector4f ToVector(const Quaternion& p_q) {
+    return Vector4f(p_q.x, p_q.y, p_q.z, p_q.w);
+}
+
+static void EncodeRotation(const Vector4f& p_rotation, uint16_t* p_out) {
+    Vector4f q = normalize(p_rotation);
+    int largest = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (glm::abs(q[i]) > glm::abs(q[largest])) {
+            largest = i;
+        }
+    }
+    // q and -q are the same rotation, keep the dropped component positive
+    if (q[largest] < 0.0f) {
+        q = q * -1.0f;
+    }
+
+    uint16_t packed[3];
+    for (int i = 0, j = 0; i < 4; ++i) {
+        if (i != largest) {
+            const float normalized = 0.5f + 0.5f * q[i] / SMALLEST_THREE_RANGE;
+            packed[j++] = Quantize(normalized, QUANTIZE_15);
+        }
+    }
+
+    // the index of the dropped component goes into the top bits
+    p_out[0] = static_cast<uint16_t>(packed[0] | ((largest & 1) << 15));
+    p_out[1] = static_cast<uint16_t>(packed[1] | ((largest >> 1) << 15));
+    p_out[2] = packed[2];
+}
+
+static Vector4f DecodeRotation(const uint16_t* p_in) {
+    const int largest = (p_in[0] >> 15) | ((p_in[1] >> 15) << 1);
+    Vector4f q;
+    float sum = 0.0f;
+    for (int i = 0, j = 0; i < 4; ++i) {
+        if (i != largest) {
+            const float normalized = static_cast<float>(p_in[j++] & 0x7FFF) / QUANTIZE_15;
+            q[i] = (normalized * 2.0f - 1.0f) * SMALLEST_THREE_RANGE;
+            sum += q[i] * q[i];
+        }
+    }
+    q[largest] = glm::sqrt(glm::max(0.0f, 1.0f - sum));
+    return q;
+}
+
+static float KeyError(const float* p_a, const float* p_b, uint32_t p_count) {
+    float error = 0.0f;
+    for (uint32_t i = 0; i < p_count; ++i) {
+        error = glm::max(error, glm::abs(p_a[i] - p_b[i]));
+    }
+    return error;
+}
+
+// greedy key reduction, a key is dropped when the segment between the last kept key and
+// the next key reproduces every key in between within p_tolerance
+static std::vector<uint32_t> ReduceKeys(const std::vector<float>& p_times,
+                                        const float* p_values,
+                                        uint32_t p_stride,
+                                        bool p_rotation,
+                                        float p_tolerance) {
+    const uint32_t key_count = static_cast<uint32_t>(p_times.size());
+    std::vector<uint32_t> kept{ 0 };
+
+    auto fits = [&](uint32_t p_first, uint32_t p_last) {
+        const float* first = p_values + p_first * p_stride;
+        const float* last = p_values + p_last * p_stride;
+        // keys sharing a time form a step, compare them against the first key instead of dividing by zero
+        const float span = p_times[p_last] - p_times[p_first];
+        for (uint32_t key = p_first + 1; key < p_last; ++key) {
+            const float t = span > 0.0f ? (p_times[key] - p_times[p_first]) / span : 0.0f;
+            const float* expected = p_values + key * p_stride;
+            if (p_rotation) {
+                Vector4f actual = Nlerp(Vector4f(first[0], first[1], first[2], first[3]),
+                                        Vector4f(last[0], last[1], last[2], last[3]),
+                                        t);
+                if (actual.x * expected[0] + actual.y * expected[1] + actual.z * expected[2] + actual.w * expected[3] < 0.0f) {
+                    actual = actual * -1.0f;
+                }
+                if (KeyError(&actual.x, expected, 4) > p_tolerance) {
+                    return false;
+                }
+            } else {
+                const float actual[3] = {
+                    first[0] + (last[0] - first[0]) * t,
+                    first[1] + (last[1] - first[1]) * t,
+                    first[2] + (last[2] - first[2]) * t,
+                };
+                if (KeyError(actual, expected, 3) > p_tolerance) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    uint32_t anchor = 0;
+    for (uint32_t key = 2; key < key_count; ++key) {
+        if (!fits(anchor, key)) {
+            anchor = key - 1;
+            kept.push_back(anchor);
+        }
+    }
+    if (key_count > 1) {
+        kept.push_back(key_count - 1);
+    }
+    return kept;
+}
+
+void AnimationPose::Resize(size_t p_joint_count) {
+    translations.resize(p_joint_count, Vector3f(0.0f));
+    rotations.resize(p_joint_count, Vector4f(0.0f, 0.0f, 0.0f, 1.0f));
+    scales.resize(p_joint_count, Vector3f(1.0f));
+}
+
+AnimationClip AnimationClip::Compress(const AnimationComponent& p_animation,
+                                      std::span<const ecs::Entity> p_joints,
+                                      float p_tolerance) {
+    HBN_PROFILE_EVENT();
+
+    std::unordered_map<ecs::Entity, uint32_t> joint_lookup;
+    for (uint32_t i = 0; i < p_joints.size(); ++i) {
+        joint_lookup[p_joints[i]] = i;
+    }
+
+    struct Source {
+        const AnimationComponent::Channel* channel;
+        const AnimationComponent::Sampler* sampler;
+        uint32_t joint;
+    };
+
+    std::vector<Source> sources;
+    float start = std::numeric_limits<float>::max();
+    float end = std::numeric_limits<float>::lowest();
+    for (const auto& channel : p_animation.channels) {
+        auto it = joint_lookup.find(channel.targetId);
+        if (channel.path == Path::PATH_UNKNOWN || it == joint_lookup.end()) {
+            continue;
+        }
+        DEV_ASSERT_INDEX(channel.samplerIndex, p_animation.samplers.size());
+        const auto& sampler = p_animation.samplers[channel.samplerIndex];
+        if (sampler.keyframeTimes.empty()) {
+            continue;
+        }
+        sources.push_back({ &channel, &sampler, it->second });
+        start = glm::min(start, sampler.keyframeTimes.front());
+        end = glm::max(end, sampler.keyframeTimes.back());
+    }
+
+    AnimationClip clip;
+    if (sources.empty()) {
+        return clip;
+    }
+
+    clip.m_startTime = start;
+    clip.m_duration = end - start;
+    const float inv_duration = clip.m_duration > 0.0f ? 1.0f / clip.m_duration : 0.0f;
+
+    for (const Source& source : sources) {
+        const bool rotation = source.channel->path == Path::PATH_ROTATION;
+        const uint32_t stride = rotation ? 4 : 3;
+        const auto& times = source.sampler->keyframeTimes;
+        const float* values = source.sampler->keyframeData.data();
+        DEV_ASSERT(source.sampler->keyframeData.size() == times.size() * stride);
+
+        const std::vector<uint32_t> keys = ReduceKeys(times, values, stride, rotation, p_tolerance);
+
+        Track track;
+        track.path = source.channel->path;
+        track.joint = source.joint;
+        track.keyOffset = static_cast<uint32_t>(clip.m_times.size());
+        track.keyCount = static_cast<uint32_t>(keys.size());
+        track.rangeMin = Vector3f(0.0f);
+        track.rangeExtent = Vector3f(0.0f);
+
+        if (!rotation) {
+            Vector3f range_max(std::numeric_limits<float>::lowest());
+            track.rangeMin = Vector3f(std::numeric_limits<float>::max());
+            for (uint32_t key : keys) {
+                const Vector3f value(values[key * 3 + 0], values[key * 3 + 1], values[key * 3 + 2]);
+                track.rangeMin = min(track.rangeMin, value);
+                range_max = max(range_max, value);
+            }
+            track.rangeExtent = range_max - track.rangeMin;
+        }
+
+        for (uint32_t key : keys) {
+            clip.m_times.push_back(Quantize((times[key] - start) * inv_duration, QUANTIZE_16));
+
+            const float* value = values + key * stride;
+            uint16_t packed[3];
+            if (rotation) {
+                EncodeRotation(Vector4f(value[0], value[1], value[2], value[3]), packed);
+            } else {
+                for (int i = 0; i < 3; ++i) {
+                    const float extent = track.rangeExtent[i];
+                    packed[i] = extent > 0.0f ? Quantize((value[i] - track.rangeMin[i]) / extent, QUANTIZE_16) : 0;
+                }
+            }
+            clip.m_values.insert(clip.m_values.end(), packed, packed + 3);
+        }
+
+        clip.m_tracks.push_back(track);
+    }
+
+    return clip;
+}
+
+void AnimationClip::Sample(float p_time, AnimationPose& p_pose) const {
+    const float normalized = m_duration > 0.0f ? Saturate((p_time - m_startTime) / m_duration) : 0.0f;
+    const float key_time = normalized * QUANTIZE_16;
+    const uint16_t key_index = static_cast<uint16_t>(key_time);
+
+    for (const Track& track : m_tracks) {
+        DEV_ASSERT_INDEX(track.joint, p_pose.GetJointCount());
+
+        const uint16_t* times = m_times.data() + track.keyOffset;
+        const uint16_t* values = m_values.data() + track.keyOffset * 3;
+
+        // last key at or before key_time
+        const uint16_t* it = std::upper_bound(times, times + track.keyCount, key_index);
+        const uint32_t left = it == times ? 0 : static_cast<uint32_t>(it - times - 1);
+        const uint32_t right = glm::min(left + 1, track.keyCount - 1);
+
+        float t = 0.0f;
+        if (left != right) {
+            t = Saturate((key_time - times[left]) / static_cast<float>(times[right] - times[left]));
+        }
+
+        const uint16_t* a = values + left * 3;
+        const uint16_t* b = values + right * 3;
+        switch (track.path) {
+            case Path::PATH_ROTATION:
+                p_pose.rotations[track.joint] = Nlerp(DecodeRotation(a), DecodeRotation(b), t);
+                break;
+            case Path::PATH_TRANSLATION:
+            case Path::PATH_SCALE: {
+                Vector3f value;
+                for (int i = 0; i < 3; ++i) {
+                    const float fraction = glm::mix(static_cast<float>(a[i]), static_cast<float>(b[i]), t) / QUANTIZE_16;
+                    value[i] = track.rangeMin[i] + fraction * track.rangeExtent[i];
+                }
+                if (track.path == Path::PATH_TRANSLATION) {
+                    p_pose.translations[track.joint] = value;
+                } else {
+                    p_pose.scales[track.joint] = value;
+                }
+                break;
+            }
+            default:
+                CRASH_NOW();
+                break;
+        }
+    }
+}
+
+size_t AnimationClip::GetMemorySize() const {
+    return sizeof(AnimationClip) +
+           m_tracks.size() * sizeof(Track) +
+           m_times.size() * sizeof(uint16_t) +
+           m_values.size() * sizeof(uint16_t);
+}
+
+void EvaluateAnimation(const AnimationPose& p_rest, AnimationInstance& p_instance) {
+    const size_t joint_count = p_rest.GetJointCount();
+    AnimationPose& pose = p_instance.pose;
+    AnimationPose& scratch = p_instance.scratch;
+    pose.Resize(joint_count);
+
+    float total_weight = 0.0f;
+    const AnimationLayer* single_layer = nullptr;
+    int layer_count = 0;
+    for (const AnimationLayer& layer : p_instance.layers) {
+        if (!layer.additive && layer.clip && layer.weight > 0.0f) {
+            total_weight += layer.weight;
+            single_layer = &layer;
+            ++layer_count;
+        }
+    }
+
+    if (layer_count == 1 && total_weight >= 1.0f) {
+        // a single clip playing at full weight, nothing to blend
+        pose = p_rest;
+        single_layer->clip->Sample(single_layer->time, pose);
+    } else {
+        // weighted average of the layers, the rest pose takes whatever weight is left
+        const float rest_weight = glm::max(0.0f, 1.0f - total_weight);
+        const float inv_weight = 1.0f / (total_weight + rest_weight);
+        for (size_t joint = 0; joint < joint_count; ++joint) {
+            pose.translations[joint] = p_rest.translations[joint] * rest_weight;
+            pose.rotations[joint] = p_rest.rotations[joint] * rest_weight;
+            pose.scales[joint] = p_rest.scales[joint] * rest_weight;
+        }
+
+        for (const AnimationLayer& layer : p_instance.layers) {
+            if (layer.additive || !layer.clip || layer.weight <= 0.0f) {
+                continue;
+            }
+            scratch = p_rest;
+            layer.clip->Sample(layer.time, scratch);
+            for (size_t joint = 0; joint < joint_count; ++joint) {
+                const Vector4f& rotation = scratch.rotations[joint];
+                // accumulate rotations in the hemisphere of the rest pose
+                const float sign = dot(rotation, p_rest.rotations[joint]) < 0.0f ? -1.0f : 1.0f;
+                pose.translations[joint] += scratch.translations[joint] * layer.weight;
+                pose.rotations[joint] += rotation * (sign * layer.weight);
+                pose.scales[joint] += scratch.scales[joint] * layer.weight;
+            }
+        }
+
+        for (size_t joint = 0; joint < joint_count; ++joint) {
+            pose.translations[joint] *= inv_weight;
+            pose.rotations[joint] = normalize(pose.rotations[joint]);
+            pose.scales[joint] *= inv_weight;
+        }
+    }
+
+    for (const AnimationLayer& layer : p_instance.layers) {
+        if (!layer.additive || !layer.clip || layer.weight <= 0.0f) {
+            continue;
+        }
+        scratch = p_rest;
+        layer.clip->Sample(layer.time, scratch);
+        for (size_t joint = 0; joint < joint_count; ++joint) {
+            pose.translations[joint] += (scratch.translations[joint] - p_rest.translations[joint]) * layer.weight;
+
+            const Quaternion delta = ToQuaternion(scratch.rotations[joint]) * glm::inverse(ToQuaternion(p_rest.rotations[joint]));
+            const Quaternion weighted = glm::slerp(Quaternion(1.0f, 0.0f, 0.0f, 0.0f), delta, layer.weight);
+            pose.rotations[joint] = ToVector(glm::normalize(weighted * ToQuaternion(pose.rotations[joint])));
+
+            // a zero rest scale has no ratio to apply, the axis is left as is
+            const Vector3f& rest_scale = p_rest.scales[joint];
+            Vector3f scale_delta(1.0f);
+            for (int i = 0; i < 3; ++i) {
+                if (rest_scale[i] != 0.0f) {
+                    scale_delta[i] = scratch.scales[joint][i] / rest_scale[i];
+                }
+            }
+            pose.scales[joint] *= lerp(Vector3f(1.0f), scale_delta, layer.weight);
+        }
+    }
+}
+
+void EvaluateAnimations(jobsystem::Context& p_context, const AnimationPose& p_rest, std::span<AnimationInstance> p_instances) {
+    HBN_PROFILE_EVENT();
+
+    const uint32_t instance_count = static_cast<uint32_t>(p_instances.size());
+#if USING(ENABLE_JOB_SYSTEM)
+    constexpr uint32_t INSTANCE_GROUP_SIZE = 16;
+    p_context.Dispatch(instance_count, INSTANCE_GROUP_SIZE, [&p_rest, p_instances](jobsystem::JobArgs p_args) {
+        EvaluateAnimation(p_rest, p_instances[p_args.jobIndex]);
+    });
+    p_context.Wait();
+#else
+    unused(p_context);
+    for (uint32_t i = 0; i < instance_count; ++i) {
+        EvaluateAnimation(p_rest, p_instances[i]);
+    }
+#endif
+}
+
+}  // namespace my
@@ -0,0 +1,88 @@
+#pragma once
+#include "engine/scene/scene_component.h"
+
+// clang-format off
+namespace my::jobsystem { class Context; }
+// clang-format on
+
+namespace my {
+
+// local transforms of a skeleton, indexed by joint
+struct AnimationPose {
+    std::vector<Vector3f> translations;
+    std::vector<Vector4f> rotations;
+    std::vector<Vector3f> scales;
+
+    void Resize(size_t p_joint_count);
+    size_t GetJointCount() const { return translations.size(); }
+};
+
+// Read only, compressed copy of the samplers of an AnimationComponent.
+// Keys that interpolation reproduces within a tolerance are dropped, times are stored as 16 bit fractions
+// of the clip duration, translation and scale as 16 bit fractions of the track range,
+// and rotations as the three smallest quaternion components.
+class AnimationClip {
+public:
+    struct Track {
+        AnimationComponent::Channel::Path path;
+        uint32_t joint;
+        uint32_t keyOffset;
+        uint32_t keyCount;
+        // translation and scale are quantized in this range
+        Vector3f rangeMin;
+        Vector3f rangeExtent;
+    };
+
+    // p_joints maps joint indices to the entities the channels target, channels targeting anything else are dropped.
+    // p_tolerance is the error allowed when dropping keys
+    static AnimationClip Compress(const AnimationComponent& p_animation,
+                                  std::span<const ecs::Entity> p_joints,
+                                  float p_tolerance = 1e-3f);
+
+    // joints without a track are left untouched, rotations are interpolated with nlerp
+    void Sample(float p_time, AnimationPose& p_pose) const;
+
+    float GetStartTime() const { return m_startTime; }
+    float GetDuration() const { return m_duration; }
+    size_t GetTrackCount() const { return m_tracks.size(); }
+    size_t GetKeyCount() const { return m_times.size(); }
+    size_t GetMemorySize() const;
+
+private:
+    float m_startTime{ 0.0f };
+    float m_duration{ 0.0f };
+    std::vector<Track> m_tracks;
+    // one entry per key
+    std::vector<uint16_t> m_times;
+    // three entries per key
+    std::vector<uint16_t> m_values;
+};
+
+struct AnimationLayer {
+    const AnimationClip* clip{ nullptr };
+    float time{ 0.0f };
+    float weight{ 1.0f };
+    // additive layers apply the difference between the clip and the rest pose on top of the blended pose
+    bool additive{ false };
+};
+
+// a character playing any number of clips, the layers are blended into pose
+struct AnimationInstance {
+    std::vector<AnimationLayer> layers;
+    AnimationPose pose;
+    AnimationPose scratch;
+};
+
+// weights of two layers fading from p_from to p_to, p_alpha goes from 0 to 1
+inline void Crossfade(AnimationLayer& p_from, AnimationLayer& p_to, float p_alpha) {
+    p_from.weight = 1.0f - p_alpha;
+    p_to.weight = p_alpha;
+}
+
+// blends the weighted layers, the rest pose fills the weight left when it adds up to less than 1,
+// then applies the additive layers
+void EvaluateAnimation(const AnimationPose& p_rest, AnimationInstance& p_instance);
+
+void EvaluateAnimations(jobsystem::Context& p_context, const AnimationPose& p_rest, std::span<AnimationInstance> p_instances);
+
+}  // namespace my
@@ -0,0 +1,127 @@
+#include "object_tree.h"
+
+#include "engine/core/debugger/profiler.h"
+#include "engine/scene/scene.h"
+
+namespace my {
+
+// when more objects than this fraction moved, refitting the whole tree is cheaper than reinserting them one by one
+static constexpr uint32_t REFIT_FRACTION = 4;
+
+bool ObjectTree::NeedsRebuild(const Scene& p_scene) const {
+    return m_meshRendererVersion != p_scene.m_MeshRendererComponents.GetVersion() ||
+           m_meshVersion != p_scene.m_MeshComponents.GetVersion();
+}
+
+void ObjectTree::ResolveTransforms(const Scene& p_scene) {
+    const auto& transforms = p_scene.m_TransformComponents;
+    const uint32_t count = static_cast<uint32_t>(m_transformIndices.size());
+    for (uint32_t i = 0; i < count; ++i) {
+        m_transformIndices[i] = transforms.FindIndex(p_scene.m_MeshRendererComponents.GetEntity(i));
+    }
+    m_transformVersion = transforms.GetVersion();
+}
+
+bool ObjectTree::ResolveMesh(const Scene& p_scene, uint32_t p_index) {
+    const auto& meshes = p_scene.m_MeshComponents;
+    const ecs::Entity mesh_id = p_scene.m_MeshRendererComponents.GetComponentByIndex(p_index).meshId;
+    bool changed = false;
+    if (m_meshIds[p_index] != mesh_id) {
+        m_meshIds[p_index] = mesh_id;
+        m_meshIndices[p_index] = meshes.FindIndex(mesh_id);
+        changed = true;
+    }
+
+    const uint32_t mesh_index = m_meshIndices[p_index];
+    DEV_ASSERT(mesh_index != ecs::EntityIndex::INVALID_INDEX);
+    if (mesh_index != ecs::EntityIndex::INVALID_INDEX) {
+        const AABB& local_bound = meshes.GetComponentByIndex(mesh_index).localBound;
+        if (local_bound.GetMin() != m_localBounds[p_index].GetMin() || local_bound.GetMax() != m_localBounds[p_index].GetMax()) {
+            m_localBounds[p_index] = local_bound;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void ObjectTree::ComputeBound(const Scene& p_scene, uint32_t p_index) {
+    const uint32_t transform_index = m_transformIndices[p_index];
+    DEV_ASSERT(transform_index != ecs::EntityIndex::INVALID_INDEX);
+
+    AABB aabb = m_localBounds[p_index];
+    if (transform_index != ecs::EntityIndex::INVALID_INDEX) {
+        aabb.ApplyMatrix(p_scene.m_TransformComponents.GetComponentByIndex(transform_index).GetWorldMatrix());
+    }
+    m_bounds[p_index] = aabb;
+}
+
+void ObjectTree::Build(Scene& p_scene) {
+    HBN_PROFILE_EVENT();
+
+    const uint32_t count = static_cast<uint32_t>(p_scene.GetCount<MeshRendererComponent>());
+    m_tree.Clear();
+    m_proxies.resize(count);
+    m_bounds.resize(count);
+    m_transformIndices.resize(count);
+    m_meshIds.assign(count, ecs::Entity::INVALID);
+    m_meshIndices.assign(count, ecs::EntityIndex::INVALID_INDEX);
+    m_localBounds.assign(count, AABB());
+
+    ResolveTransforms(p_scene);
+    for (uint32_t i = 0; i < count; ++i) {
+        ResolveMesh(p_scene, i);
+        ComputeBound(p_scene, i);
+        m_proxies[i] = m_tree.Insert(m_bounds[i], i);
+    }
+
+    m_meshRendererVersion = p_scene.m_MeshRendererComponents.GetVersion();
+    m_meshVersion = p_scene.m_MeshComponents.GetVersion();
+    m_updatedCount = count;
+}
+
+void ObjectTree::Update(Scene& p_scene) {
+    HBN_PROFILE_EVENT();
+
+    if (NeedsRebuild(p_scene)) {
+        Build(p_scene);
+    } else {
+        // transforms added or removed elsewhere shuffle the dense indices
+        if (m_transformVersion != p_scene.m_TransformComponents.GetVersion()) {
+            ResolveTransforms(p_scene);
+        }
+
+        const TransformHierarchy& hierarchy = p_scene.m_transformHierarchy;
+        const uint32_t count = static_cast<uint32_t>(m_bounds.size());
+
+        m_moved.clear();
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t transform_index = m_transformIndices[i];
+            const bool moved = transform_index != ecs::EntityIndex::INVALID_INDEX && hierarchy.IsWorldChanged(transform_index);
+            // a reassigned mesh, or a mesh edited in place, changes the bound without moving
+            if (ResolveMesh(p_scene, i) || moved) {
+                ComputeBound(p_scene, i);
+                m_moved.push_back(i);
+            }
+        }
+
+        const uint32_t moved_count = static_cast<uint32_t>(m_moved.size());
+        if (moved_count * REFIT_FRACTION > count) {
+            for (uint32_t i : m_moved) {
+                m_tree.SetLeafBound(m_proxies[i], m_bounds[i]);
+            }
+            m_tree.Refit();
+        } else {
+            for (uint32_t i : m_moved) {
+                m_tree.Move(m_proxies[i], m_bounds[i]);
+            }
+        }
+        m_updatedCount = moved_count;
+    }
+
+    m_sceneBound.MakeInvalid();
+    for (const AABB& aabb : m_bounds) {
+        m_sceneBound.UnionBox(aabb);
+    }
+}
+
+}  // namespace my
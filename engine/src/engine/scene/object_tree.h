@@ -0,0 +1,56 @@
+#pragma once
+#include "engine/ecs/entity.h"
+#include "engine/math/dynamic_aabb_tree.h"
+
+// clang-format off
+namespace my { class Scene; }
+// clang-format on
+
+namespace my {
+
+// World bounds of every MeshRendererComponent, kept in a DynamicAABBTree so culling and picking
+// only visit the objects near the query. Leaf user data is the dense MeshRendererComponent index.
+// Only objects whose world matrix, mesh or mesh bound changed are updated, the tree is rebuilt when
+// mesh renderers or meshes are added or removed.
+class ObjectTree {
+public:
+    void Update(Scene& p_scene);
+    // mesh renderers or meshes were added or removed since the last Update()
+    bool NeedsRebuild(const Scene& p_scene) const;
+
+    const DynamicAABBTree& GetTree() const { return m_tree; }
+    // tight world bound, indexed by dense MeshRendererComponent index
+    const AABB& GetBound(size_t p_index) const { return m_bounds[p_index]; }
+    const std::vector<AABB>& GetBounds() const { return m_bounds; }
+    const AABB& GetSceneBound() const { return m_sceneBound; }
+
+    // number of objects whose bound was recomputed by the last Update()
+    uint32_t GetUpdatedCount() const { return m_updatedCount; }
+
+private:
+    void Build(Scene& p_scene);
+    void ResolveTransforms(const Scene& p_scene);
+    // true if the mesh of object p_index, or its local bound, changed since the bound was computed
+    bool ResolveMesh(const Scene& p_scene, uint32_t p_index);
+    void ComputeBound(const Scene& p_scene, uint32_t p_index);
+
+    DynamicAABBTree m_tree;
+    std::vector<int> m_proxies;
+    std::vector<AABB> m_bounds;
+    // per object, what the bound was computed from. the dense indices stay valid until the
+    // manager version changes
+    std::vector<uint32_t> m_transformIndices;
+    std::vector<ecs::Entity> m_meshIds;
+    std::vector<uint32_t> m_meshIndices;
+    std::vector<AABB> m_localBounds;
+    // dense indices of the objects that moved this frame
+    std::vector<uint32_t> m_moved;
+    AABB m_sceneBound;
+
+    uint32_t m_meshRendererVersion{ ~0u };
+    uint32_t m_meshVersion{ ~0u };
+    uint32_t m_transformVersion{ ~0u };
+    uint32_t m_updatedCount{ 0 };
+};
+
+}  // namespace my
@@ -7,6 +7,7 @@
 #include "engine/runtime/asset_registry.h"
 #include "engine/systems/ecs_systems.h"
 #include "engine/systems/job_system/job_system.h"
+#include "engine/systems/job_system/task_graph.h"
 
 // @TODO: refactor
 #include "engine/renderer/graphics_dvars.h"
@@ -23,32 +24,56 @@ REGISTER_COMPONENT_LIST
 
 namespace my {
 
-void Scene::Update(float p_timestep) {
-    HBN_PROFILE_EVENT();
+// m_bonePalette is a plain vector, the task graph declares it by this tag instead
+struct BonePalette {};
 
-    m_dirtyFlags.store(0);
+std::shared_ptr<jobsystem::TaskGraph> Scene::CreateUpdateGraph() {
+    auto graph = std::make_shared<jobsystem::TaskGraph>();
 
-    jobsystem::Context ctx;
-    // animation
-    RunLightUpdateSystem(*this, ctx, p_timestep);
-    RunAnimationUpdateSystem(*this, ctx, p_timestep);
-    ctx.Wait();
+    // tasks that touch the same components run in the order they are added
+    graph->AddTask("light", [this](jobsystem::Context& p_ctx) { RunLightUpdateSystem(*this, p_ctx, m_timestep); })
+        .Read<TransformComponent>()
+        .Write<LightComponent>();
+    // animation, update local position, rotation and scale of the targets
+    graph->AddTask("animation", [this](jobsystem::Context& p_ctx) { RunAnimationUpdateSystem(*this, p_ctx, m_timestep); })
+        .Write<AnimationComponent, TransformComponent>();
     // transform, update local matrix from position, rotation and scale
-    RunTransformationUpdateSystem(*this, ctx, p_timestep);
-    ctx.Wait();
+    graph->AddTask("transformation", [this](jobsystem::Context& p_ctx) { RunTransformationUpdateSystem(*this, p_ctx, m_timestep); })
+        .Write<TransformComponent, TransformHierarchy>();
     // hierarchy, update world matrix based on hierarchy
-    RunHierarchyUpdateSystem(*this, ctx, p_timestep);
-    ctx.Wait();
-    // mesh particles
-    RunMeshEmitterUpdateSystem(*this, ctx, p_timestep);
-    // particle
-    RunParticleEmitterUpdateSystem(*this, ctx, p_timestep);
-    // armature
-    RunArmatureUpdateSystem(*this, ctx, p_timestep);
-    ctx.Wait();
+    graph->AddTask("hierarchy", [this](jobsystem::Context& p_ctx) { RunHierarchyUpdateSystem(*this, p_ctx, m_timestep); })
+        .Read<HierarchyComponent>()
+        .Write<TransformComponent, TransformHierarchy>();
+    graph->AddTask("mesh_emitter", [this](jobsystem::Context& p_ctx) { RunMeshEmitterUpdateSystem(*this, p_ctx, m_timestep); })
+        .Read<TransformComponent>()
+        .Write<MeshEmitterComponent>();
+    graph->AddTask("particle_emitter", [this](jobsystem::Context& p_ctx) { RunParticleEmitterUpdateSystem(*this, p_ctx, m_timestep); })
+        .Write<ParticleEmitterComponent>();
+    graph->AddTask("armature", [this](jobsystem::Context& p_ctx) { RunArmatureUpdateSystem(*this, p_ctx, m_timestep); })
+        .Read<TransformComponent>()
+        .Write<ArmatureComponent, BonePalette>();
+    // update bounding box, scene state that isn't a component is declared by its type, m_objectTree and m_bound here
+    graph->AddTask("object", [this](jobsystem::Context& p_ctx) { RunObjectUpdateSystem(*this, p_ctx, m_timestep); })
+        .Read<TransformComponent, MeshRendererComponent, MeshComponent, TransformHierarchy>()
+        .Write<ObjectTree, AABB>();
+
+    auto res = graph->Compile();
+    if (!res) {
+        CRASH_NOW_MSG("failed to compile scene update graph");
+    }
+    return graph;
+}
 
-    // update bounding box
-    RunObjectUpdateSystem(*this, ctx, p_timestep);
+void Scene::Update(float p_timestep) {
+    HBN_PROFILE_EVENT();
+
+    m_dirtyFlags.store(0);
+
+    m_timestep = p_timestep;
+    if (!m_updateGraph) {
+        m_updateGraph = CreateUpdateGraph();
+    }
+    m_updateGraph->Run();
 
     // @TODO: refactor
     for (auto [entity, camera] : m_CameraComponents) {
@@ -544,47 +569,120 @@ bool Scene::RayObjectIntersect(ecs::Entity p_object_id, Ray& p_ray) {
     TransformComponent* transform = GetComponent<TransformComponent>(p_object_id);
     DEV_ASSERT(mesh && transform);
 
-    if (!transform || !mesh) {
+    if (!transform || !mesh || mesh->indices.empty()) {
         return false;
     }
+    if (!mesh->bvh) {
+        mesh->bvh = BvhAccel::Construct(mesh->indices, mesh->positions);
+    }
 
-    Matrix4x4f inversedModel = glm::inverse(transform->GetWorldMatrix());
-    Ray inversedRay = p_ray.Inverse(inversedModel);
-    Ray inversedRayAABB = inversedRay;  // make a copy, we don't want dist to be modified by AABB
-    // Perform aabb test
-    if (!inversedRayAABB.Intersects(mesh->localBound)) {
+    // dist is a fraction of the segment, so it's the same in object space
+    RayPacket packet;
+    packet.Add(p_ray.Inverse(glm::inverse(transform->GetWorldMatrix())));
+    int triangle = -1;
+    if (!mesh->bvh->Intersects(packet, packet.GetMask(), mesh->indices, mesh->positions, false, &triangle)) {
         return false;
     }
 
-    // @TODO: test submesh intersection
-
-    // Test every single triange
-    for (size_t i = 0; i < mesh->indices.size(); i += 3) {
-        const Vector3f& A = mesh->positions[mesh->indices[i]];
-        const Vector3f& B = mesh->positions[mesh->indices[i + 1]];
-        const Vector3f& C = mesh->positions[mesh->indices[i + 2]];
-#define CC(a) Vector3f(a.x, a.y, a.z)
-        if (inversedRay.Intersects(CC(A), CC(B), CC(C))) {
-#undef CC
-            p_ray.CopyDist(inversedRay);
-            return true;
+    p_ray.SetDist(packet.dists[0]);
+    return true;
+}
+
+void Scene::PrepareRayQueries() {
+    HBN_PROFILE_EVENT();
+
+    // the object system moves the objects every frame, this only catches up on objects added since
+    if (m_objectTree.NeedsRebuild(*this)) {
+        m_objectTree.Update(*this);
+    }
+
+    // packets are traced in parallel, so the meshes can't build their BvhAccel on first hit
+    for (auto [entity, mesh] : m_MeshComponents) {
+        if (!mesh.bvh && !mesh.indices.empty()) {
+            mesh.bvh = BvhAccel::Construct(mesh.indices, mesh.positions);
         }
     }
-    return false;
 }
 
-Scene::RayIntersectionResult Scene::Intersects(Ray& p_ray) {
-    RayIntersectionResult result;
+void Scene::IntersectPacket(RayPacket& p_packet, RayQueryMode p_mode, RayIntersectionResult* p_results) {
+    const bool any_hit = p_mode == RayQueryMode::ANY;
 
-    // @TODO: box collider
-    for (size_t object_idx = 0; object_idx < GetCount<MeshRendererComponent>(); ++object_idx) {
-        ecs::Entity entity = GetEntity<MeshRendererComponent>(object_idx);
-        if (RayObjectIntersect(entity, p_ray)) {
-            result.entity = entity;
+    // top level, the object tree reads the dists as the rays get shortened
+    m_objectTree.GetTree().RayCast(p_packet, p_packet.GetMask(), [&](uint32_t p_object_idx, uint32_t p_mask) {
+        const ecs::Entity entity = GetEntity<MeshRendererComponent>(p_object_idx);
+        const MeshRendererComponent& object = GetComponentByIndex<MeshRendererComponent>(p_object_idx);
+        const MeshComponent* mesh = GetComponent<MeshComponent>(object.meshId);
+        const TransformComponent* transform = GetComponent<TransformComponent>(entity);
+        if (!mesh || !transform || !mesh->bvh) {
+            return p_mask;
         }
-    }
 
+        // bottom level, dist is a fraction of the segment, so it's the same in object space
+        const Matrix4x4f inverse_model = glm::inverse(transform->GetWorldMatrix());
+        RayPacket local;
+        local.count = p_packet.count;
+        for (uint32_t rays = p_mask; rays; rays &= rays - 1) {
+            const uint32_t i = std::countr_zero(rays);
+            local.starts[i] = Vector3f((inverse_model * Vector4f(p_packet.starts[i], 1.0f)).xyz);
+            local.directions[i] = Vector3f((inverse_model * Vector4f(p_packet.directions[i], 0.0f)).xyz);
+            local.dists[i] = p_packet.dists[i];
+        }
+
+        int triangles[RayPacket::MAX_SIZE];
+        const uint32_t hit = mesh->bvh->Intersects(local, p_mask, mesh->indices, mesh->positions, any_hit, triangles);
+        for (uint32_t rays = hit; rays; rays &= rays - 1) {
+            const uint32_t i = std::countr_zero(rays);
+            p_packet.dists[i] = local.dists[i];
+            p_results[i].entity = entity;
+            p_results[i].triangle = triangles[i];
+        }
+        return any_hit ? p_mask & ~hit : p_mask;
+    });
+}
+
+Scene::RayIntersectionResult Scene::Intersects(Ray& p_ray, RayQueryMode p_mode) {
+    PrepareRayQueries();
+
+    // @TODO: box collider
+    RayIntersectionResult result;
+    RayPacket packet;
+    packet.Add(p_ray);
+    IntersectPacket(packet, p_mode, &result);
+    p_ray.SetDist(packet.dists[0]);
     return result;
 }
 
+void Scene::Intersects(std::span<Ray> p_rays, std::span<RayIntersectionResult> p_results, RayQueryMode p_mode) {
+    HBN_PROFILE_EVENT();
+    DEV_ASSERT(p_rays.size() == p_results.size());
+
+    PrepareRayQueries();
+
+    auto trace_packet = [&](uint32_t p_packet_index) {
+        const size_t begin = p_packet_index * RayPacket::MAX_SIZE;
+        const size_t end = glm::min(begin + RayPacket::MAX_SIZE, p_rays.size());
+
+        RayPacket packet;
+        for (size_t i = begin; i < end; ++i) {
+            packet.Add(p_rays[i]);
+            p_results[i] = RayIntersectionResult();
+        }
+        IntersectPacket(packet, p_mode, p_results.data() + begin);
+        for (size_t i = begin; i < end; ++i) {
+            p_rays[i].SetDist(packet.dists[i - begin]);
+        }
+    };
+
+    const uint32_t packet_count = static_cast<uint32_t>((p_rays.size() + RayPacket::MAX_SIZE - 1) / RayPacket::MAX_SIZE);
+#if USING(ENABLE_JOB_SYSTEM)
+    jobsystem::Context ctx;
+    ctx.Dispatch(packet_count, 4, [&trace_packet](jobsystem::JobArgs p_args) { trace_packet(p_args.jobIndex); });
+    ctx.Wait();
+#else
+    for (uint32_t i = 0; i < packet_count; ++i) {
+        trace_packet(i);
+    }
+#endif
+}
+
 }  // namespace my
@@ -5,12 +5,15 @@
 #include "engine/ecs/view.h"
 #include "engine/math/ray.h"
 #include "engine/scene/scene_component.h"
+#include "engine/scene/object_tree.h"
 #include "engine/scene/scene_component_2d.h"
+#include "engine/scene/transform_hierarchy.h"
 
 struct lua_State;
 
 namespace my::jobsystem {
 class Context;
+class TaskGraph;
 }
 
 namespace my {
@@ -64,6 +67,10 @@ public:
     Scene()
         : IAsset(AssetType::Scene) {}
 
+    // the tasks of m_updateGraph capture this, use Copy() instead
+    Scene(Scene&&) = delete;
+    Scene& operator=(Scene&&) = delete;
+
 public:
     template<Serializable T>
     const T* GetComponent(const ecs::Entity&) const { return nullptr; }
@@ -84,20 +91,16 @@ public:
     inline ecs::Entity GetEntityByIndex(size_t) { return ecs::Entity::INVALID; }
 
     template<typename T>
-    inline ecs::View<T> View() {
+    inline ecs::ComponentManager<T>& GetManager() {
         static_assert(0, "this code should never instantiate");
-        struct Dummy {};
-        ecs::ComponentManager<Dummy> dummyManager;
-        return ecs::View(dummyManager);
+        return *(ecs::ComponentManager<T>*)0;
     }
 
-    template<typename T>
-    inline const ecs::View<T> View() const {
-        static_assert(0, "this code should never instantiate");
-        struct Dummy {};
-        ecs::ComponentManager<Dummy> dummyManager;
-        return ecs::View(dummyManager);
-    }
+    template<typename... Ts>
+    inline ecs::View<Ts...> View() { return ecs::View<Ts...>(GetManager<Ts>()...); }
+
+    template<typename... Ts>
+    inline const ecs::View<Ts...> View() const { return ecs::View<Ts...>(const_cast<Scene*>(this)->GetManager<Ts>()...); }
 
 #pragma region WORLD_COMPONENTS_REGISTRY
 #define REGISTER_COMPONENT(T, NAME, VER)                                                                           \
@@ -119,9 +122,7 @@ public:
     template<>                                                                                                     \
     T& Create<T>(const ecs::Entity& p_entity) { return m_##T##s.Create(p_entity); }                                \
     template<>                                                                                                     \
-    inline ecs::View<T> View() { return ecs::View<T>(m_##T##s); }                                                  \
-    template<>                                                                                                     \
-    inline const ecs::View<T> View() const { return ecs::View<T>(m_##T##s); }
+    inline ecs::ComponentManager<T>& GetManager<T>() { return m_##T##s; }
 
 #pragma endregion WORLD_COMPONENTS_REGISTRY
 
@@ -250,9 +251,22 @@ public:
 
     struct RayIntersectionResult {
         ecs::Entity entity;
+        // index of the hit triangle in the mesh of entity
+        int triangle{ -1 };
+    };
+
+    enum class RayQueryMode {
+        // the ray is shortened to the closest hit
+        NEAREST,
+        // stops at the first hit, for visibility tests
+        ANY,
     };
 
-    RayIntersectionResult Intersects(Ray& p_ray);
+    // the object tree finds the objects the ray passes through, then the ray is traced through the BvhAccel of their meshes
+    RayIntersectionResult Intersects(Ray& p_ray, RayQueryMode p_mode = RayQueryMode::NEAREST);
+    // traces the rays in packets of RayPacket::MAX_SIZE on the job system,
+    // neighbouring rays in p_rays should be coherent, e.g. from neighbouring pixels
+    void Intersects(std::span<Ray> p_rays, std::span<RayIntersectionResult> p_results, RayQueryMode p_mode = RayQueryMode::NEAREST);
     bool RayObjectIntersect(ecs::Entity p_object_id, Ray& p_ray);
 
     const AABB& GetBound() const { return m_bound; }
@@ -263,6 +277,14 @@ public:
     bool m_replace = false;
 
     std::atomic<uint32_t> m_dirtyFlags{ SCENE_DIRTY_NONE };
+    // systems that run in Update(), built on first use
+    std::shared_ptr<jobsystem::TaskGraph> m_updateGraph;
+    float m_timestep{ 0.0f };
+    TransformHierarchy m_transformHierarchy;
+    // skinning matrices of every armature, rebuilt every frame
+    std::vector<Matrix4x4f> m_bonePalette;
+    // world bounds of the mesh renderers, used for culling and picking
+    ObjectTree m_objectTree;
     // @TODO: refactor
     AABB m_bound;
 
@@ -272,6 +294,12 @@ public:
 
     const auto& GetLibraryEntries() const { return m_componentLib.m_entries; }
     SceneDirtyFlags GetDirtyFlags() const { return static_cast<SceneDirtyFlags>(m_dirtyFlags.load()); }
+
+private:
+    std::shared_ptr<jobsystem::TaskGraph> CreateUpdateGraph();
+
+    void PrepareRayQueries();
+    void IntersectPacket(RayPacket& p_packet, RayQueryMode p_mode, RayIntersectionResult* p_results);
 };
 
 }  // namespace my
@@ -110,6 +110,34 @@ void MeshComponent::CreateRenderData() {
 #pragma region MATERIAL_COMPONENT
 #pragma endregion MATERIAL_COMPONENT
 
+#pragma region ANIMATION_COMPONENT
+uint32_t AnimationComponent::Sampler::FindKeyframe(float p_time, uint32_t p_cursor) const {
+    const uint32_t key_count = static_cast<uint32_t>(keyframeTimes.size());
+    if (key_count < 2) {
+        return 0;
+    }
+
+    auto in_range = [&](uint32_t p_key) {
+        return keyframeTimes[p_key] <= p_time && (p_key + 1 == key_count || p_time < keyframeTimes[p_key + 1]);
+    };
+
+    if (p_cursor < key_count) {
+        if (in_range(p_cursor)) {
+            return p_cursor;
+        }
+        if (p_cursor + 1 < key_count && in_range(p_cursor + 1)) {
+            return p_cursor + 1;
+        }
+    }
+
+    auto it = std::upper_bound(keyframeTimes.begin(), keyframeTimes.end(), p_time);
+    if (it == keyframeTimes.begin()) {
+        return 0;
+    }
+    return static_cast<uint32_t>(it - keyframeTimes.begin() - 1);
+}
+#pragma endregion ANIMATION_COMPONENT
+
 #pragma region CAMERA_COMPONENT
 Matrix4x4f CameraComponent::CalcProjection() const {
     if (IsOrtho()) {
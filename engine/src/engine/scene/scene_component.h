@@ -16,6 +16,7 @@ class Emitter;
 
 namespace my {
 
+class AnimationClip;
 struct BvhAccel;
 struct GpuMesh;
 struct GpuStructuredBuffer;
@@ -52,6 +53,8 @@ private:
 #pragma region HIERARCHY_COMPONENT
 class HierarchyComponent {
 public:
+    static constexpr bool BULK_SERIALIZABLE = true;
+
     ecs::Entity GetParent() const { return m_parentId; }
 
     void Serialize(Archive& p_archive, uint32_t p_version);
@@ -217,6 +220,8 @@ struct AnimationComponent {
         NONE = 0,
         PLAYING = 1 << 0,
         LOOPED = 1 << 1,
+        // sampled from a compressed AnimationClip of the channels instead of the samplers
+        COMPRESSED = 1 << 2,
     };
 
     struct Channel {
@@ -239,11 +244,17 @@ struct AnimationComponent {
         std::vector<float> keyframeTimes;
         std::vector<float> keyframeData;
 
+        // index of the last key at or before p_time, 0 if p_time is before the first key.
+        // p_cursor is the result of the previous frame, playback mostly stays on it or moves to the next key,
+        // anything else (seek, loop) falls back to a binary search
+        uint32_t FindKeyframe(float p_time, uint32_t p_cursor) const;
+
         static void RegisterClass();
     };
 
     bool IsPlaying() const { return flags & PLAYING; }
     bool IsLooped() const { return flags & LOOPED; }
+    bool IsCompressed() const { return flags & COMPRESSED; }
     float GetLegnth() const { return end - start; }
     float IsEnd() const { return timer > end; }
 
@@ -257,8 +268,23 @@ struct AnimationComponent {
     std::vector<Channel> channels;
     std::vector<Sampler> samplers;
 
+    // Non-Serialized
+    // per channel, dense index of the target TransformComponent and the cached keyframe cursor,
+    // targets are resolved again when the transform pool version changes
+    std::vector<uint32_t> targetIndices;
+    std::vector<uint32_t> cursors;
+    uint32_t bindingVersion = ~0u;
+    // compressed animations, the clip is built on the first bind, the joints are the entities it animates
+    // and jointIndices their dense transform indices
+    std::shared_ptr<const AnimationClip> clip;
+    std::vector<ecs::Entity> clipJoints;
+    std::vector<uint32_t> jointIndices;
+
     void Serialize(Archive& p_archive, uint32_t p_version);
-    void OnDeserialized() {}
+    void OnDeserialized() {
+        bindingVersion = ~0u;
+        clip.reset();
+    }
 
     static void RegisterClass();
 };
@@ -270,10 +296,14 @@ struct ArmatureComponent {
     std::vector<Matrix4x4f> inverseBindMatrices;
 
     // Non-Serialized
-    std::vector<Matrix4x4f> boneTransforms;
+    // the skinning matrices are stored in Scene::m_bonePalette, starting at paletteOffset
+    uint32_t paletteOffset{ 0 };
+    // dense TransformComponent index of every bone, rebound when the transform manager changes
+    std::vector<uint32_t> boneIndices;
+    uint32_t bindingVersion = ~0u;
 
     void Serialize(Archive& p_archive, uint32_t p_version);
-    void OnDeserialized() {}
+    void OnDeserialized() { bindingVersion = ~0u; }
 
     static void RegisterClass();
 };
@@ -290,6 +320,8 @@ struct MeshRendererComponent : public ComponentFlagBase {
 
     ecs::Entity meshId;
 
+    static constexpr bool BULK_SERIALIZABLE = true;
+
     MeshRendererComponent() {
         flags |= FLAG_RENDERABLE | FLAG_CAST_SHADOW;
     }
@@ -689,6 +721,8 @@ struct ForceFieldComponent {
     float strength{ 1.0f };
     float radius{ 0.01f };
 
+    static constexpr bool BULK_SERIALIZABLE = true;
+
     void Serialize(Archive& p_archive, uint32_t p_version);
     void OnDeserialized() {}
 
@@ -4,9 +4,11 @@
 
 #include "engine/core/io/archive.h"
 #include "engine/core/io/file_access.h"
+#include "engine/core/io/file_access_mapped.h"
 #include "engine/core/string/string_utils.h"
 #include "engine/runtime/asset_registry.h"
 #include "engine/scene/scene.h"
+#include "engine/systems/job_system/job_system.h"
 #include "engine/systems/serialization/serialization.h"
 
 namespace my {
@@ -34,12 +36,34 @@ namespace my {
 // version 17: remove armature.flags
 // version 18: change RigidBodyComponent
 // version 19: serialize scene.m_physicsMode
+// version 20: chunked layout with a table of contents
 #pragma endregion VERSION_HISTORY
-static constexpr uint32_t LATEST_SCENE_VERSION = 19;
+static constexpr uint32_t LATEST_SCENE_VERSION = 20;
+static constexpr uint32_t CHUNKED_SCENE_VERSION = 20;
 static constexpr char SCENE_MAGIC[] = "xBScene";
 static constexpr char SCENE_GUARD_MESSAGE[] = "Should see this message";
 static constexpr uint64_t HAS_NEXT_FLAG = 6368519827137030510;
 
+// Since version 20 a scene file is
+//   SCENE_MAGIC, uint32_t version, uint32_t padding
+//   chunks, each one starting at a multiple of SCENE_CHUNK_ALIGNMENT
+//   table of contents: uint64_t chunk count, then the name, offset and size of every chunk
+//   uint64_t offset of the table of contents, SCENE_TOC_MAGIC
+// The info chunk holds the entity seed, the root and the physics mode. Every other chunk holds a component
+// manager in the format of ComponentManager::Serialize() and is named after its library entry.
+// Chunks don't depend on each other, they are read straight out of the mapped file in parallel.
+static constexpr char SCENE_INFO_CHUNK[] = "Scene::Info";
+static constexpr uint64_t SCENE_CHUNK_ALIGNMENT = 64;
+static constexpr uint64_t SCENE_TOC_MAGIC = 8319958848428500296;
+static constexpr size_t SCENE_HEADER_SIZE = sizeof(SCENE_MAGIC) + 2 * sizeof(uint32_t);
+static constexpr size_t SCENE_TRAILER_SIZE = 2 * sizeof(uint64_t);
+
+struct SceneChunk {
+    std::string name;
+    uint64_t offset;
+    uint64_t size;
+};
+
 Result<void> SaveSceneBinary(const std::string& p_path, Scene& p_scene) {
     Archive archive;
     if (auto res = archive.OpenWrite(p_path); !res) {
@@ -48,70 +72,76 @@ Result<void> SaveSceneBinary(const std::string& p_path, Scene& p_scene) {
 
     archive << SCENE_MAGIC;
     archive << LATEST_SCENE_VERSION;
-    archive << ecs::Entity::GetSeed();
-    archive << p_scene.m_root;
-    archive << p_scene.m_physicsMode;
-
-    archive << SCENE_GUARD_MESSAGE;
+    archive << uint32_t(0);
+
+    auto& file = archive.GetFileAccess();
+    std::vector<SceneChunk> chunks;
+    auto write_chunk = [&](const std::string& p_name, auto&& p_write_func) {
+        static constexpr uint8_t padding[SCENE_CHUNK_ALIGNMENT]{};
+        const uint64_t offset = static_cast<uint64_t>(file->Tell());
+        const uint64_t aligned = (offset + SCENE_CHUNK_ALIGNMENT - 1) & ~(SCENE_CHUNK_ALIGNMENT - 1);
+        archive.Write(padding, aligned - offset);
+
+        p_write_func();
+        chunks.push_back({ p_name, aligned, static_cast<uint64_t>(file->Tell()) - aligned });
+    };
+
+    write_chunk(SCENE_INFO_CHUNK, [&]() {
+        archive << ecs::Entity::GetSeed();
+        archive << p_scene.m_root;
+        archive << p_scene.m_physicsMode;
+    });
 
     for (const auto& it : p_scene.GetLibraryEntries()) {
         if (it.second.m_manager->GetCount()) {
-            archive << HAS_NEXT_FLAG;
-            archive << it.first;  // write name
-            it.second.m_manager->Serialize(archive, LATEST_SCENE_VERSION);
+            write_chunk(it.first, [&]() {
+                it.second.m_manager->Serialize(archive, LATEST_SCENE_VERSION);
+            });
         }
     }
-    archive << uint64_t(0);
-    return Result<void>();
-}
-
-Result<void> LoadSceneBinary(const std::string& p_path, Scene& p_scene) {
-    Archive archive;
-    if (auto res = archive.OpenRead(p_path); !res) {
-        return HBN_ERROR(res.error());
-    }
-
-    char magic[sizeof(SCENE_MAGIC)]{ 0 };
-    if (!archive.Read(magic) || !StringUtils::StringEqual(magic, SCENE_MAGIC)) {
-        return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "file corrupted, magic is not '{}'", SCENE_MAGIC);
-    }
 
-    uint32_t version;
-    if (!archive.Read(version) || version > LATEST_SCENE_VERSION) {
-        return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "incorrect scene version {}, current version is {}", version, LATEST_SCENE_VERSION);
+    const uint64_t toc_offset = static_cast<uint64_t>(file->Tell());
+    archive << static_cast<uint64_t>(chunks.size());
+    for (const SceneChunk& chunk : chunks) {
+        archive << chunk.name;
+        archive << chunk.offset;
+        archive << chunk.size;
     }
+    archive << toc_offset;
+    archive << SCENE_TOC_MAGIC;
+    return Result<void>();
+}
 
-    SCENE_DBG_LOG("loading scene '{}', version: {}", p_path, version);
-
+static Result<void> LoadSceneLegacy(Archive& p_archive, uint32_t p_version, Scene& p_scene) {
     uint32_t seed = ecs::Entity::MAX_ID;
-    if (!archive.Read(seed)) {
+    if (!p_archive.Read(seed)) {
         return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "failed to read seed");
     }
 
     ecs::Entity::SetSeed(seed);
 
-    archive >> p_scene.m_root;
+    p_archive >> p_scene.m_root;
 
     p_scene.m_physicsMode = PhysicsMode::NONE;
-    if (version >= 19) {
-        archive >> p_scene.m_physicsMode;
+    if (p_version >= 19) {
+        p_archive >> p_scene.m_physicsMode;
     }
 
     char guard_message[sizeof(SCENE_GUARD_MESSAGE)]{ 0 };
-    archive >> guard_message;
+    p_archive >> guard_message;
     if (!StringUtils::StringEqual(guard_message, SCENE_GUARD_MESSAGE)) {
         return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT);
     }
 
     for (;;) {
         uint64_t has_next = 0;
-        archive >> has_next;
+        p_archive >> has_next;
         if (has_next != HAS_NEXT_FLAG) {
             return Result<void>();
         }
 
         std::string key;
-        archive >> key;
+        p_archive >> key;
 
         SCENE_DBG_LOG("Loading Component {}", key);
 
@@ -119,12 +149,139 @@ Result<void> LoadSceneBinary(const std::string& p_path, Scene& p_scene) {
         if (it == p_scene.GetLibraryEntries().end()) {
             return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "entry '{}' not found", key);
         }
-        if (!it->second.m_manager->Serialize(archive, version)) {
+        if (!it->second.m_manager->Serialize(p_archive, p_version)) {
             return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "failed to serialize '{}'", key);
         }
     }
 }
 
+static Result<void> LoadSceneChunks(const FileAccessMapped& p_file, uint32_t p_version, Scene& p_scene) {
+    const size_t file_size = p_file.GetLength();
+    if (file_size < SCENE_HEADER_SIZE + SCENE_TRAILER_SIZE) {
+        return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "file too small");
+    }
+
+    uint64_t trailer[2];
+    memcpy(trailer, p_file.GetData().data() + file_size - SCENE_TRAILER_SIZE, SCENE_TRAILER_SIZE);
+    const uint64_t toc_offset = trailer[0];
+    const uint64_t toc_end = file_size - SCENE_TRAILER_SIZE;
+    if (trailer[1] != SCENE_TOC_MAGIC || toc_offset < SCENE_HEADER_SIZE || toc_offset > toc_end) {
+        return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "table of contents not found");
+    }
+
+    Archive toc;
+    toc.OpenRead(p_file.CreateView(toc_offset, toc_end - toc_offset));
+    uint64_t chunk_count = 0;
+    if (!toc.Read(chunk_count)) {
+        return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "failed to read the table of contents");
+    }
+
+    const SceneChunk* info_chunk = nullptr;
+    std::vector<SceneChunk> chunks(chunk_count);
+    std::vector<ecs::IComponentManager*> managers;
+    std::vector<const SceneChunk*> component_chunks;
+    for (SceneChunk& chunk : chunks) {
+        if (!toc.Read(chunk.name) || !toc.Read(chunk.offset) || !toc.Read(chunk.size)) {
+            return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "failed to read the table of contents");
+        }
+        if (chunk.offset < SCENE_HEADER_SIZE || chunk.offset > toc_offset || chunk.size > toc_offset - chunk.offset) {
+            return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "chunk '{}' out of range", chunk.name);
+        }
+
+        if (chunk.name == SCENE_INFO_CHUNK) {
+            info_chunk = &chunk;
+            continue;
+        }
+
+        auto it = p_scene.GetLibraryEntries().find(chunk.name);
+        if (it == p_scene.GetLibraryEntries().end()) {
+            return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "entry '{}' not found", chunk.name);
+        }
+        managers.push_back(it->second.m_manager.get());
+        component_chunks.push_back(&chunk);
+    }
+
+    if (!info_chunk) {
+        return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "chunk '{}' not found", SCENE_INFO_CHUNK);
+    }
+
+    Archive info;
+    info.OpenRead(p_file.CreateView(info_chunk->offset, info_chunk->size));
+    uint32_t seed = ecs::Entity::MAX_ID;
+    if (!info.Read(seed) || !info.Read(p_scene.m_root) || !info.Read(p_scene.m_physicsMode)) {
+        return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "failed to read chunk '{}'", SCENE_INFO_CHUNK);
+    }
+
+    ecs::Entity::SetSeed(seed);
+
+    // every chunk fills its own component manager
+    const uint32_t component_chunk_count = static_cast<uint32_t>(component_chunks.size());
+    std::vector<uint8_t> loaded(component_chunk_count, false);
+    auto load_chunk = [&](uint32_t p_index) {
+        const SceneChunk& chunk = *component_chunks[p_index];
+        SCENE_DBG_LOG("Loading Component {}", chunk.name);
+
+        // the chunk is paged in as a whole when its job gets to it, the archive then copies the fields
+        // straight out of the mapping
+        auto view = p_file.CreateView(chunk.offset, chunk.size);
+        view->Prefetch();
+
+        Archive archive;
+        archive.OpenRead(view);
+        loaded[p_index] = managers[p_index]->Serialize(archive, p_version);
+    };
+
+#if USING(ENABLE_JOB_SYSTEM)
+    jobsystem::Context ctx;
+    ctx.Dispatch(component_chunk_count, 1, [&load_chunk](jobsystem::JobArgs p_args) {
+        load_chunk(p_args.jobIndex);
+    });
+    ctx.Wait();
+#else
+    for (uint32_t i = 0; i < component_chunk_count; ++i) {
+        load_chunk(i);
+    }
+#endif
+
+    for (uint32_t i = 0; i < component_chunk_count; ++i) {
+        if (!loaded[i]) {
+            return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "failed to serialize '{}'", component_chunks[i]->name);
+        }
+    }
+
+    return Result<void>();
+}
+
+Result<void> LoadSceneBinary(const std::string& p_path, Scene& p_scene) {
+    // the file is mapped rather than read, chunks are only paged in when they are deserialized
+    auto res = FileAccessMapped::Map(p_path);
+    if (!res) {
+        return HBN_ERROR(res.error());
+    }
+
+    auto file = *res;
+    Archive archive;
+    archive.OpenRead(file);
+
+    char magic[sizeof(SCENE_MAGIC)]{ 0 };
+    if (!archive.Read(magic) || !StringUtils::StringEqual(magic, SCENE_MAGIC)) {
+        return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "file corrupted, magic is not '{}'", SCENE_MAGIC);
+    }
+
+    uint32_t version;
+    if (!archive.Read(version) || version > LATEST_SCENE_VERSION) {
+        return HBN_ERROR(ErrorCode::ERR_FILE_CORRUPT, "incorrect scene version {}, current version is {}", version, LATEST_SCENE_VERSION);
+    }
+
+    SCENE_DBG_LOG("loading scene '{}', version: {}", p_path, version);
+
+    if (version < CHUNKED_SCENE_VERSION) {
+        return LoadSceneLegacy(archive, version, p_scene);
+    }
+
+    return LoadSceneChunks(*file, version, p_scene);
+}
+
 template<Serializable T>
 [[nodiscard]] Result<void> SerializeComponent(YAML::Emitter& p_out,
                                               const char* p_name,
@@ -265,7 +422,7 @@ static Result<void> DeserializeComponent(const YAML::Node& p_node,
 Result<void> LoadSceneText(const std::string& p_path, Scene& p_scene) {
     unused(p_scene);
 
-    auto res = FileAccess::Open(p_path, FileAccess::READ);
+    auto res = FileAccess::Open(p_path, FileAccess::READ, FileAccess::PATTERN_WHOLE_FILE);
     if (!res) {
         return HBN_ERROR(res.error());
     }
@@ -350,6 +507,11 @@ void NameComponent::RegisterClass() {
     END_REGISTRY(NameComponent);
 }
 
+// components that are BULK_SERIALIZABLE are written as raw memory, keep their layout the same as Serialize()
+static_assert(BulkSerializable<HierarchyComponent> && sizeof(HierarchyComponent) == sizeof(ecs::Entity));
+static_assert(BulkSerializable<MeshRendererComponent> && sizeof(MeshRendererComponent) == sizeof(uint32_t) + sizeof(ecs::Entity));
+static_assert(BulkSerializable<ForceFieldComponent> && sizeof(ForceFieldComponent) == 2 * sizeof(float));
+
 void HierarchyComponent::Serialize(Archive& p_archive, uint32_t) {
     p_archive.ArchiveValue(m_parentId);
 }
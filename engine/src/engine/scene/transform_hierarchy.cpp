@@ -0,0 +1,172 @@
+#include "transform_hierarchy.h"
+
+#include "engine/core/debugger/profiler.h"
+#include "engine/scene/scene.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my {
+
+// levels smaller than this are not worth dispatching
+static constexpr uint32_t PARALLEL_LEVEL_MIN_SIZE = 256;
+static constexpr uint32_t NODE_GROUP_SIZE = 64;
+
+void TransformHierarchy::BeginFrame(size_t p_transform_count) {
+    m_localChanged.assign(p_transform_count, 0);
+}
+
+bool TransformHierarchy::NeedsRebuild(const Scene& p_scene) const {
+    return m_hierarchyVersion != p_scene.m_HierarchyComponents.GetVersion() ||
+           m_transformVersion != p_scene.m_TransformComponents.GetVersion();
+}
+
+void TransformHierarchy::Build(Scene& p_scene) {
+    HBN_PROFILE_EVENT();
+
+    auto& hierarchies = p_scene.m_HierarchyComponents;
+    auto& transforms = p_scene.m_TransformComponents;
+
+    // a node is an entity with a transform that either has a parent or is a parent
+    auto get_parent = [&](ecs::Entity p_entity) {
+        const HierarchyComponent* hierarchy = hierarchies.GetComponent(p_entity);
+        if (hierarchy && transforms.Contains(hierarchy->GetParent())) {
+            return hierarchy->GetParent();
+        }
+        return ecs::Entity::INVALID;
+    };
+
+    std::unordered_map<ecs::Entity, uint32_t> depths;
+    std::vector<ecs::Entity> chain;
+    uint32_t max_depth = 0;
+
+    auto add_node = [&](ecs::Entity p_entity) {
+        chain.clear();
+        uint32_t depth = 0;
+        for (ecs::Entity entity = p_entity; entity.IsValid(); entity = get_parent(entity)) {
+            if (auto it = depths.find(entity); it != depths.end()) {
+                depth = it->second + 1;
+                break;
+            }
+            chain.push_back(entity);
+            if (chain.size() > hierarchies.GetCount() + 1) {
+                DEV_ASSERT(0 && "cyclic hierarchy");
+                break;
+            }
+        }
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it, ++depth) {
+            depths[*it] = depth;
+            max_depth = glm::max(max_depth, depth);
+        }
+    };
+
+    for (auto [entity, hierarchy] : hierarchies) {
+        if (transforms.Contains(entity)) {
+            add_node(entity);
+        }
+    }
+
+    // counting sort by depth
+    const uint32_t level_count = depths.empty() ? 0 : max_depth + 1;
+    m_levelOffsets.assign(level_count + 1, 0);
+    for (const auto& [entity, depth] : depths) {
+        ++m_levelOffsets[depth + 1];
+    }
+    for (uint32_t i = 0; i < level_count; ++i) {
+        m_levelOffsets[i + 1] += m_levelOffsets[i];
+    }
+
+    const size_t node_count = depths.size();
+    std::vector<ecs::Entity> entities(node_count);
+    std::vector<uint32_t> cursors(m_levelOffsets.begin(), m_levelOffsets.end() - 1);
+    std::unordered_map<ecs::Entity, uint32_t> node_lookup;
+    for (const auto& [entity, depth] : depths) {
+        const uint32_t node = cursors[depth]++;
+        entities[node] = entity;
+        node_lookup[entity] = node;
+    }
+
+    m_transformIndices.resize(node_count);
+    m_parents.resize(node_count);
+    m_nodeDirty.assign(node_count, 1);
+    for (size_t node = 0; node < node_count; ++node) {
+        const ecs::Entity parent = get_parent(entities[node]);
+        m_transformIndices[node] = transforms.FindIndex(entities[node]);
+        m_parents[node] = parent.IsValid() ? node_lookup[parent] : INVALID_NODE;
+        DEV_ASSERT(m_parents[node] == INVALID_NODE || m_parents[node] < node);
+    }
+
+    m_hierarchyVersion = hierarchies.GetVersion();
+    m_transformVersion = transforms.GetVersion();
+    m_forceUpdate = true;
+}
+
+void TransformHierarchy::UpdateNodes(Scene& p_scene, uint32_t p_begin, uint32_t p_end) {
+    auto& transforms = p_scene.m_TransformComponents;
+
+    uint32_t updated = 0;
+    for (uint32_t node = p_begin; node < p_end; ++node) {
+        const uint32_t transform_index = m_transformIndices[node];
+        const uint32_t parent = m_parents[node];
+        TransformComponent& transform = transforms.GetComponentByIndex(transform_index);
+
+        if (parent == INVALID_NODE) {
+            // roots get their world matrix from the transformation system
+            m_nodeDirty[node] = m_forceUpdate || IsLocalChanged(transform_index);
+            if (m_forceUpdate) {
+                transform.SetWorldMatrix(transform.GetLocalMatrix());
+                m_worldChanged[transform_index] = 1;
+            }
+            continue;
+        }
+
+        const bool dirty = m_forceUpdate || m_nodeDirty[parent] || IsLocalChanged(transform_index);
+        m_nodeDirty[node] = dirty;
+        if (!dirty) {
+            continue;
+        }
+
+        const TransformComponent& parent_transform = transforms.GetComponentByIndex(m_transformIndices[parent]);
+        transform.SetWorldMatrix(parent_transform.GetWorldMatrix() * transform.GetLocalMatrix());
+        transform.SetDirty(false);
+        m_worldChanged[transform_index] = 1;
+        ++updated;
+    }
+
+    m_updatedCount.fetch_add(updated, std::memory_order_relaxed);
+}
+
+void TransformHierarchy::Update(Scene& p_scene, jobsystem::Context& p_context) {
+    HBN_PROFILE_EVENT();
+
+    if (NeedsRebuild(p_scene)) {
+        Build(p_scene);
+    }
+
+    m_updatedCount.store(0, std::memory_order_relaxed);
+    m_worldChanged.assign(p_scene.m_TransformComponents.GetCount(), 0);
+
+    const uint32_t level_count = GetLevelCount();
+    for (uint32_t level = 0; level < level_count; ++level) {
+        const uint32_t begin = m_levelOffsets[level];
+        const uint32_t end = m_levelOffsets[level + 1];
+
+#if USING(ENABLE_JOB_SYSTEM)
+        const uint32_t count = end - begin;
+        if (count >= PARALLEL_LEVEL_MIN_SIZE) {
+            const uint32_t group_count = (count + NODE_GROUP_SIZE - 1) / NODE_GROUP_SIZE;
+            p_context.Dispatch(group_count, 1, [&](jobsystem::JobArgs p_args) {
+                const uint32_t group_begin = begin + p_args.jobIndex * NODE_GROUP_SIZE;
+                UpdateNodes(p_scene, group_begin, glm::min(group_begin + NODE_GROUP_SIZE, end));
+            });
+            // the next level reads the world matrices of this one
+            p_context.Wait();
+            continue;
+        }
+#endif
+        UpdateNodes(p_scene, begin, end);
+    }
+
+    unused(p_context);
+    m_forceUpdate = false;
+}
+
+}  // namespace my
@@ -0,0 +1,62 @@
+#pragma once
+
+// clang-format off
+namespace my { class Scene; }
+namespace my::jobsystem { class Context; }
+// clang-format on
+
+namespace my {
+
+// Flat copy of the HierarchyComponent tree, nodes are sorted by depth so a parent always
+// comes before its children. World matrices are computed once per node, one level at a time,
+// and nodes whose local transform and ancestors didn't change this frame are skipped.
+// The tree is rebuilt when hierarchy or transform components are added or removed.
+class TransformHierarchy {
+public:
+    static constexpr uint32_t INVALID_NODE = ~0u;
+
+    // called by the transformation system before it updates the local matrices,
+    // p_index is the dense index of the transform component
+    void BeginFrame(size_t p_transform_count);
+    void MarkChanged(size_t p_index) { m_localChanged[p_index] = 1; }
+
+    void Update(Scene& p_scene, jobsystem::Context& p_context);
+
+    // the world matrix changed in the last Update(), either locally or through an ancestor
+    bool IsWorldChanged(size_t p_index) const {
+        return IsLocalChanged(static_cast<uint32_t>(p_index)) || (p_index < m_worldChanged.size() && m_worldChanged[p_index]);
+    }
+
+    uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_transformIndices.size()); }
+    uint32_t GetLevelCount() const { return m_levelOffsets.empty() ? 0 : static_cast<uint32_t>(m_levelOffsets.size() - 1); }
+    // number of world matrices recomputed by the last Update()
+    uint32_t GetUpdatedCount() const { return m_updatedCount.load(std::memory_order_relaxed); }
+
+private:
+    bool NeedsRebuild(const Scene& p_scene) const;
+    void Build(Scene& p_scene);
+    void UpdateNodes(Scene& p_scene, uint32_t p_begin, uint32_t p_end);
+
+    bool IsLocalChanged(uint32_t p_transform_index) const {
+        return p_transform_index < m_localChanged.size() && m_localChanged[p_transform_index];
+    }
+
+    // per node, in level order
+    std::vector<uint32_t> m_transformIndices;
+    std::vector<uint32_t> m_parents;
+    std::vector<uint8_t> m_nodeDirty;
+    // node range of level i is [m_levelOffsets[i], m_levelOffsets[i + 1])
+    std::vector<uint32_t> m_levelOffsets;
+
+    // per transform component, set by the transformation system
+    std::vector<uint8_t> m_localChanged;
+    // per transform component, set for the nodes Update() recomputed
+    std::vector<uint8_t> m_worldChanged;
+
+    uint32_t m_hierarchyVersion{ ~0u };
+    uint32_t m_transformVersion{ ~0u };
+    bool m_forceUpdate{ true };
+    std::atomic_uint32_t m_updatedCount{ 0 };
+};
+
+}  // namespace my
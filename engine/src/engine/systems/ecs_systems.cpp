@@ -2,6 +2,8 @@
 
 #include "engine/core/base/random.h"
 #include "engine/core/debugger/profiler.h"
+#include "engine/math/transform_batch.h"
+#include "engine/scene/animation_clip.h"
 #include "engine/scene/scene.h"
 #include "engine/systems/job_system/job_system.h"
 
@@ -27,98 +29,141 @@ static constexpr uint32_t SMALL_SUBTASK_GROUP_SIZE = 64;
 #define JS_PARALLEL_FOR JS_NO_PARALLEL_FOR
 #endif
 
-static void UpdateAnimation(Scene& p_scene, size_t p_index, float p_timestep) {
-    AnimationComponent& animation = p_scene.GetComponentByIndex<AnimationComponent>(p_index);
+// resolves the target transform of every channel to a dense index, so sampling doesn't do an entity lookup per channel
+static void BindAnimation(Scene& p_scene, AnimationComponent& p_animation) {
+    const auto& transforms = p_scene.GetManager<TransformComponent>();
+    const size_t channel_count = p_animation.channels.size();
+
+    p_animation.targetIndices.resize(channel_count);
+    p_animation.cursors.assign(channel_count, 0);
+    for (size_t i = 0; i < channel_count; ++i) {
+        const uint32_t index = transforms.FindIndex(p_animation.channels[i].targetId);
+        DEV_ASSERT(index != ecs::EntityIndex::INVALID_INDEX);
+        p_animation.targetIndices[i] = index;
+    }
 
-    if (!animation.IsPlaying()) {
-        return;
+    if (p_animation.IsCompressed()) {
+        // the clip only depends on the channels, rebinding just resolves the joints again
+        if (!p_animation.clip) {
+            p_animation.clipJoints.clear();
+            for (const auto& channel : p_animation.channels) {
+                if (std::find(p_animation.clipJoints.begin(), p_animation.clipJoints.end(), channel.targetId) == p_animation.clipJoints.end()) {
+                    p_animation.clipJoints.push_back(channel.targetId);
+                }
+            }
+            p_animation.clip = std::make_shared<const AnimationClip>(AnimationClip::Compress(p_animation, p_animation.clipJoints));
+        }
+
+        p_animation.jointIndices.resize(p_animation.clipJoints.size());
+        for (size_t i = 0; i < p_animation.clipJoints.size(); ++i) {
+            p_animation.jointIndices[i] = transforms.FindIndex(p_animation.clipJoints[i]);
+        }
+    } else {
+        p_animation.clip.reset();
+    }
+
+    p_animation.bindingVersion = transforms.GetVersion();
+}
+
+static Vector4f Slerp(const Vector4f& p_a, const Vector4f& p_b, float p_t) {
+    const Quaternion q = glm::slerp(Quaternion(p_a.w, p_a.x, p_a.y, p_a.z), Quaternion(p_b.w, p_b.x, p_b.y, p_b.z), p_t);
+    return Vector4f(q.x, q.y, q.z, q.w);
+}
+
+static void SampleClip(Scene& p_scene, const AnimationComponent& p_animation) {
+    // joints without a track keep their transform, so the pose starts from the current one
+    thread_local AnimationPose pose;
+    const size_t joint_count = p_animation.jointIndices.size();
+    pose.Resize(joint_count);
+    for (size_t joint = 0; joint < joint_count; ++joint) {
+        const TransformComponent& transform = p_scene.GetComponentByIndex<TransformComponent>(p_animation.jointIndices[joint]);
+        pose.translations[joint] = transform.GetTranslation();
+        pose.rotations[joint] = transform.GetRotation();
+        pose.scales[joint] = transform.GetScale();
     }
 
-    for (const AnimationComponent::Channel& channel : animation.channels) {
+    p_animation.clip->Sample(p_animation.timer, pose);
+
+    for (size_t joint = 0; joint < joint_count; ++joint) {
+        TransformComponent& transform = p_scene.GetComponentByIndex<TransformComponent>(p_animation.jointIndices[joint]);
+        transform.SetTranslation(pose.translations[joint]);
+        transform.SetRotation(pose.rotations[joint]);
+        transform.SetScale(pose.scales[joint]);
+        transform.SetDirty();
+    }
+}
+
+static void SampleChannels(Scene& p_scene, AnimationComponent& p_animation) {
+    const size_t channel_count = p_animation.channels.size();
+    for (size_t channel_index = 0; channel_index < channel_count; ++channel_index) {
+        const AnimationComponent::Channel& channel = p_animation.channels[channel_index];
         if (channel.path == AnimationComponent::Channel::PATH_UNKNOWN) {
             continue;
         }
-        DEV_ASSERT(channel.samplerIndex < (int)animation.samplers.size());
-        const AnimationComponent::Sampler& sampler = animation.samplers[channel.samplerIndex];
-
-        int key_left = 0;
-        int key_right = 0;
-        float time_first = std::numeric_limits<float>::min();
-        float time_last = std::numeric_limits<float>::min();
-        float time_left = std::numeric_limits<float>::min();
-        float time_right = std::numeric_limits<float>::max();
-
-        for (int k = 0; k < (int)sampler.keyframeTimes.size(); ++k) {
-            const float time = sampler.keyframeTimes[k];
-            if (time < time_first) {
-                time_first = time;
-            }
-            if (time > time_last) {
-                time_last = time;
-            }
-            if (time <= animation.timer && time > time_left) {
-                time_left = time;
-                key_left = k;
-            }
-            if (time >= animation.timer && time < time_right) {
-                time_right = time;
-                key_right = k;
-            }
-        }
+        DEV_ASSERT(channel.samplerIndex < (int)p_animation.samplers.size());
+        const AnimationComponent::Sampler& sampler = p_animation.samplers[channel.samplerIndex];
+        const auto& times = sampler.keyframeTimes;
 
-        if (animation.timer < time_first) {
+        if (times.empty() || p_animation.timer < times.front()) {
             continue;
         }
 
-        const float left = sampler.keyframeTimes[key_left];
-        const float right = sampler.keyframeTimes[key_right];
+        uint32_t& cursor = p_animation.cursors[channel_index];
+        cursor = sampler.FindKeyframe(p_animation.timer, cursor);
+
+        const uint32_t key_left = cursor;
+        const uint32_t key_right = glm::min(key_left + 1, static_cast<uint32_t>(times.size() - 1));
 
         float t = 0;
         if (key_left != key_right) {
-            t = (animation.timer - left) / (right - left);
+            t = (p_animation.timer - times[key_left]) / (times[key_right] - times[key_left]);
         }
         t = Saturate(t);
 
-        TransformComponent* targetTransform = p_scene.GetComponent<TransformComponent>(channel.targetId);
-        DEV_ASSERT(targetTransform);
-        auto dummy_mix = [](const Vector3f& a, const Vector3f& b, float t) {
-            glm::vec3 tmp = glm::mix(glm::vec3(a.x, a.y, a.z), glm::vec3(b.x, b.y, b.z), t);
-            return Vector3f(tmp.x, tmp.y, tmp.z);
-        };
-        auto dummy_mix_4 = [](const Vector4f& a, const Vector4f& b, float t) {
-            glm::vec4 tmp = glm::mix(glm::vec4(a.x, a.y, a.z, a.w), glm::vec4(b.x, b.y, b.z, b.w), t);
-            return Vector4f(tmp.x, tmp.y, tmp.z, tmp.w);
-        };
+        TransformComponent& target_transform = p_scene.GetComponentByIndex<TransformComponent>(p_animation.targetIndices[channel_index]);
         switch (channel.path) {
             case AnimationComponent::Channel::PATH_SCALE: {
-                DEV_ASSERT(sampler.keyframeData.size() == sampler.keyframeTimes.size() * 3);
+                DEV_ASSERT(sampler.keyframeData.size() == times.size() * 3);
                 const Vector3f* data = (const Vector3f*)sampler.keyframeData.data();
-                const Vector3f& vLeft = data[key_left];
-                const Vector3f& vRight = data[key_right];
-                targetTransform->SetScale(dummy_mix(vLeft, vRight, t));
+                target_transform.SetScale(lerp(data[key_left], data[key_right], t));
                 break;
             }
             case AnimationComponent::Channel::PATH_TRANSLATION: {
-                DEV_ASSERT(sampler.keyframeData.size() == sampler.keyframeTimes.size() * 3);
+                DEV_ASSERT(sampler.keyframeData.size() == times.size() * 3);
                 const Vector3f* data = (const Vector3f*)sampler.keyframeData.data();
-                const Vector3f& vLeft = data[key_left];
-                const Vector3f& vRight = data[key_right];
-                targetTransform->SetTranslation(dummy_mix(vLeft, vRight, t));
+                target_transform.SetTranslation(lerp(data[key_left], data[key_right], t));
                 break;
             }
             case AnimationComponent::Channel::PATH_ROTATION: {
-                DEV_ASSERT(sampler.keyframeData.size() == sampler.keyframeTimes.size() * 4);
+                DEV_ASSERT(sampler.keyframeData.size() == times.size() * 4);
                 const Vector4f* data = (const Vector4f*)sampler.keyframeData.data();
-                const Vector4f& vLeft = data[key_left];
-                const Vector4f& vRight = data[key_right];
-                targetTransform->SetRotation(dummy_mix_4(vLeft, vRight, t));
+                target_transform.SetRotation(Slerp(data[key_left], data[key_right], t));
                 break;
             }
             default:
                 CRASH_NOW();
                 break;
         }
-        targetTransform->SetDirty();
+        target_transform.SetDirty();
+    }
+}
+
+static void UpdateAnimation(Scene& p_scene, size_t p_index, float p_timestep) {
+    AnimationComponent& animation = p_scene.GetComponentByIndex<AnimationComponent>(p_index);
+
+    if (!animation.IsPlaying()) {
+        return;
+    }
+
+    if (animation.bindingVersion != p_scene.GetManager<TransformComponent>().GetVersion() ||
+        animation.IsCompressed() != (animation.clip != nullptr)) {
+        BindAnimation(p_scene, animation);
+    }
+
+    if (animation.clip) {
+        SampleClip(p_scene, animation);
+    } else {
+        SampleChannels(p_scene, animation);
     }
 
     if (animation.IsLooped() && animation.timer > animation.end) {
@@ -130,38 +175,19 @@ static void UpdateAnimation(Scene& p_scene, size_t p_index, float p_timestep) {
     }
 }
 
-static void UpdateHierarchy(Scene& p_scene, size_t p_index, float p_timestep) {
-    unused(p_timestep);
-
-    ecs::Entity self_id = p_scene.GetEntityByIndex<HierarchyComponent>(p_index);
-    TransformComponent* self_transform = p_scene.GetComponent<TransformComponent>(self_id);
-
-    if (!self_transform) {
-        return;
-    }
-
-    Matrix4x4f world_matrix = self_transform->GetLocalMatrix();
-    const HierarchyComponent* hierarchy = &p_scene.GetComponentByIndex<HierarchyComponent>(p_index);
-    ecs::Entity parent = hierarchy->GetParent();
-
-    while (parent.IsValid()) {
-        TransformComponent* parent_transform = p_scene.GetComponent<TransformComponent>(parent);
-        if (DEV_VERIFY(parent_transform)) {
-            world_matrix = parent_transform->GetLocalMatrix() * world_matrix;
+// resolves the bones to dense transform indices, so the palette update doesn't do an entity lookup per bone
+static void BindArmature(Scene& p_scene, ArmatureComponent& p_armature) {
+    const auto& transforms = p_scene.GetManager<TransformComponent>();
+    const size_t bone_count = p_armature.boneCollection.size();
 
-            if ((hierarchy = p_scene.GetComponent<HierarchyComponent>(parent)) != nullptr) {
-                parent = hierarchy->GetParent();
-                DEV_ASSERT(parent.IsValid());
-            } else {
-                parent.MakeInvalid();
-            }
-        } else {
-            break;
-        }
+    p_armature.boneIndices.resize(bone_count);
+    for (size_t i = 0; i < bone_count; ++i) {
+        const uint32_t index = transforms.FindIndex(p_armature.boneCollection[i]);
+        DEV_ASSERT(index != ecs::EntityIndex::INVALID_INDEX);
+        p_armature.boneIndices[i] = index;
     }
 
-    self_transform->SetWorldMatrix(world_matrix);
-    self_transform->SetDirty(false);
+    p_armature.bindingVersion = transforms.GetVersion();
 }
 
 static void UpdateArmature(Scene& p_scene, size_t p_index, float) {
@@ -179,26 +205,17 @@ static void UpdateArmature(Scene& p_scene, size_t p_index, float) {
     // to LH space) 	then the inverseBindMatrices are not reflected in that because they are not contained in
     // the hierarchy system. 	But this will correct them too.
 
-    ArmatureComponent& armature = p_scene.GetComponentByIndex<ArmatureComponent>(p_index);
-    const Matrix4x4f R = glm::inverse(transform->GetWorldMatrix());
-    const size_t numBones = armature.boneCollection.size();
-    if (armature.boneTransforms.size() != numBones) {
-        armature.boneTransforms.resize(numBones);
-    }
-
-    int idx = 0;
-    for (ecs::Entity boneID : armature.boneCollection) {
-        const TransformComponent* boneTransform = p_scene.GetComponent<TransformComponent>(boneID);
-        DEV_ASSERT(boneTransform);
-
-        const Matrix4x4f& B = armature.inverseBindMatrices[idx];
-        const Matrix4x4f& W = boneTransform->GetWorldMatrix();
-        const Matrix4x4f M = R * W * B;
-        armature.boneTransforms[idx] = M;
-        ++idx;
+    const ArmatureComponent& armature = p_scene.GetComponentByIndex<ArmatureComponent>(p_index);
+    const size_t bone_count = armature.boneIndices.size();
+    DEV_ASSERT(armature.inverseBindMatrices.size() >= bone_count);
 
-        // @TODO: armature animation
+    Matrix4x4f* palette = p_scene.m_bonePalette.data() + armature.paletteOffset;
+    for (size_t i = 0; i < bone_count; ++i) {
+        palette[i] = p_scene.GetComponentByIndex<TransformComponent>(armature.boneIndices[i]).GetWorldMatrix();
     }
+
+    const Matrix4x4f R = glm::inverse(transform->GetWorldMatrix());
+    ComputeSkinningMatrices(R, armature.inverseBindMatrices.data(), palette, bone_count);
 };
 
 static void UpdateLight(float p_timestep,
@@ -268,22 +285,78 @@ void RunLightUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, float p
     HBN_PROFILE_EVENT();
     unused(p_context);
 
-    for (auto [id, light] : p_scene.m_LightComponents) {
-        const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(id);
-        if (DEV_VERIFY(transform)) {
-            UpdateLight(p_timestep, *transform, light);
+    for (auto [id, light, transform] : p_scene.View<LightComponent, TransformComponent>()) {
+        UpdateLight(p_timestep, transform, light);
+    }
+}
+
+// gathers the dirty transforms of [p_begin, p_end) into SoA arrays and composes their matrices in one batch
+static void UpdateTransformChunk(Scene& p_scene, uint32_t p_begin, uint32_t p_end) {
+    constexpr uint32_t CHUNK_SIZE = SMALL_SUBTASK_GROUP_SIZE;
+    DEV_ASSERT(p_end - p_begin <= CHUNK_SIZE);
+
+    float soa[10][CHUNK_SIZE];
+    uint32_t indices[CHUNK_SIZE];
+    Matrix4x4f matrices[CHUNK_SIZE];
+
+    uint32_t count = 0;
+    for (uint32_t index = p_begin; index < p_end; ++index) {
+        TransformComponent& transform = p_scene.GetComponentByIndex<TransformComponent>(index);
+        if (!transform.IsDirty()) {
+            continue;
         }
+
+        const Vector3f& translation = transform.GetTranslation();
+        const Vector4f& rotation = transform.GetRotation();
+        const Vector3f& scale = transform.GetScale();
+        soa[0][count] = translation.x;
+        soa[1][count] = translation.y;
+        soa[2][count] = translation.z;
+        soa[3][count] = rotation.x;
+        soa[4][count] = rotation.y;
+        soa[5][count] = rotation.z;
+        soa[6][count] = rotation.w;
+        soa[7][count] = scale.x;
+        soa[8][count] = scale.y;
+        soa[9][count] = scale.z;
+        indices[count++] = index;
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    const TransformBatch batch = { soa[0], soa[1], soa[2], soa[3], soa[4], soa[5], soa[6], soa[7], soa[8], soa[9] };
+    ComposeTransforms(batch, matrices, count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        TransformComponent& transform = p_scene.GetComponentByIndex<TransformComponent>(indices[i]);
+        transform.SetWorldMatrix(matrices[i]);
+        transform.SetDirty(false);
+        p_scene.m_transformHierarchy.MarkChanged(indices[i]);
     }
+
+    p_scene.m_dirtyFlags.fetch_or(SCENE_DIRTY_WORLD);
 }
 
 void RunTransformationUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, float) {
     HBN_PROFILE_EVENT();
 
-    JS_PARALLEL_FOR(TransformComponent, p_context, index, SMALL_SUBTASK_GROUP_SIZE, {
-        if (p_scene.GetComponentByIndex<TransformComponent>(index).UpdateTransform()) {
-            p_scene.m_dirtyFlags.fetch_or(SCENE_DIRTY_WORLD);
-        }
+    const uint32_t transform_count = static_cast<uint32_t>(p_scene.GetCount<TransformComponent>());
+    p_scene.m_transformHierarchy.BeginFrame(transform_count);
+
+#if USING(ENABLE_JOB_SYSTEM)
+    const uint32_t chunk_count = (transform_count + SMALL_SUBTASK_GROUP_SIZE - 1) / SMALL_SUBTASK_GROUP_SIZE;
+    p_context.Dispatch(chunk_count, 1, [&p_scene, transform_count](jobsystem::JobArgs p_args) {
+        const uint32_t begin = p_args.jobIndex * SMALL_SUBTASK_GROUP_SIZE;
+        UpdateTransformChunk(p_scene, begin, glm::min(begin + SMALL_SUBTASK_GROUP_SIZE, transform_count));
     });
+#else
+    unused(p_context);
+    for (uint32_t begin = 0; begin < transform_count; begin += SMALL_SUBTASK_GROUP_SIZE) {
+        UpdateTransformChunk(p_scene, begin, glm::min(begin + SMALL_SUBTASK_GROUP_SIZE, transform_count));
+    }
+#endif
 }
 
 void RunAnimationUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, float p_timestep) {
@@ -293,36 +366,33 @@ void RunAnimationUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, flo
 
 void RunArmatureUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, float p_timestep) {
     HBN_PROFILE_EVENT();
+
+    // every armature gets a contiguous range of the palette, the ranges are filled in parallel
+    const uint32_t transform_version = p_scene.GetManager<TransformComponent>().GetVersion();
+    uint32_t palette_size = 0;
+    for (auto [entity, armature] : p_scene.View<ArmatureComponent>()) {
+        if (armature.bindingVersion != transform_version || armature.boneIndices.size() != armature.boneCollection.size()) {
+            BindArmature(p_scene, armature);
+        }
+        armature.paletteOffset = palette_size;
+        palette_size += static_cast<uint32_t>(armature.boneIndices.size());
+    }
+    p_scene.m_bonePalette.resize(palette_size);
+
     JS_PARALLEL_FOR(ArmatureComponent, p_context, index, 1, UpdateArmature(p_scene, index, p_timestep));
 }
 
-void RunHierarchyUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, float p_timestep) {
+void RunHierarchyUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, float) {
     HBN_PROFILE_EVENT();
-    JS_PARALLEL_FOR(HierarchyComponent, p_context, index, SMALL_SUBTASK_GROUP_SIZE, UpdateHierarchy(p_scene, index, p_timestep));
+    p_scene.m_transformHierarchy.Update(p_scene, p_context);
 }
 
 void RunObjectUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, float) {
     HBN_PROFILE_EVENT();
     unused(p_context);
 
-    AABB bound;
-
-    for (auto [entity, obj] : p_scene.m_MeshRendererComponents) {
-        if (!p_scene.Contains<TransformComponent>(entity)) {
-            continue;
-        }
-
-        const TransformComponent& transform = *p_scene.GetComponent<TransformComponent>(entity);
-        DEV_ASSERT(p_scene.Contains<MeshComponent>(obj.meshId));
-        const MeshComponent& mesh = *p_scene.GetComponent<MeshComponent>(obj.meshId);
-
-        Matrix4x4f M = transform.GetWorldMatrix();
-        AABB aabb = mesh.localBound;
-        aabb.ApplyMatrix(M);
-        bound.UnionBox(aabb);
-    }
-
-    p_scene.m_bound = bound;
+    p_scene.m_objectTree.Update(p_scene);
+    p_scene.m_bound = p_scene.m_objectTree.GetSceneBound();
 }
 
 void RunParticleEmitterUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, float) {
@@ -404,11 +474,8 @@ void RunMeshEmitterUpdateSystem(Scene& p_scene, jobsystem::Context& p_context, f
     HBN_PROFILE_EVENT();
 
     unused(p_context);
-    for (auto [id, emitter] : p_scene.m_MeshEmitterComponents) {
-        const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(id);
-        if (DEV_VERIFY(transform)) {
-            UpdateMeshEmitter(p_timestep, *transform, emitter);
-        }
+    for (auto [id, emitter, transform] : p_scene.View<MeshEmitterComponent, TransformComponent>()) {
+        UpdateMeshEmitter(p_timestep, transform, emitter);
     }
 }
 
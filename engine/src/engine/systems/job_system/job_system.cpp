@@ -1,31 +1,93 @@
 #include "job_system.h"
 
-#include "engine/core/base/thread_safe_ring_buffer.h"
+#include <bit>
+
+#include "engine/core/base/work_stealing_deque.h"
 #include "engine/core/debugger/profiler.h"
 #include "engine/core/os/threads.h"
 #include "engine/math/geomath.h"
 
+#if USING(ARCH_X64)
+#include <immintrin.h>
+#endif
+
 namespace my::jobsystem {
 
+#if USING(ENABLE_JOB_SYSTEM)
+static constexpr size_t JOB_QUEUE_CAPACITY = 512;
+// number of failed steal attempts before a worker parks, parking costs a syscall on both sides
+static constexpr int JOB_SPIN_COUNT = 256;
+static constexpr uint32_t WORKER_COUNT = thread::THREAD_JOBSYSTEM_WORKER_8 - thread::THREAD_JOBSYSTEM_WORKER_1 + 1;
+
 static struct
 {
+    // every thread owns a queue, indexed by thread id
+    std::array<WorkStealingDeque<Job, JOB_QUEUE_CAPACITY>, thread::THREAD_MAX> jobQueues;
+    std::atomic_uint32_t activeWorkerCount{ WORKER_COUNT };
+    std::atomic_uint32_t sleepingCount{ 0 };
+    std::atomic_uint32_t wakeEpoch{ 0 };
     std::condition_variable wakeCondition;
     std::mutex wakeMutex;
-    ThreadSafeRingBuffer<Job, 128> jobQueue;
 } s_glob;
 
-bool Initialize() {
-    return true;
+static inline void CpuRelax() {
+#if USING(ARCH_X64)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
 }
 
-void Finalize() {
+static void NotifyAll() {
+    {
+        std::lock_guard<std::mutex> lock(s_glob.wakeMutex);
+        s_glob.wakeEpoch.fetch_add(1, std::memory_order_relaxed);
+    }
     s_glob.wakeCondition.notify_all();
 }
 
-#if USING(ENABLE_JOB_SYSTEM)
-static bool DoWork() {
+static void WakeWorkers() {
+    // pairs with the fence in Park(), either the producer sees the sleeper,
+    // or the sleeper sees the pushed job
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (s_glob.sleepingCount.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    NotifyAll();
+}
+
+static bool HasPendingWork() {
+    for (const auto& queue : s_glob.jobQueues) {
+        if (!queue.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool Steal(uint32_t p_thread_id, Job& p_out_job) {
+    // start from the last successful victim
+    static thread_local uint32_t s_victim = 0;
+
+    for (uint32_t i = 0; i < thread::THREAD_MAX; ++i) {
+        const uint32_t victim = (s_victim + i) % thread::THREAD_MAX;
+        if (victim == p_thread_id) {
+            continue;
+        }
+
+        if (s_glob.jobQueues[victim].steal(p_out_job)) {
+            s_victim = victim;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool DoWork(uint32_t p_thread_id) {
     Job job;
-    if (!s_glob.jobQueue.pop_front(job)) {
+    if (!s_glob.jobQueues[p_thread_id].pop_back(job) && !Steal(p_thread_id, job)) {
         return false;
     }
 
@@ -34,64 +96,180 @@ static bool DoWork() {
         args.groupId = job.groupId;
         args.jobIndex = i;
         args.groupIndex = i - job.groupJobOffset;
-        job.task(args);
+        (*job.task)(args);
+    }
+
+    job.ctx->FinishJob(job.slot);
+    return true;
+}
+
+static void Park() {
+    const uint32_t epoch = s_glob.wakeEpoch.load(std::memory_order_acquire);
+    s_glob.sleepingCount.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (!HasPendingWork()) {
+        std::unique_lock<std::mutex> lock(s_glob.wakeMutex);
+        s_glob.wakeCondition.wait(lock, [epoch]() {
+            return s_glob.wakeEpoch.load(std::memory_order_relaxed) != epoch || thread::ShutdownRequested();
+        });
     }
 
-    job.ctx->DecreaseTaskCount();
+    s_glob.sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static void ParkInactive(uint32_t p_worker_index) {
+    std::unique_lock<std::mutex> lock(s_glob.wakeMutex);
+    s_glob.wakeCondition.wait(lock, [p_worker_index]() {
+        return p_worker_index < s_glob.activeWorkerCount.load(std::memory_order_relaxed) || thread::ShutdownRequested();
+    });
+}
+#endif
+
+bool Initialize() {
     return true;
 }
 
+void Finalize() {
+#if USING(ENABLE_JOB_SYSTEM)
+    NotifyAll();
+#endif
+}
+
+uint32_t GetWorkerCount() {
+#if USING(ENABLE_JOB_SYSTEM)
+    return WORKER_COUNT;
+#else
+    return 0;
+#endif
+}
+
+void SetActiveWorkerCount(uint32_t p_count) {
+#if USING(ENABLE_JOB_SYSTEM)
+    s_glob.activeWorkerCount.store(glm::min(p_count, WORKER_COUNT));
+    NotifyAll();
+#else
+    unused(p_count);
+#endif
+}
+
+uint32_t GetActiveWorkerCount() {
+#if USING(ENABLE_JOB_SYSTEM)
+    return s_glob.activeWorkerCount.load();
+#else
+    return 0;
+#endif
+}
+
+#if USING(ENABLE_JOB_SYSTEM)
 void WorkerMain() {
-    for (;;) {
-        if (thread::ShutdownRequested()) {
-            break;
+    const uint32_t thread_id = thread::GetThreadId();
+    const uint32_t worker_index = thread_id - thread::THREAD_JOBSYSTEM_WORKER_1;
+    DEV_ASSERT(worker_index < WORKER_COUNT);
+
+    while (!thread::ShutdownRequested()) {
+        if (worker_index >= s_glob.activeWorkerCount.load(std::memory_order_relaxed)) {
+            ParkInactive(worker_index);
+            continue;
         }
 
-        if (!DoWork()) {
-            std::unique_lock<std::mutex> lock(s_glob.wakeMutex);
-            s_glob.wakeCondition.wait(lock);
+        if (DoWork(thread_id)) {
+            continue;
+        }
+
+        bool found = false;
+        for (int spin = 0; spin < JOB_SPIN_COUNT && !found; ++spin) {
+            CpuRelax();
+            found = DoWork(thread_id);
+        }
+
+        if (!found) {
+            Park();
         }
     }
 }
 
-void Context::Dispatch(uint32_t p_job_count, uint32_t p_group_size, const std::function<void(JobArgs)>& p_task) {
-    // DEV_ASSERT(thread::isMainThread());
-
+void Context::Dispatch(uint32_t p_job_count, uint32_t p_group_size, const JobFunc& p_task) {
     if (p_job_count == 0 || p_group_size == 0) {
         return;
     }
 
+    // take the lowest free slot
+    uint32_t free_slots = m_freeSlots.load(std::memory_order_acquire);
+    while (free_slots && !m_freeSlots.compare_exchange_weak(free_slots, free_slots & (free_slots - 1), std::memory_order_acquire)) {
+    }
+
+    if (free_slots == 0) {
+        // every slot belongs to a task still running, e.g. deeply nested dispatches, run it on the calling thread
+        static std::atomic_bool s_warned = false;
+        if (!s_warned.exchange(true, std::memory_order_relaxed)) {
+            LOG_WARN("jobsystem: all {} task slots of a context are in use, running the task on the calling thread", MAX_TASK_COUNT);
+        }
+        for (uint32_t i = 0; i < p_job_count; ++i) {
+            JobArgs args;
+            args.groupId = i / p_group_size;
+            args.jobIndex = i;
+            args.groupIndex = i % p_group_size;
+            p_task(args);
+        }
+        return;
+    }
+
+    const uint32_t slot = static_cast<uint32_t>(std::countr_zero(free_slots));
     const uint32_t group_count = (p_job_count + p_group_size - 1) / p_group_size;  // make sure round up
-    m_taskCount.fetch_add(group_count);
+    m_slotJobCounts[slot].store(group_count, std::memory_order_relaxed);
+    m_taskCount.fetch_add(group_count, std::memory_order_acq_rel);
+
+    // jobs reference the task, it stays in the slot until the last job finished
+    const JobFunc* task = &(m_tasks[slot] = p_task);
+
+    const uint32_t thread_id = thread::GetThreadId();
+    // only the owner can push to a queue, a thread the engine didn't start has none
+    DEV_ASSERT(thread_id < thread::THREAD_MAX);
+    auto& queue = s_glob.jobQueues[thread_id];
 
     for (uint32_t group_id = 0; group_id < group_count; ++group_id) {
         Job job;
         job.ctx = this;
-        job.task = p_task;
+        job.task = task;
+        job.slot = slot;
         job.groupId = group_id;
         job.groupJobOffset = group_id * p_group_size;
         job.groupJobEnd = glm::min(job.groupJobOffset + p_group_size, p_job_count);
 
-        while (!s_glob.jobQueue.push_back(job)) {
-            // if job queue is full, notify all and let main thread do the work as well
-            s_glob.wakeCondition.notify_all();
-            DoWork();
+        while (!queue.push_back(job)) {
+            // if the queue is full, let the dispatching thread do the work as well
+            WakeWorkers();
+            DoWork(thread_id);
         }
     }
 
-    s_glob.wakeCondition.notify_all();
+    WakeWorkers();
 }
 
 void Context::Wait() {
     HBN_PROFILE_EVENT();
 
-    // Wake any threads that might be sleeping:
-    s_glob.wakeCondition.notify_all();
+    WakeWorkers();
 
     // Waiting will also put the current thread to good use by working on an other job if it can:
+    const uint32_t thread_id = thread::GetThreadId();
+    DEV_ASSERT(thread_id < thread::THREAD_MAX);
     while (IsBusy()) {
-        DoWork();
+        if (!DoWork(thread_id)) {
+            CpuRelax();
+        }
+    }
+}
+
+void Context::FinishJob(uint32_t p_slot) {
+    // the jobs of the task are done once the last one gets here, its slot can be reused right away
+    if (m_slotJobCounts[p_slot].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        m_tasks[p_slot].reset();
+        m_freeSlots.fetch_or(1u << p_slot, std::memory_order_release);
     }
+    // the context may be gone once the count drops to zero
+    m_taskCount.fetch_sub(1, std::memory_order_acq_rel);
 }
 #endif
 
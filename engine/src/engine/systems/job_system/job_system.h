@@ -1,4 +1,5 @@
 #pragma once
+#include "engine/core/base/inline_function.h"
 
 #define ENABLE_JOB_SYSTEM USE_IF(!USING(PLATFORM_WASM))
 
@@ -16,9 +17,15 @@ struct JobArgs {
     uint32_t groupIndex;
 };
 
+// captures larger than this won't compile, capture by reference instead
+using JobFunc = InlineFunction<void(JobArgs), 48>;
+
+// Job is copied in and out of the work stealing queues, so it has to stay trivially copyable,
+// the task itself is owned by the dispatching Context
 struct Job {
     Context* ctx;
-    std::function<void(JobArgs)> task;
+    const JobFunc* task;
+    uint32_t slot;
     uint32_t groupId;
     uint32_t groupJobOffset;
     uint32_t groupJobEnd;
@@ -27,21 +34,42 @@ struct Job {
 class Context {
 public:
 #if USING(ENABLE_JOB_SYSTEM)
-    void DecreaseTaskCount() { m_taskCount.fetch_sub(1); }
+    // called once the job ran, the last job of a task frees its slot
+    void FinishJob(uint32_t p_slot);
 
-    bool IsBusy() const { return m_taskCount.load() > 0; }
+    bool IsBusy() const { return m_taskCount.load(std::memory_order_acquire) > 0; }
 
-    void Dispatch(uint32_t p_job_count, uint32_t p_group_size, const std::function<void(JobArgs)>& p_task);
+    // Dispatch can be called from the main thread and the threads started by thread::Initialize(), including
+    // from a job running in the same context, as the jobs are pushed to the queue owned by the calling thread.
+    // It never allocates, the task is copied to a slot owned by the context until its last job finished.
+    // When every slot is taken, the task runs on the calling thread
+    void Dispatch(uint32_t p_job_count, uint32_t p_group_size, const JobFunc& p_task);
 
     void Wait();
 
 private:
+    static constexpr uint32_t MAX_TASK_COUNT = 32;
+
     std::atomic_int m_taskCount = 0;
+    // bit i is set when slot i is free
+    std::atomic_uint32_t m_freeSlots = ~0u;
+    std::array<std::atomic_uint32_t, MAX_TASK_COUNT> m_slotJobCounts{};
+    std::array<JobFunc, MAX_TASK_COUNT> m_tasks;
+
+    static_assert(MAX_TASK_COUNT == 32, "m_freeSlots holds one bit per slot");
 #else
     void Wait() {}
 #endif
 };
 
+// number of worker threads, not including the main thread
+uint32_t GetWorkerCount();
+
+// limit the workers that participate in stealing, the rest stay parked
+void SetActiveWorkerCount(uint32_t p_count);
+
+uint32_t GetActiveWorkerCount();
+
 void WorkerMain();
 
 }  // namespace my::jobsystem
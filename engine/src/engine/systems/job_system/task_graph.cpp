@@ -0,0 +1,139 @@
+#include "task_graph.h"
+
+#include "engine/algorithm/algorithm.h"
+#include "engine/core/debugger/profiler.h"
+
+namespace my::jobsystem {
+
+static bool Contains(const std::vector<TaskGraph::ResourceId>& p_resources, const TaskGraph::ResourceId& p_id) {
+    return std::find(p_resources.begin(), p_resources.end(), p_id) != p_resources.end();
+}
+
+bool TaskGraph::Task::ConflictsWith(const Task& p_other) const {
+    for (const auto& write : m_writes) {
+        if (Contains(p_other.m_reads, write) || Contains(p_other.m_writes, write)) {
+            return true;
+        }
+    }
+    for (const auto& read : m_reads) {
+        if (Contains(p_other.m_writes, read)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TaskGraph::Task& TaskGraph::AddTask(std::string_view p_name, TaskFunc&& p_func) {
+    DEV_ASSERT(!m_nodes);
+    m_tasks.emplace_back(Task(p_name, std::move(p_func)));
+    return m_tasks.back();
+}
+
+void TaskGraph::AddDependency(std::string_view p_from, std::string_view p_to) {
+    m_dependencies.emplace_back(std::make_pair(p_from, p_to));
+}
+
+auto TaskGraph::Compile() -> Result<void> {
+    const int N = static_cast<int>(m_tasks.size());
+    DEV_ASSERT(N);
+
+    std::unordered_map<std::string_view, int> lookup;
+    for (int i = 0; i < N; ++i) {
+        auto [_, inserted] = lookup.try_emplace(m_tasks[i].m_name, i);
+        if (!inserted) {
+            return HBN_ERROR(ErrorCode::ERR_ALREADY_EXISTS, "task '{}' already exists", m_tasks[i].m_name);
+        }
+    }
+
+    std::vector<std::pair<int, int>> edges;
+    for (const auto& [from, to] : m_dependencies) {
+        auto it = lookup.find(from);
+        if (it == lookup.end()) {
+            return HBN_ERROR(ErrorCode::ERR_DOES_NOT_EXIST, "task '{}' not found", from);
+        }
+        const int from_idx = it->second;
+        it = lookup.find(to);
+        if (it == lookup.end()) {
+            return HBN_ERROR(ErrorCode::ERR_DOES_NOT_EXIST, "task '{}' not found", to);
+        }
+        const int to_idx = it->second;
+        edges.push_back({ from_idx, to_idx });
+    }
+
+    // conflicting tasks keep the order they were added in
+    for (int to = 0; to < N; ++to) {
+        for (int from = 0; from < to; ++from) {
+            if (m_tasks[from].ConflictsWith(m_tasks[to])) {
+                edges.push_back({ from, to });
+            }
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    auto sorted = topological_sort(N, edges);
+    if (static_cast<int>(sorted.size()) != N) {
+        return HBN_ERROR(ErrorCode::ERR_CYCLIC_LINK);
+    }
+
+    m_nodes = std::make_unique<Node[]>(N);
+    for (const auto& [from, to] : edges) {
+        m_nodes[from].successors.push_back(to);
+        m_nodes[to].dependencyCount++;
+    }
+
+    m_edges = std::move(edges);
+    m_sorted = std::move(sorted);
+    return Result<void>();
+}
+
+void TaskGraph::Run() {
+    HBN_PROFILE_EVENT();
+    DEV_ASSERT(m_nodes);
+
+#if USING(ENABLE_JOB_SYSTEM)
+    const int N = static_cast<int>(m_tasks.size());
+    for (int i = 0; i < N; ++i) {
+        m_nodes[i].pendingCount.store(m_nodes[i].dependencyCount, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < N; ++i) {
+        if (m_nodes[i].dependencyCount == 0) {
+            Launch(i);
+        }
+    }
+
+    // a task launches its successors before it retires, so the context stays busy until the last one is done
+    m_context.Wait();
+#else
+    for (int index : m_sorted) {
+        Execute(index);
+    }
+#endif
+}
+
+void TaskGraph::Launch(int p_index) {
+#if USING(ENABLE_JOB_SYSTEM)
+    m_context.Dispatch(1, 1, [this, p_index](JobArgs) {
+        Execute(p_index);
+    });
+#else
+    unused(p_index);
+#endif
+}
+
+void TaskGraph::Execute(int p_index) {
+    Node& node = m_nodes[p_index];
+    m_tasks[p_index].m_func(node.context);
+    node.context.Wait();
+
+#if USING(ENABLE_JOB_SYSTEM)
+    for (int successor : node.successors) {
+        if (m_nodes[successor].pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Launch(successor);
+        }
+    }
+#endif
+}
+
+}  // namespace my::jobsystem
@@ -0,0 +1,81 @@
+#pragma once
+#include <typeindex>
+
+#include "job_system.h"
+
+namespace my::jobsystem {
+
+// A task declares the resources (usually component types) it reads and writes.
+// Edges are derived in Compile(), a task depends on every task added before it
+// that touches the same resource, unless both of them only read it.
+// Tasks without a path between them run concurrently.
+class TaskGraph {
+public:
+    using TaskFunc = std::function<void(Context&)>;
+    using ResourceId = std::type_index;
+
+    class Task {
+    public:
+        template<typename... T>
+        Task& Read() {
+            (m_reads.emplace_back(typeid(T)), ...);
+            return *this;
+        }
+
+        template<typename... T>
+        Task& Write() {
+            (m_writes.emplace_back(typeid(T)), ...);
+            return *this;
+        }
+
+        std::string_view GetName() const { return m_name; }
+
+    private:
+        Task(std::string_view p_name, TaskFunc&& p_func)
+            : m_name(p_name), m_func(std::move(p_func)) {}
+
+        bool ConflictsWith(const Task& p_other) const;
+
+        std::string m_name;
+        TaskFunc m_func;
+        std::vector<ResourceId> m_reads;
+        std::vector<ResourceId> m_writes;
+
+        friend class TaskGraph;
+    };
+
+    // the task func dispatches its work to the context it's given,
+    // the task is considered finished once that context is idle
+    Task& AddTask(std::string_view p_name, TaskFunc&& p_func);
+
+    void AddDependency(std::string_view p_from, std::string_view p_to);
+
+    [[nodiscard]] auto Compile() -> Result<void>;
+
+    // blocks until every task has finished
+    void Run();
+
+    const auto& GetSortedOrder() const { return m_sorted; }
+    const auto& GetEdges() const { return m_edges; }
+
+private:
+    struct Node {
+        std::vector<int> successors;
+        int dependencyCount{ 0 };
+        std::atomic_int pendingCount{ 0 };
+        Context context;
+    };
+
+    void Launch(int p_index);
+    void Execute(int p_index);
+
+    std::vector<Task> m_tasks;
+    std::vector<std::pair<std::string, std::string>> m_dependencies;
+
+    std::vector<std::pair<int, int>> m_edges;
+    std::vector<int> m_sorted;
+    std::unique_ptr<Node[]> m_nodes;
+    Context m_context;
+};
+
+}  // namespace my::jobsystem
@@ -0,0 +1,72 @@
+#include "allocation_tracker.h"
+
+#include <cstdlib>
+#include <new>
+
+static std::atomic_int s_trackerCount{ 0 };
+static std::atomic_uint64_t s_allocationCount{ 0 };
+
+void* operator new(size_t p_size) {
+    if (s_trackerCount.load(std::memory_order_relaxed) > 0) {
+        s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* ptr = std::malloc(p_size ? p_size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p_ptr) noexcept {
+    std::free(p_ptr);
+}
+
+void operator delete(void* p_ptr, size_t) noexcept {
+    std::free(p_ptr);
+}
+
+// over aligned allocations, such as the blocks of LinearAllocator
+void* operator new(size_t p_size, std::align_val_t p_alignment) {
+    if (s_trackerCount.load(std::memory_order_relaxed) > 0) {
+        s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    const size_t alignment = static_cast<size_t>(p_alignment);
+    const size_t size = (p_size + alignment - 1) & ~(alignment - 1);
+#if USING(PLATFORM_WINDOWS)
+    void* ptr = _aligned_malloc(size ? size : alignment, alignment);
+#else
+    void* ptr = std::aligned_alloc(alignment, size ? size : alignment);
+#endif
+    if (ptr) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p_ptr, std::align_val_t) noexcept {
+#if USING(PLATFORM_WINDOWS)
+    _aligned_free(p_ptr);
+#else
+    std::free(p_ptr);
+#endif
+}
+
+void operator delete(void* p_ptr, size_t, std::align_val_t p_alignment) noexcept {
+    operator delete(p_ptr, p_alignment);
+}
+
+namespace my {
+
+ScopedAllocationTracker::ScopedAllocationTracker() {
+    s_trackerCount.fetch_add(1);
+    m_begin = s_allocationCount.load();
+}
+
+ScopedAllocationTracker::~ScopedAllocationTracker() {
+    s_trackerCount.fetch_sub(1);
+}
+
+uint64_t ScopedAllocationTracker::GetAllocationCount() const {
+    return s_allocationCount.load() - m_begin;
+}
+
+}  // namespace my
@@ -0,0 +1,17 @@
+#pragma once
+
+namespace my {
+
+// counts global operator new calls from any thread while alive
+class ScopedAllocationTracker {
+public:
+    ScopedAllocationTracker();
+    ~ScopedAllocationTracker();
+
+    uint64_t GetAllocationCount() const;
+
+private:
+    uint64_t m_begin;
+};
+
+}  // namespace my
@@ -0,0 +1,60 @@
+#include <engine/algorithm/radix_sort.h>
+
+namespace my {
+
+struct SortItem {
+    uint64_t key;
+    int order;
+};
+
+static void Sort(std::vector<SortItem>& p_items) {
+    std::vector<SortItem> scratch(p_items.size());
+    RadixSort<SortItem>(p_items, scratch, [](const SortItem& p_item) { return p_item.key; });
+}
+
+TEST(radix_sort, matches_std_sort) {
+    std::vector<SortItem> items;
+    uint64_t seed = 12345;
+    for (int i = 0; i < 1000; ++i) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        items.push_back({ seed, i });
+    }
+
+    std::vector<SortItem> expected = items;
+    std::stable_sort(expected.begin(), expected.end(), [](const SortItem& p_lhs, const SortItem& p_rhs) {
+        return p_lhs.key < p_rhs.key;
+    });
+
+    Sort(items);
+    for (size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(items[i].key, expected[i].key);
+        EXPECT_EQ(items[i].order, expected[i].order);
+    }
+}
+
+TEST(radix_sort, stable) {
+    // only the top byte differs, a single pass runs and the result lands in the scratch buffer
+    std::vector<SortItem> items = {
+        { 2ull << 56, 0 },
+        { 1ull << 56, 1 },
+        { 2ull << 56, 2 },
+        { 1ull << 56, 3 },
+    };
+
+    Sort(items);
+    EXPECT_EQ(items[0].order, 1);
+    EXPECT_EQ(items[1].order, 3);
+    EXPECT_EQ(items[2].order, 0);
+    EXPECT_EQ(items[3].order, 2);
+}
+
+TEST(radix_sort, same_keys) {
+    std::vector<SortItem> items = { { 7, 0 }, { 7, 1 }, { 7, 2 } };
+
+    Sort(items);
+    EXPECT_EQ(items[0].order, 0);
+    EXPECT_EQ(items[1].order, 1);
+    EXPECT_EQ(items[2].order, 2);
+}
+
+}  // namespace my
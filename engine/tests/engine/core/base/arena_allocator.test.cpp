@@ -0,0 +1,56 @@
+#include "engine/core/base/arena_allocator.h"
+
+#include "allocation_tracker.h"
+
+namespace my {
+
+TEST(arena_allocator, vector) {
+    LinearAllocator arena(1024);
+    ArenaVector<int> vector(arena);
+    for (int i = 0; i < 100; ++i) {
+        vector.push_back(i);
+    }
+
+    EXPECT_EQ(vector.size(), 100u);
+    EXPECT_EQ(vector[99], 99);
+    EXPECT_GE(arena.GetUsedSize(), 100 * sizeof(int));
+}
+
+TEST(arena_allocator, hash_map) {
+    LinearAllocator arena(1024);
+    ArenaHashMap<uint32_t, uint32_t> map(arena);
+    for (uint32_t i = 0; i < 100; ++i) {
+        map[i] = i * 2;
+    }
+
+    EXPECT_EQ(map.size(), 100u);
+    EXPECT_EQ(map.at(50), 100u);
+    EXPECT_EQ(map.get_allocator().GetArena(), &arena);
+}
+
+TEST(arena_allocator, no_heap_after_warm_up) {
+    LinearAllocator arena(1024);
+
+    auto fill = [&arena]() {
+        ArenaVector<uint64_t> vector(arena);
+        ArenaHashMap<uint32_t, uint32_t> map(arena);
+        for (uint32_t i = 0; i < 1000; ++i) {
+            vector.push_back(i);
+            map[i] = i;
+        }
+        return vector.size() + map.size();
+    };
+
+    // the first pass allocates the blocks
+    EXPECT_EQ(fill(), 2000u);
+    arena.Reset();
+
+    ScopedAllocationTracker tracker;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(fill(), 2000u);
+        arena.Reset();
+    }
+    EXPECT_EQ(tracker.GetAllocationCount(), 0u);
+}
+
+}  // namespace my
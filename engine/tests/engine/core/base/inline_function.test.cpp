@@ -0,0 +1,44 @@
+#include "engine/core/base/inline_function.h"
+
+namespace my {
+
+TEST(inline_function, empty) {
+    InlineFunction<int(int), 16> func;
+    EXPECT_FALSE(func);
+    func = [](int p_value) { return p_value * 2; };
+    EXPECT_TRUE(func);
+    EXPECT_EQ(func(3), 6);
+    func.reset();
+    EXPECT_FALSE(func);
+}
+
+TEST(inline_function, capture) {
+    int a = 1;
+    int b = 2;
+    InlineFunction<int(), 16> func = [a, &b]() { return a + b; };
+    EXPECT_EQ(func(), 3);
+    b = 10;
+    EXPECT_EQ(func(), 11);
+}
+
+TEST(inline_function, copy_and_move) {
+    auto counter = std::make_shared<int>(0);
+    {
+        InlineFunction<void(), 32> func = [counter]() { ++(*counter); };
+        EXPECT_EQ(counter.use_count(), 2);
+
+        InlineFunction<void(), 32> copied = func;
+        EXPECT_EQ(counter.use_count(), 3);
+
+        InlineFunction<void(), 32> moved = std::move(func);
+        EXPECT_FALSE(func);
+        EXPECT_EQ(counter.use_count(), 3);
+
+        copied();
+        moved();
+        EXPECT_EQ(*counter, 2);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+}  // namespace my
@@ -0,0 +1,67 @@
+#include "engine/core/base/linear_allocator.h"
+
+namespace my {
+
+TEST(linear_allocator, alignment) {
+    LinearAllocator allocator(1024);
+
+    allocator.Allocate(1, 1);
+    void* ptr = allocator.Allocate(16, 16);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 16, 0u);
+
+    auto array = allocator.AllocateArray<double>(3);
+    EXPECT_EQ(array.size(), 3u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(array.data()) % alignof(double), 0u);
+    EXPECT_EQ(allocator.GetUsedSize(), 1u + 16u + 3u * sizeof(double));
+}
+
+TEST(linear_allocator, block_alignment) {
+    LinearAllocator allocator(256);
+
+    // new blocks, the first one and an oversized one, start on the block alignment
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(allocator.Allocate(1, 1)) % LinearAllocator::BLOCK_ALIGNMENT, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(allocator.Allocate(1000, 1)) % LinearAllocator::BLOCK_ALIGNMENT, 0u);
+
+    allocator.Allocate(3, 1);
+    void* ptr = allocator.Allocate(64, LinearAllocator::BLOCK_ALIGNMENT);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % LinearAllocator::BLOCK_ALIGNMENT, 0u);
+}
+
+TEST(linear_allocator, grow) {
+    LinearAllocator allocator(64);
+
+    char* a = static_cast<char*>(allocator.Allocate(48, 1));
+    char* b = static_cast<char*>(allocator.Allocate(48, 1));
+    // doesn't fit the first block
+    EXPECT_NE(a + 48, b);
+    memset(a, 1, 48);
+    memset(b, 2, 48);
+    EXPECT_EQ(a[47], 1);
+
+    // larger than a block
+    void* c = allocator.Allocate(1000, 1);
+    EXPECT_NE(c, nullptr);
+    EXPECT_GE(allocator.GetCapacity(), 64u + 64u + 1000u);
+}
+
+TEST(linear_allocator, reset_reuses_blocks) {
+    LinearAllocator allocator(64);
+
+    void* first = allocator.Allocate(32, 1);
+    allocator.Allocate(64, 1);
+    const size_t capacity = allocator.GetCapacity();
+
+    allocator.Reset();
+    EXPECT_EQ(allocator.GetUsedSize(), 0u);
+    EXPECT_EQ(allocator.Allocate(32, 1), first);
+    allocator.Allocate(64, 1);
+    EXPECT_EQ(allocator.GetCapacity(), capacity);
+}
+
+TEST(linear_allocator, empty_array) {
+    LinearAllocator allocator;
+    EXPECT_TRUE(allocator.AllocateArray<int>(0).empty());
+    EXPECT_EQ(allocator.GetCapacity(), 0u);
+}
+
+}  // namespace my
@@ -0,0 +1,105 @@
+#include "engine/core/base/work_stealing_deque.h"
+
+namespace my {
+
+TEST(work_stealing_deque, push_pop) {
+    WorkStealingDeque<int, 4> deque;
+    EXPECT_TRUE(deque.empty());
+    EXPECT_EQ(deque.capacity(), 4);
+
+    EXPECT_TRUE(deque.push_back(1));
+    EXPECT_TRUE(deque.push_back(2));
+    EXPECT_TRUE(deque.push_back(3));
+    EXPECT_TRUE(deque.push_back(4));
+    EXPECT_FALSE(deque.push_back(5));
+    EXPECT_FALSE(deque.empty());
+
+    // owner pops LIFO
+    int value = 0;
+    EXPECT_TRUE(deque.pop_back(value));
+    EXPECT_EQ(value, 4);
+    EXPECT_TRUE(deque.pop_back(value));
+    EXPECT_EQ(value, 3);
+
+    // thieves steal FIFO
+    EXPECT_TRUE(deque.steal(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(deque.steal(value));
+    EXPECT_EQ(value, 2);
+
+    EXPECT_TRUE(deque.empty());
+    EXPECT_FALSE(deque.pop_back(value));
+    EXPECT_FALSE(deque.steal(value));
+}
+
+TEST(work_stealing_deque, wrap_around) {
+    WorkStealingDeque<int, 4> deque;
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(deque.push_back(i));
+        EXPECT_TRUE(deque.push_back(i + 100));
+        int value = 0;
+        EXPECT_TRUE(deque.steal(value));
+        EXPECT_EQ(value, i);
+        EXPECT_TRUE(deque.pop_back(value));
+        EXPECT_EQ(value, i + 100);
+    }
+    EXPECT_TRUE(deque.empty());
+}
+
+TEST(work_stealing_deque, concurrent_steal) {
+    constexpr int TASK_COUNT = 100000;
+    constexpr int THIEF_COUNT = 3;
+
+    WorkStealingDeque<int, 256> deque;
+    std::vector<std::atomic_int> visited(TASK_COUNT);
+    std::atomic_int done_count = 0;
+    std::atomic_bool stop = false;
+
+    std::latch latch{ THIEF_COUNT };
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < THIEF_COUNT; ++i) {
+        thieves.emplace_back([&]() {
+            latch.count_down();
+            int value = 0;
+            while (!stop) {
+                if (deque.steal(value)) {
+                    visited[value].fetch_add(1);
+                    done_count.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    latch.wait();
+    for (int i = 0; i < TASK_COUNT; ++i) {
+        while (!deque.push_back(i)) {
+            int value = 0;
+            if (deque.pop_back(value)) {
+                visited[value].fetch_add(1);
+                done_count.fetch_add(1);
+            }
+        }
+    }
+
+    int value = 0;
+    while (deque.pop_back(value)) {
+        visited[value].fetch_add(1);
+        done_count.fetch_add(1);
+    }
+
+    while (done_count.load() < TASK_COUNT) {
+        std::this_thread::yield();
+    }
+
+    stop = true;
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    EXPECT_EQ(done_count.load(), TASK_COUNT);
+    for (int i = 0; i < TASK_COUNT; ++i) {
+        EXPECT_EQ(visited[i].load(), 1);
+    }
+}
+
+}  // namespace my
@@ -1,5 +1,6 @@
 #include "engine/core/io/archive.h"
 
+#include "engine/core/io/file_access_mapped.h"
 #include "engine/core/io/file_access_unix.h"
 
 namespace my {
@@ -75,4 +76,53 @@ TEST(archive, write_and_read) {
     EXPECT_TRUE(std::filesystem::remove(test_file));
 }
 
+TEST(archive, read_mapped_view) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    const char* test_file = "archive_test_read_mapped_view";
+    const std::vector<uint32_t> test_vector = { 1, 2, 3, 4 };
+
+    {
+        Archive writer;
+        ASSERT_TRUE(writer.OpenWrite(test_file));
+        writer << uint64_t(0);
+        writer << std::string("abc");
+        writer << test_vector;
+        writer << 1.5f;
+    }
+
+    auto file = FileAccessMapped::Map(test_file).value();
+    {
+        // the view skips the first field
+        Archive reader;
+        reader.OpenRead(file->CreateView(sizeof(uint64_t), file->GetLength() - sizeof(uint64_t)));
+
+        std::string actual_string;
+        EXPECT_TRUE(reader.Read(actual_string));
+        EXPECT_EQ(actual_string, "abc");
+
+        std::vector<uint32_t> actual_vector;
+        EXPECT_TRUE(reader.Read(actual_vector));
+        EXPECT_EQ(actual_vector, test_vector);
+
+        float actual_float = 0.0f;
+        EXPECT_TRUE(reader.Read(actual_float));
+        EXPECT_EQ(actual_float, 1.5f);
+
+        // nothing left
+        EXPECT_FALSE(reader.Read(actual_float));
+    }
+    {
+        // reading starts at the cursor of the file
+        EXPECT_EQ(file->Seek(sizeof(uint64_t)), 0);
+        Archive reader;
+        reader.OpenRead(file);
+        std::string actual_string;
+        EXPECT_TRUE(reader.Read(actual_string));
+        EXPECT_EQ(actual_string, "abc");
+    }
+
+    file.reset();
+    EXPECT_TRUE(std::filesystem::remove(test_file));
+}
+
 }  // namespace my
@@ -0,0 +1,113 @@
+#include "engine/core/io/file_access_buffered.h"
+
+#include "engine/core/io/file_access_mapped.h"
+#include "engine/core/io/file_access_unix.h"
+
+namespace my {
+
+static std::string ReadAll(const std::string& p_path) {
+    auto f = FileAccess::Open(p_path, FileAccess::READ).value();
+    std::string content(f->GetLength(), '\0');
+    f->ReadBuffer(content.data(), content.size());
+    return content;
+}
+
+TEST(file_access_buffered, write_flush_on_close) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    const std::string FILE_NAME = "file_access_buffered_write_flush_on_close";
+
+    {
+        FileAccessBuffered f(FileAccess::Open(FILE_NAME, FileAccess::WRITE).value(), 8);
+        ASSERT_TRUE(f.IsOpen());
+        EXPECT_EQ(f.WriteBuffer("abc", 3), 3u);
+        EXPECT_EQ(f.WriteBuffer("def", 3), 3u);
+        EXPECT_EQ(f.Tell(), 6);
+        EXPECT_EQ(f.GetLength(), 6u);
+
+        // doesn't fit, flushes what is buffered first
+        EXPECT_EQ(f.WriteBuffer("ghi", 3), 3u);
+        EXPECT_EQ(f.Tell(), 9);
+
+        // larger than the buffer, written through
+        EXPECT_EQ(f.WriteBuffer("0123456789", 10), 10u);
+        EXPECT_EQ(f.Tell(), 19);
+        EXPECT_EQ(f.WriteBuffer("!", 1), 1u);
+    }
+
+    EXPECT_EQ(ReadAll(FILE_NAME), "abcdefghi0123456789!");
+    ASSERT_TRUE(std::filesystem::remove(FILE_NAME));
+}
+
+TEST(file_access_buffered, seek_flushes) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    const std::string FILE_NAME = "file_access_buffered_seek_flushes";
+
+    {
+        FileAccessBuffered f(FileAccess::Open(FILE_NAME, FileAccess::WRITE).value());
+        EXPECT_EQ(f.WriteBuffer("abcdef", 6), 6u);
+        EXPECT_EQ(f.Seek(2), 0);
+        EXPECT_EQ(f.Tell(), 2);
+        EXPECT_EQ(f.WriteBuffer("XY", 2), 2u);
+        f.Close();
+        EXPECT_FALSE(f.IsOpen());
+    }
+
+    EXPECT_EQ(ReadAll(FILE_NAME), "abXYef");
+    ASSERT_TRUE(std::filesystem::remove(FILE_NAME));
+}
+
+TEST(file_access_buffered, read) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    const std::string FILE_NAME = "file_access_buffered_read";
+    const std::string STRING = "abcdefghijklmnopqrstuvwxyz";
+
+    {
+        auto f = FileAccess::Open(FILE_NAME, FileAccess::WRITE).value();
+        ASSERT_TRUE(f->WriteBuffer(STRING.data(), STRING.length()));
+    }
+    {
+        FileAccessBuffered f(FileAccess::Open(FILE_NAME, FileAccess::READ).value(), 4);
+        EXPECT_EQ(f.GetLength(), STRING.length());
+
+        char buffer[128]{ 0 };
+        EXPECT_EQ(f.ReadBuffer(buffer, 3), 3u);
+        EXPECT_EQ(f.Tell(), 3);
+        // spans two refills
+        EXPECT_EQ(f.ReadBuffer(buffer + 3, 3), 3u);
+        EXPECT_EQ(f.Tell(), 6);
+        // larger than the buffer, read through
+        EXPECT_EQ(f.ReadBuffer(buffer + 6, 10), 10u);
+        EXPECT_EQ(std::string(buffer), STRING.substr(0, 16));
+
+        EXPECT_EQ(f.Seek(24), 0);
+        EXPECT_EQ(f.ReadBuffer(buffer, sizeof(buffer)), 2u);
+        EXPECT_EQ(std::string(buffer, 2), "yz");
+        EXPECT_EQ(f.Tell(), 26);
+    }
+
+    ASSERT_TRUE(std::filesystem::remove(FILE_NAME));
+}
+
+TEST(file_access_buffered, open_with_pattern) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    const std::string FILE_NAME = "file_access_buffered_open_with_pattern";
+
+    {
+        auto f = FileAccess::Open(FILE_NAME, FileAccess::WRITE, FileAccess::PATTERN_STREAM).value();
+        EXPECT_NE(dynamic_cast<FileAccessBuffered*>(f.get()), nullptr);
+        ASSERT_TRUE(f->WriteBuffer("abc", 3));
+    }
+    {
+        auto f = FileAccess::Open(FILE_NAME, FileAccess::READ, FileAccess::PATTERN_WHOLE_FILE).value();
+        EXPECT_NE(dynamic_cast<FileAccessMapped*>(f.get()), nullptr);
+        EXPECT_EQ(f->GetLength(), 3u);
+    }
+    {
+        auto f = FileAccess::Open(FILE_NAME, FileAccess::READ).value();
+        EXPECT_NE(dynamic_cast<FileAccessUnix*>(f.get()), nullptr);
+    }
+
+    ASSERT_TRUE(std::filesystem::remove(FILE_NAME));
+}
+
+}  // namespace my
@@ -0,0 +1,75 @@
+#include "engine/core/io/file_access_mapped.h"
+
+#include "engine/core/io/file_access_unix.h"
+
+namespace my {
+
+TEST(file_access_mapped, map_fail) {
+    auto err = FileAccessMapped::Map("file_access_mapped_map_fail").error();
+    EXPECT_EQ(err->value, ErrorCode::ERR_FILE_NOT_FOUND);
+}
+
+TEST(file_access_mapped, read_and_seek) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    const std::string FILE_NAME = "file_access_mapped_read_and_seek";
+    const std::string STRING = "abcdefg";
+
+    {
+        auto f = FileAccess::Open(FILE_NAME, FileAccess::WRITE).value();
+        ASSERT_TRUE(f->WriteBuffer(STRING.data(), STRING.length()));
+    }
+    {
+        auto f = FileAccessMapped::Map(FILE_NAME).value();
+        ASSERT_TRUE(f->IsOpen());
+        EXPECT_EQ(f->GetLength(), STRING.length());
+        EXPECT_EQ(std::string(reinterpret_cast<const char*>(f->GetData().data()), f->GetData().size()), STRING);
+
+        char buffer[128]{ 0 };
+        EXPECT_EQ(f->ReadBuffer(buffer, 3), 3u);
+        EXPECT_EQ(std::string(buffer), "abc");
+        EXPECT_EQ(f->Tell(), 3);
+
+        // reading past the end stops at the end
+        char rest[128]{ 0 };
+        EXPECT_EQ(f->ReadBuffer(rest, sizeof(rest)), 4u);
+        EXPECT_EQ(std::string(rest), "defg");
+
+        EXPECT_EQ(f->Seek(1), 0);
+        EXPECT_EQ(f->ReadBuffer(buffer, 1), 1u);
+        EXPECT_EQ(buffer[0], 'b');
+        EXPECT_EQ(f->Seek(8), -1);
+    }
+
+    ASSERT_TRUE(std::filesystem::remove(FILE_NAME));
+}
+
+TEST(file_access_mapped, view) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    const std::string FILE_NAME = "file_access_mapped_view";
+    const std::string STRING = "header|chunk";
+
+    {
+        auto f = FileAccess::Open(FILE_NAME, FileAccess::WRITE).value();
+        ASSERT_TRUE(f->WriteBuffer(STRING.data(), STRING.length()));
+    }
+    {
+        auto file = FileAccessMapped::Map(FILE_NAME).value();
+        auto view = file->CreateView(7, 5);
+        auto empty_view = file->CreateView(file->GetLength(), 0);
+        file.reset();
+
+        // the view keeps the mapping alive and reads from its own offset
+        char buffer[128]{ 0 };
+        EXPECT_EQ(view->GetLength(), 5u);
+        EXPECT_EQ(view->ReadBuffer(buffer, sizeof(buffer)), 5u);
+        EXPECT_EQ(std::string(buffer), "chunk");
+        EXPECT_EQ(view->Tell(), 5);
+
+        EXPECT_TRUE(empty_view->IsOpen());
+        EXPECT_EQ(empty_view->ReadBuffer(buffer, sizeof(buffer)), 0u);
+    }
+
+    ASSERT_TRUE(std::filesystem::remove(FILE_NAME));
+}
+
+}  // namespace my
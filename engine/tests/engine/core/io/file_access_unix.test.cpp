@@ -63,4 +63,27 @@ TEST(file_access_unix, write_read_buffer) {
     }
 }
 
+TEST(file_access_unix, get_length_keeps_offset) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    const std::string FILE_NAME = "file_access_unix_get_length_keeps_offset";
+    const std::string STRING = "abcdefg";
+
+    {
+        auto f = FileAccess::Open(FILE_NAME, FileAccess::WRITE).value();
+        ASSERT_TRUE(f->WriteBuffer(STRING.data(), STRING.length()));
+        EXPECT_EQ(f->GetLength(), STRING.length());
+        EXPECT_EQ(f->Tell(), 7);
+    }
+    {
+        auto f = FileAccess::Open(FILE_NAME, FileAccess::READ).value();
+        char buffer[128]{ 0 };
+        ASSERT_TRUE(f->ReadBuffer(buffer, 2));
+        EXPECT_EQ(f->GetLength(), STRING.length());
+        EXPECT_EQ(f->Tell(), 2);
+        EXPECT_EQ(f->GetLength(), STRING.length());
+    }
+
+    ASSERT_TRUE(std::filesystem::remove(FILE_NAME));
+}
+
 }  // namespace my
@@ -0,0 +1,22 @@
+#include <thread>
+
+#include "engine/core/os/threads.h"
+
+namespace my::thread {
+
+TEST(threads, main_thread_id) {
+    EXPECT_EQ(GetThreadId(), THREAD_MAIN);
+    EXPECT_TRUE(IsMainThread());
+}
+
+TEST(threads, foreign_thread_id) {
+    // a thread the engine didn't start owns no job queue, it must not look like the main thread
+    uint32_t thread_id = THREAD_MAIN;
+    std::thread([&]() {
+        thread_id = GetThreadId();
+    }).join();
+
+    EXPECT_EQ(thread_id, THREAD_MAX);
+}
+
+}  // namespace my::thread
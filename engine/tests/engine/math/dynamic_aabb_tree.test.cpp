@@ -0,0 +1,176 @@
+#include <random>
+
+#include "engine/math/dynamic_aabb_tree.h"
+
+namespace my {
+
+class DynamicAABBTreeTest : public testing::Test {
+protected:
+    AABB RandomBox() {
+        std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> size(0.1f, 3.0f);
+        const Vector3f min(position(m_random), position(m_random), position(m_random));
+        return AABB(min, min + Vector3f(size(m_random), size(m_random), size(m_random)));
+    }
+
+    static bool Overlaps(const AABB& p_a, const AABB& p_b) {
+        for (int i = 0; i < 3; ++i) {
+            if (p_a.GetMin()[i] > p_b.GetMax()[i] || p_a.GetMax()[i] < p_b.GetMin()[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // every node contains its children, links and heights are consistent, the tree is balanced
+    int Validate(const DynamicAABBTree& p_tree, int p_node, int p_parent) {
+        const auto& node = p_tree.GetNode(p_node);
+        EXPECT_EQ(node.parent, p_parent);
+        if (node.IsLeaf()) {
+            EXPECT_EQ(node.height, 0);
+            return 0;
+        }
+
+        const int left = Validate(p_tree, node.left, p_node);
+        const int right = Validate(p_tree, node.right, p_node);
+        EXPECT_LE(std::abs(left - right), 1);
+        EXPECT_EQ(node.height, 1 + std::max(left, right));
+        for (int child : { node.left, node.right }) {
+            const AABB& box = p_tree.GetNode(child).aabb;
+            for (int i = 0; i < 3; ++i) {
+                EXPECT_LE(node.aabb.GetMin()[i], box.GetMin()[i]);
+                EXPECT_GE(node.aabb.GetMax()[i], box.GetMax()[i]);
+            }
+        }
+        return node.height;
+    }
+
+    void Validate(const DynamicAABBTree& p_tree) {
+        if (p_tree.GetRoot() != DynamicAABBTree::NULL_NODE) {
+            Validate(p_tree, p_tree.GetRoot(), DynamicAABBTree::NULL_NODE);
+        }
+    }
+
+    std::mt19937 m_random{ 1234 };
+};
+
+TEST_F(DynamicAABBTreeTest, insert_remove_move) {
+    DynamicAABBTree tree;
+    std::vector<AABB> boxes;
+    std::vector<int> proxies;
+    for (uint32_t i = 0; i < 500; ++i) {
+        boxes.push_back(RandomBox());
+        proxies.push_back(tree.Insert(boxes.back(), i));
+    }
+    Validate(tree);
+    EXPECT_EQ(tree.GetLeafCount(), 500u);
+    // a balanced tree of 500 leaves
+    EXPECT_LE(tree.GetHeight(), 12);
+
+    for (uint32_t i = 0; i < 500; i += 2) {
+        tree.Remove(proxies[i]);
+        proxies[i] = DynamicAABBTree::NULL_NODE;
+    }
+    for (uint32_t i = 1; i < 500; i += 2) {
+        boxes[i] = RandomBox();
+        EXPECT_TRUE(tree.Move(proxies[i], boxes[i]));
+        EXPECT_EQ(tree.GetUserData(proxies[i]), i);
+    }
+    Validate(tree);
+    EXPECT_EQ(tree.GetLeafCount(), 250u);
+
+    // a move inside the margin doesn't touch the tree
+    const AABB& fat = tree.GetFatBound(proxies[1]);
+    EXPECT_FALSE(tree.Move(proxies[1], AABB(fat.GetMin() + Vector3f(0.01f), fat.GetMax() - Vector3f(0.01f))));
+
+    for (int query = 0; query < 20; ++query) {
+        const AABB region = AABB::FromCenterSize(RandomBox().Center(), Vector3f(20.0f));
+        std::set<uint32_t> found;
+        tree.Query(region, [&](uint32_t p_index) { found.insert(p_index); });
+        for (uint32_t i = 1; i < 500; i += 2) {
+            // the tree stores enlarged boxes, so it may report more but never less
+            if (Overlaps(boxes[i], region)) {
+                EXPECT_TRUE(found.count(i));
+            }
+        }
+        for (uint32_t index : found) {
+            EXPECT_TRUE(Overlaps(tree.GetFatBound(proxies[index]), region));
+        }
+    }
+}
+
+TEST_F(DynamicAABBTreeTest, refit) {
+    DynamicAABBTree tree(0.0f);
+    std::vector<int> proxies;
+    for (uint32_t i = 0; i < 64; ++i) {
+        proxies.push_back(tree.Insert(RandomBox(), i));
+    }
+
+    for (int proxy : proxies) {
+        const AABB& box = tree.GetFatBound(proxy);
+        tree.SetLeafBound(proxy, AABB(box.GetMin() + Vector3f(100.0f), box.GetMax() + Vector3f(100.0f)));
+    }
+    tree.Refit();
+    Validate(tree);
+
+    int count = 0;
+    tree.Query(AABB(Vector3f(0.0f), Vector3f(200.0f)), [&](uint32_t) { ++count; });
+    EXPECT_EQ(count, 64);
+}
+
+TEST_F(DynamicAABBTreeTest, frustum_and_ray) {
+    DynamicAABBTree tree(0.0f);
+    tree.Insert(AABB(Vector3f(-0.5f), Vector3f(0.5f)), 0);
+    tree.Insert(AABB(Vector3f(2.0f), Vector3f(3.0f)), 1);
+    tree.Insert(AABB(Vector3f(0.8f, -0.1f, -0.1f), Vector3f(1.5f, 0.1f, 0.1f)), 2);
+
+    // the identity matrix gives the [-1, 1] cube
+    std::set<uint32_t> visible;
+    tree.Query(Frustum(Matrix4x4f(1.0f)), [&](uint32_t p_index) { visible.insert(p_index); });
+    EXPECT_EQ(visible, (std::set<uint32_t>{ 0, 2 }));
+
+    std::set<uint32_t> hits;
+    tree.RayCast(Ray(Vector3f(-5.0f, 0.0f, 0.0f), Vector3f(5.0f, 0.0f, 0.0f)), [&](uint32_t p_index) {
+        hits.insert(p_index);
+        return true;
+    });
+    EXPECT_EQ(hits, (std::set<uint32_t>{ 0, 2 }));
+
+    // starting inside a box still hits it
+    hits.clear();
+    tree.RayCast(Ray(Vector3f(2.5f), Vector3f(10.0f)), [&](uint32_t p_index) {
+        hits.insert(p_index);
+        return true;
+    });
+    EXPECT_EQ(hits, (std::set<uint32_t>{ 1 }));
+}
+
+TEST_F(DynamicAABBTreeTest, ray_packet) {
+    DynamicAABBTree tree(0.0f);
+    tree.Insert(AABB(Vector3f(-0.5f), Vector3f(0.5f)), 0);
+    tree.Insert(AABB(Vector3f(2.0f), Vector3f(3.0f)), 1);
+    tree.Insert(AABB(Vector3f(0.8f, -0.1f, -0.1f), Vector3f(1.5f, 0.1f, 0.1f)), 2);
+
+    RayPacket packet;
+    packet.Add(Ray(Vector3f(-5.0f, 0.0f, 0.0f), Vector3f(5.0f, 0.0f, 0.0f)));
+    packet.Add(Ray(Vector3f(2.5f), Vector3f(10.0f)));
+    packet.Add(Ray(Vector3f(0.0f, 5.0f, 0.0f), Vector3f(0.0f, 10.0f, 0.0f)));
+
+    std::map<uint32_t, uint32_t> hits;
+    tree.RayCast(packet, packet.GetMask(), [&](uint32_t p_index, uint32_t p_mask) {
+        hits[p_index] |= p_mask;
+        return p_mask;
+    });
+    EXPECT_EQ(hits, (std::map<uint32_t, uint32_t>{ { 0, 0b001 }, { 1, 0b010 }, { 2, 0b001 } }));
+
+    // a ray that stops tracing isn't reported again
+    uint32_t reported = 0;
+    tree.RayCast(packet, packet.GetMask(), [&](uint32_t, uint32_t p_mask) {
+        EXPECT_EQ(reported & p_mask, 0u);
+        reported |= p_mask;
+        return 0u;
+    });
+    EXPECT_EQ(reported, 0b011u);
+}
+
+}  // namespace my
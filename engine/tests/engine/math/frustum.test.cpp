@@ -1,7 +1,37 @@
+#include "engine/math/aabb.h"
 #include "engine/math/frustum.h"
 
 namespace my {
 
-// @TODO:
+TEST(frustum, intersects_batch) {
+    // the identity matrix gives the [-1, 1] cube
+    const Frustum frustum(Matrix4x4f(1.0f));
+
+    const std::vector<AABB> boxes = {
+        AABB(Vector3f(-0.5f), Vector3f(0.5f)),
+        AABB(Vector3f(0.5f), Vector3f(2.0f)),
+        AABB(Vector3f(2.0f), Vector3f(3.0f)),
+        AABB(Vector3f(-3.0f, -0.5f, -0.5f), Vector3f(-1.5f, 0.5f, 0.5f)),
+        AABB(Vector3f(-5.0f), Vector3f(5.0f)),
+    };
+
+    std::vector<float> soa[6];
+    for (const AABB& box : boxes) {
+        for (int axis = 0; axis < 3; ++axis) {
+            soa[axis].push_back(box.GetMin()[axis]);
+            soa[axis + 3].push_back(box.GetMax()[axis]);
+        }
+    }
+
+    const AABBBatch batch = { soa[0].data(), soa[1].data(), soa[2].data(), soa[3].data(), soa[4].data(), soa[5].data() };
+    std::vector<uint8_t> visible(boxes.size());
+    frustum.Intersects(batch, visible.data(), boxes.size());
+
+    const uint8_t expected[] = { 1, 1, 0, 0, 1 };
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        EXPECT_EQ(visible[i], expected[i]);
+        EXPECT_EQ(visible[i] != 0, frustum.Intersects(boxes[i]));
+    }
+}
 
 }  // namespace my
@@ -0,0 +1,72 @@
+#include "engine/math/detail/config.h"
+
+#if USING(MATH_ENABLE_SIMD_SSE)
+#include "engine/math/detail/ray_sse.h"
+
+namespace my {
+
+// 4 rays going down -z from z = 5, x at -2, 0.25, 0.5 and 3
+struct RaySseTest : public ::testing::Test {
+    void SetUp() override {
+        origin[0] = _mm_setr_ps(-2.0f, 0.25f, 0.5f, 3.0f);
+        origin[1] = _mm_setr_ps(0.25f, 0.25f, 0.5f, 0.25f);
+        origin[2] = _mm_set1_ps(5.0f);
+        direction[0] = _mm_setzero_ps();
+        direction[1] = _mm_setzero_ps();
+        direction[2] = _mm_set1_ps(-1.0f);
+        for (int axis = 0; axis < 3; ++axis) {
+            inv_direction[axis] = _mm_div_ps(_mm_set1_ps(1.0f), direction[axis]);
+        }
+    }
+
+    __m128 origin[3];
+    __m128 direction[3];
+    __m128 inv_direction[3];
+};
+
+TEST_F(RaySseTest, aabb) {
+    const float min[3] = { 0.0f, 0.0f, -1.0f };
+    const float max[3] = { 1.0f, 1.0f, 1.0f };
+
+    EXPECT_EQ(ray4_aabb_sse(origin, inv_direction, _mm_set1_ps(100.0f), min, max), 0b0110);
+    // the box starts 4 units away
+    EXPECT_EQ(ray4_aabb_sse(origin, inv_direction, _mm_setr_ps(100.0f, 3.0f, 4.0f, 100.0f), min, max), 0b0100);
+    // negative t never hits
+    EXPECT_EQ(ray4_aabb_sse(origin, inv_direction, _mm_set1_ps(-1.0f), min, max), 0);
+}
+
+TEST_F(RaySseTest, triangle) {
+    // counter clockwise seen from +z
+    const float a[3] = { 0.0f, 0.0f, 1.0f };
+    const float b[3] = { 1.0f, 0.0f, 1.0f };
+    const float c[3] = { 0.0f, 1.0f, 1.0f };
+
+    __m128 t = _mm_setr_ps(100.0f, 100.0f, 100.0f, 100.0f);
+    __m128 u = _mm_setzero_ps();
+    __m128 v = _mm_setzero_ps();
+    EXPECT_EQ(ray4_triangle_sse(origin, direction, t, u, v, a, b, c, 1e-6f), 0b0110);
+
+    alignas(16) float t_out[4], u_out[4], v_out[4];
+    _mm_store_ps(t_out, t);
+    _mm_store_ps(u_out, u);
+    _mm_store_ps(v_out, v);
+    EXPECT_FLOAT_EQ(t_out[0], 100.0f);
+    EXPECT_FLOAT_EQ(t_out[1], 4.0f);
+    EXPECT_FLOAT_EQ(u_out[1], 0.25f);
+    EXPECT_FLOAT_EQ(v_out[1], 0.25f);
+    // on the edge u + v = 1
+    EXPECT_FLOAT_EQ(t_out[2], 4.0f);
+    EXPECT_FLOAT_EQ(u_out[2], 0.5f);
+    EXPECT_FLOAT_EQ(v_out[2], 0.5f);
+
+    // closer hits only
+    EXPECT_EQ(ray4_triangle_sse(origin, direction, t, u, v, a, b, c, 1e-6f), 0);
+
+    // back face
+    t = _mm_set1_ps(100.0f);
+    EXPECT_EQ(ray4_triangle_sse(origin, direction, t, u, v, a, c, b, 1e-6f), 0);
+}
+
+}  // namespace my
+
+#endif  // #if USING(MATH_ENABLE_SIMD_SSE)
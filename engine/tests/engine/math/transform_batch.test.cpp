@@ -0,0 +1,75 @@
+#include "engine/math/matrix_transform.h"
+#include "engine/math/transform_batch.h"
+
+namespace my {
+
+TEST(transform_batch, matches_glm) {
+    // not a multiple of 4, so the tail is covered as well
+    constexpr size_t COUNT = 11;
+
+    std::vector<float> soa[10];
+    for (auto& values : soa) {
+        values.resize(COUNT);
+    }
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        const float f = static_cast<float>(i);
+        const Quaternion q = glm::normalize(Quaternion(1.0f + f, 0.1f * f, -0.3f * f, 0.5f));
+        soa[0][i] = f;
+        soa[1][i] = -2.0f * f;
+        soa[2][i] = 0.5f;
+        soa[3][i] = q.x;
+        soa[4][i] = q.y;
+        soa[5][i] = q.z;
+        soa[6][i] = q.w;
+        soa[7][i] = 1.0f + f;
+        soa[8][i] = 2.0f;
+        soa[9][i] = 0.25f * f;
+    }
+
+    const TransformBatch batch = { soa[0].data(), soa[1].data(), soa[2].data(), soa[3].data(), soa[4].data(),
+                                   soa[5].data(), soa[6].data(), soa[7].data(), soa[8].data(), soa[9].data() };
+    std::vector<Matrix4x4f> matrices(COUNT);
+    ComposeTransforms(batch, matrices.data(), COUNT);
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        const Quaternion q(soa[6][i], soa[3][i], soa[4][i], soa[5][i]);
+        const Matrix4x4f expected = glm::translate(glm::vec3(soa[0][i], soa[1][i], soa[2][i])) *
+                                    glm::toMat4(q) *
+                                    glm::scale(glm::vec3(soa[7][i], soa[8][i], soa[9][i]));
+        for (int col = 0; col < 4; ++col) {
+            for (int row = 0; row < 4; ++row) {
+                EXPECT_NEAR(matrices[i][col][row], expected[col][row], 1e-4f);
+            }
+        }
+    }
+}
+
+TEST(transform_batch, skinning_matrices) {
+    constexpr size_t COUNT = 5;
+
+    const Matrix4x4f root = glm::translate(glm::vec3(1.0f, 2.0f, 3.0f)) * glm::scale(glm::vec3(2.0f));
+    const Matrix4x4f root_inverse = glm::inverse(root);
+
+    std::vector<Matrix4x4f> worlds(COUNT);
+    std::vector<Matrix4x4f> inverse_binds(COUNT);
+    for (size_t i = 0; i < COUNT; ++i) {
+        const float f = static_cast<float>(i);
+        worlds[i] = glm::translate(glm::vec3(f, -f, 0.5f)) * glm::toMat4(glm::angleAxis(0.3f * f, glm::vec3(0.0f, 1.0f, 0.0f)));
+        inverse_binds[i] = glm::inverse(glm::translate(glm::vec3(0.0f, f, 0.0f)));
+    }
+
+    std::vector<Matrix4x4f> palette = worlds;
+    ComputeSkinningMatrices(root_inverse, inverse_binds.data(), palette.data(), COUNT);
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        const Matrix4x4f expected = root_inverse * worlds[i] * inverse_binds[i];
+        for (int col = 0; col < 4; ++col) {
+            for (int row = 0; row < 4; ++row) {
+                EXPECT_NEAR(palette[i][col][row], expected[col][row], 1e-4f);
+            }
+        }
+    }
+}
+
+}  // namespace my
@@ -0,0 +1,103 @@
+#include "engine/renderer/frame_data.h"
+
+#include "allocation_tracker.h"
+
+namespace my {
+
+static MaterialConstantBuffer MakeMaterial(float p_metallic) {
+    MaterialConstantBuffer material;
+    memset(&material, 0, sizeof(material));
+    material.c_metallic = p_metallic;
+    return material;
+}
+
+// what RenderSystem does every frame, on a ring of arenas
+static void BuildFrames(std::span<LinearAllocator> p_arenas, std::span<FrameData*> p_frames, int p_frame_count, uint32_t p_object_count) {
+    for (int frame = 0; frame < p_frame_count; ++frame) {
+        const size_t index = frame % p_arenas.size();
+        if (p_frames[index]) {
+            p_frames[index]->~FrameData();
+        }
+        LinearAllocator& arena = p_arenas[index];
+        arena.Reset();
+
+        FrameData* frame_data = new (arena.Allocate(sizeof(FrameData), alignof(FrameData))) FrameData(RenderOptions(), arena);
+        p_frames[index] = frame_data;
+
+        frame_data->passCache.emplace_back();
+        for (uint32_t i = 0; i < p_object_count; ++i) {
+            DrawCommand draw;
+            draw.batch_idx = static_cast<int>(i);
+            draw.mat_idx = frame_data->materialCache.FindOrAdd(MakeMaterial(static_cast<float>(i % 8)));
+            frame_data->gbuffer_commands.emplace_back(RenderCommand::From(draw));
+            frame_data->shadow_pass_commands.emplace_back(RenderCommand::From(draw));
+            frame_data->drawDebugContext.positions.emplace_back(Vector3f::Zero);
+        }
+    }
+}
+
+TEST(frame_data, no_heap_after_warm_up) {
+    constexpr uint32_t object_count = 1000;
+    std::array<LinearAllocator, 2> arenas;
+    std::array<FrameData*, 2> frames{};
+
+    BuildFrames(arenas, frames, 2, object_count);
+    EXPECT_EQ(frames[1]->gbuffer_commands.size(), object_count);
+    EXPECT_EQ(frames[1]->materialCache.buffer.size(), 8u);
+
+    {
+        ScopedAllocationTracker tracker;
+        BuildFrames(arenas, frames, 8, object_count);
+        EXPECT_EQ(tracker.GetAllocationCount(), 0u);
+    }
+
+    for (FrameData* frame_data : frames) {
+        frame_data->~FrameData();
+    }
+}
+
+static bool IsAligned(const void* p_ptr, size_t p_alignment) {
+    return reinterpret_cast<uintptr_t>(p_ptr) % p_alignment == 0;
+}
+
+TEST(frame_data, caches_are_aligned) {
+    LinearAllocator arena(1024);
+    // leave the arena at an odd offset
+    arena.Allocate(1, 1);
+    FrameData* frame_data = new (arena.Allocate(sizeof(FrameData), alignof(FrameData))) FrameData(RenderOptions(), arena);
+
+    for (int i = 0; i < 3; ++i) {
+        frame_data->passCache.emplace_back();
+        frame_data->instanceCache.emplace_back();
+        frame_data->materialCache.FindOrAdd(MakeMaterial(static_cast<float>(i)));
+
+        EXPECT_TRUE(IsAligned(frame_data->passCache.data(), alignof(Matrix4x4f)));
+        EXPECT_TRUE(IsAligned(frame_data->instanceCache.data(), alignof(Matrix4x4f)));
+        EXPECT_TRUE(IsAligned(frame_data->materialCache.buffer.data(), alignof(Matrix4x4f)));
+        EXPECT_TRUE(IsAligned(frame_data->passCache.data(), alignof(PerPassConstantBuffer)));
+        EXPECT_TRUE(IsAligned(frame_data->instanceCache.data(), alignof(BoneConstantBuffer)));
+        EXPECT_TRUE(IsAligned(frame_data->materialCache.buffer.data(), alignof(MaterialConstantBuffer)));
+    }
+
+    // a 16 byte SIMD type allocated right after an odd sized one
+    arena.Allocate(3, 1);
+    EXPECT_TRUE(IsAligned(arena.Allocate(sizeof(Matrix4x4f), 16), 16));
+
+    frame_data->~FrameData();
+}
+
+TEST(frame_data, material_dedup_by_content) {
+    LinearAllocator arena;
+    BufferCache<MaterialConstantBuffer> cache(arena);
+
+    EXPECT_EQ(cache.FindOrAdd(MakeMaterial(0.0f)), 0u);
+    EXPECT_EQ(cache.FindOrAdd(MakeMaterial(1.0f)), 1u);
+    EXPECT_EQ(cache.FindOrAdd(MakeMaterial(0.0f)), 0u);
+    EXPECT_EQ(cache.FindOrAdd(MakeMaterial(1.0f)), 1u);
+    EXPECT_EQ(cache.buffer.size(), 2u);
+
+    cache.Clear();
+    EXPECT_EQ(cache.FindOrAdd(MakeMaterial(1.0f)), 0u);
+}
+
+}  // namespace my
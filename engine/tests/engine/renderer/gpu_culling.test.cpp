@@ -0,0 +1,163 @@
+#include "engine/renderer/gpu_culling.h"
+
+#include "engine/math/frustum.h"
+#include "engine/math/matrix_transform.h"
+
+namespace my {
+
+static const float FOVY = glm::radians(60.0f);
+static constexpr float NEAR_PLANE = 0.1f;
+static constexpr float FAR_PLANE = 100.0f;
+
+// camera at the origin looking down -z
+static Frustum CameraFrustum() {
+    return Frustum(BuildOpenGlPerspectiveRH(FOVY, 1.0f, NEAR_PLANE, FAR_PLANE));
+}
+
+// reversed depth in [0, 1], like the rendering matrix of the d3d backends
+static Matrix4x4f CameraRenderingMatrix() {
+    constexpr Matrix4x4f reverse_z{ 1.0f, 0.0f, 0.0f, 0.0f,
+                                    0.0f, 1.0f, 0.0f, 0.0f,
+                                    0.0f, 0.0f, -1.0f, 0.0f,
+                                    0.0f, 0.0f, 1.0f, 1.0f };
+    return reverse_z * BuildPerspectiveRH(FOVY, 1.0f, NEAR_PLANE, FAR_PLANE);
+}
+
+static GpuCullInstance MakeInstance(const Vector3f& p_center, float p_half_size, uint32_t p_draw_id) {
+    GpuCullInstance instance;
+    instance.min = p_center - Vector3f(p_half_size);
+    instance.max = p_center + Vector3f(p_half_size);
+    instance.indexCount = 36 + p_draw_id;
+    instance.firstIndex = 3 * p_draw_id;
+    instance.baseVertex = static_cast<int>(10 * p_draw_id);
+    instance.drawId = p_draw_id;
+    instance._padding = Vector2i(0);
+    return instance;
+}
+
+static std::vector<GpuDrawIndirectArgs> Cull(const GpuCullConstants& p_constants,
+                                             const CullingImage& p_hiz,
+                                             const std::vector<GpuCullInstance>& p_instances) {
+    std::vector<GpuDrawIndirectArgs> args(p_instances.size());
+    args.resize(CullInstances(p_constants, p_hiz, p_instances, args));
+    return args;
+}
+
+// a wall at p_distance covering the whole screen
+static CullingImage MakeOccluderHiZ(const Vector2i& p_size, float p_distance) {
+    const Vector4f clip = CameraRenderingMatrix() * Vector4f(0.0f, 0.0f, -p_distance, 1.0f);
+
+    CullingImage hiz;
+    hiz.width = p_size.x;
+    hiz.height = p_size.y;
+    hiz.texels.assign(p_size.x * p_size.y, clip.z / clip.w);
+    return hiz;
+}
+
+TEST(gpu_culling, frustum_culling) {
+    const std::vector<GpuCullInstance> instances = {
+        MakeInstance(Vector3f(0.0f, 0.0f, -10.0f), 1.0f, 0),
+        // behind the camera
+        MakeInstance(Vector3f(0.0f, 0.0f, 10.0f), 1.0f, 1),
+        // far to the right
+        MakeInstance(Vector3f(100.0f, 0.0f, -10.0f), 1.0f, 2),
+        // beyond the far plane
+        MakeInstance(Vector3f(0.0f, 0.0f, -200.0f), 1.0f, 3),
+        // crosses the left plane
+        MakeInstance(Vector3f(-6.0f, 0.0f, -10.0f), 1.0f, 4),
+    };
+
+    const GpuCullConstants constants = MakeCullConstants(CameraFrustum(), nullptr, Vector2i(0), 5);
+    EXPECT_EQ(constants.hizEnabled, 0);
+
+    const auto args = Cull(constants, CullingImage{}, instances);
+    ASSERT_EQ(args.size(), 2u);
+    EXPECT_EQ(args[0].firstInstance, 0u);
+    EXPECT_EQ(args[1].firstInstance, 4u);
+}
+
+TEST(gpu_culling, compaction_keeps_order_and_args) {
+    std::vector<GpuCullInstance> instances;
+    for (uint32_t i = 0; i < 8; ++i) {
+        // every other instance is behind the camera
+        const float z = (i % 2) ? 10.0f : -10.0f;
+        instances.push_back(MakeInstance(Vector3f(0.0f, 0.0f, z), 1.0f, i));
+    }
+
+    const GpuCullConstants constants = MakeCullConstants(CameraFrustum(), nullptr, Vector2i(0), 8);
+    const auto args = Cull(constants, CullingImage{}, instances);
+    ASSERT_EQ(args.size(), 4u);
+    for (uint32_t i = 0; i < 4; ++i) {
+        const GpuCullInstance& instance = instances[2 * i];
+        EXPECT_EQ(args[i].indexCount, instance.indexCount);
+        EXPECT_EQ(args[i].instanceCount, 1u);
+        EXPECT_EQ(args[i].firstIndex, instance.firstIndex);
+        EXPECT_EQ(args[i].baseVertex, instance.baseVertex);
+        EXPECT_EQ(args[i].firstInstance, instance.drawId);
+    }
+}
+
+TEST(gpu_culling, build_hiz_keeps_farthest_depth) {
+    CullingImage depth;
+    depth.width = HIZ_TILE_SIZE + 4;
+    depth.height = HIZ_TILE_SIZE + 2;
+    depth.texels.assign(depth.width * depth.height, 0.5f);
+    // reversed depth, the smaller the farther
+    depth.texels[3 * depth.width + 5] = 0.25f;
+    depth.texels[(depth.height - 1) * depth.width + depth.width - 1] = 0.125f;
+    depth.texels[HIZ_TILE_SIZE + 1] = 0.75f;
+
+    const CullingImage hiz = BuildHiZ(depth);
+    ASSERT_EQ(hiz.width, 2);
+    ASSERT_EQ(hiz.height, 2);
+    EXPECT_EQ(hiz.Load(Vector3i(0, 0, 0)), 0.25f);
+    EXPECT_EQ(hiz.Load(Vector3i(1, 0, 0)), 0.5f);
+    EXPECT_EQ(hiz.Load(Vector3i(0, 1, 0)), 0.5f);
+    EXPECT_EQ(hiz.Load(Vector3i(1, 1, 0)), 0.125f);
+}
+
+TEST(gpu_culling, occlusion_culling) {
+    const Vector2i hiz_size = GetHiZSize(1024, 1024);
+    const CullingImage hiz = MakeOccluderHiZ(hiz_size, 5.0f);
+    const Matrix4x4f hiz_matrix = BuildHiZMatrix(CameraRenderingMatrix(), false);
+
+    const std::vector<GpuCullInstance> instances = {
+        // behind the wall
+        MakeInstance(Vector3f(0.0f, 0.0f, -20.0f), 0.25f, 0),
+        MakeInstance(Vector3f(2.0f, -1.0f, -30.0f), 0.25f, 1),
+        // in front of the wall
+        MakeInstance(Vector3f(0.0f, 0.0f, -4.0f), 0.1f, 2),
+        // behind the wall, but covers too many texels to test
+        MakeInstance(Vector3f(0.0f, 0.0f, -20.0f), 5.0f, 3),
+        // behind the wall, partly off screen
+        MakeInstance(Vector3f(11.5f, 0.0f, -20.0f), 0.25f, 4),
+    };
+
+    GpuCullConstants constants = MakeCullConstants(CameraFrustum(), &hiz_matrix, hiz_size, 5);
+    EXPECT_EQ(constants.hizEnabled, 1);
+
+    const auto args = Cull(constants, hiz, instances);
+    ASSERT_EQ(args.size(), 3u);
+    EXPECT_EQ(args[0].firstInstance, 2u);
+    EXPECT_EQ(args[1].firstInstance, 3u);
+    EXPECT_EQ(args[2].firstInstance, 4u);
+
+    // without a hi-z only the frustum is tested
+    constants.hizEnabled = 0;
+    EXPECT_EQ(Cull(constants, hiz, instances).size(), 5u);
+}
+
+TEST(gpu_culling, hiz_matrix_rows) {
+    // a point on the top edge of the screen
+    const Vector4f point(0.0f, 10.0f * glm::tan(0.5f * FOVY), -10.0f, 1.0f);
+
+    const Vector4f d3d = BuildHiZMatrix(CameraRenderingMatrix(), false) * point;
+    EXPECT_NEAR(d3d.x / d3d.w, 0.5f, 1e-5f);
+    EXPECT_NEAR(d3d.y / d3d.w, 0.0f, 1e-5f);
+
+    const Vector4f opengl = BuildHiZMatrix(CameraRenderingMatrix(), true) * point;
+    EXPECT_NEAR(opengl.x / opengl.w, 0.5f, 1e-5f);
+    EXPECT_NEAR(opengl.y / opengl.w, 1.0f, 1e-5f);
+}
+
+}  // namespace my
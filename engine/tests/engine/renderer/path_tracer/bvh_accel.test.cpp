@@ -0,0 +1,173 @@
+#include <random>
+
+#include "engine/renderer/path_tracer/bvh_accel.h"
+
+namespace my {
+
+class BvhAccelTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // random triangles facing +z, so rays going down -z see their front faces
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> offset(0.2f, 1.0f);
+        for (uint32_t i = 0; i < TRIANGLE_COUNT; ++i) {
+            const Vector3f a(position(rng), position(rng), position(rng));
+            vertices.push_back(a);
+            vertices.push_back(a + Vector3f(offset(rng), 0.0f, 0.0f));
+            vertices.push_back(a + Vector3f(0.0f, offset(rng), 0.0f));
+            indices.insert(indices.end(), { 3 * i, 3 * i + 1, 3 * i + 2 });
+        }
+        bvh = BvhAccel::Construct(indices, vertices);
+
+        std::uniform_real_distribution<float> xy(-8.0f, 8.0f);
+        for (uint32_t i = 0; i < RAY_COUNT; ++i) {
+            const float x = xy(rng);
+            const float y = xy(rng);
+            rays.emplace_back(Vector3f(x, y, 20.0f), Vector3f(x + 0.1f, y - 0.1f, -20.0f));
+        }
+    }
+
+    // nearest hit by testing every triangle
+    int BruteForce(Ray& p_ray) const {
+        int result = -1;
+        for (uint32_t i = 0; i < TRIANGLE_COUNT; ++i) {
+            if (p_ray.Intersects(vertices[3 * i], vertices[3 * i + 1], vertices[3 * i + 2])) {
+                result = static_cast<int>(i);
+            }
+        }
+        return result;
+    }
+
+    static constexpr uint32_t TRIANGLE_COUNT = 500;
+    static constexpr uint32_t RAY_COUNT = 64;
+
+    std::vector<Vector3f> vertices;
+    std::vector<uint32_t> indices;
+    BvhAccel::Ref bvh;
+    std::vector<Ray> rays;
+};
+
+// walks the tree the way the path tracer shader does, checking the layout on the way
+static void CheckStructure(const BvhAccel& p_bvh, uint32_t p_triangle_count) {
+    ASSERT_EQ(p_bvh.nodes.size(), 2 * p_triangle_count - 1);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p_bvh.nodes.data()) % 32, 0u);
+
+    std::vector<int> leaf_count(p_triangle_count, 0);
+    int max_depth = 0;
+    std::vector<int> depths(p_bvh.nodes.size(), 0);
+    for (int i = 0; i < static_cast<int>(p_bvh.nodes.size()); ++i) {
+        const BvhAccel::Node& node = p_bvh.nodes[i];
+        max_depth = std::max(max_depth, depths[i]);
+        if (node.IsLeaf()) {
+            ASSERT_GE(node.triangleIndex, 0);
+            ASSERT_LT(node.triangleIndex, static_cast<int>(p_triangle_count));
+            ++leaf_count[node.triangleIndex];
+            continue;
+        }
+
+        for (int child : { p_bvh.GetLeftChild(i), p_bvh.GetRightChild(i) }) {
+            ASSERT_GT(child, i);
+            const BvhAccel::Node& child_node = p_bvh.nodes[child];
+            depths[child] = depths[i] + 1;
+            for (int axis = 0; axis < 3; ++axis) {
+                EXPECT_LE(node.min[axis], child_node.min[axis]);
+                EXPECT_GE(node.max[axis], child_node.max[axis]);
+            }
+        }
+        // both subtrees end where the parent's does
+        EXPECT_EQ(p_bvh.nodes[p_bvh.GetRightChild(i)].missIndex, node.missIndex);
+    }
+
+    for (int count : leaf_count) {
+        EXPECT_EQ(count, 1);
+    }
+    EXPECT_LT(max_depth, 128);
+}
+
+TEST_F(BvhAccelTest, structure) {
+    CheckStructure(*bvh, TRIANGLE_COUNT);
+    EXPECT_EQ(bvh->nodes[0].missIndex, -1);
+
+    std::vector<GpuPtBvh> gpu_bvhs(1);
+    bvh->FillGpuBvhAccel(gpu_bvhs);
+    ASSERT_EQ(gpu_bvhs.size(), bvh->nodes.size() + 1);
+    EXPECT_EQ(memcmp(gpu_bvhs.data() + 1, bvh->nodes.data(), sizeof(GpuPtBvh) * bvh->nodes.size()), 0);
+}
+
+TEST_F(BvhAccelTest, same_centroids) {
+    // no plane separates these, the builder has to fall back to median splits
+    std::vector<Vector3f> same_vertices = { Vector3f(0.0f), Vector3f(1.0f, 0.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f) };
+    std::vector<uint32_t> same_indices;
+    for (uint32_t i = 0; i < TRIANGLE_COUNT; ++i) {
+        same_indices.insert(same_indices.end(), { 0, 1, 2 });
+    }
+    auto same = BvhAccel::Construct(same_indices, same_vertices);
+    CheckStructure(*same, TRIANGLE_COUNT);
+}
+
+TEST_F(BvhAccelTest, nearest_hit) {
+    int hit_count = 0;
+    for (const Ray& ray : rays) {
+        Ray expected_ray = ray;
+        const int expected = BruteForce(expected_ray);
+
+        RayPacket packet;
+        packet.Add(ray);
+        int triangle = -1;
+        const uint32_t hit = bvh->Intersects(packet, packet.GetMask(), indices, vertices, false, &triangle);
+
+        EXPECT_EQ(hit != 0, expected != -1);
+        if (expected != -1) {
+            EXPECT_EQ(triangle, expected);
+            EXPECT_FLOAT_EQ(packet.dists[0], expected_ray.GetDist());
+            ++hit_count;
+        }
+    }
+    // make sure the test covers both cases
+    EXPECT_GT(hit_count, 0);
+    EXPECT_LT(hit_count, static_cast<int>(RAY_COUNT));
+}
+
+TEST_F(BvhAccelTest, any_hit) {
+    for (const Ray& ray : rays) {
+        Ray expected_ray = ray;
+        const int expected = BruteForce(expected_ray);
+
+        RayPacket packet;
+        packet.Add(ray);
+        int triangle = -1;
+        const uint32_t hit = bvh->Intersects(packet, packet.GetMask(), indices, vertices, true, &triangle);
+
+        EXPECT_EQ(hit != 0, expected != -1);
+        if (hit) {
+            // not necessarily the nearest, but a triangle the ray does hit
+            Ray check = ray;
+            EXPECT_TRUE(check.Intersects(vertices[3 * triangle], vertices[3 * triangle + 1], vertices[3 * triangle + 2]));
+            EXPECT_GE(packet.dists[0], expected_ray.GetDist());
+        }
+    }
+}
+
+TEST_F(BvhAccelTest, packet_matches_single_rays) {
+    for (size_t begin = 0; begin < rays.size(); begin += RayPacket::MAX_SIZE) {
+        RayPacket packet;
+        for (size_t i = begin; i < begin + RayPacket::MAX_SIZE; ++i) {
+            packet.Add(rays[i]);
+        }
+        int triangles[RayPacket::MAX_SIZE];
+        const uint32_t hit = bvh->Intersects(packet, packet.GetMask(), indices, vertices, false, triangles);
+
+        for (uint32_t i = 0; i < RayPacket::MAX_SIZE; ++i) {
+            Ray expected_ray = rays[begin + i];
+            const int expected = BruteForce(expected_ray);
+            EXPECT_EQ((hit >> i) & 1, expected != -1 ? 1u : 0u);
+            if (expected != -1) {
+                EXPECT_EQ(triangles[i], expected);
+                EXPECT_FLOAT_EQ(packet.dists[i], expected_ray.GetDist());
+            }
+        }
+    }
+}
+
+}  // namespace my
@@ -0,0 +1,160 @@
+#include <fstream>
+
+#include "engine/renderer/path_tracer/cpu_path_tracer.h"
+
+#include "engine/core/io/file_access_unix.h"
+#include "engine/math/matrix_transform.h"
+#include "engine/scene/scene.h"
+#include "engine/systems/ecs_systems.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my {
+
+// the sky color of RayColor() in shared_path_tracer.h
+static const Vector3f SKY_COLOR(0.3f);
+// the emissive color of the cube, the shader scales the base color by the emissive strength
+static const Vector3f CUBE_COLOR(1.0f, 0.5f, 0.25f);
+// 0.3 as shared exponent bytes
+static constexpr uint8_t SKY_RGBE[4] = { 153, 153, 153, 127 };
+
+// an emissive cube in front of a camera looking down -z, so every path is known without sampling:
+// a ray that misses sees the sky, a ray that hits the cube picks up its emission, then bounces away
+// from the convex cube and sees the sky through the base color
+class CpuPathTracerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ecs::Entity::SetSeed();
+        const ecs::Entity material_id = scene.CreateMaterialEntity("material");
+        MaterialComponent& material = *scene.GetComponent<MaterialComponent>(material_id);
+        material.baseColor = Vector4f(CUBE_COLOR, 1.0f);
+        material.emissive = 1.0f;
+        material.metallic = 0.0f;
+        material.roughness = 1.0f;
+        scene.CreateCubeEntity("cube", material_id, Vector3f(1.0f), glm::translate(glm::vec3(0.0f, 0.0f, -5.0f)));
+
+        jobsystem::Context ctx;
+        RunTransformationUpdateSystem(scene, ctx, 0.0f);
+        ctx.Wait();
+        RunHierarchyUpdateSystem(scene, ctx, 0.0f);
+        ctx.Wait();
+    }
+
+    void Render(int p_width, int p_height, uint32_t p_sample_count) {
+        CameraComponent camera;
+        camera.SetDimension(p_width, p_height);
+        camera.Update();
+
+        tracer.SetScene(scene);
+        tracer.SetCamera(camera);
+        for (uint32_t i = 0; i < p_sample_count; ++i) {
+            tracer.RenderSample();
+        }
+    }
+
+    const Vector4f& Pixel(int p_x, int p_y) const { return tracer.GetImage()[p_y * tracer.GetWidth() + p_x]; }
+
+    static std::vector<uint8_t> ReadFile(const char* p_path) {
+        std::ifstream file(p_path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    Scene scene;
+    CpuPathTracer tracer;
+};
+
+TEST_F(CpuPathTracerTest, render_tiles) {
+    // more than one tile each way, the last ones partial
+    constexpr int width = CpuPathTracer::TILE_SIZE + 8;
+    constexpr int height = CpuPathTracer::TILE_SIZE + 6;
+    Render(width, height, 3);
+
+    ASSERT_EQ(tracer.GetSampleCount(), 3u);
+    ASSERT_EQ(tracer.GetImage().size(), static_cast<size_t>(width * height));
+    for (const Vector4f& pixel : tracer.GetImage()) {
+        EXPECT_EQ(pixel.w, 3.0f);
+    }
+
+    const Vector3f hit_color = CUBE_COLOR + SKY_COLOR * CUBE_COLOR;
+    const Vector4f& center = Pixel(width / 2, height / 2);
+    EXPECT_NEAR(center.x, hit_color.x, 1e-4f);
+    EXPECT_NEAR(center.y, hit_color.y, 1e-4f);
+    EXPECT_NEAR(center.z, hit_color.z, 1e-4f);
+
+    for (const Vector4f* corner : { &Pixel(0, 0), &Pixel(width - 1, 0), &Pixel(0, height - 1), &Pixel(width - 1, height - 1) }) {
+        EXPECT_NEAR(corner->x, SKY_COLOR.x, 1e-5f);
+        EXPECT_NEAR(corner->y, SKY_COLOR.y, 1e-5f);
+        EXPECT_NEAR(corner->z, SKY_COLOR.z, 1e-5f);
+    }
+}
+
+TEST_F(CpuPathTracerTest, write_hdr_run_length_encoded) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    constexpr const char* test_file = "cpu_path_tracer_test_rle.hdr";
+    constexpr int width = 200;
+    constexpr int height = 3;
+    Render(width, height, 1);
+    ASSERT_TRUE(tracer.WriteHdr(test_file));
+
+    const std::vector<uint8_t> bytes = ReadFile(test_file);
+    const std::string header = "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y 3 +X 200\n";
+    ASSERT_GE(bytes.size(), header.size());
+    EXPECT_EQ(std::string(bytes.begin(), bytes.begin() + header.size()), header);
+
+    // every scanline is 2, 2, the width, then the channels one after the other in runs of at most 128
+    size_t offset = header.size();
+    for (int y = 0; y < height; ++y) {
+        ASSERT_LE(offset + 4, bytes.size());
+        EXPECT_EQ(bytes[offset], 2);
+        EXPECT_EQ(bytes[offset + 1], 2);
+        EXPECT_EQ((bytes[offset + 2] << 8) | bytes[offset + 3], width);
+        offset += 4;
+
+        std::vector<uint8_t> rgbe(4 * width);
+        for (int channel = 0; channel < 4; ++channel) {
+            for (int x = 0; x < width;) {
+                ASSERT_LT(offset, bytes.size());
+                const int count = bytes[offset++];
+                // literal runs only
+                ASSERT_TRUE(count > 0 && count <= 128 && x + count <= width);
+                for (int i = 0; i < count; ++i) {
+                    rgbe[4 * (x + i) + channel] = bytes[offset++];
+                }
+                x += count;
+            }
+        }
+
+        // the first and the last pixels of every scanline see the sky
+        for (int x : { 0, width - 1 }) {
+            for (int i = 0; i < 4; ++i) {
+                EXPECT_EQ(rgbe[4 * x + i], SKY_RGBE[i]);
+            }
+        }
+    }
+    EXPECT_EQ(offset, bytes.size());
+
+    EXPECT_TRUE(std::filesystem::remove(test_file));
+}
+
+TEST_F(CpuPathTracerTest, write_hdr_flat_for_narrow_images) {
+    FileAccess::MakeDefault<FileAccessUnix>(FileAccess::ACCESS_FILESYSTEM);
+    constexpr const char* test_file = "cpu_path_tracer_test_flat.hdr";
+    constexpr int width = 4;
+    constexpr int height = 4;
+    Render(width, height, 1);
+    ASSERT_TRUE(tracer.WriteHdr(test_file));
+
+    // too narrow to run length encode, the scanlines are plain rgbe pixels
+    const std::vector<uint8_t> bytes = ReadFile(test_file);
+    const std::string header = "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y 4 +X 4\n";
+    ASSERT_EQ(bytes.size(), header.size() + 4 * width * height);
+    EXPECT_EQ(std::string(bytes.begin(), bytes.begin() + header.size()), header);
+
+    // the top left pixel sees the sky
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(bytes[header.size() + i], SKY_RGBE[i]);
+    }
+
+    EXPECT_TRUE(std::filesystem::remove(test_file));
+}
+
+}  // namespace my
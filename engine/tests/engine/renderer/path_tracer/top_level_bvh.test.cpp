@@ -0,0 +1,81 @@
+#include "engine/renderer/path_tracer/top_level_bvh.h"
+
+namespace my {
+
+static std::vector<AABB> CreateInstanceBounds(int p_count) {
+    std::vector<AABB> bounds;
+    for (int i = 0; i < p_count; ++i) {
+        const Vector3f center(3.0f * (i % 4), 0.0f, 3.0f * (i / 4));
+        bounds.emplace_back(center - Vector3f(1.0f), center + Vector3f(1.0f));
+    }
+    return bounds;
+}
+
+static bool Contains(const GpuPtBvh& p_outer, const Vector3f& p_min, const Vector3f& p_max) {
+    for (int axis = 0; axis < 3; ++axis) {
+        if (p_outer.min[axis] > p_min[axis] || p_outer.max[axis] < p_max[axis]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// every instance is in exactly one leaf and every box holds its children
+static void CheckTree(const std::vector<AABB>& p_bounds, const std::vector<GpuPtBvh>& p_nodes) {
+    std::vector<int> leaf_count(p_bounds.size());
+    for (int i = 0; i < static_cast<int>(p_nodes.size()); ++i) {
+        const GpuPtBvh& node = p_nodes[i];
+        if (node.triangleIndex != -1) {
+            ++leaf_count[node.triangleIndex];
+            EXPECT_TRUE(Contains(node, p_bounds[node.triangleIndex].GetMin(), p_bounds[node.triangleIndex].GetMax()));
+            continue;
+        }
+
+        const GpuPtBvh& left = p_nodes[i + 1];
+        ASSERT_GT(left.missIdx, i + 1);
+        const GpuPtBvh& right = p_nodes[left.missIdx];
+        EXPECT_TRUE(Contains(node, left.min, left.max));
+        EXPECT_TRUE(Contains(node, right.min, right.max));
+        EXPECT_EQ(node.missIdx, right.missIdx);
+    }
+
+    for (int count : leaf_count) {
+        EXPECT_EQ(count, 1);
+    }
+}
+
+TEST(top_level_bvh, build) {
+    EXPECT_EQ(TopLevelBvh::GetNodeCount(0), 0);
+    EXPECT_EQ(TopLevelBvh::GetNodeCount(1), 1);
+
+    for (int count : { 1, 2, 5, 16 }) {
+        const std::vector<AABB> bounds = CreateInstanceBounds(count);
+        std::vector<GpuPtBvh> nodes(TopLevelBvh::GetNodeCount(count));
+        TopLevelBvh::Build(bounds, nodes.data());
+
+        EXPECT_EQ(nodes[0].missIdx, -1);
+        CheckTree(bounds, nodes);
+    }
+}
+
+TEST(top_level_bvh, refit) {
+    std::vector<AABB> bounds = CreateInstanceBounds(9);
+    std::vector<GpuPtBvh> nodes(TopLevelBvh::GetNodeCount(9));
+    TopLevelBvh::Build(bounds, nodes.data());
+
+    EXPECT_EQ(TopLevelBvh::Refit(bounds, nodes.data()), 0);
+
+    bounds[4] = AABB(Vector3f(20.0f), Vector3f(22.0f));
+    const int dirty_end = TopLevelBvh::Refit(bounds, nodes.data());
+    EXPECT_GT(dirty_end, 0);
+    EXPECT_LE(dirty_end, static_cast<int>(nodes.size()));
+    EXPECT_EQ(nodes[0].max, Vector3f(22.0f));
+    CheckTree(bounds, nodes);
+
+    // the leaf of the moved instance is within the range to upload
+    for (int i = dirty_end; i < static_cast<int>(nodes.size()); ++i) {
+        EXPECT_NE(nodes[i].triangleIndex, 4);
+    }
+}
+
+}  // namespace my
@@ -0,0 +1,43 @@
+#include "engine/renderer/render_command.h"
+
+namespace my {
+
+TEST(render_command, quantize_depth_order) {
+    EXPECT_EQ(QuantizeSortDepth(-1.0f), 0u);
+    EXPECT_EQ(QuantizeSortDepth(0.0f), 0u);
+    EXPECT_LT(QuantizeSortDepth(0.5f), QuantizeSortDepth(1.0f));
+    EXPECT_LT(QuantizeSortDepth(1.0f), QuantizeSortDepth(100.0f));
+    EXPECT_LT(QuantizeSortDepth(100.0f), QuantizeSortDepth(10000.0f));
+    EXPECT_LE(QuantizeSortDepth(std::numeric_limits<float>::max()), 0xFFFFFu);
+}
+
+TEST(render_command, opaque_state_then_front_to_back) {
+    const uint64_t near_a = MakeOpaqueSortKey(0, 0, 1, 1, 1.0f);
+    const uint64_t far_a = MakeOpaqueSortKey(0, 0, 1, 1, 50.0f);
+    const uint64_t near_b = MakeOpaqueSortKey(0, 0, 2, 1, 1.0f);
+
+    EXPECT_LT(near_a, far_a);
+    // the material outranks depth, draws sharing state stay together
+    EXPECT_LT(far_a, near_b);
+    // the pass outranks everything
+    EXPECT_LT(MakeOpaqueSortKey(0, 0xFF, 0xFFFF, 0xFFFF, 1000.0f), MakeOpaqueSortKey(1, 0, 0, 0, 0.0f));
+}
+
+TEST(render_command, transparent_back_to_front) {
+    const uint64_t near_a = MakeTransparentSortKey(0, 0, 1, 1, 1.0f);
+    const uint64_t far_b = MakeTransparentSortKey(0, 0, 2, 1, 50.0f);
+
+    EXPECT_LT(far_b, near_a);
+    EXPECT_LT(MakeTransparentSortKey(0, 0, 1, 1, 5.0f), MakeTransparentSortKey(0, 0, 2, 1, 5.0f));
+}
+
+TEST(render_command, pipeline_field) {
+    EXPECT_EQ(GetSortKeyPipeline(MakeOpaqueSortKey(3, 0, 0xFFFF, 0xFFFF, 1000.0f)), 0u);
+    EXPECT_EQ(GetSortKeyPipeline(MakeOpaqueSortKey(3, 7, 0xFFFF, 0xFFFF, 1000.0f)), 7u);
+    EXPECT_EQ(GetSortKeyPipeline(MakeTransparentSortKey(15, 0xFF, 1, 1, 5.0f)), 0xFFu);
+
+    // draws of a pass are grouped by pipeline before material
+    EXPECT_LT(MakeOpaqueSortKey(0, 1, 0xFFFF, 0xFFFF, 1000.0f), MakeOpaqueSortKey(0, 2, 0, 0, 0.0f));
+}
+
+}  // namespace my
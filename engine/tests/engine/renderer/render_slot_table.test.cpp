@@ -0,0 +1,53 @@
+#include "engine/renderer/render_slot_table.h"
+
+namespace my {
+
+using Range = std::pair<uint32_t, uint32_t>;
+
+static std::vector<Range> ChangedRanges(const std::vector<uint32_t>& p_versions, uint32_t p_version) {
+    std::vector<Range> ranges;
+    RenderSlotTable::ForEachChangedRange(p_versions, p_version, [&](uint32_t p_begin, uint32_t p_end) {
+        ranges.emplace_back(p_begin, p_end);
+    });
+    return ranges;
+}
+
+TEST(render_slot_table, nothing_changed) {
+    std::vector<uint32_t> versions(64, 1);
+    EXPECT_TRUE(ChangedRanges(versions, 1).empty());
+    EXPECT_TRUE(ChangedRanges({}, 0).empty());
+}
+
+TEST(render_slot_table, fresh_buffer_uploads_everything) {
+    std::vector<uint32_t> versions(64, 1);
+    versions[10] = 5;
+
+    const auto ranges = ChangedRanges(versions, 0);
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0], Range(0, 64));
+}
+
+TEST(render_slot_table, merge_close_ranges) {
+    std::vector<uint32_t> versions(64, 1);
+    versions[2] = 2;
+    versions[3] = 2;
+    // within MERGE_GAP of slot 3
+    versions[3 + RenderSlotTable::MERGE_GAP] = 3;
+    // too far, starts a new range
+    versions[40] = 3;
+    versions[63] = 2;
+
+    const auto ranges = ChangedRanges(versions, 1);
+    ASSERT_EQ(ranges.size(), 3u);
+    EXPECT_EQ(ranges[0], Range(2, 4 + RenderSlotTable::MERGE_GAP));
+    EXPECT_EQ(ranges[1], Range(40, 41));
+    EXPECT_EQ(ranges[2], Range(63, 64));
+
+    // a buffer updated at version 2 only misses what version 3 wrote
+    const auto newer = ChangedRanges(versions, 2);
+    ASSERT_EQ(newer.size(), 2u);
+    EXPECT_EQ(newer[0], Range(3 + RenderSlotTable::MERGE_GAP, 4 + RenderSlotTable::MERGE_GAP));
+    EXPECT_EQ(newer[1], Range(40, 41));
+}
+
+}  // namespace my
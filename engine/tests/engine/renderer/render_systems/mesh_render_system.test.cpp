@@ -0,0 +1,90 @@
+#include "allocation_tracker.h"
+#include "engine/math/geometry.h"
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/frame_data.h"
+#include "engine/renderer/render_slot_table.h"
+#include "engine/scene/scene.h"
+#include "engine/systems/ecs_systems.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my {
+
+extern void RunMeshRenderSystem(Scene& p_scene, FrameData& p_framedata);
+
+// cubes sharing a mesh, so some are drawn instanced, and a voxel gi region showing its debug box
+static void CreateRenderScene(Scene& p_scene) {
+    const ecs::Entity material_id = p_scene.CreateMaterialEntity("material");
+    const ecs::Entity mesh_id = p_scene.CreateMeshEntity("mesh");
+    MeshComponent& mesh = *p_scene.GetComponent<MeshComponent>(mesh_id);
+    mesh = MakeCubeMesh();
+    mesh.subsets[0].material_id = material_id;
+    // nothing is drawn, the commands only need a mesh to point at
+    mesh.gpuResource = std::make_shared<GpuMesh>();
+
+    for (int i = 0; i < 8; ++i) {
+        const ecs::Entity entity = p_scene.CreateObjectEntity("object");
+        p_scene.GetComponent<MeshRendererComponent>(entity)->meshId = mesh_id;
+        p_scene.GetComponent<TransformComponent>(entity)->SetTranslation(Vector3f(2.0f * i, 0.0f, -10.0f));
+    }
+
+    const ecs::Entity voxel_gi_id = p_scene.CreateVoxelGiEntity("voxel_gi");
+    VoxelGiComponent& voxel_gi = *p_scene.GetComponent<VoxelGiComponent>(voxel_gi_id);
+    voxel_gi.flags = VoxelGiComponent::SHOW_DEBUG_BOX;
+    voxel_gi.region = AABB(Vector3f(-20.0f), Vector3f(20.0f));
+
+    jobsystem::Context ctx;
+    RunTransformationUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+    RunHierarchyUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+    RunObjectUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+}
+
+TEST(mesh_render_system, no_heap_after_warm_up) {
+    Scene scene;
+    CreateRenderScene(scene);
+    RenderSlotTable slots;
+    slots.Update(scene, false);
+
+    RenderOptions options;
+    options.instancingEnabled = true;
+    const Matrix4x4f projection = BuildOpenGlPerspectiveRH(glm::radians(60.0f), 1.0f, 0.1f, 100.0f);
+
+    std::array<LinearAllocator, 2> arenas;
+    std::array<FrameData*, 2> frames{};
+    auto render_frames = [&](int p_frame_count) {
+        for (int frame = 0; frame < p_frame_count; ++frame) {
+            const size_t index = frame % arenas.size();
+            if (frames[index]) {
+                frames[index]->~FrameData();
+            }
+            LinearAllocator& arena = arenas[index];
+            arena.Reset();
+
+            FrameData* frame_data = new (arena.Allocate(sizeof(FrameData), alignof(FrameData))) FrameData(options, arena);
+            frames[index] = frame_data;
+            frame_data->slots = &slots;
+            frame_data->mainCamera.viewMatrix = Matrix4x4f(1.0f);
+            frame_data->mainCamera.projectionMatrixFrustum = projection;
+            frame_data->mainCamera.projectionMatrixRendering = projection;
+            RunMeshRenderSystem(scene, *frame_data);
+        }
+    };
+
+    render_frames(2);
+    EXPECT_FALSE(frames[1]->gbuffer_commands.empty());
+    EXPECT_FALSE(frames[1]->drawDebugContext.positions.empty());
+
+    {
+        ScopedAllocationTracker tracker;
+        render_frames(4);
+        EXPECT_EQ(tracker.GetAllocationCount(), 0u);
+    }
+
+    for (FrameData* frame_data : frames) {
+        frame_data->~FrameData();
+    }
+}
+
+}  // namespace my
@@ -0,0 +1,155 @@
+#include "engine/runtime/asset_load_queue.h"
+
+#include "engine/assets/asset_entry.h"
+
+namespace my {
+
+static AssetLoadRequest MakeRequest(AssetEntry& p_entry, AssetLoadPriority p_priority) {
+    AssetLoadRequest request;
+    request.entry = &p_entry;
+    request.priority = p_priority;
+    return request;
+}
+
+TEST(asset_load_queue, priority_order) {
+    AssetEntry background{ AssetMetaData{ .type = AssetType::Image } };
+    AssetEntry prefetch{ AssetMetaData{ .type = AssetType::Image } };
+    AssetEntry visible_1{ AssetMetaData{ .type = AssetType::Image } };
+    AssetEntry visible_2{ AssetMetaData{ .type = AssetType::Image } };
+
+    AssetLoadQueue queue;
+    queue.Push(MakeRequest(background, AssetLoadPriority::Background));
+    queue.Push(MakeRequest(prefetch, AssetLoadPriority::Prefetch));
+    queue.Push(MakeRequest(visible_1, AssetLoadPriority::Visible));
+    queue.Push(MakeRequest(visible_2, AssetLoadPriority::Visible));
+
+    AssetLoadRequest request;
+    for (const AssetEntry* expected : { &visible_1, &visible_2, &prefetch, &background }) {
+        ASSERT_TRUE(queue.TryPop(0, request));
+        EXPECT_EQ(request.entry, expected);
+        queue.Finish(request);
+    }
+    EXPECT_FALSE(queue.TryPop(0, request));
+}
+
+TEST(asset_load_queue, type_limit) {
+    AssetEntry scene_1{ AssetMetaData{ .type = AssetType::Scene } };
+    AssetEntry scene_2{ AssetMetaData{ .type = AssetType::Scene } };
+    AssetEntry image{ AssetMetaData{ .type = AssetType::Image } };
+
+    AssetLoadQueue queue;
+    queue.SetWorkerCount(2);
+    queue.SetTypeLimit(AssetType::Scene, 1);
+    queue.Push(MakeRequest(scene_1, AssetLoadPriority::Visible));
+    queue.Push(MakeRequest(scene_2, AssetLoadPriority::Visible));
+    queue.Push(MakeRequest(image, AssetLoadPriority::Background));
+
+    AssetLoadRequest first, second;
+    ASSERT_TRUE(queue.TryPop(0, first));
+    EXPECT_EQ(first.entry, &scene_1);
+    // the second scene waits, the image behind it goes first
+    ASSERT_TRUE(queue.TryPop(1, second));
+    EXPECT_EQ(second.entry, &image);
+    EXPECT_FALSE(queue.TryPop(1, second));
+
+    queue.Finish(first);
+    ASSERT_TRUE(queue.TryPop(1, second));
+    EXPECT_EQ(second.entry, &scene_2);
+}
+
+TEST(asset_load_queue, worker_count) {
+    AssetEntry image{ AssetMetaData{ .type = AssetType::Image } };
+
+    AssetLoadQueue queue;
+    queue.SetWorkerCount(1);
+    queue.Push(MakeRequest(image, AssetLoadPriority::Visible));
+
+    AssetLoadRequest request;
+    EXPECT_FALSE(queue.TryPop(1, request));
+    queue.SetWorkerCount(2);
+    EXPECT_TRUE(queue.TryPop(1, request));
+}
+
+TEST(asset_load_queue, promote_and_cancel) {
+    AssetEntry image_1{ AssetMetaData{ .type = AssetType::Image } };
+    AssetEntry image_2{ AssetMetaData{ .type = AssetType::Image } };
+    AssetEntry image_3{ AssetMetaData{ .type = AssetType::Image } };
+    AssetEntry image_4{ AssetMetaData{ .type = AssetType::Image } };
+
+    AssetLoadQueue queue;
+    queue.Push(MakeRequest(image_1, AssetLoadPriority::Visible));
+    queue.Push(MakeRequest(image_2, AssetLoadPriority::Prefetch));
+    queue.Push(MakeRequest(image_3, AssetLoadPriority::Prefetch));
+    queue.Push(MakeRequest(image_4, AssetLoadPriority::Background));
+
+    EXPECT_TRUE(queue.Promote(&image_4, AssetLoadPriority::Visible));
+    EXPECT_TRUE(queue.Cancel(&image_1));
+    EXPECT_FALSE(queue.Cancel(&image_1));
+
+    auto metrics = queue.GetMetrics();
+    EXPECT_EQ(metrics.queueDepth[std::to_underlying(AssetLoadPriority::Visible)], 1u);
+    EXPECT_EQ(metrics.queueDepth[std::to_underlying(AssetLoadPriority::Prefetch)], 2u);
+    EXPECT_EQ(metrics.queueDepth[std::to_underlying(AssetLoadPriority::Background)], 0u);
+
+    auto cancelled = queue.Cancel(AssetLoadPriority::Prefetch);
+    ASSERT_EQ(cancelled.size(), 2u);
+    EXPECT_EQ(cancelled[0].entry, &image_2);
+    EXPECT_EQ(cancelled[1].entry, &image_3);
+
+    AssetLoadRequest request;
+    ASSERT_TRUE(queue.TryPop(0, request));
+    EXPECT_EQ(request.entry, &image_4);
+    EXPECT_EQ(request.priority, AssetLoadPriority::Visible);
+    // a request being loaded can't be cancelled
+    EXPECT_FALSE(queue.Cancel(&image_4));
+    EXPECT_FALSE(queue.Promote(&image_4, AssetLoadPriority::Visible));
+    queue.Finish(request);
+
+    metrics = queue.GetMetrics();
+    EXPECT_EQ(metrics.inFlight, 0u);
+    EXPECT_EQ(metrics.loadCount, 1u);
+    EXPECT_EQ(metrics.cancelCount, 3u);
+}
+
+TEST(asset_load_queue, cancelled_entry) {
+    AssetEntry image{ AssetMetaData{ .type = AssetType::Image } };
+    image.MarkCancelled();
+
+    auto res = image.Wait();
+    ASSERT_FALSE(res);
+    EXPECT_EQ(res.error()->value, ErrorCode::ERR_SKIP);
+}
+
+TEST(asset_load_queue, shutdown_wakes_workers) {
+    AssetLoadQueue queue;
+    queue.SetWorkerCount(4);
+
+    std::atomic_int exited = 0;
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < 4; ++i) {
+        workers.emplace_back([&queue, &exited, i]() {
+            AssetLoadRequest request;
+            while (queue.Pop(i, request)) {
+                queue.Finish(request);
+            }
+            ++exited;
+        });
+    }
+
+    std::deque<AssetEntry> images;
+    for (int i = 0; i < 16; ++i) {
+        AssetEntry& image = images.emplace_back(AssetMetaData{ .type = AssetType::Image });
+        queue.Push(MakeRequest(image, AssetLoadPriority::Background));
+    }
+    while (queue.GetMetrics().loadCount < 16) {
+        std::this_thread::yield();
+    }
+
+    queue.Shutdown();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(exited, 4);
+}
+
+}  // namespace my
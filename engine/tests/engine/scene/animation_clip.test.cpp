@@ -0,0 +1,155 @@
+#include "engine/math/geomath.h"
+#include "engine/scene/animation_clip.h"
+
+namespace my {
+
+static constexpr int KEY_COUNT = 31;
+
+// joint 0 moves along x and spins around y, joint 1 has a constant scale
+static AnimationComponent CreateAnimation(const ecs::Entity* p_joints) {
+    AnimationComponent animation;
+    animation.samplers.resize(3);
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        const float time = i / 30.0f;
+        const Quaternion q = glm::angleAxis(time * 3.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        for (auto& sampler : animation.samplers) {
+            sampler.keyframeTimes.push_back(time);
+        }
+        animation.samplers[0].keyframeData.insert(animation.samplers[0].keyframeData.end(), { glm::sin(time * 4.0f), 1.0f, -2.0f });
+        animation.samplers[1].keyframeData.insert(animation.samplers[1].keyframeData.end(), { q.x, q.y, q.z, q.w });
+        animation.samplers[2].keyframeData.insert(animation.samplers[2].keyframeData.end(), { 2.0f, 2.0f, 2.0f });
+    }
+
+    using Channel = AnimationComponent::Channel;
+    animation.channels.push_back({ Channel::PATH_TRANSLATION, p_joints[0], 0 });
+    animation.channels.push_back({ Channel::PATH_ROTATION, p_joints[0], 1 });
+    animation.channels.push_back({ Channel::PATH_SCALE, p_joints[1], 2 });
+    animation.end = (KEY_COUNT - 1) / 30.0f;
+    return animation;
+}
+
+TEST(animation_clip, compress) {
+    const ecs::Entity joints[2] = { ecs::Entity(1), ecs::Entity(2) };
+    const AnimationComponent animation = CreateAnimation(joints);
+
+    const float tolerance = 2e-3f;
+    const AnimationClip clip = AnimationClip::Compress(animation, joints, tolerance);
+    EXPECT_EQ(clip.GetTrackCount(), 3u);
+    EXPECT_FLOAT_EQ(clip.GetDuration(), animation.end);
+    // the constant scale track only keeps both ends
+    EXPECT_LT(clip.GetKeyCount(), 3u * KEY_COUNT);
+
+    size_t raw_size = 0;
+    for (const auto& sampler : animation.samplers) {
+        raw_size += (sampler.keyframeTimes.size() + sampler.keyframeData.size()) * sizeof(float);
+    }
+    EXPECT_LT(clip.GetMemorySize(), raw_size);
+
+    AnimationPose pose;
+    pose.Resize(2);
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        const float time = i / 30.0f;
+        clip.Sample(time, pose);
+
+        const Quaternion q = glm::angleAxis(time * 3.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        const Vector4f& rotation = pose.rotations[0];
+        const float sign = rotation.x * q.x + rotation.y * q.y + rotation.z * q.z + rotation.w * q.w < 0.0f ? -1.0f : 1.0f;
+        EXPECT_NEAR(pose.translations[0].x, glm::sin(time * 4.0f), 2.0f * tolerance);
+        EXPECT_NEAR(pose.translations[0].z, -2.0f, 2.0f * tolerance);
+        EXPECT_NEAR(rotation.y * sign, q.y, 2.0f * tolerance);
+        EXPECT_NEAR(rotation.w * sign, q.w, 2.0f * tolerance);
+        EXPECT_NEAR(pose.scales[1].x, 2.0f, 2.0f * tolerance);
+    }
+}
+
+TEST(animation_clip, compress_step_keys) {
+    // the translation jumps from 0 to 1 at time 1, the keys at time 1 have no span to interpolate over
+    AnimationComponent animation;
+    animation.samplers.resize(1);
+    animation.samplers[0].keyframeTimes = { 0.0f, 1.0f, 1.0f, 1.0f, 2.0f };
+    for (float x : { 0.0f, 0.0f, 1.0f, 1.0f, 1.0f }) {
+        animation.samplers[0].keyframeData.insert(animation.samplers[0].keyframeData.end(), { x, 0.0f, 0.0f });
+    }
+    const ecs::Entity joint(1);
+    animation.channels.push_back({ AnimationComponent::Channel::PATH_TRANSLATION, joint, 0 });
+    animation.end = 2.0f;
+
+    const AnimationClip clip = AnimationClip::Compress(animation, { &joint, 1 });
+    EXPECT_EQ(clip.GetKeyCount(), 4u);
+
+    AnimationPose pose;
+    pose.Resize(1);
+    clip.Sample(0.5f, pose);
+    EXPECT_FLOAT_EQ(pose.translations[0].x, 0.0f);
+    clip.Sample(1.5f, pose);
+    EXPECT_FLOAT_EQ(pose.translations[0].x, 1.0f);
+}
+
+TEST(animation_clip, unknown_targets_are_dropped) {
+    const ecs::Entity joints[2] = { ecs::Entity(1), ecs::Entity(2) };
+    const AnimationComponent animation = CreateAnimation(joints);
+
+    const ecs::Entity other_joints[1] = { ecs::Entity(2) };
+    const AnimationClip clip = AnimationClip::Compress(animation, other_joints);
+    EXPECT_EQ(clip.GetTrackCount(), 1u);
+}
+
+TEST(animation_clip, blend) {
+    const ecs::Entity joints[2] = { ecs::Entity(1), ecs::Entity(2) };
+    const AnimationComponent animation = CreateAnimation(joints);
+    const AnimationClip clip = AnimationClip::Compress(animation, joints);
+
+    AnimationPose rest;
+    rest.Resize(2);
+
+    AnimationInstance instance;
+    instance.layers.resize(2);
+    instance.layers[0].clip = &clip;
+    instance.layers[0].time = 0.0f;
+    instance.layers[1].clip = &clip;
+    instance.layers[1].time = 0.0f;
+
+    Crossfade(instance.layers[0], instance.layers[1], 0.25f);
+    EvaluateAnimation(rest, instance);
+    EXPECT_NEAR(instance.pose.translations[0].y, 1.0f, 1e-3f);
+    EXPECT_NEAR(instance.pose.scales[1].x, 2.0f, 1e-3f);
+
+    // half of the clip, half of the rest pose
+    instance.layers.resize(1);
+    instance.layers[0].weight = 0.5f;
+    EvaluateAnimation(rest, instance);
+    EXPECT_NEAR(instance.pose.translations[0].y, 0.5f, 1e-3f);
+    EXPECT_NEAR(instance.pose.scales[1].x, 1.5f, 1e-3f);
+
+    // additive on top of the rest pose
+    instance.layers[0].weight = 1.0f;
+    instance.layers[0].additive = true;
+    rest.translations[0] = Vector3f(0.0f, 10.0f, 0.0f);
+    EvaluateAnimation(rest, instance);
+    EXPECT_NEAR(instance.pose.translations[0].y, 1.0f, 1e-3f);
+    EXPECT_NEAR(instance.pose.scales[1].x, 2.0f, 1e-3f);
+}
+
+TEST(animation_clip, additive_zero_rest_scale) {
+    const ecs::Entity joints[2] = { ecs::Entity(1), ecs::Entity(2) };
+    const AnimationComponent animation = CreateAnimation(joints);
+    const AnimationClip clip = AnimationClip::Compress(animation, joints);
+
+    AnimationPose rest;
+    rest.Resize(2);
+    rest.scales[1] = Vector3f(0.0f, 1.0f, 1.0f);
+
+    AnimationInstance instance;
+    instance.layers.resize(1);
+    instance.layers[0].clip = &clip;
+    instance.layers[0].additive = true;
+    EvaluateAnimation(rest, instance);
+
+    // the collapsed axis stays collapsed instead of turning into nan
+    const Vector3f& scale = instance.pose.scales[1];
+    EXPECT_EQ(scale.x, 0.0f);
+    EXPECT_NEAR(scale.y, 2.0f, 1e-3f);
+    EXPECT_NEAR(scale.z, 2.0f, 1e-3f);
+}
+
+}  // namespace my
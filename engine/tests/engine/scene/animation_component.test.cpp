@@ -0,0 +1,44 @@
+#include "engine/scene/scene_component.h"
+
+namespace my {
+
+TEST(animation_sampler, find_keyframe) {
+    AnimationComponent::Sampler sampler;
+    sampler.keyframeTimes = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f };
+
+    EXPECT_EQ(sampler.FindKeyframe(-1.0f, 0), 0u);
+    EXPECT_EQ(sampler.FindKeyframe(0.0f, 0), 0u);
+    EXPECT_EQ(sampler.FindKeyframe(0.5f, 0), 0u);
+    EXPECT_EQ(sampler.FindKeyframe(1.0f, 0), 1u);
+    EXPECT_EQ(sampler.FindKeyframe(3.5f, 0), 3u);
+    EXPECT_EQ(sampler.FindKeyframe(4.0f, 0), 4u);
+    EXPECT_EQ(sampler.FindKeyframe(10.0f, 0), 4u);
+    // looping back to the start
+    EXPECT_EQ(sampler.FindKeyframe(0.25f, 4), 0u);
+    // stale cursor
+    EXPECT_EQ(sampler.FindKeyframe(2.5f, 100), 2u);
+}
+
+TEST(animation_sampler, find_keyframe_playback) {
+    AnimationComponent::Sampler sampler;
+    for (int i = 0; i < 100; ++i) {
+        sampler.keyframeTimes.push_back(0.1f * i);
+    }
+
+    uint32_t cursor = 0;
+    for (float time = 0.0f; time < 10.0f; time += 0.016f) {
+        cursor = sampler.FindKeyframe(time, cursor);
+        const auto it = std::upper_bound(sampler.keyframeTimes.begin(), sampler.keyframeTimes.end(), time);
+        EXPECT_EQ(cursor, static_cast<uint32_t>(it - sampler.keyframeTimes.begin() - 1));
+    }
+}
+
+TEST(animation_sampler, find_keyframe_single_key) {
+    AnimationComponent::Sampler sampler;
+    sampler.keyframeTimes = { 1.0f };
+
+    EXPECT_EQ(sampler.FindKeyframe(0.0f, 0), 0u);
+    EXPECT_EQ(sampler.FindKeyframe(2.0f, 0), 0u);
+}
+
+}  // namespace my
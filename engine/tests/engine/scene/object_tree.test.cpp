@@ -0,0 +1,134 @@
+#include "engine/math/matrix_transform.h"
+#include "engine/scene/scene.h"
+#include "engine/systems/ecs_systems.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my {
+
+static void UpdateObjects(Scene& p_scene) {
+    jobsystem::Context ctx;
+    RunTransformationUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+    RunHierarchyUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+    RunObjectUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+}
+
+static std::vector<ecs::Entity> QueryObjects(Scene& p_scene, const AABB& p_aabb) {
+    std::vector<ecs::Entity> result;
+    p_scene.m_objectTree.GetTree().Query(p_aabb, [&](uint32_t p_index) {
+        result.push_back(p_scene.GetEntityByIndex<MeshRendererComponent>(p_index));
+    });
+    return result;
+}
+
+class ObjectTreeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ecs::Entity::SetSeed();
+        // unit cubes along the x axis
+        a = scene.CreateCubeEntity("a", Vector3f(0.5f), glm::translate(glm::vec3(0.0f, 0.0f, 0.0f)));
+        b = scene.CreateCubeEntity("b", Vector3f(0.5f), glm::translate(glm::vec3(10.0f, 0.0f, 0.0f)));
+        c = scene.CreateCubeEntity("c", Vector3f(0.5f), glm::translate(glm::vec3(20.0f, 0.0f, 0.0f)));
+    }
+
+    Scene scene;
+    ecs::Entity a, b, c;
+};
+
+TEST_F(ObjectTreeTest, build) {
+    UpdateObjects(scene);
+
+    const ObjectTree& tree = scene.m_objectTree;
+    EXPECT_EQ(tree.GetTree().GetLeafCount(), 3u);
+    EXPECT_EQ(tree.GetUpdatedCount(), 3u);
+    EXPECT_FLOAT_EQ(scene.GetBound().GetMin().x, -0.5f);
+    EXPECT_FLOAT_EQ(scene.GetBound().GetMax().x, 20.5f);
+
+    const auto result = QueryObjects(scene, AABB(Vector3f(9.0f, -1.0f, -1.0f), Vector3f(11.0f, 1.0f, 1.0f)));
+    ASSERT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0], b);
+}
+
+TEST_F(ObjectTreeTest, move) {
+    UpdateObjects(scene);
+    UpdateObjects(scene);
+    EXPECT_EQ(scene.m_objectTree.GetUpdatedCount(), 0u);
+
+    scene.GetComponent<TransformComponent>(b)->Translate(Vector3f(20.0f, 0.0f, 0.0f));
+    UpdateObjects(scene);
+
+    EXPECT_EQ(scene.m_objectTree.GetUpdatedCount(), 1u);
+    EXPECT_FLOAT_EQ(scene.GetBound().GetMax().x, 30.5f);
+    EXPECT_TRUE(QueryObjects(scene, AABB(Vector3f(9.0f, -1.0f, -1.0f), Vector3f(11.0f, 1.0f, 1.0f))).empty());
+
+    const auto result = QueryObjects(scene, AABB(Vector3f(29.0f, -1.0f, -1.0f), Vector3f(31.0f, 1.0f, 1.0f)));
+    ASSERT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0], b);
+}
+
+TEST_F(ObjectTreeTest, mesh_change) {
+    UpdateObjects(scene);
+
+    // the mesh of b grows in place
+    const ecs::Entity mesh_b = scene.GetComponent<MeshRendererComponent>(b)->meshId;
+    scene.GetComponent<MeshComponent>(mesh_b)->localBound = AABB(Vector3f(-2.0f), Vector3f(2.0f));
+    UpdateObjects(scene);
+
+    EXPECT_EQ(scene.m_objectTree.GetUpdatedCount(), 1u);
+    const auto result = QueryObjects(scene, AABB(Vector3f(11.5f, -1.0f, -1.0f), Vector3f(12.5f, 1.0f, 1.0f)));
+    ASSERT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0], b);
+
+    // c draws the mesh of b
+    scene.GetComponent<MeshRendererComponent>(c)->meshId = mesh_b;
+    UpdateObjects(scene);
+
+    EXPECT_EQ(scene.m_objectTree.GetUpdatedCount(), 1u);
+    EXPECT_FLOAT_EQ(scene.GetBound().GetMax().x, 22.0f);
+}
+
+TEST_F(ObjectTreeTest, add_remove) {
+    UpdateObjects(scene);
+
+    scene.RemoveEntity(a);
+    auto d = scene.CreateCubeEntity("d", Vector3f(0.5f), glm::translate(glm::vec3(0.0f, 10.0f, 0.0f)));
+    UpdateObjects(scene);
+
+    EXPECT_EQ(scene.m_objectTree.GetTree().GetLeafCount(), 3u);
+    EXPECT_TRUE(QueryObjects(scene, AABB(Vector3f(-1.0f), Vector3f(1.0f))).empty());
+
+    const auto result = QueryObjects(scene, AABB(Vector3f(-1.0f, 9.0f, -1.0f), Vector3f(1.0f, 11.0f, 1.0f)));
+    ASSERT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0], d);
+}
+
+TEST_F(ObjectTreeTest, ray_pick) {
+    UpdateObjects(scene);
+
+    // off center, so the rays don't go through the diagonal of a face
+    Ray ray(Vector3f(-5.0f, 0.1f, 0.2f), Vector3f(25.0f, 0.1f, 0.2f));
+    const auto nearest = scene.Intersects(ray);
+    EXPECT_EQ(nearest.entity, a);
+    EXPECT_NE(nearest.triangle, -1);
+    // within the first cube
+    EXPECT_LT(ray.GetDist(), 6.0f / 30.0f);
+
+    Ray any_ray(Vector3f(-5.0f, 0.1f, 0.2f), Vector3f(25.0f, 0.1f, 0.2f));
+    EXPECT_TRUE(scene.Intersects(any_ray, Scene::RayQueryMode::ANY).entity.IsValid());
+
+    // one ray per cube and one that misses everything
+    std::vector<Ray> rays;
+    for (float x : { 0.0f, 10.0f, 20.0f, 30.0f }) {
+        rays.emplace_back(Vector3f(x + 0.1f, 5.0f, 0.2f), Vector3f(x + 0.1f, -5.0f, 0.2f));
+    }
+    std::vector<Scene::RayIntersectionResult> results(rays.size());
+    scene.Intersects(rays, results);
+    EXPECT_EQ(results[0].entity, a);
+    EXPECT_EQ(results[1].entity, b);
+    EXPECT_EQ(results[2].entity, c);
+    EXPECT_FALSE(results[3].entity.IsValid());
+}
+
+}  // namespace my
@@ -0,0 +1,114 @@
+#include "engine/scene/scene.h"
+#include "engine/systems/ecs_systems.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my {
+
+static void UpdateTransforms(Scene& p_scene) {
+    jobsystem::Context ctx;
+    RunTransformationUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+    RunHierarchyUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+}
+
+static void ExpectWorldTranslation(const Scene& p_scene, ecs::Entity p_entity, float p_x, float p_y, float p_z) {
+    const TransformComponent* transform = p_scene.GetComponent<TransformComponent>(p_entity);
+    ASSERT_TRUE(transform);
+    const auto& translation = transform->GetWorldMatrix()[3];
+    EXPECT_FLOAT_EQ(translation.x, p_x);
+    EXPECT_FLOAT_EQ(translation.y, p_y);
+    EXPECT_FLOAT_EQ(translation.z, p_z);
+}
+
+class TransformHierarchyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ecs::Entity::SetSeed();
+        // root
+        // |-- a
+        // |   `-- b
+        // `-- c
+        root = scene.CreateTransformEntity("root");
+        a = scene.CreateTransformEntity("a");
+        b = scene.CreateTransformEntity("b");
+        c = scene.CreateTransformEntity("c");
+        scene.AttachChild(b, a);
+        scene.AttachChild(a, root);
+        scene.AttachChild(c, root);
+
+        scene.GetComponent<TransformComponent>(root)->Translate(Vector3f(1, 0, 0));
+        scene.GetComponent<TransformComponent>(a)->Translate(Vector3f(0, 2, 0));
+        scene.GetComponent<TransformComponent>(b)->Translate(Vector3f(0, 0, 3));
+        scene.GetComponent<TransformComponent>(c)->Translate(Vector3f(4, 0, 0));
+    }
+
+    Scene scene;
+    ecs::Entity root, a, b, c;
+};
+
+TEST_F(TransformHierarchyTest, world_matrix) {
+    UpdateTransforms(scene);
+
+    const TransformHierarchy& hierarchy = scene.m_transformHierarchy;
+    EXPECT_EQ(hierarchy.GetNodeCount(), 4u);
+    EXPECT_EQ(hierarchy.GetLevelCount(), 3u);
+    EXPECT_EQ(hierarchy.GetUpdatedCount(), 3u);
+
+    ExpectWorldTranslation(scene, root, 1, 0, 0);
+    ExpectWorldTranslation(scene, a, 1, 2, 0);
+    ExpectWorldTranslation(scene, b, 1, 2, 3);
+    ExpectWorldTranslation(scene, c, 5, 0, 0);
+}
+
+TEST_F(TransformHierarchyTest, skip_unchanged) {
+    UpdateTransforms(scene);
+    UpdateTransforms(scene);
+
+    EXPECT_EQ(scene.m_transformHierarchy.GetUpdatedCount(), 0u);
+    ExpectWorldTranslation(scene, b, 1, 2, 3);
+    ExpectWorldTranslation(scene, c, 5, 0, 0);
+}
+
+TEST_F(TransformHierarchyTest, update_subtree) {
+    UpdateTransforms(scene);
+
+    scene.GetComponent<TransformComponent>(a)->Translate(Vector3f(0, 1, 0));
+    UpdateTransforms(scene);
+
+    // a and b, c is untouched
+    EXPECT_EQ(scene.m_transformHierarchy.GetUpdatedCount(), 2u);
+    ExpectWorldTranslation(scene, a, 1, 3, 0);
+    ExpectWorldTranslation(scene, b, 1, 3, 3);
+    ExpectWorldTranslation(scene, c, 5, 0, 0);
+
+    scene.GetComponent<TransformComponent>(root)->Translate(Vector3f(1, 0, 0));
+    UpdateTransforms(scene);
+
+    EXPECT_EQ(scene.m_transformHierarchy.GetUpdatedCount(), 3u);
+    ExpectWorldTranslation(scene, root, 2, 0, 0);
+    ExpectWorldTranslation(scene, b, 2, 3, 3);
+    ExpectWorldTranslation(scene, c, 6, 0, 0);
+}
+
+TEST_F(TransformHierarchyTest, rebuild) {
+    UpdateTransforms(scene);
+
+    scene.RemoveEntity(a);
+    UpdateTransforms(scene);
+
+    EXPECT_EQ(scene.m_transformHierarchy.GetNodeCount(), 2u);
+    EXPECT_EQ(scene.m_transformHierarchy.GetLevelCount(), 2u);
+    ExpectWorldTranslation(scene, c, 5, 0, 0);
+
+    auto d = scene.CreateTransformEntity("d");
+    scene.AttachChild(d, c);
+    scene.GetComponent<TransformComponent>(d)->Translate(Vector3f(0, 0, 1));
+    UpdateTransforms(scene);
+
+    EXPECT_EQ(scene.m_transformHierarchy.GetNodeCount(), 3u);
+    EXPECT_EQ(scene.m_transformHierarchy.GetLevelCount(), 3u);
+    ExpectWorldTranslation(scene, d, 5, 0, 1);
+}
+
+}  // namespace my
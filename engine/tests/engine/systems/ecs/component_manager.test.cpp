@@ -1,4 +1,5 @@
 #include "engine/ecs/component_manager.h"
+#include "engine/scene/scene.h"
 
 namespace my::ecs {
 
@@ -68,4 +69,65 @@ TEST(component_manager, iterator) {
     }
 }
 
+TEST(entity_index, set_find_erase) {
+    EntityIndex index;
+    const Entity a{ 1 };
+    const Entity b{ 5 * EntityIndex::PAGE_SIZE + 3 };
+    EXPECT_EQ(index.Find(a), EntityIndex::INVALID_INDEX);
+    EXPECT_EQ(index.Find(b), EntityIndex::INVALID_INDEX);
+
+    index.Set(a, 7);
+    index.Set(b, 8);
+    EXPECT_EQ(index.Find(a), 7);
+    EXPECT_EQ(index.Find(b), 8);
+    EXPECT_EQ(index.Find(Entity{ 2 }), EntityIndex::INVALID_INDEX);
+
+    index.Erase(a);
+    EXPECT_EQ(index.Find(a), EntityIndex::INVALID_INDEX);
+    EXPECT_EQ(index.Find(b), 8);
+
+    index.Clear();
+    EXPECT_EQ(index.Find(b), EntityIndex::INVALID_INDEX);
+}
+
+TEST(component_manager, swap_and_pop_remove) {
+    Entity::SetSeed();
+    Scene scene;
+    auto& manager = scene.m_NameComponents;
+
+    std::vector<Entity> entities;
+    for (int i = 0; i < 100; ++i) {
+        entities.push_back(scene.CreateNameEntity(std::format("entity_{}", i)));
+    }
+    ASSERT_EQ(manager.GetCount(), 100);
+
+    // remove every third, including the first and the last one
+    for (int i = 0; i < 100; ++i) {
+        if (i % 3 == 0) {
+            manager.Remove(entities[i]);
+        }
+    }
+    // removing twice is a no-op
+    manager.Remove(entities[0]);
+
+    for (int i = 0; i < 100; ++i) {
+        const bool removed = i % 3 == 0;
+        EXPECT_EQ(manager.Contains(entities[i]), !removed);
+        const NameComponent* name = manager.GetComponent(entities[i]);
+        if (removed) {
+            EXPECT_EQ(name, nullptr);
+        } else {
+            ASSERT_NE(name, nullptr);
+            EXPECT_EQ(name->GetName(), std::format("entity_{}", i));
+        }
+    }
+
+    for (size_t i = 0; i < manager.GetCount(); ++i) {
+        EXPECT_EQ(manager.GetComponent(manager.GetEntity(i)), &manager.GetComponentByIndex(i));
+    }
+
+    EXPECT_EQ(manager.GetCount(), 66);
+    EXPECT_FALSE(manager.Contains(Entity::INVALID));
+}
+
 }  // namespace my::ecs
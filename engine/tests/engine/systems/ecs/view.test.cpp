@@ -1,3 +1,4 @@
+#include "allocation_tracker.h"
 #include "engine/scene/scene.h"
 
 namespace my::ecs {
@@ -36,4 +37,91 @@ TEST(view, iterator) {
     }
 }
 
+TEST(view, multiple_components) {
+    Entity::SetSeed();
+    Scene scene;
+    for (int i = 0; i < 8; ++i) {
+        if (i % 2) {
+            scene.CreateTransformEntity(std::format("transform_{}", i));
+        } else {
+            scene.CreateNameEntity(std::format("name_{}", i));
+        }
+    }
+
+    auto view = scene.View<NameComponent, TransformComponent>();
+    // driven by the smaller pool
+    EXPECT_EQ(view.GetSize(), 4);
+
+    int count = 0;
+    for (auto [id, name, transform] : view) {
+        EXPECT_EQ(&transform, scene.GetComponent<TransformComponent>(id));
+        EXPECT_EQ(name.GetName().rfind("transform_", 0), 0);
+        ++count;
+    }
+    EXPECT_EQ(count, 4);
+
+    // removing a component excludes the entity from the view
+    scene.m_TransformComponents.Remove(scene.GetEntity<TransformComponent>(0));
+    count = 0;
+    for (auto [id, name, transform] : scene.View<TransformComponent, NameComponent>()) {
+        ++count;
+    }
+    EXPECT_EQ(count, 3);
+}
+
+TEST(view, for_each) {
+    Entity::SetSeed();
+    Scene scene;
+    for (int i = 0; i < 300; ++i) {
+        if (i % 3 == 0) {
+            scene.CreateTransformEntity(std::format("{}", i));
+        } else {
+            scene.CreateNameEntity(std::format("{}", i));
+        }
+    }
+
+    std::atomic_int count = 0;
+    const auto view = scene.View<NameComponent, TransformComponent>();
+    view.ForEach(0, view.GetSize(), [&](Entity, const NameComponent&, const TransformComponent&) {
+        count.fetch_add(1);
+    });
+    EXPECT_EQ(count.load(), 100);
+
+    count = 0;
+    auto func = [&](Entity, NameComponent& p_name, TransformComponent&) {
+        p_name.GetNameRef().push_back('!');
+        count.fetch_add(1);
+    };
+    jobsystem::Context ctx;
+    auto parallel_view = scene.View<TransformComponent, NameComponent>();
+    parallel_view.ParallelForEach(ctx, 16, [&](Entity p_id, TransformComponent& p_transform, NameComponent& p_name) {
+        func(p_id, p_name, p_transform);
+    });
+    ctx.Wait();
+    EXPECT_EQ(count.load(), 100);
+
+    for (auto [id, name, transform] : view) {
+        EXPECT_EQ(name.GetName().back(), '!');
+    }
+}
+
+TEST(view, does_not_allocate) {
+    Entity::SetSeed();
+    Scene scene;
+    for (int i = 0; i < 100; ++i) {
+        scene.CreateTransformEntity("entity");
+    }
+
+    ScopedAllocationTracker tracker;
+    int count = 0;
+    for (auto [id, name] : scene.View<NameComponent>()) {
+        ++count;
+    }
+    for (auto [id, name, transform] : scene.View<NameComponent, TransformComponent>()) {
+        ++count;
+    }
+    EXPECT_EQ(count, 200);
+    EXPECT_EQ(tracker.GetAllocationCount(), 0);
+}
+
 }  // namespace my::ecs
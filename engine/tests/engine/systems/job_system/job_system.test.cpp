@@ -0,0 +1,123 @@
+#include "allocation_tracker.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my::jobsystem {
+
+TEST(job_system, dispatch) {
+    constexpr uint32_t JOB_COUNT = 1000;
+    std::vector<int> result(JOB_COUNT, 0);
+
+    Context ctx;
+    ctx.Dispatch(JOB_COUNT, 16, [&](JobArgs p_args) {
+        result[p_args.jobIndex] = p_args.jobIndex * 2;
+    });
+    ctx.Wait();
+
+    EXPECT_FALSE(ctx.IsBusy());
+    for (uint32_t i = 0; i < JOB_COUNT; ++i) {
+        EXPECT_EQ(result[i], static_cast<int>(i * 2));
+    }
+}
+
+TEST(job_system, group) {
+    std::vector<JobArgs> result(10);
+
+    Context ctx;
+    ctx.Dispatch(10, 4, [&](JobArgs p_args) {
+        result[p_args.jobIndex] = p_args;
+    });
+    ctx.Wait();
+
+    for (uint32_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(result[i].jobIndex, i);
+        EXPECT_EQ(result[i].groupId, i / 4);
+        EXPECT_EQ(result[i].groupIndex, i % 4);
+    }
+}
+
+TEST(job_system, dispatch_more_than_queue_capacity) {
+    std::atomic_int counter = 0;
+
+    Context ctx;
+    ctx.Dispatch(4096, 1, [&](JobArgs) {
+        counter.fetch_add(1);
+    });
+    ctx.Dispatch(0, 1, [&](JobArgs) {
+        counter.fetch_add(1);
+    });
+    ctx.Wait();
+
+    EXPECT_EQ(counter.load(), 4096);
+}
+
+TEST(job_system, dispatch_does_not_allocate) {
+    std::atomic_int counter = 0;
+    // capture more than std::function stores inline
+    std::array<int, 8> payload = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    int* dummy = nullptr;
+
+    Context ctx;
+    ScopedAllocationTracker tracker;
+    for (int round = 0; round < 4; ++round) {
+        ctx.Dispatch(256, 8, [&counter, payload, dummy](JobArgs p_args) {
+            unused(dummy);
+            counter.fetch_add(payload[p_args.jobIndex % payload.size()]);
+        });
+        ctx.Dispatch(64, 1, [&counter](JobArgs) {
+            counter.fetch_add(1);
+        });
+        ctx.Wait();
+    }
+
+    EXPECT_EQ(tracker.GetAllocationCount(), 0);
+    EXPECT_EQ(counter.load(), 4 * (256 / 8 * 36 + 64));
+}
+
+TEST(job_system, dispatch_out_of_task_slots) {
+    std::atomic_int counter = 0;
+
+    Context ctx;
+    for (int i = 0; i < 100; ++i) {
+        ctx.Dispatch(10, 3, [&](JobArgs) {
+            counter.fetch_add(1);
+        });
+    }
+    ctx.Wait();
+
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+// like TaskGraph::Launch(), every job dispatches the next one to the same context,
+// far more tasks than slots go through it, but only one is in flight at a time
+TEST(job_system, retired_task_slots_are_reused) {
+    constexpr int CHAIN_LENGTH = 200;
+    static thread_local int s_depth = 0;
+
+    struct Chain {
+        Context ctx;
+        std::atomic_int count = 0;
+        std::atomic_int maxDepth = 0;
+
+        void Next() {
+            ctx.Dispatch(1, 1, [this](JobArgs) {
+                // a task run by Dispatch() itself would nest inside the job that dispatched it
+                const int depth = ++s_depth;
+                int max_depth = maxDepth.load();
+                while (depth > max_depth && !maxDepth.compare_exchange_weak(max_depth, depth)) {
+                }
+                if (count.fetch_add(1) + 1 < CHAIN_LENGTH) {
+                    Next();
+                }
+                --s_depth;
+            });
+        }
+    } chain;
+
+    chain.Next();
+    chain.ctx.Wait();
+
+    EXPECT_EQ(chain.count.load(), CHAIN_LENGTH);
+    EXPECT_EQ(chain.maxDepth.load(), 1);
+}
+
+}  // namespace my::jobsystem
@@ -0,0 +1,96 @@
+#include "engine/systems/job_system/task_graph.h"
+
+namespace my::jobsystem {
+
+struct A {};
+struct B {};
+struct C {};
+
+static bool HasEdge(const TaskGraph& p_graph, int p_from, int p_to) {
+    const auto& edges = p_graph.GetEdges();
+    return std::find(edges.begin(), edges.end(), std::make_pair(p_from, p_to)) != edges.end();
+}
+
+TEST(task_graph, derive_edges) {
+    TaskGraph graph;
+    graph.AddTask("0", [](Context&) {}).Write<A>();
+    graph.AddTask("1", [](Context&) {}).Read<A>().Write<B>();
+    graph.AddTask("2", [](Context&) {}).Read<A>();
+    graph.AddTask("3", [](Context&) {}).Write<C>();
+    graph.AddTask("4", [](Context&) {}).Write<A>();
+    ASSERT_TRUE(graph.Compile());
+
+    EXPECT_TRUE(HasEdge(graph, 0, 1));
+    EXPECT_TRUE(HasEdge(graph, 0, 2));
+    // both read only
+    EXPECT_FALSE(HasEdge(graph, 1, 2));
+    // write after read
+    EXPECT_TRUE(HasEdge(graph, 1, 4));
+    EXPECT_TRUE(HasEdge(graph, 2, 4));
+    EXPECT_TRUE(HasEdge(graph, 0, 4));
+    // no shared resource
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_FALSE(HasEdge(graph, i, 3));
+        EXPECT_FALSE(HasEdge(graph, 3, i));
+    }
+}
+
+TEST(task_graph, duplicated_name) {
+    TaskGraph graph;
+    graph.AddTask("a", [](Context&) {});
+    graph.AddTask("a", [](Context&) {});
+    auto res = graph.Compile();
+    ASSERT_FALSE(res);
+    EXPECT_EQ(res.error()->value, ErrorCode::ERR_ALREADY_EXISTS);
+}
+
+TEST(task_graph, cyclic_dependency) {
+    TaskGraph graph;
+    graph.AddTask("a", [](Context&) {}).Write<A>();
+    graph.AddTask("b", [](Context&) {}).Read<A>();
+    graph.AddDependency("b", "a");
+    auto res = graph.Compile();
+    ASSERT_FALSE(res);
+    EXPECT_EQ(res.error()->value, ErrorCode::ERR_CYCLIC_LINK);
+}
+
+TEST(task_graph, run_in_order) {
+    constexpr uint32_t COUNT = 1000;
+    std::vector<int> a(COUNT, 0);
+    std::vector<int> b(COUNT, 0);
+    std::atomic_int c = 0;
+    int sum = 0;
+
+    TaskGraph graph;
+    graph.AddTask("write_a", [&](Context& p_ctx) {
+             p_ctx.Dispatch(COUNT, 16, [&](JobArgs p_args) { a[p_args.jobIndex] = p_args.jobIndex; });
+         })
+        .Write<A>();
+    graph.AddTask("write_c", [&](Context& p_ctx) {
+             p_ctx.Dispatch(COUNT, 16, [&](JobArgs) { c.fetch_add(1); });
+         })
+        .Write<C>();
+    graph.AddTask("a_to_b", [&](Context& p_ctx) {
+             p_ctx.Dispatch(COUNT, 16, [&](JobArgs p_args) { b[p_args.jobIndex] = 2 * a[p_args.jobIndex]; });
+         })
+        .Read<A>()
+        .Write<B>();
+    graph.AddTask("sum", [&](Context&) {
+             for (uint32_t i = 0; i < COUNT; ++i) {
+                 sum += b[i];
+             }
+         })
+        .Read<B>();
+    ASSERT_TRUE(graph.Compile());
+
+    for (int frame = 0; frame < 10; ++frame) {
+        sum = 0;
+        c = 0;
+        graph.Run();
+
+        EXPECT_EQ(sum, static_cast<int>(COUNT * (COUNT - 1)));
+        EXPECT_EQ(c.load(), static_cast<int>(COUNT));
+    }
+}
+
+}  // namespace my::jobsystem
@@ -316,12 +316,32 @@ auto D3d11GraphicsManager::CreateStructuredBuffer(const GpuBufferDesc& p_desc) -
     return structured_buffer;
 }
 
+void D3d11GraphicsManager::UpdateBufferData(const GpuBufferDesc& p_desc, const GpuStructuredBuffer* p_buffer) {
+    auto buffer = reinterpret_cast<const D3d11StructuredBuffer*>(p_buffer);
+    if (DEV_VERIFY(buffer)) {
+        DEV_ASSERT(p_desc.offset + p_desc.elementCount <= buffer->desc.elementCount);
+        D3D11_BOX box{};
+        box.left = p_desc.offset * p_desc.elementSize;
+        box.right = box.left + p_desc.elementCount * p_desc.elementSize;
+        box.bottom = 1;
+        box.back = 1;
+        m_deviceContext->UpdateSubresource(buffer->buffer.Get(), 0, &box, p_desc.initialData, 0, 0);
+    }
+}
+
 void D3d11GraphicsManager::UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) {
     auto buffer = reinterpret_cast<const D3d11UniformBuffer*>(p_buffer);
     DEV_ASSERT(p_size <= buffer->capacity);
     buffer->data = (const char*)p_data;
 }
 
+void D3d11GraphicsManager::UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, uint32_t p_size, uint32_t p_offset) {
+    // the bound range is copied from the CPU data in BindConstantBufferRange()
+    auto buffer = reinterpret_cast<const D3d11UniformBuffer*>(p_buffer);
+    DEV_ASSERT(p_size + p_offset <= buffer->capacity);
+    buffer->data = (const char*)p_data;
+}
+
 void D3d11GraphicsManager::BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
     auto buffer = reinterpret_cast<const D3d11UniformBuffer*>(p_buffer);
     DEV_ASSERT(p_size + p_offset <= buffer->capacity);
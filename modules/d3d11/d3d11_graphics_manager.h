@@ -63,6 +63,7 @@ public:
 
     auto CreateConstantBuffer(const GpuBufferDesc& p_desc) -> Result<std::shared_ptr<GpuConstantBuffer>> final;
     auto CreateStructuredBuffer(const GpuBufferDesc& p_desc) -> Result<std::shared_ptr<GpuStructuredBuffer>> final;
+    void UpdateBufferData(const GpuBufferDesc& p_desc, const GpuStructuredBuffer* p_buffer) final;
 
     void BindStructuredBuffer(int p_slot, const GpuStructuredBuffer* p_buffer) final;
     void UnbindStructuredBuffer(int p_slot) final;
@@ -70,6 +71,7 @@ public:
     void UnbindStructuredBufferSRV(int p_slot) final;
 
     void UpdateConstantBuffer(const GpuConstantBuffer* p_buffer, const void* p_data, size_t p_size) final;
+    void UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, uint32_t p_size, uint32_t p_offset) final;
     void BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) final;
 
     void BindTexture(Dimension p_dimension, uint64_t p_handle, int p_slot) final;
@@ -651,6 +651,14 @@ void D3d12GraphicsManager::UpdateConstantBuffer(const GpuConstantBuffer* p_buffe
     }
 }
 
+void D3d12GraphicsManager::UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, uint32_t p_size, uint32_t p_offset) {
+    if (p_size) {
+        auto cb = reinterpret_cast<const D3d12ConstantBuffer*>(p_buffer);
+        DEV_ASSERT(p_size + p_offset <= cb->capacity);
+        memcpy((char*)cb->mappedData + p_offset, (const char*)p_data + p_offset, p_size);
+    }
+}
+
 void D3d12GraphicsManager::BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
     auto buffer = reinterpret_cast<const D3d12ConstantBuffer*>(p_buffer);
     DEV_ASSERT(p_size + p_offset <= buffer->capacity);
@@ -101,11 +101,12 @@ auto OpenGL4GraphicsManager::CreateStructuredBuffer(const GpuBufferDesc& p_desc)
 void OpenGL4GraphicsManager::UpdateBufferData(const GpuBufferDesc& p_desc, const GpuStructuredBuffer* p_buffer) {
     auto buffer = reinterpret_cast<const OpenGlStructuredBuffer*>(p_buffer);
     if (DEV_VERIFY(buffer)) {
+        DEV_ASSERT(p_desc.offset + p_desc.elementCount <= buffer->desc.elementCount);
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer->handle);
-        float* ptr = (float*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY);
-        DEV_ASSERT(ptr);
-        memcpy(ptr + p_desc.offset, p_desc.initialData, p_desc.elementCount * p_desc.elementSize);
-        glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                        p_desc.offset * p_desc.elementSize,
+                        p_desc.elementCount * p_desc.elementSize,
+                        p_desc.initialData);
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
     }
 }
@@ -357,6 +357,16 @@ void CommonOpenGLGraphicsManager::UpdateConstantBuffer(const GpuConstantBuffer*
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
+void CommonOpenGLGraphicsManager::UpdateConstantBufferRange(const GpuConstantBuffer* p_buffer, const void* p_data, uint32_t p_size, uint32_t p_offset) {
+    if (p_size) {
+        auto buffer = reinterpret_cast<const OpenGlUniformBuffer*>(p_buffer);
+        DEV_ASSERT(p_size + p_offset <= buffer->capacity);
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer->handle);
+        glBufferSubData(GL_UNIFORM_BUFFER, p_offset, p_size, (const char*)p_data + p_offset);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+}
+
 void CommonOpenGLGraphicsManager::BindConstantBufferRange(const GpuConstantBuffer* p_buffer, uint32_t p_size, uint32_t p_offset) {
     auto buffer = reinterpret_cast<const OpenGlUniformBuffer*>(p_buffer);
     DEV_ASSERT(p_size + p_offset <= buffer->capacity);
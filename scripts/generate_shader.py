@@ -19,6 +19,8 @@ input_shaders = [
     'bloom_downsample.cs',
     'bloom_upsample.cs',
     'depth.ps',
+    'gpu_culling.cs',
+    'hiz_build.cs',
     'debug_draw_texture.vs',
     'debug_draw_texture.ps',
     # 'mesh.vs',
@@ -0,0 +1,137 @@
+#include "benchmark.h"
+
+#include "engine/math/geomath.h"
+#include "engine/scene/animation_clip.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my {
+
+static constexpr uint32_t JOINT_COUNT = 64;
+static constexpr uint32_t KEY_COUNT = 121;
+static constexpr float FRAME_RATE = 30.0f;
+
+// every joint has translation, rotation and scale tracks sampled at 30 fps, like an imported clip
+static AnimationComponent CreateClip(std::vector<ecs::Entity>& p_joints) {
+    AnimationComponent animation;
+    for (uint32_t joint = 0; joint < JOINT_COUNT; ++joint) {
+        p_joints.push_back(ecs::Entity(joint + 1));
+
+        AnimationComponent::Sampler translation, rotation, scale;
+        const float phase = 0.1f * joint;
+        for (uint32_t key = 0; key < KEY_COUNT; ++key) {
+            const float time = key / FRAME_RATE;
+            const Quaternion q = glm::angleAxis(glm::sin(time + phase), glm::vec3(0.0f, 1.0f, 0.0f));
+            translation.keyframeTimes.push_back(time);
+            rotation.keyframeTimes.push_back(time);
+            scale.keyframeTimes.push_back(time);
+            translation.keyframeData.insert(translation.keyframeData.end(), { glm::sin(time * 2.0f + phase), 1.0f, 0.0f });
+            rotation.keyframeData.insert(rotation.keyframeData.end(), { q.x, q.y, q.z, q.w });
+            scale.keyframeData.insert(scale.keyframeData.end(), { 1.0f, 1.0f, 1.0f });
+        }
+
+        const int sampler_index = static_cast<int>(animation.samplers.size());
+        animation.samplers.push_back(std::move(translation));
+        animation.samplers.push_back(std::move(rotation));
+        animation.samplers.push_back(std::move(scale));
+        animation.channels.push_back({ AnimationComponent::Channel::PATH_TRANSLATION, p_joints.back(), sampler_index + 0 });
+        animation.channels.push_back({ AnimationComponent::Channel::PATH_ROTATION, p_joints.back(), sampler_index + 1 });
+        animation.channels.push_back({ AnimationComponent::Channel::PATH_SCALE, p_joints.back(), sampler_index + 2 });
+    }
+    animation.end = (KEY_COUNT - 1) / FRAME_RATE;
+    return animation;
+}
+
+// what UpdateAnimation does for one character, without writing to the scene
+static void SampleRaw(const AnimationComponent& p_animation, float p_time, std::vector<uint32_t>& p_cursors, AnimationPose& p_pose) {
+    for (size_t i = 0; i < p_animation.channels.size(); ++i) {
+        const auto& channel = p_animation.channels[i];
+        const auto& sampler = p_animation.samplers[channel.samplerIndex];
+        const uint32_t left = p_cursors[i] = sampler.FindKeyframe(p_time, p_cursors[i]);
+        const uint32_t right = glm::min(left + 1, KEY_COUNT - 1);
+        const float t = left == right ? 0.0f : Saturate((p_time - sampler.keyframeTimes[left]) / (sampler.keyframeTimes[right] - sampler.keyframeTimes[left]));
+        const uint32_t joint = static_cast<uint32_t>(i / 3);
+        const float* data = sampler.keyframeData.data();
+        switch (channel.path) {
+            case AnimationComponent::Channel::PATH_ROTATION: {
+                const Quaternion q = glm::slerp(Quaternion(data[left * 4 + 3], data[left * 4 + 0], data[left * 4 + 1], data[left * 4 + 2]),
+                                                Quaternion(data[right * 4 + 3], data[right * 4 + 0], data[right * 4 + 1], data[right * 4 + 2]),
+                                                t);
+                p_pose.rotations[joint] = Vector4f(q.x, q.y, q.z, q.w);
+            } break;
+            default: {
+                const Vector3f a(data[left * 3 + 0], data[left * 3 + 1], data[left * 3 + 2]);
+                const Vector3f b(data[right * 3 + 0], data[right * 3 + 1], data[right * 3 + 2]);
+                auto& target = channel.path == AnimationComponent::Channel::PATH_TRANSLATION ? p_pose.translations : p_pose.scales;
+                target[joint] = lerp(a, b, t);
+            } break;
+        }
+    }
+}
+
+BENCHMARK(animation_clip) {
+    constexpr uint32_t character_count = 2000;
+    constexpr int iterations = 20;
+
+    std::vector<ecs::Entity> joints;
+    const AnimationComponent animation = CreateClip(joints);
+    const AnimationClip clip = AnimationClip::Compress(animation, joints);
+
+    size_t raw_size = 0;
+    for (const auto& sampler : animation.samplers) {
+        raw_size += (sampler.keyframeTimes.size() + sampler.keyframeData.size()) * sizeof(float);
+    }
+    PRINT("  raw clip: {} KB, compressed clip: {} KB ({:.1f}x), {} of {} keys kept",
+          raw_size / 1024,
+          clip.GetMemorySize() / 1024,
+          static_cast<double>(raw_size) / clip.GetMemorySize(),
+          clip.GetKeyCount(),
+          animation.channels.size() * KEY_COUNT);
+
+    AnimationPose rest;
+    rest.Resize(JOINT_COUNT);
+
+    std::vector<AnimationPose> raw_poses(character_count, rest);
+    std::vector<std::vector<uint32_t>> cursors(character_count, std::vector<uint32_t>(animation.channels.size(), 0));
+    float time = 0.0f;
+    const double raw_ms = benchmark::Measure(iterations, [&]() {
+        time = glm::mod(time + 1.0f / 60.0f, animation.end);
+        for (uint32_t i = 0; i < character_count; ++i) {
+            SampleRaw(animation, time + 0.001f * i, cursors[i], raw_poses[i]);
+        }
+    });
+
+    std::vector<AnimationInstance> instances(character_count);
+    for (AnimationInstance& instance : instances) {
+        instance.layers.resize(1);
+        instance.layers[0].clip = &clip;
+    }
+    const double clip_ms = benchmark::Measure(iterations, [&]() {
+        time = glm::mod(time + 1.0f / 60.0f, animation.end);
+        for (uint32_t i = 0; i < character_count; ++i) {
+            instances[i].layers[0].time = time + 0.001f * i;
+            EvaluateAnimation(rest, instances[i]);
+        }
+    });
+
+    // crossfade between two clips plus an additive layer, evaluated with the job system
+    for (AnimationInstance& instance : instances) {
+        instance.layers.resize(3);
+        instance.layers[1].clip = &clip;
+        instance.layers[2].clip = &clip;
+        instance.layers[2].additive = true;
+        instance.layers[2].weight = 0.3f;
+        Crossfade(instance.layers[0], instance.layers[1], 0.5f);
+    }
+    const double blend_ms = benchmark::Measure(iterations, [&]() {
+        jobsystem::Context ctx;
+        EvaluateAnimations(ctx, rest, instances);
+    });
+
+    PRINT("  {} characters: raw {:8.3f} ms, compressed {:8.3f} ms, 3 layers in jobs {:8.3f} ms",
+          character_count,
+          raw_ms,
+          clip_ms,
+          blend_ms);
+}
+
+}  // namespace my
@@ -0,0 +1,27 @@
+#pragma once
+#include "engine/core/os/timer.h"
+
+namespace my::benchmark {
+
+using BenchmarkFunc = void (*)();
+
+bool Register(const char* p_name, BenchmarkFunc p_func);
+
+// runs p_func p_iterations times after one warm up run, returns average time in milliseconds
+template<typename FUNC>
+double Measure(int p_iterations, FUNC&& p_func) {
+    p_func();
+
+    Timer timer;
+    for (int i = 0; i < p_iterations; ++i) {
+        p_func();
+    }
+    return timer.GetDuration().ToMillisecond() / p_iterations;
+}
+
+}  // namespace my::benchmark
+
+#define BENCHMARK(NAME)                                                                         \
+    static void NAME();                                                                         \
+    [[maybe_unused]] static bool s_##NAME##_registered = ::my::benchmark::Register(#NAME, NAME); \
+    static void NAME()
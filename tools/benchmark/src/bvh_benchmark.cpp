@@ -0,0 +1,129 @@
+#include "benchmark.h"
+
+#include <random>
+
+#include "engine/renderer/path_tracer/bvh_accel.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my {
+
+struct TriangleMesh {
+    const char* name;
+    std::vector<Vector3f> vertices;
+    std::vector<uint32_t> indices;
+};
+
+// p_size * p_size quads of a bumpy height field on the xz plane, two triangles each
+static TriangleMesh CreateTerrain(uint32_t p_size) {
+    TriangleMesh mesh{ .name = "terrain" };
+    const float step = 100.0f / p_size;
+    for (uint32_t z = 0; z <= p_size; ++z) {
+        for (uint32_t x = 0; x <= p_size; ++x) {
+            const float height = 2.0f * glm::sin(0.3f * x * step) * glm::cos(0.2f * z * step);
+            mesh.vertices.emplace_back(x * step, height, z * step);
+        }
+    }
+    for (uint32_t z = 0; z < p_size; ++z) {
+        for (uint32_t x = 0; x < p_size; ++x) {
+            const uint32_t a = z * (p_size + 1) + x;
+            const uint32_t b = a + 1;
+            const uint32_t c = a + p_size + 1;
+            const uint32_t d = c + 1;
+            mesh.indices.insert(mesh.indices.end(), { a, c, b, b, c, d });
+        }
+    }
+    return mesh;
+}
+
+// small random triangles in the same volume, the worst case for splitting
+static TriangleMesh CreateSoup(uint32_t p_count) {
+    TriangleMesh mesh{ .name = "soup" };
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> position(0.0f, 100.0f);
+    std::uniform_real_distribution<float> height(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> offset(-0.2f, 0.2f);
+    for (uint32_t i = 0; i < p_count; ++i) {
+        const Vector3f a(position(rng), height(rng), position(rng));
+        mesh.vertices.push_back(a);
+        mesh.vertices.push_back(a + Vector3f(offset(rng), offset(rng), offset(rng)));
+        mesh.vertices.push_back(a + Vector3f(offset(rng), offset(rng), offset(rng)));
+        mesh.indices.insert(mesh.indices.end(), { 3 * i, 3 * i + 1, 3 * i + 2 });
+    }
+    return mesh;
+}
+
+BENCHMARK(bvh_build_and_trace) {
+    constexpr int iterations = 3;
+    // 16x16 pixel tiles looking down at the mesh, one packet per tile
+    constexpr uint32_t tile_count = 1024;
+
+    const uint32_t worker_count = jobsystem::GetWorkerCount();
+
+    const TriangleMesh meshes[] = { CreateTerrain(708), CreateSoup(1000000) };
+    for (const TriangleMesh& mesh : meshes) {
+        const uint32_t triangle_count = static_cast<uint32_t>(mesh.indices.size() / 3);
+
+        BvhAccel::Ref bvh;
+        jobsystem::SetActiveWorkerCount(0);
+        const double serial_ms = benchmark::Measure(iterations, [&]() {
+            bvh = BvhAccel::Construct(mesh.indices, mesh.vertices);
+        });
+        jobsystem::SetActiveWorkerCount(worker_count);
+        const double parallel_ms = benchmark::Measure(iterations, [&]() {
+            bvh = BvhAccel::Construct(mesh.indices, mesh.vertices);
+        });
+
+        std::mt19937 rng(9);
+        std::uniform_real_distribution<float> position(0.0f, 99.0f);
+        std::vector<Ray> rays;
+        for (uint32_t tile = 0; tile < tile_count; ++tile) {
+            const Vector3f corner(position(rng), 0.0f, position(rng));
+            for (uint32_t i = 0; i < RayPacket::MAX_SIZE; ++i) {
+                const Vector3f origin = corner + Vector3f(0.05f * (i % 4), 20.0f, 0.05f * (i / 4));
+                rays.emplace_back(origin, origin + Vector3f(0.3f, -40.0f, 0.2f));
+            }
+        }
+
+        uint32_t single_hits = 0;
+        const double single_ms = benchmark::Measure(iterations, [&]() {
+            single_hits = 0;
+            for (const Ray& ray : rays) {
+                RayPacket packet;
+                packet.Add(ray);
+                int triangle = -1;
+                single_hits += bvh->Intersects(packet, packet.GetMask(), mesh.indices, mesh.vertices, false, &triangle) != 0;
+            }
+        });
+
+        uint32_t packet_hits = 0;
+        const double packet_ms = benchmark::Measure(iterations, [&]() {
+            packet_hits = 0;
+            for (size_t begin = 0; begin < rays.size(); begin += RayPacket::MAX_SIZE) {
+                RayPacket packet;
+                for (size_t i = begin; i < begin + RayPacket::MAX_SIZE; ++i) {
+                    packet.Add(rays[i]);
+                }
+                int triangles[RayPacket::MAX_SIZE];
+                packet_hits += std::popcount(bvh->Intersects(packet, packet.GetMask(), mesh.indices, mesh.vertices, false, triangles));
+            }
+        });
+
+        PRINT("  {:7} {} triangles, {} nodes: build {:8.3f} ms on 1 thread, {:8.3f} ms on {} threads",
+              mesh.name,
+              triangle_count,
+              bvh->nodes.size(),
+              serial_ms,
+              parallel_ms,
+              worker_count + 1);
+        PRINT("  {:7} {} rays: single {:8.3f} ms ({} hits), packets of {} {:8.3f} ms ({} hits)",
+              mesh.name,
+              rays.size(),
+              single_ms,
+              single_hits,
+              RayPacket::MAX_SIZE,
+              packet_ms,
+              packet_hits);
+    }
+}
+
+}  // namespace my
@@ -0,0 +1,98 @@
+#include "benchmark.h"
+
+#include "engine/core/io/archive.h"
+#include "engine/core/io/file_access_mapped.h"
+#include "engine/ecs/component_manager.inl"
+#include "engine/math/vector.h"
+
+namespace my {
+
+static constexpr char COMPONENT_FILE[] = "component_serialization_benchmark.bin";
+
+// a transform and a parent, Serialize() writes every member in order
+template<bool BULK>
+struct BenchmarkComponent {
+    static constexpr bool BULK_SERIALIZABLE = BULK;
+
+    uint32_t flags;
+    Vector3f translation;
+    Vector4f rotation;
+    Vector3f scale;
+    ecs::Entity parent;
+
+    void Serialize(Archive& p_archive, uint32_t) {
+        p_archive.ArchiveValue(flags);
+        p_archive.ArchiveValue(translation);
+        p_archive.ArchiveValue(rotation);
+        p_archive.ArchiveValue(scale);
+        p_archive.ArchiveValue(parent);
+    }
+
+    void OnDeserialized() {}
+
+    static void RegisterClass() {}
+};
+
+template class ecs::ComponentManager<BenchmarkComponent<false>>;
+template class ecs::ComponentManager<BenchmarkComponent<true>>;
+
+template<bool BULK>
+static void MeasureComponents(uint32_t p_count, int p_iterations, double& p_save_ms, double& p_load_ms) {
+    using Component = BenchmarkComponent<BULK>;
+    // no padding, the bulk path writes the same bytes
+    static_assert(sizeof(Component) == 2 * sizeof(uint32_t) + sizeof(Vector3f) * 2 + sizeof(Vector4f));
+
+    ecs::ComponentManager<Component> components;
+    for (uint32_t i = 0; i < p_count; ++i) {
+        Component& component = components.Create(ecs::Entity(i + 1));
+        component.flags = i;
+        component.translation = Vector3f(static_cast<float>(i));
+        component.rotation = Vector4f(0.0f, 0.0f, 0.0f, 1.0f);
+        component.scale = Vector3f(1.0f);
+        component.parent = ecs::Entity(i / 2 + 1);
+    }
+
+    p_save_ms = benchmark::Measure(p_iterations, [&]() {
+        Archive archive;
+        if (!archive.OpenWrite(COMPONENT_FILE)) {
+            CRASH_NOW_MSG("failed to open component file");
+        }
+        components.Serialize(archive, 0);
+    });
+
+    p_load_ms = benchmark::Measure(p_iterations, [&]() {
+        ecs::ComponentManager<Component> loaded;
+        Archive archive;
+        archive.OpenRead(FileAccessMapped::Map(COMPONENT_FILE).value());
+        if (!loaded.Serialize(archive, 0) || loaded.GetCount() != p_count) {
+            CRASH_NOW_MSG("failed to load components");
+        }
+    });
+}
+
+BENCHMARK(component_serialization) {
+    for (uint32_t count : { 100'000u, 1'000'000u }) {
+        const int iterations = count >= 1'000'000 ? 5 : 20;
+
+        double per_field_save_ms, per_field_load_ms;
+        double bulk_save_ms, bulk_load_ms;
+        MeasureComponents<false>(count, iterations, per_field_save_ms, per_field_load_ms);
+        MeasureComponents<true>(count, iterations, bulk_save_ms, bulk_load_ms);
+
+        PRINT("  {:7} entities, {} KB: save per field {:8.3f} ms, bulk {:8.3f} ms, speed up {:.2f}x",
+              count,
+              std::filesystem::file_size(COMPONENT_FILE) / 1024,
+              per_field_save_ms,
+              bulk_save_ms,
+              per_field_save_ms / bulk_save_ms);
+        PRINT("  {:7} entities: load per field {:8.3f} ms, bulk {:8.3f} ms, speed up {:.2f}x",
+              count,
+              per_field_load_ms,
+              bulk_load_ms,
+              per_field_load_ms / bulk_load_ms);
+    }
+
+    std::filesystem::remove(COMPONENT_FILE);
+}
+
+}  // namespace my
@@ -0,0 +1,94 @@
+#include "benchmark.h"
+
+#include <random>
+
+#include "engine/math/dynamic_aabb_tree.h"
+#include "engine/math/matrix_transform.h"
+
+namespace my {
+
+// boxes are spread over the ground with the same density at every count,
+// so the camera sees about the same number of objects however big the scene is
+static void CreateBoxes(uint32_t p_count, std::vector<AABB>& p_boxes) {
+    const float half_extent = 5.0f * glm::sqrt(static_cast<float>(p_count));
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-half_extent, half_extent);
+    std::uniform_real_distribution<float> height(0.0f, 10.0f);
+    std::uniform_real_distribution<float> size(0.5f, 2.0f);
+
+    p_boxes.resize(p_count);
+    for (AABB& box : p_boxes) {
+        const Vector3f center(position(rng), height(rng), position(rng));
+        box = AABB::FromCenterSize(center, Vector3f(size(rng)));
+    }
+}
+
+BENCHMARK(frustum_culling) {
+    constexpr int iterations = 20;
+
+    const Matrix4x4f view = LookAtRh(Vector3f(0.0f, 5.0f, 0.0f), Vector3f(0.0f, 5.0f, -1.0f), Vector3f::UnitY);
+    const Matrix4x4f projection = BuildOpenGlPerspectiveRH(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    const Frustum frustum(projection * view);
+
+    for (uint32_t count : { 1000u, 10000u, 100000u }) {
+        std::vector<AABB> boxes;
+        CreateBoxes(count, boxes);
+
+        // what the renderer did before, every box tested in batch
+        std::vector<float> soa[6];
+        for (int axis = 0; axis < 3; ++axis) {
+            soa[axis].resize(count);
+            soa[axis + 3].resize(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                soa[axis][i] = boxes[i].GetMin()[axis];
+                soa[axis + 3][i] = boxes[i].GetMax()[axis];
+            }
+        }
+        const AABBBatch batch = { soa[0].data(), soa[1].data(), soa[2].data(), soa[3].data(), soa[4].data(), soa[5].data() };
+        std::vector<uint8_t> visible(count);
+        uint32_t brute_visible = 0;
+        const double brute_ms = benchmark::Measure(iterations, [&]() {
+            frustum.Intersects(batch, visible.data(), count);
+            brute_visible = 0;
+            for (uint8_t v : visible) {
+                brute_visible += v;
+            }
+        });
+
+        DynamicAABBTree tree;
+        std::vector<int> proxies(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            proxies[i] = tree.Insert(boxes[i], i);
+        }
+
+        uint32_t tree_visible = 0;
+        const double tree_ms = benchmark::Measure(iterations, [&]() {
+            tree_visible = 0;
+            tree.Query(frustum, [&](uint32_t) { ++tree_visible; });
+        });
+
+        // one percent of the objects move a bit every frame
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<uint32_t> pick(0, count - 1);
+        std::uniform_real_distribution<float> offset(-0.2f, 0.2f);
+        const double move_ms = benchmark::Measure(iterations, [&]() {
+            for (uint32_t i = 0; i < count / 100; ++i) {
+                const uint32_t index = pick(rng);
+                const Vector3f delta(offset(rng), 0.0f, offset(rng));
+                boxes[index] = AABB(boxes[index].GetMin() + delta, boxes[index].GetMax() + delta);
+                tree.Move(proxies[index], boxes[index]);
+            }
+        });
+
+        PRINT("  {:6} boxes: brute force {:8.3f} ms ({} visible), tree {:8.3f} ms ({} candidates, height {}), move 1% {:8.3f} ms",
+              count,
+              brute_ms,
+              brute_visible,
+              tree_ms,
+              tree_visible,
+              tree.GetHeight(),
+              move_ms);
+    }
+}
+
+}  // namespace my
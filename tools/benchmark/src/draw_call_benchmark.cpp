@@ -0,0 +1,115 @@
+#include "benchmark.h"
+
+#include "engine/math/geometry.h"
+#include "engine/math/matrix_transform.h"
+#include "engine/renderer/frame_data.h"
+#include "engine/renderer/render_slot_table.h"
+#include "engine/scene/scene.h"
+#include "engine/systems/ecs_systems.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my {
+
+extern void RunMeshRenderSystem(Scene& p_scene, FrameData& p_framedata);
+
+static constexpr float SPACING = 3.0f;
+
+// pools of objects sharing a few meshes, like the rocks, batteries and cloud blocks of the_aviator
+static void CreateScene(Scene& p_scene, uint32_t p_count) {
+    const ecs::Entity material_id = p_scene.CreateMaterialEntity("material");
+    MeshComponent (*make_mesh[])() = {
+        []() { return MakeSphereMesh(1.0f, 12, 12); },
+        []() { return MakeCubeMesh(); },
+        []() { return MakeTetrahedronMesh(); },
+    };
+
+    std::vector<ecs::Entity> meshes;
+    for (auto make : make_mesh) {
+        const ecs::Entity mesh_id = p_scene.CreateMeshEntity("mesh");
+        MeshComponent& mesh = *p_scene.GetComponent<MeshComponent>(mesh_id);
+        mesh = make();
+        mesh.subsets[0].material_id = material_id;
+        // nothing is drawn, the commands only need a mesh to point at
+        mesh.gpuResource = std::make_shared<GpuMesh>();
+        meshes.push_back(mesh_id);
+    }
+
+    const uint32_t row = static_cast<uint32_t>(glm::ceil(glm::sqrt(static_cast<float>(p_count))));
+    for (uint32_t i = 0; i < p_count; ++i) {
+        const ecs::Entity entity = p_scene.CreateObjectEntity("object");
+        p_scene.GetComponent<MeshRendererComponent>(entity)->meshId = meshes[i % meshes.size()];
+        p_scene.GetComponent<TransformComponent>(entity)->SetTranslation(Vector3f(SPACING * (i % row), 0.0f, SPACING * (i / row)));
+    }
+
+    jobsystem::Context ctx;
+    RunTransformationUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+    RunHierarchyUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+    RunObjectUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+}
+
+struct DrawCount {
+    size_t draws;
+    size_t objects;
+};
+
+static DrawCount CountDraws(const ArenaVector<RenderCommand>& p_commands) {
+    DrawCount count{ p_commands.size(), 0 };
+    for (const RenderCommand& command : p_commands) {
+        count.objects += command.draw.instanceCount;
+    }
+    return count;
+}
+
+BENCHMARK(draw_calls) {
+    constexpr int iterations = 10;
+
+    for (uint32_t count : { 1000u, 10000u, 50000u }) {
+        Scene scene;
+        CreateScene(scene, count);
+
+        RenderSlotTable slots;
+        slots.Update(scene, false);
+
+        // looking over the whole grid from a corner
+        const float extent = SPACING * glm::sqrt(static_cast<float>(count));
+        const Vector3f center(0.5f * extent, 0.0f, 0.5f * extent);
+        const Matrix4x4f view = LookAtRh(Vector3f(-0.2f * extent, 0.5f * extent, -0.2f * extent), center, Vector3f::UnitY);
+        const Matrix4x4f projection = BuildOpenGlPerspectiveRH(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 4.0f * extent);
+
+        LinearAllocator arena;
+        DrawCount result[2];
+        double ms[2];
+        for (int instancing = 0; instancing < 2; ++instancing) {
+            RenderOptions options;
+            options.instancingEnabled = instancing;
+
+            ms[instancing] = benchmark::Measure(iterations, [&]() {
+                arena.Reset();
+                FrameData* framedata = new (arena.Allocate(sizeof(FrameData), alignof(FrameData))) FrameData(options, arena);
+                framedata->slots = &slots;
+                framedata->mainCamera.viewMatrix = view;
+                framedata->mainCamera.projectionMatrixFrustum = projection;
+                framedata->mainCamera.projectionMatrixRendering = projection;
+
+                RunMeshRenderSystem(scene, *framedata);
+                result[instancing] = CountDraws(framedata->gbuffer_commands);
+                framedata->~FrameData();
+            });
+        }
+
+        const double reduction = result[0].draws ? 100.0 * (1.0 - double(result[1].draws) / double(result[0].draws)) : 0.0;
+        PRINT("  {:6} objects: {:6} visible, gbuffer draws {:6} -> {:4} ({:5.1f}% fewer), mesh render system {:8.3f} ms -> {:8.3f} ms",
+              count,
+              result[0].objects,
+              result[0].draws,
+              result[1].draws,
+              reduction,
+              ms[0],
+              ms[1]);
+    }
+}
+
+}  // namespace my
@@ -0,0 +1,96 @@
+#include "benchmark.h"
+
+#include "engine/core/io/file_access_mapped.h"
+
+namespace my {
+
+static constexpr char TEST_FILE[] = "file_access_benchmark.bin";
+
+// p_size bytes in p_field_size writes, what an Archive does for every field
+static void WriteFields(FileAccess::AccessPattern p_pattern, size_t p_size, size_t p_field_size) {
+    auto file = FileAccess::Open(TEST_FILE, FileAccess::WRITE, p_pattern).value();
+    const std::vector<uint8_t> field(p_field_size, 0x5A);
+    for (size_t written = 0; written < p_size; written += p_field_size) {
+        file->WriteBuffer(field.data(), p_field_size);
+    }
+}
+
+static uint64_t ReadFields(FileAccess::AccessPattern p_pattern, size_t p_field_size) {
+    auto file = FileAccess::Open(TEST_FILE, FileAccess::READ, p_pattern).value();
+    std::vector<uint8_t> field(p_field_size);
+    uint64_t checksum = 0;
+    while (file->ReadBuffer(field.data(), p_field_size) == p_field_size) {
+        checksum += field[0];
+    }
+    return checksum;
+}
+
+// what the asset loaders do, the whole file into memory
+static uint64_t ReadWholeFile(FileAccess::AccessPattern p_pattern) {
+    auto file = FileAccess::Open(TEST_FILE, FileAccess::READ, p_pattern).value();
+    std::vector<uint8_t> buffer(file->GetLength());
+    file->ReadBuffer(buffer.data(), buffer.size());
+    return buffer.back();
+}
+
+BENCHMARK(file_access) {
+    constexpr size_t size = 64 * 1024 * 1024;
+    constexpr int iterations = 5;
+
+    for (size_t field_size : { 4u, 16u, 64u }) {
+        const double write_file_ms = benchmark::Measure(iterations, [&]() {
+            WriteFields(FileAccess::PATTERN_DEFAULT, size, field_size);
+        });
+        const double write_buffered_ms = benchmark::Measure(iterations, [&]() {
+            WriteFields(FileAccess::PATTERN_STREAM, size, field_size);
+        });
+
+        uint64_t checksum = 0;
+        const double read_file_ms = benchmark::Measure(iterations, [&]() {
+            checksum += ReadFields(FileAccess::PATTERN_DEFAULT, field_size);
+        });
+        const double read_buffered_ms = benchmark::Measure(iterations, [&]() {
+            checksum += ReadFields(FileAccess::PATTERN_STREAM, field_size);
+        });
+        const double read_mapped_ms = benchmark::Measure(iterations, [&]() {
+            checksum += ReadFields(FileAccess::PATTERN_WHOLE_FILE, field_size);
+        });
+
+        PRINT("  {:2} byte fields, write: FILE* {:8.3f} ms, buffered {:8.3f} ms, speed up {:.2f}x",
+              field_size,
+              write_file_ms,
+              write_buffered_ms,
+              write_file_ms / write_buffered_ms);
+        PRINT("  {:2} byte fields, read:  FILE* {:8.3f} ms, buffered {:8.3f} ms, mapped {:8.3f} ms ({})",
+              field_size,
+              read_file_ms,
+              read_buffered_ms,
+              read_mapped_ms,
+              checksum);
+    }
+
+    uint64_t checksum = 0;
+    const double whole_file_ms = benchmark::Measure(iterations, [&]() {
+        checksum += ReadWholeFile(FileAccess::PATTERN_DEFAULT);
+    });
+    const double whole_mapped_ms = benchmark::Measure(iterations, [&]() {
+        checksum += ReadWholeFile(FileAccess::PATTERN_WHOLE_FILE);
+    });
+    const double span_ms = benchmark::Measure(iterations, [&]() {
+        auto file = FileAccessMapped::Map(TEST_FILE).value();
+        for (uint8_t byte : file->GetData()) {
+            checksum += byte;
+        }
+    });
+
+    PRINT("  {} MB file, read: FILE* {:8.3f} ms, mapped {:8.3f} ms, span without copy {:8.3f} ms ({})",
+          size / 1024 / 1024,
+          whole_file_ms,
+          whole_mapped_ms,
+          span_ms,
+          checksum);
+
+    std::filesystem::remove(TEST_FILE);
+}
+
+}  // namespace my
@@ -0,0 +1,63 @@
+#include "benchmark.h"
+
+#include "engine/math/geomath.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my {
+
+#if USING(ENABLE_JOB_SYSTEM)
+BENCHMARK(job_system_dispatch_overhead) {
+    constexpr uint32_t job_count = 64 * 1024;
+    constexpr int iterations = 100;
+
+    for (uint32_t group_size : { 1u, 16u, 256u }) {
+        const double ms = benchmark::Measure(iterations, [&]() {
+            jobsystem::Context ctx;
+            ctx.Dispatch(job_count, group_size, [](jobsystem::JobArgs) {});
+            ctx.Wait();
+        });
+
+        const uint32_t group_count = (job_count + group_size - 1) / group_size;
+        PRINT("  group size {:4}: {:8.3f} ms per dispatch, {:8.1f} ns per group",
+              group_size,
+              ms,
+              ms * 1e6 / group_count);
+    }
+}
+
+BENCHMARK(job_system_scaling) {
+    constexpr uint32_t job_count = 1024 * 1024;
+    constexpr uint32_t group_size = 256;
+    constexpr int iterations = 20;
+
+    std::vector<float> data(job_count);
+    const uint32_t worker_count = jobsystem::GetWorkerCount();
+    double baseline = 0.0;
+
+    for (uint32_t active = 0; active <= worker_count; ++active) {
+        jobsystem::SetActiveWorkerCount(active);
+
+        const double ms = benchmark::Measure(iterations, [&]() {
+            jobsystem::Context ctx;
+            ctx.Dispatch(job_count, group_size, [&](jobsystem::JobArgs p_args) {
+                float x = static_cast<float>(p_args.jobIndex);
+                for (int i = 0; i < 64; ++i) {
+                    x = glm::sqrt(x * x + 1.0f);
+                }
+                data[p_args.jobIndex] = x;
+            });
+            ctx.Wait();
+        });
+
+        if (active == 0) {
+            baseline = ms;
+        }
+
+        PRINT("  {} thread(s): {:8.3f} ms, speed up {:.2f}x", active + 1, ms, baseline / ms);
+    }
+
+    jobsystem::SetActiveWorkerCount(worker_count);
+}
+#endif
+
+}  // namespace my
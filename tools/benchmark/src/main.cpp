@@ -0,0 +1,47 @@
+#include "benchmark.h"
+
+#include "engine/core/os/threads.h"
+#include "engine/runtime/engine.h"
+
+namespace my::benchmark {
+
+struct BenchmarkEntry {
+    const char* name;
+    BenchmarkFunc func;
+};
+
+static std::vector<BenchmarkEntry>& GetBenchmarks() {
+    static std::vector<BenchmarkEntry> s_benchmarks;
+    return s_benchmarks;
+}
+
+bool Register(const char* p_name, BenchmarkFunc p_func) {
+    GetBenchmarks().push_back({ p_name, p_func });
+    return true;
+}
+
+}  // namespace my::benchmark
+
+using namespace my;
+
+// usage: benchmark [filter]
+// runs every benchmark whose name contains filter
+int main(int p_argc, const char** p_argv) {
+    const std::string_view filter = p_argc > 1 ? p_argv[1] : "";
+
+    engine::InitializeCore();
+
+    for (const auto& entry : benchmark::GetBenchmarks()) {
+        if (!filter.empty() && std::string_view(entry.name).find(filter) == std::string_view::npos) {
+            continue;
+        }
+
+        PRINT("[benchmark] {}", entry.name);
+        entry.func();
+    }
+
+    thread::RequestShutdown();
+    engine::FinalizeCore();
+
+    return 0;
+}
@@ -0,0 +1 @@
+#include "engine/pch.h"
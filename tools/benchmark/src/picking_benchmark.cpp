@@ -0,0 +1,127 @@
+#include "benchmark.h"
+
+#include <random>
+
+#include "engine/math/geometry.h"
+#include "engine/math/matrix_transform.h"
+#include "engine/scene/scene.h"
+#include "engine/systems/ecs_systems.h"
+#include "engine/systems/job_system/job_system.h"
+
+namespace my {
+
+static constexpr float SPACING = 3.0f;
+
+// p_count instances of one sphere mesh on a square grid
+static void CreateScene(Scene& p_scene, uint32_t p_count) {
+    const ecs::Entity material_id = p_scene.CreateMaterialEntity("material");
+    const ecs::Entity mesh_id = p_scene.CreateMeshEntity("sphere");
+    MeshComponent& mesh = *p_scene.GetComponent<MeshComponent>(mesh_id);
+    mesh = MakeSphereMesh(1.0f, 20, 20);
+    mesh.subsets[0].material_id = material_id;
+
+    const uint32_t row = static_cast<uint32_t>(glm::ceil(glm::sqrt(static_cast<float>(p_count))));
+    for (uint32_t i = 0; i < p_count; ++i) {
+        const ecs::Entity entity = p_scene.CreateObjectEntity("object");
+        p_scene.GetComponent<MeshRendererComponent>(entity)->meshId = mesh_id;
+        p_scene.GetComponent<TransformComponent>(entity)->SetTranslation(Vector3f(SPACING * (i % row), 0.0f, SPACING * (i / row)));
+    }
+
+    jobsystem::Context ctx;
+    RunTransformationUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+    RunHierarchyUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+    RunObjectUpdateSystem(p_scene, ctx, 0.0f);
+    ctx.Wait();
+}
+
+// what Scene::Intersects used to do, every triangle of every object
+static ecs::Entity BruteForce(Scene& p_scene, Ray& p_ray) {
+    ecs::Entity result;
+    for (auto [entity, object, transform] : p_scene.View<MeshRendererComponent, TransformComponent>()) {
+        const MeshComponent& mesh = *p_scene.GetComponent<MeshComponent>(object.meshId);
+        Ray local = p_ray.Inverse(glm::inverse(transform.GetWorldMatrix()));
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            if (local.Intersects(mesh.positions[mesh.indices[i]], mesh.positions[mesh.indices[i + 1]], mesh.positions[mesh.indices[i + 2]])) {
+                result = entity;
+            }
+        }
+        p_ray.CopyDist(local);
+    }
+    return result;
+}
+
+BENCHMARK(ray_picking) {
+    constexpr uint32_t ray_count = 256;
+    constexpr int iterations = 5;
+
+    for (uint32_t count : { 100u, 1000u, 10000u }) {
+        Scene scene;
+        CreateScene(scene, count);
+
+        // rays from above, next to each other like the pixels of a small region of the screen
+        const float extent = SPACING * glm::sqrt(static_cast<float>(count));
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<float> position(0.0f, extent);
+        const Vector3f center(position(rng), 0.0f, position(rng));
+        std::vector<Ray> rays;
+        for (uint32_t i = 0; i < ray_count; ++i) {
+            const Vector3f offset(0.05f * (i % 16), 0.0f, 0.05f * (i / 16));
+            rays.emplace_back(center + offset + Vector3f(0.0f, 50.0f, 0.0f), center + offset - Vector3f(0.0f, 50.0f, 0.0f));
+        }
+        auto reset_rays = [&]() {
+            for (Ray& ray : rays) {
+                ray.SetDist(1.0f);
+            }
+        };
+
+        // the bottom level trees are built on the first query
+        reset_rays();
+        Ray warm_up = rays[0];
+        scene.Intersects(warm_up);
+
+        uint32_t brute_hits = 0;
+        const double brute_ms = benchmark::Measure(1, [&]() {
+            reset_rays();
+            brute_hits = 0;
+            for (Ray& ray : rays) {
+                brute_hits += BruteForce(scene, ray).IsValid();
+            }
+        });
+
+        uint32_t nearest_hits = 0;
+        const double nearest_ms = benchmark::Measure(iterations, [&]() {
+            reset_rays();
+            nearest_hits = 0;
+            for (Ray& ray : rays) {
+                nearest_hits += scene.Intersects(ray).entity.IsValid();
+            }
+        });
+
+        const double any_ms = benchmark::Measure(iterations, [&]() {
+            reset_rays();
+            for (Ray& ray : rays) {
+                scene.Intersects(ray, Scene::RayQueryMode::ANY);
+            }
+        });
+
+        std::vector<Scene::RayIntersectionResult> results(ray_count);
+        const double packet_ms = benchmark::Measure(iterations, [&]() {
+            reset_rays();
+            scene.Intersects(rays, results);
+        });
+
+        PRINT("  {} objects, {} rays: brute force {:8.3f} ms ({} hits), nearest {:8.3f} ms ({} hits), any {:8.3f} ms, packets {:8.3f} ms",
+              count,
+              ray_count,
+              brute_ms,
+              brute_hits,
+              nearest_ms,
+              nearest_hits,
+              any_ms,
+              packet_ms);
+    }
+}
+
+}  // namespace my
@@ -0,0 +1,58 @@
+#include "benchmark.h"
+
+#include "engine/core/base/random.h"
+#include "engine/math/matrix_transform.h"
+#include "engine/math/transform_batch.h"
+
+namespace my {
+
+BENCHMARK(transform_compose) {
+    for (size_t count : { 10'000u, 100'000u, 1'000'000u }) {
+        std::vector<float> soa[10];
+        for (auto& values : soa) {
+            values.resize(count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const Quaternion q = glm::normalize(Quaternion(Random::Float(), Random::Float(), Random::Float(), Random::Float()));
+            soa[0][i] = Random::Float(-100.0f, 100.0f);
+            soa[1][i] = Random::Float(-100.0f, 100.0f);
+            soa[2][i] = Random::Float(-100.0f, 100.0f);
+            soa[3][i] = q.x;
+            soa[4][i] = q.y;
+            soa[5][i] = q.z;
+            soa[6][i] = q.w;
+            soa[7][i] = soa[8][i] = soa[9][i] = Random::Float(0.5f, 2.0f);
+        }
+
+        const TransformBatch batch = { soa[0].data(), soa[1].data(), soa[2].data(), soa[3].data(), soa[4].data(),
+                                       soa[5].data(), soa[6].data(), soa[7].data(), soa[8].data(), soa[9].data() };
+        std::vector<Matrix4x4f> matrices(count);
+
+        const int iterations = count >= 1'000'000 ? 10 : 100;
+
+        // what TransformComponent::GetLocalMatrix() does
+        const double glm_ms = benchmark::Measure(iterations, [&]() {
+            for (size_t i = 0; i < count; ++i) {
+                const Quaternion q(soa[6][i], soa[3][i], soa[4][i], soa[5][i]);
+                matrices[i] = glm::translate(glm::vec3(soa[0][i], soa[1][i], soa[2][i])) *
+                              glm::toMat4(q) *
+                              glm::scale(glm::vec3(soa[7][i], soa[8][i], soa[9][i]));
+            }
+        });
+        const double scalar_ms = benchmark::Measure(iterations, [&]() {
+            ComposeTransformsScalar(batch, matrices.data(), count);
+        });
+        const double batch_ms = benchmark::Measure(iterations, [&]() {
+            ComposeTransforms(batch, matrices.data(), count);
+        });
+
+        PRINT("  {:7} transforms: glm {:8.3f} ms, scalar {:8.3f} ms, batch {:8.3f} ms, speed up {:.2f}x",
+              count,
+              glm_ms,
+              scalar_ms,
+              batch_ms,
+              glm_ms / batch_ms);
+    }
+}
+
+}  // namespace my
@@ -316,6 +316,10 @@ void PropertyPanel::UpdateInternal(Scene& p_scene) {
         if (ImGui::SliderFloat("Frame", &p_animation.timer, p_animation.start, p_animation.end)) {
             p_animation.flags |= AnimationComponent::PLAYING;
         }
+        bool compressed = p_animation.IsCompressed();
+        if (ImGui::Checkbox("Compressed", &compressed)) {
+            p_animation.flags ^= AnimationComponent::COMPRESSED;
+        }
         ImGui::Separator();
     });
 
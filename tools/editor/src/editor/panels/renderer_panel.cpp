@@ -33,6 +33,17 @@ void RendererPanel::UpdateInternal(Scene&) {
     ImGui::Text("Frame rate:%.2f", ImGui::GetIO().Framerate);
     ImGui::Checkbox("show editor", (bool*)DVAR_GET_POINTER(show_editor));
 
+    CollapseWindow("Draw", []() {
+        ImGui::Checkbox("instancing", (bool*)DVAR_GET_POINTER(gfx_enable_instancing));
+        ImGui::Checkbox("debug gpu culling", (bool*)DVAR_GET_POINTER(gfx_debug_gpu_culling));
+        const DrawStats& stats = IGraphicsManager::GetSingleton().GetCurrentFrame().drawStats;
+        ImGui::Text("draws: %u (%u instances)", stats.drawCount, stats.instanceCount);
+        ImGui::Text("pipeline binds skipped: %u", stats.pipelineBindsSkipped);
+        ImGui::Text("mesh binds skipped: %u", stats.meshBindsSkipped);
+        ImGui::Text("material binds skipped: %u", stats.materialBindsSkipped);
+        ImGui::Text("bone binds skipped: %u", stats.boneBindsSkipped);
+    });
+
     CollapseWindow("Shadow", []() {
         ImGui::Checkbox("debug", (bool*)DVAR_GET_POINTER(gfx_debug_shadow));
     });